@@ -29,14 +29,17 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/param.h>
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/kthread.h>
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/can.h>
+#include <nuttx/net/ip.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev_lowerhalf.h>
 #include <nuttx/net/pkt.h>
+#include <nuttx/net/udp.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/spinlock.h>
 
@@ -54,12 +57,25 @@
 #  define NETDEV_WORK LPWORK
 #endif
 
-#ifdef CONFIG_NETDEV_RSS
-#  define NETDEV_THREAD_COUNT CONFIG_SMP_NCPUS
+/* A multi-queue device has one thread per queue, the thread of queue n
+ * runs on CPU (n % CONFIG_SMP_NCPUS) and polls queue n only.  Other
+ * devices have one thread per CPU with RSS, or a single thread.
+ */
+
+#if defined(CONFIG_NETDEV_MULTIQUEUE)
+#  define NETDEV_THREAD_COUNT  MAX(CONFIG_NETDEV_MAX_QUEUES, CONFIG_SMP_NCPUS)
+#  define NETDEV_THREAD_CPU(i) ((i) % CONFIG_SMP_NCPUS)
+#elif defined(CONFIG_NETDEV_RSS)
+#  define NETDEV_THREAD_COUNT  CONFIG_SMP_NCPUS
+#  define NETDEV_THREAD_CPU(i) (i)
 #else
-#  define NETDEV_THREAD_COUNT 1
+#  define NETDEV_THREAD_COUNT  1
 #endif
 
+/* Size of the table mapping flow hashes to TX queues */
+
+#define NETDEV_RSS_TABLE_SIZE    128
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -85,6 +101,16 @@ struct netdev_upperhalf_s
 #if CONFIG_IOB_NCHAINS > 0
   struct iob_queue_s txq;
 #endif
+
+  /* Max packets received from a queue in one poll */
+
+  int rxbudget;
+
+  /* TX queue of each flow hash bucket, follows the CPU receiving the flow */
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  uint8_t rss_queue[NETDEV_RSS_TABLE_SIZE];
+#endif
 };
 
 /****************************************************************************
@@ -221,6 +247,98 @@ netdev_upper_alloc(FAR struct netdev_lowerhalf_s *dev)
   return upper;
 }
 
+/****************************************************************************
+ * Name: netdev_upper_nqueues/nthreads
+ *
+ * Description:
+ *   Get the number of queue pairs and of worker threads of the device.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+#  define netdev_upper_nqueues(upper) MAX((upper)->lower->nqueues, 1)
+#  define netdev_upper_nthreads(upper) \
+     ((upper)->lower->nqueues > 1 ? \
+      (upper)->lower->nqueues : CONFIG_SMP_NCPUS)
+#else
+#  define netdev_upper_nqueues(upper)  1
+#  define netdev_upper_nthreads(upper) NETDEV_THREAD_COUNT
+#endif
+
+/****************************************************************************
+ * Name: netdev_upper_txqueue
+ *
+ * Description:
+ *   Select the TX queue of the outgoing packet in d_iob.  TCP and UDP
+ *   flows are hashed over the 4-tuple the same way as by
+ *   netdev_notify_recvcpu(), so the packets of a flow leave on the queue
+ *   of the CPU that receives it.  Other packets use queue 0.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+static int netdev_upper_txqueue(FAR struct netdev_upperhalf_s *upper)
+{
+  FAR struct net_driver_s *dev = &upper->lower->netdev;
+  FAR struct udp_hdr_s *udp = NULL;
+  uint32_t src[4];
+  uint32_t dst[4];
+  uint8_t domain;
+  uint32_t hash;
+
+#ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv4(dev->d_flags))
+    {
+      FAR struct ipv4_hdr_s *ipv4 = IPv4BUF;
+
+      if (ipv4->proto == IP_PROTO_TCP || ipv4->proto == IP_PROTO_UDP)
+        {
+          udp = IPBUF((ipv4->vhl & IPv4_HLMASK) << 2);
+        }
+
+      memcpy(src, ipv4->srcipaddr, sizeof(in_addr_t));
+      memcpy(dst, ipv4->destipaddr, sizeof(in_addr_t));
+      domain = PF_INET;
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if (IFF_IS_IPv6(dev->d_flags))
+    {
+      FAR struct ipv6_hdr_s *ipv6 = IPv6BUF;
+
+      if (ipv6->proto == IP_PROTO_TCP || ipv6->proto == IP_PROTO_UDP)
+        {
+          udp = IPBUF(IPv6_HDRLEN);
+        }
+
+      memcpy(src, ipv6->srcipaddr, sizeof(net_ipv6addr_t));
+      memcpy(dst, ipv6->destipaddr, sizeof(net_ipv6addr_t));
+      domain = PF_INET6;
+    }
+  else
+#endif
+    {
+      return 0;
+    }
+
+  /* The source and destination ports are at the same offsets in the TCP
+   * and UDP headers.
+   */
+
+  if (udp == NULL)
+    {
+      return 0;
+    }
+
+  hash = netdev_flow_hash(domain, src, udp->srcport, dst, udp->destport);
+  return upper->rss_queue[hash % NETDEV_RSS_TABLE_SIZE];
+}
+#endif
+
 /****************************************************************************
  * Name: netdev_upper_can_tx
  *
@@ -277,11 +395,23 @@ static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
   FAR struct netdev_lowerhalf_s *lower = upper->lower;
   FAR netpkt_t                  *pkt;
   int                            ret;
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  int                            queue = 0;
+#endif
 
   DEBUGASSERT(dev->d_len > 0);
 
   NETDEV_TXPACKETS(dev);
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (lower->nqueues > 1)
+    {
+      queue = netdev_upper_txqueue(upper);
+    }
+
+  NETDEV_TXQUEUE(dev, queue);
+#endif
+
 #ifdef CONFIG_NET_PKT
   /* When packet sockets are enabled, feed the tx frame into it */
 
@@ -295,6 +425,12 @@ static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
       nerr("ERROR: Packet too long to send!\n");
       ret = -EMSGSIZE;
     }
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  else if (lower->nqueues > 1)
+    {
+      ret = lower->ops->transmitq(lower, pkt, queue);
+    }
+#endif
   else
     {
       ret = lower->ops->transmit(lower, pkt);
@@ -581,31 +717,87 @@ static void ip_input(FAR struct net_driver_s *dev)
 }
 #endif
 
+/****************************************************************************
+ * Name: netdev_upper_receive
+ *
+ * Description:
+ *   Receive one packet from an RX queue of the lower half.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static inline FAR netpkt_t *
+netdev_upper_receive(FAR struct netdev_lowerhalf_s *lower, int queue)
+{
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (lower->nqueues > 1)
+    {
+      return lower->ops->receiveq(lower, queue);
+    }
+#endif
+
+  return lower->ops->receive(lower);
+}
+
 /****************************************************************************
  * Function: netdev_upper_rxpoll_work
  *
  * Description:
  *   Try to receive packets from device and pass packets into IP
- *   stack and send packets which is from IP stack if necessary.
+ *   stack and send packets which is from IP stack if necessary.  At most
+ *   rxbudget packets are taken, the RX interrupt is unmasked only once the
+ *   queue is drained.
  *
  * Input Parameters:
  *   upper - Reference to the upper half driver structure
+ *   queue - The RX queue to poll
+ *
+ * Returned Value:
+ *   True if the budget ran out before the queue was drained.
  *
  * Assumptions:
  *   Called with the network locked.
  *
  ****************************************************************************/
 
-static void netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper)
+static bool netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper,
+                                     int queue)
 {
   FAR struct netdev_lowerhalf_s *lower = upper->lower;
   FAR struct net_driver_s       *dev   = &lower->netdev;
   FAR netpkt_t                  *pkt;
+  int                            budget = upper->rxbudget;
+
+  NETDEV_RXPOLLS(dev);
 
   /* Loop while receive() successfully retrieves valid Ethernet frames. */
 
-  while ((pkt = lower->ops->receive(lower)) != NULL)
+  while (budget-- > 0)
     {
+      pkt = netdev_upper_receive(lower, queue);
+      if (pkt == NULL)
+        {
+          if (lower->ops->rxint == NULL)
+            {
+              return false;
+            }
+
+          /* Drained, unmask the interrupt and check again for a packet
+           * that arrived before it was unmasked.
+           */
+
+          lower->ops->rxint(lower, queue, true);
+          pkt = netdev_upper_receive(lower, queue);
+          if (pkt == NULL)
+            {
+              return false;
+            }
+
+          lower->ops->rxint(lower, queue, false);
+        }
+
       if (!IFF_IS_UP(dev->d_flags))
         {
           /* Interface down, drop frame */
@@ -617,6 +809,7 @@ static void netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper)
 
       netpkt_put(dev, pkt, NETPKT_RX);
       NETDEV_RXPACKETS(dev);
+      NETDEV_RXQUEUE(dev, queue);
 
 #ifdef CONFIG_NET_PKT
       /* When packet sockets are enabled, feed the frame into the tap */
@@ -656,30 +849,66 @@ static void netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper)
           break;
         }
     }
+
+  /* Budget exhausted, leave the interrupt masked and poll again later */
+
+  return true;
 }
 
 /****************************************************************************
- * Name: netdev_upper_work
+ * Name: netdev_upper_poll
  *
  * Description:
- *   Perform an out-of-cycle poll on a dedicated thread or the worker thread.
+ *   Poll one RX queue of the device, then send the pending TX packets.
  *
  * Input Parameters:
- *   arg - Reference to the upper half driver structure (cast to void *)
+ *   upper - Reference to the upper half driver structure
+ *   queue - The RX queue to poll
+ *
+ * Returned Value:
+ *   True if the RX queue needs to be polled again.
  *
  ****************************************************************************/
 
-static void netdev_upper_work(FAR void *arg)
+static bool netdev_upper_poll(FAR struct netdev_upperhalf_s *upper,
+                              int queue)
 {
-  FAR struct netdev_upperhalf_s *upper = arg;
+  bool again;
 
   /* RX may release quota and driver buffer, so do RX first. */
 
   net_lock();
-  netdev_upper_rxpoll_work(upper);
+  again = netdev_upper_rxpoll_work(upper, queue);
   netdev_upper_txavail_work(upper);
   net_unlock();
+
+  return again;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_work
+ *
+ * Description:
+ *   Perform an out-of-cycle poll on the worker thread.
+ *
+ * Input Parameters:
+ *   arg - Reference to the upper half driver structure (cast to void *)
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_NETDEV_WORK_THREAD
+static void netdev_upper_work(FAR void *arg)
+{
+  FAR struct netdev_upperhalf_s *upper = arg;
+
+  /* Requeue to give other work a chance if the budget ran out */
+
+  if (netdev_upper_poll(upper, 0))
+    {
+      work_queue(NETDEV_WORK, &upper->work, netdev_upper_work, upper, 0);
+    }
 }
+#endif
 
 /****************************************************************************
  * Name: netdev_upper_wait
@@ -702,6 +931,26 @@ static int netdev_upper_wait(FAR sem_t *sem)
 #endif
 }
 
+/****************************************************************************
+ * Name: netdev_upper_post
+ *
+ * Description:
+ *   Wake up a dedicated thread if it is not already pending.
+ *
+ ****************************************************************************/
+
+static inline void netdev_upper_post(FAR struct netdev_upperhalf_s *upper,
+                                     int index)
+{
+  int semcount;
+
+  if (nxsem_get_value(&upper->sem[index], &semcount) == OK &&
+      semcount <= 0)
+    {
+      nxsem_post(&upper->sem[index]);
+    }
+}
+
 /****************************************************************************
  * Name: netdev_upper_loop
  *
@@ -714,24 +963,37 @@ static int netdev_upper_loop(int argc, FAR char *argv[])
 {
   FAR struct netdev_upperhalf_s *upper =
     (FAR struct netdev_upperhalf_s *)((uintptr_t)strtoul(argv[1], NULL, 16));
-  int cpu = atoi(argv[2]);
+  int index = atoi(argv[2]);
 
 #ifdef CONFIG_NETDEV_RSS
   cpu_set_t cpuset;
 
   CPU_ZERO(&cpuset);
-  CPU_SET(cpu, &cpuset);
-  sched_setaffinity(upper->tid[cpu], sizeof(cpu_set_t), &cpuset);
+  CPU_SET(NETDEV_THREAD_CPU(index), &cpuset);
+  sched_setaffinity(upper->tid[index], sizeof(cpu_set_t), &cpuset);
 #endif
 
-  while (netdev_upper_wait(&upper->sem[cpu]) == OK &&
-         upper->tid[cpu] != INVALID_PROCESS_ID)
+  while (netdev_upper_wait(&upper->sem[index]) == OK &&
+         upper->tid[index] != INVALID_PROCESS_ID)
     {
-      netdev_upper_work(upper);
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+      int queue = index < upper->lower->nqueues ? index : 0;
+#else
+      const int queue = 0;
+#endif
+
+      /* Wake up again at once if the budget ran out, the network lock
+       * has been released in between.
+       */
+
+      if (netdev_upper_poll(upper, queue))
+        {
+          netdev_upper_post(upper, index);
+        }
     }
 
   nwarn("WARNING: Netdev work thread quitting.");
-  nxsem_post(&upper->sem_exit[cpu]);
+  nxsem_post(&upper->sem_exit[index]);
   return 0;
 }
 #endif
@@ -753,17 +1015,10 @@ static inline void netdev_upper_queue_work(FAR struct net_driver_s *dev)
 
 #ifdef CONFIG_NETDEV_WORK_THREAD
 #  ifdef CONFIG_NETDEV_RSS
-  int cpu = this_cpu();
+  netdev_upper_post(upper, this_cpu() % netdev_upper_nthreads(upper));
 #  else
-  const int cpu = 0;
+  netdev_upper_post(upper, 0);
 #  endif
-  int semcount;
-
-  if (nxsem_get_value(&upper->sem[cpu], &semcount) == OK &&
-      semcount <= 0)
-    {
-      nxsem_post(&upper->sem[cpu]);
-    }
 #else
   if (work_available(&upper->work))
     {
@@ -1051,7 +1306,7 @@ static int netdev_upper_ifup(FAR struct net_driver_s *dev)
 
   /* Try to bring up a dedicated thread for work. */
 
-  for (i = 0; i < NETDEV_THREAD_COUNT; i++)
+  for (i = 0; i < netdev_upper_nthreads(upper); i++)
     {
       if (upper->tid[i] <= 0)
         {
@@ -1154,6 +1409,30 @@ static int netdev_upper_ioctl(FAR struct net_driver_s *dev, int cmd,
     }
 #endif
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  /* Move the TX queue of the flow to the CPU now receiving it, and let the
+   * lower half steer its RX queues too if it can.
+   */
+
+  if (cmd == SIOCNOTIFYRECVCPU)
+    {
+      FAR struct netdev_rss_s *rss =
+        (FAR struct netdev_rss_s *)((uintptr_t)arg);
+
+      int ret = -ENOTTY;
+
+      upper->rss_queue[rss->hash % NETDEV_RSS_TABLE_SIZE] =
+        rss->cpu % netdev_upper_nqueues(upper);
+
+      if (lower->ops->ioctl)
+        {
+          ret = lower->ops->ioctl(lower, cmd, arg);
+        }
+
+      return ret == -ENOTTY ? OK : ret;
+    }
+#endif
+
   if (lower->ops->ioctl)
     {
       return lower->ops->ioctl(lower, cmd, arg);
@@ -1189,7 +1468,7 @@ int netdev_lower_register(FAR struct netdev_lowerhalf_s *dev,
 {
   FAR struct netdev_upperhalf_s *upper;
   int ret;
-#ifdef CONFIG_NETDEV_WORK_THREAD
+#if defined(CONFIG_NETDEV_WORK_THREAD) || defined(CONFIG_NETDEV_MULTIQUEUE)
   int i;
 #endif
 
@@ -1199,6 +1478,15 @@ int netdev_lower_register(FAR struct netdev_lowerhalf_s *dev,
       return -EINVAL;
     }
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (dev->nqueues > 1 &&
+      (dev->nqueues > CONFIG_NETDEV_MAX_QUEUES ||
+       dev->ops->transmitq == NULL || dev->ops->receiveq == NULL))
+    {
+      return -EINVAL;
+    }
+#endif
+
   if ((upper = netdev_upper_alloc(dev)) == NULL)
     {
       return -ENOMEM;
@@ -1216,6 +1504,19 @@ int netdev_lower_register(FAR struct netdev_lowerhalf_s *dev,
 #endif
   dev->netdev.d_private = upper;
 
+#if CONFIG_NETDEV_RX_BUDGET > 0
+  upper->rxbudget = CONFIG_NETDEV_RX_BUDGET;
+#else
+  upper->rxbudget = MAX(netdev_lower_quota_load(dev, NETPKT_RX), 1);
+#endif
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  for (i = 0; i < NETDEV_RSS_TABLE_SIZE; i++)
+    {
+      upper->rss_queue[i] = i % netdev_upper_nqueues(upper);
+    }
+#endif
+
   ret = netdev_register(&dev->netdev, lltype);
   if (ret < 0)
     {
@@ -1343,6 +1644,14 @@ void netdev_lower_carrier_off(FAR struct netdev_lowerhalf_s *dev)
 
 void netdev_lower_rxready(FAR struct netdev_lowerhalf_s *dev)
 {
+  /* Mask the interrupt until the queue is drained by the poll */
+
+  NETDEV_RXINTERRUPTS(&dev->netdev);
+  if (dev->ops->rxint)
+    {
+      dev->ops->rxint(dev, 0, false);
+    }
+
 #if CONFIG_NETDEV_WORK_THREAD_POLLING_PERIOD == 0
   netdev_upper_queue_work(&dev->netdev);
 #endif
@@ -1367,6 +1676,61 @@ void netdev_lower_txdone(FAR struct netdev_lowerhalf_s *dev)
 #endif
 }
 
+/****************************************************************************
+ * Name: netdev_lower_rxready_queue
+ *
+ * Description:
+ *   Notifies the networking layer about an RX packet is ready to read on
+ *   one queue of a multi-queue device.
+ *
+ * Input Parameters:
+ *   dev   - The lower half device driver structure
+ *   queue - The queue that has packets ready
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+void netdev_lower_rxready_queue(FAR struct netdev_lowerhalf_s *dev,
+                                int queue)
+{
+  DEBUGASSERT(queue >= 0 && queue < MAX(dev->nqueues, 1));
+
+  NETDEV_RXINTERRUPTS(&dev->netdev);
+  if (dev->ops->rxint)
+    {
+      dev->ops->rxint(dev, queue, false);
+    }
+
+#if CONFIG_NETDEV_WORK_THREAD_POLLING_PERIOD == 0
+  netdev_upper_post(dev->netdev.d_private, queue);
+#endif
+}
+
+/****************************************************************************
+ * Name: netdev_lower_txdone_queue
+ *
+ * Description:
+ *   Notifies the networking layer about a TX packet is sent on one queue
+ *   of a multi-queue device.
+ *
+ * Input Parameters:
+ *   dev   - The lower half device driver structure
+ *   queue - The queue that completed the transmission
+ *
+ ****************************************************************************/
+
+void netdev_lower_txdone_queue(FAR struct netdev_lowerhalf_s *dev,
+                               int queue)
+{
+  DEBUGASSERT(queue >= 0 && queue < MAX(dev->nqueues, 1));
+
+  NETDEV_TXDONE(&dev->netdev);
+#if CONFIG_NETDEV_WORK_THREAD_POLLING_PERIOD == 0
+  netdev_upper_post(dev->netdev.d_private, queue);
+#endif
+}
+#endif
+
 /****************************************************************************
  * Name: netdev_lower_quota_load
  *
@@ -62,6 +62,16 @@
 #  define pipe_dumpbuffer(m,a,n)
 #endif
 
+/* In SPSC mode the writer owns the head and the reader owns the tail of
+ * d_buffer.  Each side only accesses the index of the other side through
+ * these atomic views.
+ */
+
+#ifdef CONFIG_DEV_PIPE_SPSC
+#  define PIPE_HEAD(d) ((FAR atomic_ulong *)&(d)->d_buffer.head)
+#  define PIPE_TAIL(d) ((FAR atomic_ulong *)&(d)->d_buffer.tail)
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -80,6 +90,654 @@ static void pipecommon_wakeup(FAR sem_t *sem)
     }
 }
 
+#ifdef CONFIG_DEV_PIPE_SPSC
+/****************************************************************************
+ * Name: pipecommon_spsc_enter
+ *
+ * Description:
+ *   Start a lock-free read or write.  Returns false if the pipe is not in
+ *   SPSC mode, the caller then takes the locked path.  PIPEIOC_SPSC does
+ *   not leave the mode while a lock-free read or write is running.
+ *
+ ****************************************************************************/
+
+static bool pipecommon_spsc_enter(FAR struct pipe_dev_s *dev)
+{
+  if (!PIPE_IS_SPSC(dev))
+    {
+      return false;
+    }
+
+  atomic_fetch_add_explicit(&dev->d_nspsc, 1, memory_order_seq_cst);
+  if (PIPE_IS_SPSC(dev))
+    {
+      return true;
+    }
+
+  atomic_fetch_sub_explicit(&dev->d_nspsc, 1, memory_order_seq_cst);
+  return false;
+}
+
+static void pipecommon_spsc_leave(FAR struct pipe_dev_s *dev)
+{
+  atomic_fetch_sub_explicit(&dev->d_nspsc, 1, memory_order_seq_cst);
+}
+
+/****************************************************************************
+ * Name: pipecommon_spsc_notify
+ *
+ * Description:
+ *   Deliver a poll event from the lock-free path.  The d_fds array is
+ *   protected by d_bflock, so the lock is only taken if somebody polls.
+ *
+ ****************************************************************************/
+
+static void pipecommon_spsc_notify(FAR struct pipe_dev_s *dev,
+                                   pollevent_t eventset)
+{
+  if (atomic_load_explicit(&dev->d_npolls, memory_order_seq_cst) == 0 ||
+      nxrmutex_lock(&dev->d_bflock) < 0)
+    {
+      return;
+    }
+
+  if (eventset == POLLIN ?
+      circbuf_used(&dev->d_buffer) > dev->d_pollinthrd :
+      circbuf_used(&dev->d_buffer) <= (dev->d_bufsize - dev->d_polloutthrd))
+    {
+      poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS, eventset);
+    }
+
+  nxrmutex_unlock(&dev->d_bflock);
+}
+
+/****************************************************************************
+ * Name: pipecommon_spsc_read
+ *
+ * Description:
+ *   The lock-free read path.  The writer is only woken up if it waits for
+ *   space, i.e. on the full to non-full transition.
+ *
+ ****************************************************************************/
+
+static ssize_t pipecommon_spsc_read(FAR struct file *filep,
+                                    FAR struct pipe_dev_s *dev,
+                                    FAR char *buffer, size_t len)
+{
+  FAR struct circbuf_s *circ = &dev->d_buffer;
+  size_t tail = circ->tail;
+  size_t head;
+  size_t off;
+  size_t n;
+  int ret;
+
+  for (; ; )
+    {
+      head = atomic_load_explicit(PIPE_HEAD(dev), memory_order_acquire);
+      if (head != tail)
+        {
+          break;
+        }
+
+      /* If there are no writers on the pipe, then return end of file */
+
+      if (dev->d_nwriters <= 0 && PIPE_IS_POLICY_0(dev->d_flags))
+        {
+          return 0;
+        }
+
+      if (filep->f_oflags & O_NONBLOCK)
+        {
+          return -EAGAIN;
+        }
+
+      /* Announce that we are going to sleep and look again, so that a
+       * writer which missed the announcement cannot be missed either.
+       */
+
+      atomic_store_explicit(&dev->d_rdwaiting, true, memory_order_seq_cst);
+      if (atomic_load_explicit(PIPE_HEAD(dev), memory_order_seq_cst) == tail)
+        {
+          ret = nxsem_wait(&dev->d_rdsem);
+        }
+      else
+        {
+          ret = OK;
+        }
+
+      atomic_store_explicit(&dev->d_rdwaiting, false, memory_order_relaxed);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  n   = MIN(head - tail, len);
+  off = tail % circ->size;
+  if (n > circ->size - off)
+    {
+      memcpy(buffer, (FAR char *)circ->base + off, circ->size - off);
+      memcpy(buffer + circ->size - off, circ->base, n - (circ->size - off));
+    }
+  else
+    {
+      memcpy(buffer, (FAR char *)circ->base + off, n);
+    }
+
+  atomic_store_explicit(PIPE_TAIL(dev), tail + n, memory_order_seq_cst);
+
+  if (atomic_exchange_explicit(&dev->d_wrwaiting, false,
+                               memory_order_seq_cst))
+    {
+      pipecommon_wakeup(&dev->d_wrsem);
+    }
+
+  pipecommon_spsc_notify(dev, POLLOUT);
+  return n;
+}
+
+/****************************************************************************
+ * Name: pipecommon_spsc_write
+ *
+ * Description:
+ *   The lock-free write path.  The reader is only woken up if it waits for
+ *   data, i.e. on the empty to non-empty transition.
+ *
+ ****************************************************************************/
+
+static ssize_t pipecommon_spsc_write(FAR struct file *filep,
+                                     FAR struct pipe_dev_s *dev,
+                                     FAR const char *buffer, size_t len)
+{
+  FAR struct circbuf_s *circ = &dev->d_buffer;
+  size_t head = circ->head;
+  size_t nwritten = 0;
+  size_t tail;
+  size_t off;
+  size_t n;
+  int ret;
+
+  for (; ; )
+    {
+      if (dev->d_nreaders <= 0 && PIPE_IS_POLICY_0(dev->d_flags))
+        {
+          return nwritten == 0 ? -EPIPE : (ssize_t)nwritten;
+        }
+
+      tail = atomic_load_explicit(PIPE_TAIL(dev), memory_order_acquire);
+      n    = MIN(circ->size - (head - tail), len - nwritten);
+      if (n > 0)
+        {
+          off = head % circ->size;
+          if (n > circ->size - off)
+            {
+              memcpy((FAR char *)circ->base + off, buffer + nwritten,
+                     circ->size - off);
+              memcpy(circ->base, buffer + nwritten + circ->size - off,
+                     n - (circ->size - off));
+            }
+          else
+            {
+              memcpy((FAR char *)circ->base + off, buffer + nwritten, n);
+            }
+
+          head     += n;
+          nwritten += n;
+          atomic_store_explicit(PIPE_HEAD(dev), head, memory_order_seq_cst);
+
+          if (atomic_exchange_explicit(&dev->d_rdwaiting, false,
+                                       memory_order_seq_cst))
+            {
+              pipecommon_wakeup(&dev->d_rdsem);
+            }
+
+          pipecommon_spsc_notify(dev, POLLIN);
+          if (nwritten == len)
+            {
+              return len;
+            }
+
+          continue;
+        }
+
+      if (filep->f_oflags & O_NONBLOCK)
+        {
+          return nwritten == 0 ? -EAGAIN : (ssize_t)nwritten;
+        }
+
+      /* Announce that we are going to sleep and look again */
+
+      atomic_store_explicit(&dev->d_wrwaiting, true, memory_order_seq_cst);
+      if (atomic_load_explicit(PIPE_TAIL(dev), memory_order_seq_cst) == tail)
+        {
+          ret = nxsem_wait(&dev->d_wrsem);
+        }
+      else
+        {
+          ret = OK;
+        }
+
+      atomic_store_explicit(&dev->d_wrwaiting, false, memory_order_relaxed);
+      if (ret < 0)
+        {
+          return nwritten == 0 ? ret : (ssize_t)nwritten;
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: pipecommon_notify_read
+ *
+ * Description:
+ *   Tell writers and poll waiters that data has been removed from the pipe.
+ *
+ ****************************************************************************/
+
+static void pipecommon_notify_read(FAR struct pipe_dev_s *dev)
+{
+  if (circbuf_used(&dev->d_buffer) <= (dev->d_bufsize - dev->d_polloutthrd))
+    {
+      poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS, POLLOUT);
+    }
+
+  pipecommon_wakeup(&dev->d_wrsem);
+}
+
+/****************************************************************************
+ * Name: pipecommon_notify_write
+ *
+ * Description:
+ *   Tell readers and poll waiters that data has been added to the pipe.
+ *
+ ****************************************************************************/
+
+static void pipecommon_notify_write(FAR struct pipe_dev_s *dev)
+{
+  if (circbuf_used(&dev->d_buffer) > dev->d_pollinthrd)
+    {
+      poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS, POLLIN);
+    }
+
+  pipecommon_wakeup(&dev->d_rdsem);
+}
+
+/****************************************************************************
+ * Name: pipecommon_splice_lock
+ *
+ * Description:
+ *   Lock two pipes.  The locks are always taken in the same (address) order
+ *   so that two concurrent splices in opposite directions cannot deadlock.
+ *
+ ****************************************************************************/
+
+static int pipecommon_splice_lock(FAR struct pipe_dev_s *dev1,
+                                  FAR struct pipe_dev_s *dev2)
+{
+  int ret;
+
+  if (dev1 > dev2)
+    {
+      FAR struct pipe_dev_s *tmp = dev1;
+
+      dev1 = dev2;
+      dev2 = tmp;
+    }
+
+  ret = nxrmutex_lock(&dev1->d_bflock);
+  if (ret >= 0)
+    {
+      ret = nxrmutex_lock(&dev2->d_bflock);
+      if (ret < 0)
+        {
+          nxrmutex_unlock(&dev1->d_bflock);
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pipecommon_splice_pipe
+ *
+ * Description:
+ *   Move (or with 'tee' set, duplicate) data from the pipe 'filep' into the
+ *   pipe 'splice->filep'.  The data is copied directly from one pipe buffer
+ *   into the other.
+ *
+ ****************************************************************************/
+
+static ssize_t pipecommon_splice_pipe(FAR struct file *filep,
+                                      FAR struct pipe_splice_s *splice,
+                                      bool tee)
+{
+  FAR struct pipe_dev_s *src = filep->f_inode->i_private;
+  FAR struct pipe_dev_s *dst = splice->filep->f_inode->i_private;
+  FAR sem_t *sem;
+  FAR void *wrbuffer;
+  ssize_t nspliced = 0;
+  ssize_t ret;
+  size_t size;
+
+  if (!INODE_IS_PIPE(splice->filep->f_inode) || src == dst)
+    {
+      return -EINVAL;
+    }
+  else if (splice->offset != NULL)
+    {
+      return -ESPIPE;
+    }
+
+  /* Wait until there is data in the source pipe and room in the
+   * destination pipe.
+   */
+
+  for (; ; )
+    {
+      ret = pipecommon_splice_lock(src, dst);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      if (PIPE_IS_SPSC(src) || PIPE_IS_SPSC(dst))
+        {
+          ret = -EBUSY;
+          goto out;
+        }
+
+      if (circbuf_is_empty(&src->d_buffer))
+        {
+          if (src->d_nwriters <= 0 && PIPE_IS_POLICY_0(src->d_flags))
+            {
+              ret = 0;
+              goto out;
+            }
+
+          sem = &src->d_rdsem;
+        }
+      else if (!tee && !PIPE_CAN_READ(src->d_flags))
+        {
+          sem = &src->d_rdsem;
+        }
+      else if (dst->d_nreaders <= 0 && PIPE_IS_POLICY_0(dst->d_flags))
+        {
+          ret = -EPIPE;
+          goto out;
+        }
+      else if (circbuf_is_full(&dst->d_buffer) ||
+               !PIPE_CAN_WRITE(dst->d_flags))
+        {
+          sem = &dst->d_wrsem;
+        }
+      else
+        {
+          break;
+        }
+
+      nxrmutex_unlock(&dst->d_bflock);
+      nxrmutex_unlock(&src->d_bflock);
+
+      if ((splice->flags & SPLICE_F_NONBLOCK) != 0 ||
+          ((filep->f_oflags | splice->filep->f_oflags) & O_NONBLOCK) != 0)
+        {
+          return -EAGAIN;
+        }
+
+      ret = nxsem_wait(sem);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  /* Copy straight from the source buffer into the free space of the
+   * destination buffer.
+   */
+
+  while ((size_t)nspliced < splice->len)
+    {
+      wrbuffer = circbuf_get_writeptr(&dst->d_buffer, &size);
+      size     = MIN(size, splice->len - nspliced);
+      if (size == 0)
+        {
+          break;
+        }
+
+      ret = circbuf_peekat(&src->d_buffer, src->d_buffer.tail + nspliced,
+                           wrbuffer, size);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      circbuf_writecommit(&dst->d_buffer, ret);
+      nspliced += ret;
+    }
+
+  if (!tee)
+    {
+      circbuf_readcommit(&src->d_buffer, nspliced);
+      pipecommon_notify_read(src);
+    }
+
+  pipecommon_notify_write(dst);
+  ret = nspliced;
+
+out:
+  nxrmutex_unlock(&dst->d_bflock);
+  nxrmutex_unlock(&src->d_bflock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pipecommon_splice_out
+ *
+ * Description:
+ *   Move data from the pipe to another file.  The other file is written
+ *   directly from the pipe buffer, without holding the lock of the pipe.
+ *   PIPE_FLAG_SPLICEOUT keeps the other readers away from the data until
+ *   the part that was written is removed from the pipe.  Writers only
+ *   append behind it.
+ *
+ ****************************************************************************/
+
+static ssize_t pipecommon_splice_out(FAR struct file *filep,
+                                     FAR struct pipe_splice_s *splice)
+{
+  FAR struct pipe_dev_s *dev = filep->f_inode->i_private;
+  FAR void *rdbuffer;
+  ssize_t ret;
+  size_t size;
+
+  if (INODE_IS_PIPE(splice->filep->f_inode))
+    {
+      return pipecommon_splice_pipe(filep, splice, false);
+    }
+
+  ret = nxrmutex_lock(&dev->d_bflock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Wait for data the same way as pipecommon_read() */
+
+  while (PIPE_IS_SPSC(dev) || circbuf_is_empty(&dev->d_buffer) ||
+         !PIPE_CAN_READ(dev->d_flags))
+    {
+      if (PIPE_IS_SPSC(dev))
+        {
+          nxrmutex_unlock(&dev->d_bflock);
+          return -EBUSY;
+        }
+
+      if (circbuf_is_empty(&dev->d_buffer) &&
+          dev->d_nwriters <= 0 && PIPE_IS_POLICY_0(dev->d_flags))
+        {
+          nxrmutex_unlock(&dev->d_bflock);
+          return 0;
+        }
+
+      if ((splice->flags & SPLICE_F_NONBLOCK) != 0 ||
+          (filep->f_oflags & O_NONBLOCK) != 0)
+        {
+          nxrmutex_unlock(&dev->d_bflock);
+          return -EAGAIN;
+        }
+
+      nxrmutex_unlock(&dev->d_bflock);
+      ret = nxsem_wait(&dev->d_rdsem);
+      if (ret < 0 || (ret = nxrmutex_lock(&dev->d_bflock)) < 0)
+        {
+          return ret;
+        }
+    }
+
+  /* Write the first contiguous region of the buffered data.  A short count
+   * is normal for splice().
+   */
+
+  dev->d_flags |= PIPE_FLAG_SPLICEOUT;
+  rdbuffer = circbuf_get_readptr(&dev->d_buffer, &size);
+  size     = MIN(size, splice->len);
+  nxrmutex_unlock(&dev->d_bflock);
+
+  if (splice->offset != NULL)
+    {
+      ret = file_pwrite(splice->filep, rdbuffer, size, *splice->offset);
+    }
+  else
+    {
+      ret = file_write(splice->filep, rdbuffer, size);
+    }
+
+  /* Take the lock back and remove the data written from the pipe */
+
+  nxrmutex_lock(&dev->d_bflock);
+  if (ret > 0)
+    {
+      circbuf_readcommit(&dev->d_buffer, ret);
+      if (splice->offset != NULL)
+        {
+          *splice->offset += ret;
+        }
+
+      pipecommon_notify_read(dev);
+    }
+  else if (ret == 0)
+    {
+      /* Zero would read as end-of-file to the caller */
+
+      ret = -EAGAIN;
+    }
+
+  dev->d_flags &= ~PIPE_FLAG_SPLICEOUT;
+  pipecommon_wakeup(&dev->d_rdsem);
+  nxrmutex_unlock(&dev->d_bflock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pipecommon_splice_in
+ *
+ * Description:
+ *   Move data from another file into the pipe.  The other file is read
+ *   directly into the free space of the pipe buffer, without holding the
+ *   lock of the pipe.  PIPE_FLAG_SPLICEIN keeps the other writers away from
+ *   the free space until the data read is added to the pipe.  Readers only
+ *   make more room.
+ *
+ ****************************************************************************/
+
+static ssize_t pipecommon_splice_in(FAR struct file *filep,
+                                    FAR struct pipe_splice_s *splice)
+{
+  FAR struct pipe_dev_s *dev = filep->f_inode->i_private;
+  FAR void *wrbuffer;
+  ssize_t ret;
+  size_t size;
+
+  ret = nxrmutex_lock(&dev->d_bflock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Wait for space the same way as pipecommon_write() */
+
+  for (; ; )
+    {
+      if (PIPE_IS_SPSC(dev))
+        {
+          nxrmutex_unlock(&dev->d_bflock);
+          return -EBUSY;
+        }
+
+      if (dev->d_nreaders <= 0 && PIPE_IS_POLICY_0(dev->d_flags))
+        {
+          nxrmutex_unlock(&dev->d_bflock);
+          return -EPIPE;
+        }
+
+      if (!circbuf_is_full(&dev->d_buffer) && PIPE_CAN_WRITE(dev->d_flags))
+        {
+          break;
+        }
+
+      if ((splice->flags & SPLICE_F_NONBLOCK) != 0 ||
+          (filep->f_oflags & O_NONBLOCK) != 0)
+        {
+          nxrmutex_unlock(&dev->d_bflock);
+          return -EAGAIN;
+        }
+
+      nxrmutex_unlock(&dev->d_bflock);
+      ret = nxsem_wait(&dev->d_wrsem);
+      if (ret < 0 || (ret = nxrmutex_lock(&dev->d_bflock)) < 0)
+        {
+          return ret;
+        }
+    }
+
+  /* Read once into the contiguous free space of the pipe buffer.  A short
+   * count is normal for splice() and avoids blocking twice on the source.
+   */
+
+  dev->d_flags |= PIPE_FLAG_SPLICEIN;
+  wrbuffer = circbuf_get_writeptr(&dev->d_buffer, &size);
+  size     = MIN(size, splice->len);
+  nxrmutex_unlock(&dev->d_bflock);
+
+  if (splice->offset != NULL)
+    {
+      ret = file_pread(splice->filep, wrbuffer, size, *splice->offset);
+    }
+  else
+    {
+      ret = file_read(splice->filep, wrbuffer, size);
+    }
+
+  /* Take the lock back and add the data read to the pipe */
+
+  nxrmutex_lock(&dev->d_bflock);
+  if (ret > 0)
+    {
+      circbuf_writecommit(&dev->d_buffer, ret);
+      if (splice->offset != NULL)
+        {
+          *splice->offset += ret;
+        }
+
+      pipecommon_notify_write(dev);
+    }
+
+  dev->d_flags &= ~PIPE_FLAG_SPLICEIN;
+  pipecommon_wakeup(&dev->d_wrsem);
+  nxrmutex_unlock(&dev->d_bflock);
+  return ret;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -385,6 +1043,9 @@ int pipecommon_close(FAR struct file *filep)
 
       dev->d_nwriters = 0;
       dev->d_nreaders = 0;
+#ifdef CONFIG_DEV_PIPE_SPSC
+      atomic_store_explicit(&dev->d_spsc, false, memory_order_seq_cst);
+#endif
 
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
       /* If, in addition, we have been unlinked, then also need to free the
@@ -421,6 +1082,21 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
       return 0;
     }
 
+#ifdef CONFIG_DEV_PIPE_SPSC
+retry:
+  if (pipecommon_spsc_enter(dev))
+    {
+      nread = pipecommon_spsc_read(filep, dev, buffer, len);
+      pipecommon_spsc_leave(dev);
+      if (nread > 0)
+        {
+          pipe_dumpbuffer("From PIPE:", buffer, nread);
+        }
+
+      return nread;
+    }
+#endif
+
   /* Make sure that we have exclusive access to the device structure */
 
   ret = nxrmutex_lock(&dev->d_bflock);
@@ -433,13 +1109,27 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
       return ret;
     }
 
-  /* If the pipe is empty, then wait for something to be written to it */
+  /* If the pipe is empty, then wait for something to be written to it.
+   * Data that a splice() is writing out does not count.
+   */
 
-  while (circbuf_is_empty(&dev->d_buffer))
+  while (PIPE_IS_SPSC(dev) || circbuf_is_empty(&dev->d_buffer) ||
+         !PIPE_CAN_READ(dev->d_flags))
     {
+#ifdef CONFIG_DEV_PIPE_SPSC
+      /* The pipe was switched to SPSC mode while we took the lock */
+
+      if (PIPE_IS_SPSC(dev))
+        {
+          nxrmutex_unlock(&dev->d_bflock);
+          goto retry;
+        }
+#endif
+
       /* If there are no writers on the pipe, then return end of file */
 
-      if (dev->d_nwriters <= 0 && PIPE_IS_POLICY_0(dev->d_flags))
+      if (circbuf_is_empty(&dev->d_buffer) &&
+          dev->d_nwriters <= 0 && PIPE_IS_POLICY_0(dev->d_flags))
         {
           nxrmutex_unlock(&dev->d_bflock);
           return 0;
@@ -532,6 +1222,22 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
 
   DEBUGASSERT(up_interrupt_context() == false);
 
+#ifdef CONFIG_DEV_PIPE_SPSC
+retry:
+  if (pipecommon_spsc_enter(dev))
+    {
+      last = pipecommon_spsc_write(filep, dev, buffer + nwritten,
+                                   len - nwritten);
+      pipecommon_spsc_leave(dev);
+      if (last < 0)
+        {
+          return nwritten == 0 ? last : nwritten;
+        }
+
+      return nwritten + last;
+    }
+#endif
+
   /* Make sure that we have exclusive access to the device structure */
 
   ret = nxrmutex_lock(&dev->d_bflock);
@@ -546,9 +1252,19 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
 
   /* Loop until all of the bytes have been written */
 
-  last = 0;
+  last = nwritten;
   for (; ; )
     {
+#ifdef CONFIG_DEV_PIPE_SPSC
+      /* The pipe was switched to SPSC mode while we took the lock */
+
+      if (PIPE_IS_SPSC(dev))
+        {
+          nxrmutex_unlock(&dev->d_bflock);
+          goto retry;
+        }
+#endif
+
       /* REVISIT:  "If all file descriptors referring to the read end of a
        * pipe have been closed, then a write will cause a SIGPIPE signal to
        * be generated for the calling process.  If the calling process is
@@ -561,9 +1277,11 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
           return nwritten == 0 ? -EPIPE : nwritten;
         }
 
-      /* Would the next write overflow the circular buffer? */
+      /* Would the next write overflow the circular buffer?  The free space
+       * belongs to a splice() that is reading into it.
+       */
 
-      if (!circbuf_is_full(&dev->d_buffer))
+      if (!circbuf_is_full(&dev->d_buffer) && PIPE_CAN_WRITE(dev->d_flags))
         {
           /* Loop until all of the bytes have been written */
 
@@ -690,6 +1408,10 @@ int pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds,
 
               dev->d_fds[i] = fds;
               fds->priv     = &dev->d_fds[i];
+#ifdef CONFIG_DEV_PIPE_SPSC
+              atomic_fetch_add_explicit(&dev->d_npolls, 1,
+                                        memory_order_seq_cst);
+#endif
               break;
             }
         }
@@ -762,6 +1484,9 @@ int pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds,
 
       *slot     = NULL;
       fds->priv = NULL;
+#ifdef CONFIG_DEV_PIPE_SPSC
+      atomic_fetch_sub_explicit(&dev->d_npolls, 1, memory_order_seq_cst);
+#endif
     }
 
 errout:
@@ -788,6 +1513,27 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
     }
 #endif
 
+  /* The splice operations may block and manage the lock themselves */
+
+  switch (cmd)
+    {
+      case PIPEIOC_SPLICEOUT:
+        return pipecommon_splice_out(filep,
+                                     (FAR struct pipe_splice_s *)arg);
+
+      case PIPEIOC_SPLICEIN:
+        return pipecommon_splice_in(filep,
+                                    (FAR struct pipe_splice_s *)arg);
+
+      case PIPEIOC_TEE:
+        return pipecommon_splice_pipe(filep,
+                                      (FAR struct pipe_splice_s *)arg,
+                                      true);
+
+      default:
+        break;
+    }
+
   ret = nxrmutex_lock(&dev->d_bflock);
   if (ret < 0)
     {
@@ -860,6 +1606,17 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
               break;
             }
 
+          /* The lock-free reader and writer, and splice(), access the
+           * buffer unlocked
+           */
+
+          if (PIPE_IS_SPSC(dev) || !PIPE_CAN_READ(dev->d_flags) ||
+              !PIPE_CAN_WRITE(dev->d_flags))
+            {
+              ret = -EBUSY;
+              break;
+            }
+
           size = MIN(size, CONFIG_DEV_PIPE_MAXSIZE);
           ret = circbuf_resize(&dev->d_buffer, size);
           if (ret != 0)
@@ -877,6 +1634,49 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+#ifdef CONFIG_DEV_PIPE_SPSC
+      case PIPEIOC_SPSC:
+        {
+          int rdwaiters;
+          int wrwaiters;
+
+          DEBUGASSERT(sizeof(atomic_ulong) == sizeof(size_t));
+
+          /* A thread asleep on the other path would never be woken up,
+           * and splice() accesses the buffer unlocked.  The threads that
+           * wait for the lock check the mode again once they got it.
+           */
+
+          nxsem_get_value(&dev->d_rdsem, &rdwaiters);
+          nxsem_get_value(&dev->d_wrsem, &wrwaiters);
+          if (rdwaiters < 0 || wrwaiters < 0 ||
+              !PIPE_CAN_READ(dev->d_flags) || !PIPE_CAN_WRITE(dev->d_flags))
+            {
+              ret = -EBUSY;
+              break;
+            }
+
+          atomic_store_explicit(&dev->d_spsc, arg != 0,
+                                memory_order_seq_cst);
+
+          /* A lock-free read or write may have started before the mode
+           * was left; it would not wake up the locked side.
+           */
+
+          if (arg == 0 &&
+              atomic_load_explicit(&dev->d_nspsc, memory_order_seq_cst) > 0)
+            {
+              atomic_store_explicit(&dev->d_spsc, true,
+                                    memory_order_seq_cst);
+              ret = -EBUSY;
+              break;
+            }
+
+          ret = OK;
+        }
+        break;
+#endif
+
       case FIONWRITE:  /* Number of bytes waiting in send queue */
       case FIONREAD:   /* Number of bytes available for reading */
         {
@@ -28,6 +28,9 @@
 #include <nuttx/config.h>
 #include <nuttx/mutex.h>
 #include <nuttx/circbuf.h>
+#ifdef CONFIG_DEV_PIPE_SPSC
+#  include <nuttx/atomic.h>
+#endif
 #include <sys/types.h>
 
 #include <stdint.h>
@@ -85,6 +88,8 @@
 
 #define PIPE_FLAG_POLICY    (1 << 0) /* Bit 0: Policy=Free buffer when empty */
 #define PIPE_FLAG_UNLINKED  (1 << 1) /* Bit 1: The driver has been unlinked */
+#define PIPE_FLAG_SPLICEOUT (1 << 3) /* Bit 3: splice() owns the buffered data */
+#define PIPE_FLAG_SPLICEIN  (1 << 4) /* Bit 4: splice() owns the free space */
 
 #define PIPE_POLICY_0(f)    do { (f) &= ~PIPE_FLAG_POLICY; } while (0)
 #define PIPE_POLICY_1(f)    do { (f) |= PIPE_FLAG_POLICY; } while (0)
@@ -94,6 +99,22 @@
 #define PIPE_UNLINK(f)      do { (f) |= PIPE_FLAG_UNLINKED; } while (0)
 #define PIPE_IS_UNLINKED(f) (((f) & PIPE_FLAG_UNLINKED) != 0)
 
+/* The lock-free readers and writers test the SPSC mode without the lock */
+
+#ifdef CONFIG_DEV_PIPE_SPSC
+#  define PIPE_IS_SPSC(d)   atomic_load_explicit(&(d)->d_spsc, \
+                                                 memory_order_seq_cst)
+#else
+#  define PIPE_IS_SPSC(d)   false
+#endif
+
+/* While a splice() reads from or writes to the other file without the
+ * lock, the pipe readers or writers must keep away from the buffer.
+ */
+
+#define PIPE_CAN_READ(f)    (((f) & PIPE_FLAG_SPLICEOUT) == 0)
+#define PIPE_CAN_WRITE(f)   (((f) & PIPE_FLAG_SPLICEIN) == 0)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -129,6 +150,14 @@ struct pipe_dev_s
   int16_t          d_crefs;       /* References to dev */
   struct circbuf_s d_buffer;      /* Buffer allocated when device opened */
 
+#ifdef CONFIG_DEV_PIPE_SPSC
+  atomic_bool      d_spsc;        /* SPSC: The mode is enabled */
+  atomic_uchar     d_nspsc;       /* SPSC: Lock-free reads and writes running */
+  atomic_bool      d_rdwaiting;   /* SPSC: The reader waits for data */
+  atomic_bool      d_wrwaiting;   /* SPSC: The writer waits for space */
+  atomic_uchar     d_npolls;      /* SPSC: Number of active poll waiters */
+#endif
+
   /* The following is a list if poll structures of threads waiting for
    * driver events. The 'struct pollfd' reference for each open is also
    * retained in the f_priv field of the 'struct file'.
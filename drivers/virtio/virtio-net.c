@@ -27,6 +27,7 @@
 #include <stdint.h>
 #include <string.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/compiler.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/net/ip.h>
@@ -43,6 +44,16 @@
 /* Virtio net feature bits */
 
 #define VIRTIO_NET_F_MAC      5
+#define VIRTIO_NET_F_CTRL_VQ  17
+#define VIRTIO_NET_F_MQ       22
+
+/* Virtio net control commands */
+
+#define VIRTIO_NET_OK                   0
+#define VIRTIO_NET_CTRL_MQ              4
+#define VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET 0
+
+#define VIRTIO_NET_CTRL_TIMEOUT         100000 /* Polls of 10us */
 
 /* Virtio net header size and packet buffer size */
 
@@ -50,11 +61,22 @@
 #define VIRTIO_NET_LLHDRSIZE  (sizeof(struct virtio_net_llhdr_s))
 #define VIRTIO_NET_BUFSIZE    (CONFIG_NET_ETH_PKTSIZE + CONFIG_NET_GUARDSIZE)
 
-/* Virtio net virtqueue index and number */
+/* Virtio net virtqueue index and number.  Queue pair n uses virtqueues
+ * 2n (RX) and 2n + 1 (TX), with multiple pairs the control virtqueue
+ * follows the last pair.
+ */
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+#  define VIRTIO_NET_MAX_QUEUES CONFIG_NETDEV_MAX_QUEUES
+#else
+#  define VIRTIO_NET_MAX_QUEUES 1
+#endif
 
 #define VIRTIO_NET_RX         0
 #define VIRTIO_NET_TX         1
-#define VIRTIO_NET_NUM        2
+#define VIRTIO_NET_RXQ(q)     (2 * (q) + VIRTIO_NET_RX)
+#define VIRTIO_NET_TXQ(q)     (2 * (q) + VIRTIO_NET_TX)
+#define VIRTIO_NET_NUM        (2 * VIRTIO_NET_MAX_QUEUES + 1)
 
 #define VIRTIO_NET_MAX_PKT_SIZE \
     ((CONFIG_NET_LL_GUARDSIZE - ETH_HDRLEN) + VIRTIO_NET_BUFSIZE)
@@ -97,6 +119,16 @@ begin_packed_struct struct virtio_net_config_s
   uint32_t supported_hash_types;
 } end_packed_struct;
 
+/* Virtio net control command, only VIRTIO_NET_CTRL_MQ is used */
+
+begin_packed_struct struct virtio_net_ctrl_s
+{
+  uint8_t  class;
+  uint8_t  cmd;
+  uint16_t pairs;
+  uint8_t  ack;
+} end_packed_struct;
+
 struct virtio_net_priv_s
 {
 #ifdef CONFIG_DRIVERS_WIFI_SIM
@@ -116,6 +148,16 @@ struct virtio_net_priv_s
 
   FAR struct virtio_device *vdev;      /* Virtio device pointer */
   int                       bufnum;    /* TX and RX Buffer number */
+  int                       nqueues;   /* Number of queue pairs in use */
+  int                       nvqs;      /* Number of virtqueues */
+
+  /* RX buffers held by each RX virtqueue */
+
+  int                       rxnum[VIRTIO_NET_MAX_QUEUES];
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  struct virtio_net_ctrl_s  ctrl;      /* Control command buffer */
+#endif
 };
 
 /* Virtio Link Layer Header, follow shows the iob buffer layout:
@@ -152,6 +194,12 @@ static int virtio_net_ifdown(FAR struct netdev_lowerhalf_s *dev);
 static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
                            FAR netpkt_t *pkt);
 static netpkt_t *virtio_net_recv(FAR struct netdev_lowerhalf_s *dev);
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+static int virtio_net_sendq(FAR struct netdev_lowerhalf_s *dev,
+                            FAR netpkt_t *pkt, int queue);
+static netpkt_t *virtio_net_recvq(FAR struct netdev_lowerhalf_s *dev,
+                                  int queue);
+#endif
 #ifdef CONFIG_NET_MCASTGROUP
 static int virtio_net_addmac(FAR struct netdev_lowerhalf_s *dev,
                              FAR const uint8_t *mac);
@@ -163,6 +211,8 @@ static int virtio_net_ioctl(FAR struct netdev_lowerhalf_s *dev,
                             int cmd, unsigned long arg);
 #endif
 static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev);
+static void virtio_net_rxint(FAR struct netdev_lowerhalf_s *dev, int queue,
+                             bool enable);
 
 static int  virtio_net_probe(FAR struct virtio_device *vdev);
 static void virtio_net_remove(FAR struct virtio_device *vdev);
@@ -192,7 +242,12 @@ static const struct netdev_ops_s g_virtio_net_ops =
 #ifdef CONFIG_NETDEV_IOCTL
   virtio_net_ioctl,
 #endif
-  virtio_net_txfree
+  virtio_net_txfree,
+  virtio_net_rxint,
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  virtio_net_sendq,
+  virtio_net_recvq,
+#endif
 };
 
 #ifdef CONFIG_DRIVERS_WIFI_SIM
@@ -264,7 +319,7 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
     }
 
   vrtinfo("Fill vq=%u, hdr=%p, count=%d\n", vq_id, hdr, iov_cnt);
-  if (vq_id == VIRTIO_NET_RX)
+  if (vq_id % 2 == VIRTIO_NET_RX)
     {
       return virtqueue_add_buffer_lock(vq, vb, 0, iov_cnt, hdr,
                                        &priv->lock[vq_id]);
@@ -280,14 +335,20 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
  * Name: virtio_net_rxfill
  ****************************************************************************/
 
-static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev)
+static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev,
+                              int queue)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_RX].vq;
+  int vq_id = VIRTIO_NET_RXQ(queue);
+  FAR struct virtqueue *vq = priv->vdev->vrings_info[vq_id].vq;
   FAR netpkt_t *pkt;
   int i;
 
-  for (i = 0; i < priv->bufnum; i++)
+  /* Every RX virtqueue gets its share of the RX buffers, so that a busy
+   * queue cannot starve the others.
+   */
+
+  for (i = 0; priv->rxnum[queue] < priv->bufnum / priv->nqueues; i++)
     {
       /* IOB Offload, Alloc buffer from RX netpkt */
 
@@ -310,31 +371,33 @@ static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev)
 
       /* Add buffer to RX virtqueue */
 
-      virtio_net_addbuffer(dev, vq, pkt, VIRTIO_NET_RX);
+      virtio_net_addbuffer(dev, vq, pkt, vq_id);
+      priv->rxnum[queue]++;
     }
 
   if (i > 0)
     {
-      virtqueue_kick_lock(vq, &priv->lock[VIRTIO_NET_RX]);
+      virtqueue_kick_lock(vq, &priv->lock[vq_id]);
     }
 }
 
 /****************************************************************************
- * Name: virtio_net_txfree
+ * Name: virtio_net_txfree_queue
  ****************************************************************************/
 
-static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
+static void virtio_net_txfree_queue(FAR struct netdev_lowerhalf_s *dev,
+                                    int queue)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_TX].vq;
+  int vq_id = VIRTIO_NET_TXQ(queue);
+  FAR struct virtqueue *vq = priv->vdev->vrings_info[vq_id].vq;
   FAR struct virtio_net_llhdr_s *hdr;
 
   while (1)
     {
       /* Get buffer from tx virtqueue */
 
-      hdr = virtqueue_get_buffer_lock(vq, NULL, NULL,
-                                      &priv->lock[VIRTIO_NET_TX]);
+      hdr = virtqueue_get_buffer_lock(vq, NULL, NULL, &priv->lock[vq_id]);
       if (hdr == NULL)
         {
           break;
@@ -345,6 +408,21 @@ static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
     }
 }
 
+/****************************************************************************
+ * Name: virtio_net_txfree
+ ****************************************************************************/
+
+static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
+{
+  FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
+  int i;
+
+  for (i = 0; i < priv->nqueues; i++)
+    {
+      virtio_net_txfree_queue(dev, i);
+    }
+}
+
 /****************************************************************************
  * Name: virtio_net_ifup
  ****************************************************************************/
@@ -352,6 +430,7 @@ static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
 static int virtio_net_ifup(FAR struct netdev_lowerhalf_s *dev)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
+  int i;
 
 #ifdef CONFIG_NET_IPv4
   vrtinfo("Bringing up: %u.%u.%u.%u\n",
@@ -368,9 +447,12 @@ static int virtio_net_ifup(FAR struct netdev_lowerhalf_s *dev)
 
   /* Prepare interrupt and packets for receiving */
 
-  virtqueue_enable_cb_lock(priv->vdev->vrings_info[VIRTIO_NET_RX].vq,
-                           &priv->lock[VIRTIO_NET_RX]);
-  virtio_net_rxfill(dev);
+  for (i = 0; i < priv->nqueues; i++)
+    {
+      virtqueue_enable_cb_lock(priv->vdev->vrings_info[VIRTIO_NET_RXQ(i)].vq,
+                               &priv->lock[VIRTIO_NET_RXQ(i)]);
+      virtio_net_rxfill(dev, i);
+    }
 
 #ifdef CONFIG_DRIVERS_WIFI_SIM
   if (priv->lower.wifi == NULL)
@@ -393,7 +475,7 @@ static int virtio_net_ifdown(FAR struct netdev_lowerhalf_s *dev)
 
   /* Disable the Ethernet interrupt */
 
-  for (i = 0; i < VIRTIO_NET_NUM; i++)
+  for (i = 0; i < priv->nvqs; i++)
     {
       virtqueue_disable_cb_lock(priv->vdev->vrings_info[i].vq,
                                 &priv->lock[i]);
@@ -413,14 +495,15 @@ static int virtio_net_ifdown(FAR struct netdev_lowerhalf_s *dev)
 }
 
 /****************************************************************************
- * Name: virtio_net_send
+ * Name: virtio_net_sendq
  ****************************************************************************/
 
-static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
-                           FAR netpkt_t *pkt)
+static int virtio_net_sendq(FAR struct netdev_lowerhalf_s *dev,
+                            FAR netpkt_t *pkt, int queue)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_TX].vq;
+  int vq_id = VIRTIO_NET_TXQ(queue);
+  FAR struct virtqueue *vq = priv->vdev->vrings_info[vq_id].vq;
 
   /* Check the send length */
 
@@ -432,57 +515,64 @@ static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
 
   /* Add buffer to vq and notify the other side */
 
-  virtio_net_addbuffer(dev, vq, pkt, VIRTIO_NET_TX);
-  virtqueue_kick_lock(vq, &priv->lock[VIRTIO_NET_TX]);
+  virtio_net_addbuffer(dev, vq, pkt, vq_id);
+  virtqueue_kick_lock(vq, &priv->lock[vq_id]);
 
   /* Try return Netpkt TX buffer to upper-half. */
 
-  virtio_net_txfree(dev);
+  virtio_net_txfree_queue(dev, queue);
 
   /* If we have no buffer left, enable TX done callback. */
 
   if (netdev_lower_quota_load(dev, NETPKT_TX) <= 0)
     {
-      virtqueue_enable_cb_lock(vq, &priv->lock[VIRTIO_NET_TX]);
+      virtqueue_enable_cb_lock(vq, &priv->lock[vq_id]);
     }
 
   return OK;
 }
 
 /****************************************************************************
- * Name: virtio_net_recv
+ * Name: virtio_net_send
  ****************************************************************************/
 
-static netpkt_t *virtio_net_recv(FAR struct netdev_lowerhalf_s *dev)
+static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
+                           FAR netpkt_t *pkt)
+{
+  return virtio_net_sendq(dev, pkt, 0);
+}
+
+/****************************************************************************
+ * Name: virtio_net_recvq
+ ****************************************************************************/
+
+static netpkt_t *virtio_net_recvq(FAR struct netdev_lowerhalf_s *dev,
+                                  int queue)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_RX].vq;
+  int vq_id = VIRTIO_NET_RXQ(queue);
+  FAR struct virtqueue *vq = priv->vdev->vrings_info[vq_id].vq;
   FAR struct virtio_net_llhdr_s *hdr;
-  irqstate_t flags;
   uint32_t len;
 
   /* Fill the free Netpkt RX buffer to the RX virtqueue */
 
-  virtio_net_rxfill(dev);
+  virtio_net_rxfill(dev, queue);
 
   /* Get received buffer form RX virtqueue */
 
-  flags = spin_lock_irqsave(&priv->lock[VIRTIO_NET_RX]);
-  hdr = virtqueue_get_buffer(vq, &len, NULL);
+  hdr = virtqueue_get_buffer_lock(vq, &len, NULL, &priv->lock[vq_id]);
   if (hdr == NULL)
     {
-      /* If we have no buffer left, enable RX callback. */
-
-      virtqueue_enable_cb(vq);
-      spin_unlock_irqrestore(&priv->lock[VIRTIO_NET_RX], flags);
+      /* The upper half enables the RX callback when we have no buffer
+       * left, see virtio_net_rxint().
+       */
 
       vrtinfo("get NULL buffer\n");
       return NULL;
     }
-  else
-    {
-      spin_unlock_irqrestore(&priv->lock[VIRTIO_NET_RX], flags);
-    }
+
+  priv->rxnum[queue]--;
 
   /* Set the received pkt length */
 
@@ -491,6 +581,15 @@ static netpkt_t *virtio_net_recv(FAR struct netdev_lowerhalf_s *dev)
   return hdr->pkt;
 }
 
+/****************************************************************************
+ * Name: virtio_net_recv
+ ****************************************************************************/
+
+static netpkt_t *virtio_net_recv(FAR struct netdev_lowerhalf_s *dev)
+{
+  return virtio_net_recvq(dev, 0);
+}
+
 #ifdef CONFIG_NET_MCASTGROUP
 /****************************************************************************
  * Name: virtio_net_addmac
@@ -525,6 +624,27 @@ static int virtio_net_ioctl(FAR struct netdev_lowerhalf_s *dev,
 }
 #endif
 
+/****************************************************************************
+ * Name: virtio_net_rxint
+ ****************************************************************************/
+
+static void virtio_net_rxint(FAR struct netdev_lowerhalf_s *dev, int queue,
+                             bool enable)
+{
+  FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
+  int vq_id = VIRTIO_NET_RXQ(queue);
+  FAR struct virtqueue *vq = priv->vdev->vrings_info[vq_id].vq;
+
+  if (enable)
+    {
+      virtqueue_enable_cb_lock(vq, &priv->lock[vq_id]);
+    }
+  else
+    {
+      virtqueue_disable_cb_lock(vq, &priv->lock[vq_id]);
+    }
+}
+
 /****************************************************************************
  * Name: virtio_net_rxready
  ****************************************************************************/
@@ -533,8 +653,19 @@ static void virtio_net_rxready(FAR struct virtqueue *vq)
 {
   FAR struct virtio_net_priv_s *priv = vq->vq_dev->priv;
 
-  virtqueue_disable_cb_lock(vq, &priv->lock[VIRTIO_NET_RX]);
-  netdev_lower_rxready((FAR struct netdev_lowerhalf_s *)priv);
+  /* The upper half masks the callback through virtio_net_rxint() */
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (priv->nqueues > 1)
+    {
+      netdev_lower_rxready_queue((FAR struct netdev_lowerhalf_s *)priv,
+                                 vq->vq_queue_index / 2);
+    }
+  else
+#endif
+    {
+      netdev_lower_rxready((FAR struct netdev_lowerhalf_s *)priv);
+    }
 }
 
 /****************************************************************************
@@ -545,10 +676,77 @@ static void virtio_net_txdone(FAR struct virtqueue *vq)
 {
   FAR struct virtio_net_priv_s *priv = vq->vq_dev->priv;
 
-  virtqueue_disable_cb_lock(vq, &priv->lock[VIRTIO_NET_TX]);
-  netdev_lower_txdone((FAR struct netdev_lowerhalf_s *)priv);
+  virtqueue_disable_cb_lock(vq, &priv->lock[vq->vq_queue_index]);
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (priv->nqueues > 1)
+    {
+      netdev_lower_txdone_queue((FAR struct netdev_lowerhalf_s *)priv,
+                                vq->vq_queue_index / 2);
+    }
+  else
+#endif
+    {
+      netdev_lower_txdone((FAR struct netdev_lowerhalf_s *)priv);
+    }
 }
 
+/****************************************************************************
+ * Name: virtio_net_set_queues
+ *
+ * Description:
+ *   Tell the device how many queue pairs to use, it starts with one.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+static int virtio_net_set_queues(FAR struct virtio_net_priv_s *priv)
+{
+  FAR struct virtqueue *vq = priv->vdev->vrings_info[priv->nvqs - 1].vq;
+  FAR struct virtio_net_ctrl_s *ctrl = &priv->ctrl;
+  struct virtqueue_buf vb[3];
+  int ret;
+  int i;
+
+  ctrl->class = VIRTIO_NET_CTRL_MQ;
+  ctrl->cmd   = VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET;
+  ctrl->pairs = priv->nqueues;
+  ctrl->ack   = ~VIRTIO_NET_OK;
+
+  /* Header, data and status each in their own descriptor */
+
+  vb[0].buf = &ctrl->class;
+  vb[0].len = 2;
+  vb[1].buf = &ctrl->pairs;
+  vb[1].len = sizeof(ctrl->pairs);
+  vb[2].buf = &ctrl->ack;
+  vb[2].len = sizeof(ctrl->ack);
+
+  ret = virtqueue_add_buffer_lock(vq, vb, 2, 1, ctrl,
+                                  &priv->lock[priv->nvqs - 1]);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  virtqueue_kick_lock(vq, &priv->lock[priv->nvqs - 1]);
+
+  /* The control virtqueue has no callback, poll for the answer */
+
+  for (i = 0; i < VIRTIO_NET_CTRL_TIMEOUT; i++)
+    {
+      if (virtqueue_get_buffer_lock(vq, NULL, NULL,
+                                    &priv->lock[priv->nvqs - 1]) != NULL)
+        {
+          return ctrl->ack == VIRTIO_NET_OK ? OK : -EIO;
+        }
+
+      up_udelay(10);
+    }
+
+  return -ETIMEDOUT;
+}
+#endif
+
 /****************************************************************************
  * Name: virtio_net_init
  ****************************************************************************/
@@ -558,25 +756,74 @@ static int virtio_net_init(FAR struct virtio_net_priv_s *priv,
 {
   FAR const char *vqnames[VIRTIO_NET_NUM];
   vq_callback callbacks[VIRTIO_NET_NUM];
+  uint64_t features = (1UL << VIRTIO_NET_F_MAC) |
+                      (1UL << VIRTIO_F_ANY_LAYOUT);
   int ret;
+  int i;
+
+  for (i = 0; i < VIRTIO_NET_NUM; i++)
+    {
+      spin_lock_init(&priv->lock[i]);
+    }
 
-  spin_lock_init(&priv->lock[VIRTIO_NET_RX]);
-  spin_lock_init(&priv->lock[VIRTIO_NET_TX]);
-  priv->vdev = vdev;
-  vdev->priv = priv;
+  priv->vdev    = vdev;
+  priv->nqueues = 1;
+  vdev->priv    = priv;
 
   /* Initialize the virtio device */
 
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER);
-  virtio_negotiate_features(vdev, (1UL << VIRTIO_NET_F_MAC) |
-                                  (1UL << VIRTIO_F_ANY_LAYOUT), NULL);
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  /* Use all the queue pairs of the device if we can have that many,
+   * otherwise fall back to a single pair.
+   */
+
+  virtio_negotiate_features(vdev, features |
+                                  (1UL << VIRTIO_NET_F_CTRL_VQ) |
+                                  (1UL << VIRTIO_NET_F_MQ), NULL);
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_CTRL_VQ) &&
+      virtio_has_feature(vdev, VIRTIO_NET_F_MQ))
+    {
+      uint16_t pairs;
+
+      virtio_read_config_member(vdev, struct virtio_net_config_s,
+                                max_virtqueue_pairs, &pairs);
+      if (pairs > 1 && pairs <= VIRTIO_NET_MAX_QUEUES)
+        {
+          priv->nqueues = pairs;
+        }
+    }
+
+  if (priv->nqueues == 1)
+#endif
+    {
+      virtio_negotiate_features(vdev, features, NULL);
+    }
+
   virtio_set_status(vdev, VIRTIO_CONFIG_FEATURES_OK);
 
-  vqnames[VIRTIO_NET_RX]   = "virtio_net_rx";
-  vqnames[VIRTIO_NET_TX]   = "virtio_net_tx";
-  callbacks[VIRTIO_NET_RX] = virtio_net_rxready;
-  callbacks[VIRTIO_NET_TX] = virtio_net_txdone;
-  ret = virtio_create_virtqueues(vdev, 0, VIRTIO_NET_NUM, vqnames,
+  priv->nvqs = priv->nqueues > 1 ? 2 * priv->nqueues + 1 : 2;
+  for (i = 0; i < priv->nvqs; i++)
+    {
+      if (i == 2 * priv->nqueues)
+        {
+          vqnames[i]   = "virtio_net_ctrl";
+          callbacks[i] = NULL;
+        }
+      else if (i % 2 == VIRTIO_NET_RX)
+        {
+          vqnames[i]   = "virtio_net_rx";
+          callbacks[i] = virtio_net_rxready;
+        }
+      else
+        {
+          vqnames[i]   = "virtio_net_tx";
+          callbacks[i] = virtio_net_txdone;
+        }
+    }
+
+  ret = virtio_create_virtqueues(vdev, 0, priv->nvqs, vqnames,
                                  callbacks, NULL);
   if (ret < 0)
     {
@@ -586,6 +833,19 @@ static int virtio_net_init(FAR struct virtio_net_priv_s *priv,
 
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER_OK);
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (priv->nqueues > 1)
+    {
+      ret = virtio_net_set_queues(priv);
+      if (ret < 0)
+        {
+          vrtwarn("Failed to enable %d queue pairs, ret=%d\n",
+                  priv->nqueues, ret);
+          priv->nqueues = 1;
+        }
+    }
+#endif
+
 #if CONFIG_DRIVERS_VIRTIO_NET_BUFNUM > 0
   priv->bufnum = CONFIG_DRIVERS_VIRTIO_NET_BUFNUM;
 #else
@@ -669,6 +929,9 @@ static int virtio_net_probe(FAR struct virtio_device *vdev)
   netdev->quota[NETPKT_RX] = priv->bufnum;
   netdev->quota[NETPKT_TX] = priv->bufnum;
   netdev->ops = &g_virtio_net_ops;
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  netdev->nqueues = priv->nqueues;
+#endif
 
 #ifdef CONFIG_DRIVERS_WIFI_SIM
   /* If the WiFi interfaces has reached the setting value,
@@ -48,6 +48,24 @@
 #  define CONFIG_FS_NAIOC 8
 #endif
 
+/* The priority of the waiting task is only inherited by the shared low
+ * priority work queue.  A dedicated AIO worker pool runs at its own
+ * priority.
+ */
+
+#if defined(CONFIG_PRIORITY_INHERITANCE) && CONFIG_FS_AIO_NTHREADS == 0
+#  define AIO_PRIORITY_INHERITANCE 1
+#endif
+
+/* States of an AIO container in g_aio_pending.  Only the oldest request on
+ * a file is started;  the others wait for it to complete.
+ */
+
+#define AIOC_IDLE     0            /* Contained but not yet submitted */
+#define AIOC_WAITING  1            /* Waiting for an older request */
+#define AIOC_QUEUED   2            /* In the work queue */
+#define AIOC_RUNNING  3            /* Being performed by a worker */
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -58,14 +76,22 @@
  */
 
 struct file;
+struct inode;
 struct aio_container_s
 {
   dq_entry_t aioc_link;            /* Supports a doubly linked list */
   FAR struct aiocb *aioc_aiocbp;   /* The contained AIO control block */
   FAR struct file *aioc_filep;     /* File structure to use with the I/O */
   struct work_s aioc_work;         /* Used to defer I/O to the work thread */
+  worker_t aioc_worker;            /* Performs the I/O on the work thread */
+
+  /* Next request served by the same read (CONFIG_FS_AIO_MERGESIZE) */
+
+  FAR struct aio_container_s *aioc_merge;
+
   pid_t aioc_pid;                  /* ID of the waiting task */
-#ifdef CONFIG_PRIORITY_INHERITANCE
+  uint8_t aioc_state;              /* See AIOC_* definitions */
+#ifdef AIO_PRIORITY_INHERITANCE
   uint8_t aioc_prio;               /* Priority of the waiting task */
 #endif
 };
@@ -190,7 +216,8 @@ FAR struct aio_container_s *aio_contain(FAR struct aiocb *aiocbp);
  *
  * Description:
  *   Remove the AIO control block from the container and free all resources
- *   used by the container.
+ *   used by the container.  The oldest request waiting on the same file is
+ *   then started.
  *
  * Input Parameters:
  *   aioc - Pointer to the AIO control block container
@@ -206,11 +233,13 @@ FAR struct aiocb *aioc_decant(FAR struct aio_container_s *aioc);
  * Name: aio_queue
  *
  * Description:
- *   Schedule the asynchronous I/O on the low priority work queue
+ *   Schedule the asynchronous I/O on the AIO work queue.  If an older
+ *   request on the same file is still pending, the I/O is deferred until
+ *   that request completes.
  *
  * Input Parameters:
- *   arg - Worker argument.  In this case, a pointer to an instance of
- *     struct aiocb cast to void *.
+ *   aioc   - The AIO control block container
+ *   worker - The function that performs the I/O on the work thread
  *
  * Returned Value:
  *   Zero (OK) on success.  Otherwise, -1 is returned and the errno is set
@@ -220,6 +249,46 @@ FAR struct aiocb *aioc_decant(FAR struct aio_container_s *aioc);
 
 int aio_queue(FAR struct aio_container_s *aioc, worker_t worker);
 
+/****************************************************************************
+ * Name: aio_kick
+ *
+ * Description:
+ *   Start the oldest request on the file if it is waiting.  Called when a
+ *   request leaves g_aio_pending.
+ *
+ * Input Parameters:
+ *   filep - The open file
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The caller holds the AIO lock.
+ *
+ ****************************************************************************/
+
+void aio_kick(FAR struct file *filep);
+
+/****************************************************************************
+ * Name: aio_cancelwork
+ *
+ * Description:
+ *   Cancel a request that has not been started by a worker yet.
+ *
+ * Input Parameters:
+ *   aioc - The AIO control block container
+ *
+ * Returned Value:
+ *   Zero (OK) if the request was canceled; -ENOENT if it is already being
+ *   performed.
+ *
+ * Assumptions:
+ *   The caller holds the AIO lock.
+ *
+ ****************************************************************************/
+
+int aio_cancelwork(FAR struct aio_container_s *aioc);
+
 /****************************************************************************
  * Name: aio_signal
  *
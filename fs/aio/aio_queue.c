@@ -29,40 +29,67 @@
 #include <sched.h>
 #include <aio.h>
 #include <assert.h>
+#include <stdbool.h>
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/fs/fs.h>
 #include <nuttx/wqueue.h>
 
 #include "aio/aio.h"
 
 #ifdef CONFIG_FS_AIO
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#if CONFIG_FS_AIO_NTHREADS > 0
+/* The dedicated AIO worker pool, created on first use */
+
+static FAR struct kwork_wqueue_s *g_aio_wqueue;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: aio_queue
+ * Name: aio_ordered
  *
  * Description:
- *   Schedule the asynchronous I/O on the low priority work queue
+ *   Requests are performed in submission order only on files with a
+ *   position.  A read on a socket, pipe, eventfd or other stream may wait
+ *   for a later write on the same file and must not hold it up.
  *
- * Input Parameters:
- *   arg - Worker argument.  In this case, a pointer to an instance of
- *     struct aiocb cast to void *.
+ ****************************************************************************/
+
+static bool aio_ordered(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+
+  return INODE_IS_MOUNTPT(inode) || INODE_IS_BLOCK(inode) ||
+         INODE_IS_MTD(inode);
+}
+
+/****************************************************************************
+ * Name: aio_start
  *
- * Returned Value:
- *   Zero (OK) on success.  Otherwise, -1 is returned and the errno is set
- *   appropriately.
+ * Description:
+ *   Hand the request to a worker thread.
+ *
+ * Assumptions:
+ *   The caller holds the AIO lock.
  *
  ****************************************************************************/
 
-int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
+static int aio_start(FAR struct aio_container_s *aioc)
 {
   int ret;
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
+  aioc->aioc_state = AIOC_QUEUED;
+
+#ifdef AIO_PRIORITY_INHERITANCE
   /* Prohibit context switches until we complete the queuing */
 
   sched_lock();
@@ -74,28 +101,205 @@ int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
   lpwork_boostpriority(aioc->aioc_prio);
 #endif
 
+#if CONFIG_FS_AIO_NTHREADS > 0
+  if (g_aio_wqueue == NULL)
+    {
+      g_aio_wqueue = work_queue_create("aio", CONFIG_FS_AIO_PRIORITY, NULL,
+                                       CONFIG_FS_AIO_STACKSIZE,
+                                       CONFIG_FS_AIO_NTHREADS);
+    }
+
+  ret = g_aio_wqueue == NULL ? -ENOMEM :
+        work_queue_wq(g_aio_wqueue, &aioc->aioc_work, aioc->aioc_worker,
+                      aioc, 0);
+#else
   /* Schedule the work on the low priority worker thread */
 
-  ret = work_queue(LPWORK, &aioc->aioc_work, worker, aioc, 0);
+  ret = work_queue(LPWORK, &aioc->aioc_work, aioc->aioc_worker, aioc, 0);
+#endif
+
+#ifdef AIO_PRIORITY_INHERITANCE
   if (ret < 0)
     {
-      FAR struct aiocb *aiocbp = aioc->aioc_aiocbp;
-      DEBUGASSERT(aiocbp);
-
-#ifdef CONFIG_PRIORITY_INHERITANCE
       lpwork_restorepriority(aioc->aioc_prio);
-#endif
-      aiocbp->aio_result = ret;
-      set_errno(-ret);
-      ret = ERROR;
     }
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
   /* Now the low-priority work queue might run at its new priority */
 
   sched_unlock();
 #endif
+
   return ret;
 }
 
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aio_queue
+ *
+ * Description:
+ *   Schedule the asynchronous I/O on the AIO work queue.  If an older
+ *   request on the same open file is still pending, the I/O is deferred
+ *   until that request completes.  Requests on streams are never
+ *   deferred.
+ *
+ * Input Parameters:
+ *   aioc   - The AIO control block container
+ *   worker - The function that performs the I/O on the work thread
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  Otherwise, -1 is returned and the errno is set
+ *   appropriately.
+ *
+ ****************************************************************************/
+
+int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
+{
+  FAR struct aio_container_s *older;
+  FAR struct file *filep = aioc->aioc_filep;
+  int ret;
+
+  ret = aio_lock();
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  aioc->aioc_worker = worker;
+  aioc->aioc_state  = AIOC_WAITING;
+
+  /* Containers are appended to g_aio_pending, so any other request on the
+   * same file is older than this one.  This request is started by
+   * aio_kick() when it becomes the oldest.  Ordering is per struct file:
+   * Pseudo files such as sockets share one inode.
+   */
+
+  for (older = (FAR struct aio_container_s *)g_aio_pending.head;
+       older != NULL && older != aioc;
+       older = (FAR struct aio_container_s *)older->aioc_link.flink)
+    {
+      if (older->aioc_filep == filep && aio_ordered(filep))
+        {
+          aio_unlock();
+          return OK;
+        }
+    }
+
+  ret = aio_start(aioc);
+  aio_unlock();
+  if (ret >= 0)
+    {
+      return OK;
+    }
+
+errout:
+  aioc->aioc_aiocbp->aio_result = ret;
+  set_errno(-ret);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: aio_kick
+ *
+ * Description:
+ *   Start the oldest request on the file if it is waiting.  Called when a
+ *   request leaves g_aio_pending.
+ *
+ * Input Parameters:
+ *   filep - The open file
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The caller holds the AIO lock.
+ *
+ ****************************************************************************/
+
+void aio_kick(FAR struct file *filep)
+{
+  FAR struct aio_container_s *aioc;
+  FAR struct aiocb *aiocbp;
+  pid_t pid;
+  int ret;
+
+  for (aioc = (FAR struct aio_container_s *)g_aio_pending.head;
+       aioc != NULL;
+       aioc = (FAR struct aio_container_s *)aioc->aioc_link.flink)
+    {
+      if (aioc->aioc_filep == filep)
+        {
+          break;
+        }
+    }
+
+  if (aioc == NULL || aioc->aioc_state != AIOC_WAITING)
+    {
+      return;
+    }
+
+  ret = aio_start(aioc);
+  if (ret < 0)
+    {
+      /* Complete the request with the error.  That kicks the next one. */
+
+      ferr("ERROR: Failed to start deferred I/O: %d\n", ret);
+
+      pid    = aioc->aioc_pid;
+      aiocbp = aioc_decant(aioc);
+      aiocbp->aio_result = ret;
+      aio_signal(pid, aiocbp);
+    }
+}
+
+/****************************************************************************
+ * Name: aio_cancelwork
+ *
+ * Description:
+ *   Cancel a request that has not been started by a worker yet.
+ *
+ * Input Parameters:
+ *   aioc - The AIO control block container
+ *
+ * Returned Value:
+ *   Zero (OK) if the request was canceled; -ENOENT if it is already being
+ *   performed.
+ *
+ * Assumptions:
+ *   The caller holds the AIO lock.
+ *
+ ****************************************************************************/
+
+int aio_cancelwork(FAR struct aio_container_s *aioc)
+{
+  int ret;
+
+  switch (aioc->aioc_state)
+    {
+      case AIOC_WAITING:
+        return OK;
+
+      case AIOC_QUEUED:
+#if CONFIG_FS_AIO_NTHREADS > 0
+        ret = work_cancel_wq(g_aio_wqueue, &aioc->aioc_work);
+#else
+        ret = work_cancel(LPWORK, &aioc->aioc_work);
+#endif
+
+#ifdef AIO_PRIORITY_INHERITANCE
+        if (ret >= 0)
+          {
+            lpwork_restorepriority(aioc->aioc_prio);
+          }
+#endif
+
+        return ret < 0 ? -ENOENT : OK;
+
+      default:
+        return -ENOENT;
+    }
+}
+
 #endif /* CONFIG_FS_AIO */
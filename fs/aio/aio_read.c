@@ -31,18 +31,119 @@
 #include <aio.h>
 #include <assert.h>
 #include <errno.h>
+#include <string.h>
 #include <debug.h>
 
 #include <nuttx/fs/fs.h>
 
 #include "aio/aio.h"
+#include "fs_heap.h"
 
 #ifdef CONFIG_FS_AIO
 
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void aio_read_worker(FAR void *arg);
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: aio_read_complete
+ *
+ * Description:
+ *   Return the result of a read to the client, release the container and
+ *   signal the client.
+ *
+ ****************************************************************************/
+
+static void aio_read_complete(FAR struct aio_container_s *aioc,
+                              ssize_t nread)
+{
+  FAR struct aiocb *aiocbp = aioc->aioc_aiocbp;
+  pid_t pid = aioc->aioc_pid;
+
+  /* Set the result of the read operation. */
+
+#ifdef CONFIG_DEBUG_FS_ERROR
+  if (nread < 0)
+    {
+      ferr("ERROR: read failed: %d\n", (int)nread);
+    }
+#endif
+
+  aiocbp->aio_result = nread;
+  aioc_decant(aioc);
+
+  /* Signal the client */
+
+  aio_signal(pid, aiocbp);
+}
+
+/****************************************************************************
+ * Name: aio_read_merge
+ *
+ * Description:
+ *   Claim the requests waiting behind aioc that continue its read on the
+ *   same open file.  They are chained to aioc through aioc_merge.
+ *
+ * Returned Value:
+ *   The total number of bytes of aioc and of the claimed requests.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_AIO_MERGESIZE > 0
+static size_t aio_read_merge(FAR struct aio_container_s *aioc)
+{
+  FAR struct aio_container_s *next;
+  FAR struct aio_container_s *tail = aioc;
+  size_t total = aioc->aioc_aiocbp->aio_nbytes;
+
+  aioc->aioc_merge = NULL;
+  if (aio_lock() < 0)
+    {
+      return total;
+    }
+
+  for (next = (FAR struct aio_container_s *)aioc->aioc_link.flink;
+       next != NULL;
+       next = (FAR struct aio_container_s *)next->aioc_link.flink)
+    {
+      FAR struct aiocb *aiocbp = next->aioc_aiocbp;
+
+      if (next->aioc_filep != aioc->aioc_filep)
+        {
+          continue;
+        }
+
+      /* The first other request on the file ends the merge if it does not
+       * continue the read.  Requests on the file must complete in order.
+       */
+
+      if (next->aioc_state != AIOC_WAITING ||
+          next->aioc_worker != aio_read_worker ||
+          aiocbp->aio_offset !=
+          aioc->aioc_aiocbp->aio_offset + (off_t)total ||
+          total + aiocbp->aio_nbytes > CONFIG_FS_AIO_MERGESIZE)
+        {
+          break;
+        }
+
+      next->aioc_state = AIOC_RUNNING;
+      tail->aioc_merge = next;
+      tail             = next;
+      total           += aiocbp->aio_nbytes;
+    }
+
+  tail->aioc_merge = NULL;
+  aio_unlock();
+  return total;
+}
+#endif
+
 /****************************************************************************
  * Name: aio_read_worker
  *
@@ -63,51 +164,107 @@ static void aio_read_worker(FAR void *arg)
 {
   FAR struct aio_container_s *aioc = (FAR struct aio_container_s *)arg;
   FAR struct aiocb *aiocbp;
-  pid_t pid;
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#if CONFIG_FS_AIO_MERGESIZE > 0
+  FAR struct aio_container_s *next;
+  FAR uint8_t *buffer;
+  size_t total;
+#endif
+#ifdef AIO_PRIORITY_INHERITANCE
   uint8_t prio;
 #endif
   ssize_t nread = 0;
 
-  /* Get the information from the container, decant the AIO control block,
-   * and free the container before starting any I/O.  That will minimize
-   * the delays by any other threads waiting for a pre-allocated container.
+  /* The container is only decanted after the I/O:  It holds the reference
+   * to the file and keeps later requests on the same file waiting.
    */
 
   DEBUGASSERT(aioc && aioc->aioc_aiocbp);
-  pid    = aioc->aioc_pid;
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_PRIORITY_INHERITANCE
   prio   = aioc->aioc_prio;
 #endif
-  aiocbp = aioc_decant(aioc);
-
-  /* Perform the file read using:
-   *
-   *   aioc_filep   - File structure pointer
-   *   aio_buf      - Location of buffer
-   *   aio_nbytes   - Length of transfer
-   *   aio_offset   - File offset
-   */
+  aiocbp = aioc->aioc_aiocbp;
 
-  nread = file_pread(aioc->aioc_filep, (FAR void *)aiocbp->aio_buf,
-                     aiocbp->aio_nbytes, aiocbp->aio_offset);
+#if CONFIG_FS_AIO_MERGESIZE > 0
+  /* Serve adjacent reads waiting on the same file with a single read into
+   * a bounce buffer.
+   */
 
-  /* Set the result of the read operation. */
+  total  = aio_read_merge(aioc);
+  buffer = NULL;
 
-#ifdef CONFIG_DEBUG_FS_ERROR
-  if (nread < 0)
+  if (aioc->aioc_merge != NULL)
     {
-      ferr("ERROR: read failed: %d\n", (int)nread);
+      buffer = fs_heap_malloc(total);
+      if (buffer == NULL)
+        {
+          /* Leave the claimed requests to their own workers */
+
+          aio_lock();
+          for (next = aioc->aioc_merge; next; next = next->aioc_merge)
+            {
+              next->aioc_state = AIOC_WAITING;
+            }
+
+          aioc->aioc_merge = NULL;
+          aio_unlock();
+        }
     }
-#endif
 
-  aiocbp->aio_result = nread;
+  if (buffer != NULL)
+    {
+      FAR struct aio_container_s *curr = aioc;
+      size_t offset = 0;
 
-  /* Signal the client */
+      nread = file_pread(aioc->aioc_filep, buffer, total,
+                         aiocbp->aio_offset);
 
-  aio_signal(pid, aiocbp);
+      /* Hand out the data in order.  A failed read fails all requests */
+
+      do
+        {
+          ssize_t result = nread;
+          size_t nbytes;
+
+          next   = curr->aioc_merge;
+          aiocbp = curr->aioc_aiocbp;
+
+          if (nread >= 0)
+            {
+              nbytes = (size_t)nread > offset ? (size_t)nread - offset : 0;
+              if (nbytes > aiocbp->aio_nbytes)
+                {
+                  nbytes = aiocbp->aio_nbytes;
+                }
+
+              memcpy((FAR void *)aiocbp->aio_buf, buffer + offset, nbytes);
+              offset += aiocbp->aio_nbytes;
+              result  = nbytes;
+            }
+
+          aio_read_complete(curr, result);
+          curr = next;
+        }
+      while (curr != NULL);
+
+      fs_heap_free(buffer);
+    }
+  else
+#endif
+    {
+      /* Perform the file read using:
+       *
+       *   aioc_filep   - File structure pointer
+       *   aio_buf      - Location of buffer
+       *   aio_nbytes   - Length of transfer
+       *   aio_offset   - File offset
+       */
+
+      nread = file_pread(aioc->aioc_filep, (FAR void *)aiocbp->aio_buf,
+                         aiocbp->aio_nbytes, aiocbp->aio_offset);
+      aio_read_complete(aioc, nread);
+    }
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_PRIORITY_INHERITANCE
   /* Restore the low priority worker thread default priority */
 
   lpwork_restorepriority(prio);
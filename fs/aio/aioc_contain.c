@@ -63,7 +63,7 @@ FAR struct aio_container_s *aio_contain(FAR struct aiocb *aiocbp)
   FAR struct aio_container_s *aioc;
   FAR struct file *filep;
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_PRIORITY_INHERITANCE
   struct sched_param param;
 #endif
   int ret;
@@ -95,7 +95,7 @@ FAR struct aio_container_s *aio_contain(FAR struct aiocb *aiocbp)
   aioc->aioc_filep  = filep;
   aioc->aioc_pid    = nxsched_getpid();
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_PRIORITY_INHERITANCE
   DEBUGVERIFY(nxsched_get_param(aioc->aioc_pid, &param));
   aioc->aioc_prio   = param.sched_priority;
 #endif
@@ -150,6 +150,12 @@ FAR struct aiocb *aioc_decant(FAR struct aio_container_s *aioc)
     {
       dq_rem(&aioc->aioc_link, &g_aio_pending);
 
+      /* Start the next request on the same file while the file is still
+       * referenced.
+       */
+
+      aio_kick(aioc->aioc_filep);
+
       /* De-cant the AIO control block and return the container to the
        * free list.
        */
@@ -157,7 +163,6 @@ FAR struct aiocb *aioc_decant(FAR struct aio_container_s *aioc)
       aiocbp = aioc->aioc_aiocbp;
       fs_putfilep(aioc->aioc_filep);
       aioc_free(aioc);
-
       aio_unlock();
     }
 
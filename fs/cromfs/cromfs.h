@@ -30,6 +30,22 @@
 #include <sys/types.h>
 #include <stdint.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Node flags (cn_flags).  Images made by older versions of gencromfs have
+ * no flags set.
+ */
+
+#define CROMFS_NODE_BLKINDEX (1 << 0) /* The blocks of the file are indexed */
+
+/* Type of the data blocks compressed with LZ4 (gencromfs -z lz4).  They
+ * use the layout of struct lzf_type1_header_s.
+ */
+
+#define CROMFS_LZ4_HDR       2
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -102,16 +118,21 @@ struct cromfs_volume_s
  *                Return 0
  *   st_ctime   - Time of last status change
  *                Return 0
+ *
+ * The data blocks of a file follow its name.  All but the last one hold
+ * cv_bsize bytes of uncompressed data.  If CROMFS_NODE_BLKINDEX is set, the
+ * first block is immediately preceded by an index: an array of
+ * (cn_size + cv_bsize - 1) / cv_bsize uint32_t offsets to the blocks.
  */
 
 begin_packed_struct struct cromfs_node_s
 {
-  uint16_t cn_mode; /* File type, attributes, and access mode bits */
-  uint16_t cn_pad;  /* Not used */
-  uint32_t cn_name; /* Offset from the beginning of the volume header to the
-                     * node name string.  NUL-terminated. */
-  uint32_t cn_size; /* Size of the uncompressed data (in bytes) */
-  uint32_t cn_peer; /* Offset to next node in this directory (for readdir()) */
+  uint16_t cn_mode;  /* File type, attributes, and access mode bits */
+  uint16_t cn_flags; /* CROMFS_NODE_* flags */
+  uint32_t cn_name;  /* Offset from the beginning of the volume header to the
+                      * node name string.  NUL-terminated. */
+  uint32_t cn_size;  /* Size of the uncompressed data (in bytes) */
+  uint32_t cn_peer;  /* Offset to next node in this directory (for readdir()) */
   union
   {
     uint32_t cn_child;  /* Offset to first node in sub-directory (directories only) */
@@ -43,6 +43,7 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/mutex.h>
 
 #include "cromfs.h"
 #include "fs_heap.h"
@@ -55,6 +56,10 @@
 
 #define CROMFS_MAX_LINKS 64
 
+#ifndef CONFIG_FS_CROMFS_CACHE_NBLOCKS
+#  define CONFIG_FS_CROMFS_CACHE_NBLOCKS 0
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -71,11 +76,36 @@ struct cromfs_dir_s
 struct cromfs_file_s
 {
   FAR const struct cromfs_node_s *ff_node;  /* The open file node */
+  FAR const struct lzf_header_s *ff_blkhdr; /* Last block accessed (or NULL) */
+  uint32_t ff_blkpos;                       /* File position of that block */
+#if CONFIG_FS_CROMFS_CACHE_NBLOCKS == 0
   uint32_t ff_offset;                       /* Cached block offset (zero means none) */
   uint16_t ff_ulen;                         /* Length of decompressed data in cache */
   FAR uint8_t *ff_buffer;                   /* Cached, decompressed data */
+#endif
+};
+
+#if CONFIG_FS_CROMFS_CACHE_NBLOCKS > 0
+/* The block cache is shared by all open files.  Each entry holds one
+ * decompressed block of cv_bsize bytes.
+ */
+
+struct cromfs_cacheblk_s
+{
+  uint32_t cb_offset;                       /* Block offset (zero means none) */
+  uint32_t cb_used;                         /* cc_clock at the last access */
 };
 
+struct cromfs_cache_s
+{
+  mutex_t cc_lock;                          /* Protects the cache */
+  unsigned int cc_refs;                     /* Number of mounts */
+  uint32_t cc_clock;                        /* Incremented on each access */
+  FAR uint8_t *cc_buffer;                   /* Decompressed data */
+  struct cromfs_cacheblk_s cc_blocks[CONFIG_FS_CROMFS_CACHE_NBLOCKS];
+};
+#endif
+
 /* This is the form of the callback from cromfs_foreach_node(): */
 
 typedef CODE int (*cromfs_foreach_t)(FAR const struct cromfs_volume_s *fs,
@@ -137,6 +167,24 @@ static int      cromfs_find_node(FAR const struct cromfs_volume_s *fs,
                                  FAR const char *relpath,
                                  FAR struct cromfs_nodeinfo_s *info,
                                  FAR uint32_t *offset);
+static uint32_t cromfs_block_size(FAR const struct lzf_header_s *hdr,
+                                  FAR uint16_t *ulen,
+                                  FAR uint16_t *clen);
+static FAR const struct lzf_header_s *
+cromfs_find_block(FAR const struct cromfs_volume_s *fs,
+                  FAR struct cromfs_file_s *ff, uint32_t fpos);
+#ifdef CONFIG_FS_CROMFS_LZ4
+static int      cromfs_lz4_decompress(FAR const uint8_t *src, uint16_t clen,
+                                      FAR uint8_t *dest, uint16_t ulen);
+#endif
+static int      cromfs_decompress(uint8_t type, FAR const uint8_t *src,
+                                  uint16_t clen, FAR uint8_t *dest,
+                                  uint16_t ulen);
+static ssize_t  cromfs_read_block(FAR const struct cromfs_volume_s *fs,
+                                  FAR struct cromfs_file_s *ff,
+                                  FAR const struct lzf_header_s *hdr,
+                                  uint32_t copyoffs, FAR uint8_t *dest,
+                                  size_t remaining);
 
 /* Common file system methods */
 
@@ -228,6 +276,17 @@ const struct mountpt_operations g_cromfs_operations =
 
 extern const struct cromfs_volume_s g_cromfs_image;
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#if CONFIG_FS_CROMFS_CACHE_NBLOCKS > 0
+static struct cromfs_cache_s g_cromfs_cache =
+{
+  NXMUTEX_INITIALIZER
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -351,7 +410,7 @@ static int cromfs_follow_link(FAR const struct cromfs_volume_s *fs,
            */
 
           newnode->cn_mode    = S_IFDIR | (node->cn_mode & ~S_IFMT);
-          newnode->cn_pad     = 0;
+          newnode->cn_flags   = 0;
           newnode->cn_name    = node->cn_name;
           newnode->cn_size    = 0;
           newnode->cn_peer    = node->cn_peer;
@@ -368,13 +427,13 @@ static int cromfs_follow_link(FAR const struct cromfs_volume_s *fs,
       /* Copy the origin node file name into the writable node copy */
 
       newnode->cn_name   = node->cn_name;
-      newnode->cn_pad    = 0;
 
       /* Copy all attributes of the target node, but retain the hard link
        * file name and, possibly, the peer node reference.
        */
 
       newnode->cn_mode   = linknode->cn_mode;
+      newnode->cn_flags  = linknode->cn_flags;
       newnode->cn_size   = linknode->cn_size;
       newnode->u.cn_link = linknode->u.cn_link;
 
@@ -726,6 +785,402 @@ static int cromfs_find_node(FAR const struct cromfs_volume_s *fs,
     }
 }
 
+/****************************************************************************
+ * Name: cromfs_block_size
+ *
+ * Description:
+ *   Return the size of a data block in the image, header included, and
+ *   the uncompressed and compressed lengths of its data.
+ *
+ ****************************************************************************/
+
+static uint32_t cromfs_block_size(FAR const struct lzf_header_s *hdr,
+                                  FAR uint16_t *ulen,
+                                  FAR uint16_t *clen)
+{
+  if (hdr->lzf_type == LZF_TYPE0_HDR)
+    {
+      FAR const struct lzf_type0_header_s *hdr0 =
+        (FAR const struct lzf_type0_header_s *)hdr;
+
+      *ulen = (uint16_t)hdr0->lzf_len[0] << 8 |
+              (uint16_t)hdr0->lzf_len[1];
+      *clen = *ulen;
+      return (uint32_t)*clen + LZF_TYPE0_HDR_SIZE;
+    }
+  else
+    {
+      FAR const struct lzf_type1_header_s *hdr1 =
+        (FAR const struct lzf_type1_header_s *)hdr;
+
+      *ulen = (uint16_t)hdr1->lzf_ulen[0] << 8 |
+              (uint16_t)hdr1->lzf_ulen[1];
+      *clen = (uint16_t)hdr1->lzf_clen[0] << 8 |
+              (uint16_t)hdr1->lzf_clen[1];
+      return (uint32_t)*clen + LZF_TYPE1_HDR_SIZE;
+    }
+}
+
+/****************************************************************************
+ * Name: cromfs_find_block
+ *
+ * Description:
+ *   Find the data block containing the file position fpos.  If the image
+ *   has a block index, the block is looked up directly.  Otherwise the
+ *   block list is walked, starting from the last block accessed if fpos
+ *   lies at or after it, so that sequential reads do not rescan the file.
+ *
+ ****************************************************************************/
+
+static FAR const struct lzf_header_s *
+cromfs_find_block(FAR const struct cromfs_volume_s *fs,
+                  FAR struct cromfs_file_s *ff, uint32_t fpos)
+{
+  FAR const struct cromfs_node_s *node = ff->ff_node;
+  FAR const struct lzf_header_s *hdr;
+  uint32_t blkpos;
+  uint16_t ulen;
+  uint16_t clen;
+
+  if ((node->cn_flags & CROMFS_NODE_BLKINDEX) != 0)
+    {
+      FAR const uint8_t *index;
+      uint32_t nblocks;
+      uint32_t blkno;
+      uint32_t offset;
+
+      /* The index lies just before the first block and may not be
+       * aligned.
+       */
+
+      nblocks = (node->cn_size + fs->cv_bsize - 1) / fs->cv_bsize;
+      blkno   = fpos / fs->cv_bsize;
+      DEBUGASSERT(blkno < nblocks);
+
+      index   = (FAR const uint8_t *)fs + node->u.cn_blocks -
+                nblocks * sizeof(uint32_t);
+      memcpy(&offset, &index[blkno * sizeof(uint32_t)], sizeof(uint32_t));
+
+      hdr     = (FAR const struct lzf_header_s *)
+                cromfs_offset2addr(fs, offset);
+      blkpos  = blkno * fs->cv_bsize;
+    }
+  else
+    {
+      if (ff->ff_blkhdr != NULL && fpos >= ff->ff_blkpos)
+        {
+          hdr    = ff->ff_blkhdr;
+          blkpos = ff->ff_blkpos;
+        }
+      else
+        {
+          hdr    = (FAR const struct lzf_header_s *)
+                   cromfs_offset2addr(fs, node->u.cn_blocks);
+          blkpos = 0;
+        }
+
+      for (; ; )
+        {
+          uint32_t blksize = cromfs_block_size(hdr, &ulen, &clen);
+
+          if (fpos < blkpos + ulen)
+            {
+              break;
+            }
+
+          blkpos += ulen;
+          hdr     = (FAR const struct lzf_header_s *)
+                    ((FAR const uint8_t *)hdr + blksize);
+        }
+    }
+
+  ff->ff_blkhdr = hdr;
+  ff->ff_blkpos = blkpos;
+  return hdr;
+}
+
+#ifdef CONFIG_FS_CROMFS_LZ4
+/****************************************************************************
+ * Name: cromfs_lz4_decompress
+ *
+ * Description:
+ *   Decompress one LZ4 block.  The data must decompress to exactly ulen
+ *   bytes.
+ *
+ ****************************************************************************/
+
+static int cromfs_lz4_decompress(FAR const uint8_t *src, uint16_t clen,
+                                 FAR uint8_t *dest, uint16_t ulen)
+{
+  FAR const uint8_t *srcend = src + clen;
+  FAR uint8_t *destend = dest + ulen;
+  FAR uint8_t *outptr = dest;
+  FAR const uint8_t *ref;
+  size_t offset;
+  size_t len;
+  uint8_t token;
+  uint8_t byte;
+
+  while (src < srcend)
+    {
+      /* Each sequence starts with a literal run */
+
+      token = *src++;
+      len   = token >> 4;
+      if (len == 15)
+        {
+          do
+            {
+              if (src >= srcend)
+                {
+                  return -EIO;
+                }
+
+              byte = *src++;
+              len += byte;
+            }
+          while (byte == 255);
+        }
+
+      if (len > (size_t)(srcend - src) || len > (size_t)(destend - outptr))
+        {
+          return -EIO;
+        }
+
+      memcpy(outptr, src, len);
+      outptr += len;
+      src    += len;
+
+      /* The last sequence has no match */
+
+      if (src >= srcend)
+        {
+          break;
+        }
+
+      if (srcend - src < 2)
+        {
+          return -EIO;
+        }
+
+      offset = (size_t)src[0] | (size_t)src[1] << 8;
+      src   += 2;
+      if (offset == 0 || offset > (size_t)(outptr - dest))
+        {
+          return -EIO;
+        }
+
+      len = (token & 15) + 4;
+      if ((token & 15) == 15)
+        {
+          do
+            {
+              if (src >= srcend)
+                {
+                  return -EIO;
+                }
+
+              byte = *src++;
+              len += byte;
+            }
+          while (byte == 255);
+        }
+
+      if (len > (size_t)(destend - outptr))
+        {
+          return -EIO;
+        }
+
+      /* The match may overlap the data it produces */
+
+      ref = outptr - offset;
+      if (offset >= len)
+        {
+          memcpy(outptr, ref, len);
+          outptr += len;
+        }
+      else
+        {
+          while (len-- > 0)
+            {
+              *outptr++ = *ref++;
+            }
+        }
+    }
+
+  return outptr == destend ? OK : -EIO;
+}
+#endif
+
+/****************************************************************************
+ * Name: cromfs_decompress
+ *
+ * Description:
+ *   Decompress one data block of the given type into dest.
+ *
+ ****************************************************************************/
+
+static int cromfs_decompress(uint8_t type, FAR const uint8_t *src,
+                             uint16_t clen, FAR uint8_t *dest,
+                             uint16_t ulen)
+{
+#ifdef CONFIG_FS_CROMFS_LZ4
+  if (type == CROMFS_LZ4_HDR)
+    {
+      return cromfs_lz4_decompress(src, clen, dest, ulen);
+    }
+#endif
+
+  if (type != LZF_TYPE1_HDR)
+    {
+      ferr("ERROR: Unsupported block type %u\n", type);
+      return -EIO;
+    }
+
+  return lzf_decompress(src, clen, dest, ulen) == ulen ? OK : -EIO;
+}
+
+/****************************************************************************
+ * Name: cromfs_read_block
+ *
+ * Description:
+ *   Copy data from one block, starting copyoffs bytes into the block, to
+ *   the user buffer.  Returns the number of bytes copied or a negated
+ *   errno value.
+ *
+ ****************************************************************************/
+
+static ssize_t cromfs_read_block(FAR const struct cromfs_volume_s *fs,
+                                 FAR struct cromfs_file_s *ff,
+                                 FAR const struct lzf_header_s *hdr,
+                                 uint32_t copyoffs, FAR uint8_t *dest,
+                                 size_t remaining)
+{
+#if CONFIG_FS_CROMFS_CACHE_NBLOCKS > 0
+  FAR struct cromfs_cache_s *cache = &g_cromfs_cache;
+  FAR struct cromfs_cacheblk_s *blk;
+  unsigned int victim;
+  unsigned int i;
+#endif
+  FAR const uint8_t *src;
+  uint32_t voloffs;
+  size_t copysize;
+  uint16_t ulen;
+  uint16_t clen;
+  int ret;
+
+  cromfs_block_size(hdr, &ulen, &clen);
+  if (ulen > fs->cv_bsize || copyoffs >= ulen)
+    {
+      return -EIO;
+    }
+
+  copysize = ulen - copyoffs;
+  if (copysize > remaining)
+    {
+      /* Clip to the size really needed */
+
+      copysize = remaining;
+    }
+
+  if (hdr->lzf_type == LZF_TYPE0_HDR)
+    {
+      /* Just copy the uncompressed data from image to the user buffer */
+
+      src = (FAR const uint8_t *)hdr + LZF_TYPE0_HDR_SIZE;
+      memcpy(dest, &src[copyoffs], copysize);
+      return copysize;
+    }
+
+  src     = (FAR const uint8_t *)hdr + LZF_TYPE1_HDR_SIZE;
+  voloffs = cromfs_addr2offset(fs, src);
+
+  finfo("voloffs=%" PRIu32 " ulen=%" PRIu16 " clen=%" PRIu16
+        " copyoffs=%" PRIu32 " copysize=%zu\n",
+        voloffs, ulen, clen, copyoffs, copysize);
+
+#if CONFIG_FS_CROMFS_CACHE_NBLOCKS > 0
+  ret = nxmutex_lock(&cache->cc_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Look the block up, keeping track of the least recently used entry.
+   * Unused entries have never been accessed and are taken first.
+   */
+
+  victim = 0;
+  for (i = 0; i < CONFIG_FS_CROMFS_CACHE_NBLOCKS; i++)
+    {
+      blk = &cache->cc_blocks[i];
+      if (blk->cb_offset == voloffs)
+        {
+          break;
+        }
+
+      if (blk->cb_used < cache->cc_blocks[victim].cb_used)
+        {
+          victim = i;
+        }
+    }
+
+  if (i >= CONFIG_FS_CROMFS_CACHE_NBLOCKS)
+    {
+      /* Not cached.  Replace the least recently used block. */
+
+      i   = victim;
+      blk = &cache->cc_blocks[i];
+      ret = cromfs_decompress(hdr->lzf_type, src, clen,
+                              &cache->cc_buffer[i * fs->cv_bsize], ulen);
+      if (ret < 0)
+        {
+          blk->cb_offset = 0;
+          blk->cb_used   = 0;
+          nxmutex_unlock(&cache->cc_lock);
+          return ret;
+        }
+
+      blk->cb_offset = voloffs;
+    }
+
+  blk->cb_used = ++cache->cc_clock;
+  memcpy(dest, &cache->cc_buffer[i * fs->cv_bsize + copyoffs], copysize);
+  nxmutex_unlock(&cache->cc_lock);
+#else
+  if (voloffs != ff->ff_offset)
+    {
+      /* If the whole block is wanted, decompress it directly into the user
+       * buffer.
+       */
+
+      if (copysize == ulen)
+        {
+          ret = cromfs_decompress(hdr->lzf_type, src, clen, dest, ulen);
+          return ret < 0 ? ret : copysize;
+        }
+
+      /* Otherwise decompress into the intermediate buffer */
+
+      ret = cromfs_decompress(hdr->lzf_type, src, clen, ff->ff_buffer,
+                              ulen);
+      if (ret < 0)
+        {
+          ff->ff_offset = 0;
+          return ret;
+        }
+
+      ff->ff_offset = voloffs;
+      ff->ff_ulen   = ulen;
+    }
+
+  DEBUGASSERT(ff->ff_ulen >= copyoffs + copysize);
+  memcpy(dest, &ff->ff_buffer[copyoffs], copysize);
+#endif
+
+  return copysize;
+}
+
 /****************************************************************************
  * Name: cromfs_open
  ****************************************************************************/
@@ -794,6 +1249,7 @@ static int cromfs_open(FAR struct file *filep, FAR const char *relpath,
       return -ENOMEM;
     }
 
+#if CONFIG_FS_CROMFS_CACHE_NBLOCKS == 0
   /* Create a file buffer to support partial sector accesses */
 
   ff->ff_buffer = fs_heap_malloc(fs->cv_bsize);
@@ -802,6 +1258,7 @@ static int cromfs_open(FAR struct file *filep, FAR const char *relpath,
       fs_heap_free(ff);
       return -ENOMEM;
     }
+#endif
 
   /* Save the node in the open file instance */
 
@@ -828,11 +1285,13 @@ static int cromfs_close(FAR struct file *filep)
   /* Get the open file instance from the file structure */
 
   ff = filep->f_priv;
-  DEBUGASSERT(ff->ff_node != NULL && ff->ff_buffer != NULL);
+  DEBUGASSERT(ff->ff_node != NULL);
 
   /* Free all resources consumed by the opened file */
 
+#if CONFIG_FS_CROMFS_CACHE_NBLOCKS == 0
   fs_heap_free(ff->ff_buffer);
+#endif
   fs_heap_free(ff);
 
   return OK;
@@ -848,17 +1307,11 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
   FAR struct inode *inode;
   FAR const struct cromfs_volume_s *fs;
   FAR struct cromfs_file_s *ff;
-  FAR struct lzf_header_s *currhdr;
-  FAR struct lzf_header_s *nexthdr;
+  FAR const struct lzf_header_s *hdr;
   FAR uint8_t *dest;
-  FAR const uint8_t *src;
   off_t fpos;
   size_t remaining;
-  uint32_t blkoffs;
-  uint16_t ulen;
-  uint16_t clen;
-  unsigned int copysize;
-  unsigned int copyoffs;
+  ssize_t nread;
 
   finfo("Read %zu bytes from offset %jd\n", buflen, (intmax_t)filep->f_pos);
   DEBUGASSERT(filep->f_priv != NULL);
@@ -874,7 +1327,7 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
   /* Get the open file instance from the file structure */
 
   ff = (FAR struct cromfs_file_s *)filep->f_priv;
-  DEBUGASSERT(ff->ff_node != NULL && ff->ff_buffer != NULL);
+  DEBUGASSERT(ff->ff_node != NULL);
 
   /* Check for a read past the end of the file */
 
@@ -895,185 +1348,43 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
       buflen = ff->ff_node->cn_size - filep->f_pos;
     }
 
-  /* Find the compressed block containing the current offset, f_pos */
-
   dest      = (FAR uint8_t *)buffer;
   remaining = buflen;
   fpos      = filep->f_pos;
-  blkoffs   = 0;
-  ulen      = 0;
-  nexthdr   = (FAR struct lzf_header_s *)
-               cromfs_offset2addr(fs, ff->ff_node->u.cn_blocks);
-
-  /* Look until we find the compressed block containing the start of the
-   * requested data.
-   */
 
   while (remaining > 0)
     {
-      /* Search for the next block containing the fpos file offset.  This is
-       * real search on the first time through but the remaining blocks
-       * should be contiguous so that the logic should not loop.
-       *
-       */
-
-      do
-        {
-          uint32_t blksize;
-
-          /* Go to the next block */
-
-          currhdr  = nexthdr;
-          blkoffs += ulen;
+      /* Find the block containing the fpos file offset and copy from it */
 
-          if (currhdr->lzf_type == LZF_TYPE0_HDR)
-            {
-              FAR struct lzf_type0_header_s *hdr0 =
-                (FAR struct lzf_type0_header_s *)currhdr;
-
-              ulen    = (uint16_t)hdr0->lzf_len[0] << 8 |
-                        (uint16_t)hdr0->lzf_len[1];
-              blksize = (uint32_t)ulen + LZF_TYPE0_HDR_SIZE;
-            }
-          else
-            {
-              FAR struct lzf_type1_header_s * hdr1 =
-                (FAR struct lzf_type1_header_s *)currhdr;
-
-              ulen    = (uint16_t)hdr1->lzf_ulen[0] << 8 |
-                        (uint16_t)hdr1->lzf_ulen[1];
-              clen    = (uint16_t)hdr1->lzf_clen[0] << 8 |
-                        (uint16_t)hdr1->lzf_clen[1];
-              blksize = (uint32_t)clen + LZF_TYPE1_HDR_SIZE;
-            }
-
-          nexthdr  = (FAR struct lzf_header_s *)
-                     ((FAR uint8_t *)currhdr + blksize);
-        }
-      while (fpos >= (blkoffs + ulen));
-
-      /* Check if we need to decompress the next block into the user
-       * buffer.
-       */
-
-      if (currhdr->lzf_type == LZF_TYPE0_HDR)
+      hdr   = cromfs_find_block(fs, ff, fpos);
+      nread = cromfs_read_block(fs, ff, hdr, fpos - ff->ff_blkpos, dest,
+                                remaining);
+      if (nread < 0)
         {
-          /* Just copy the uncompressed data copy data from image to the
-           * user buffer.
-           */
+          ferr("ERROR: Bad data block at offset %jd: %zd\n",
+               (intmax_t)fpos, nread);
 
-          copyoffs = (blkoffs >= filep->f_pos) ? 0 : filep->f_pos - blkoffs;
-          DEBUGASSERT(ulen > copyoffs);
-          copysize = ulen - copyoffs;
+          /* Return the data read so far, if any */
 
-          if (copysize > remaining)
+          if (remaining == buflen)
             {
-              /* Clip to the size really needed */
-
-              copysize = remaining;
+              return nread;
             }
 
-          src = (FAR const uint8_t *)currhdr + LZF_TYPE0_HDR_SIZE;
-          memcpy(dest, &src[copyoffs], copysize);
-
-          finfo("blkoffs=%" PRIu32 " ulen=%" PRIu16 " copysize=%u\n",
-                blkoffs, ulen, copysize);
-        }
-      else
-        {
-          /* If the source of the data is at the beginning of the compressed
-           * data buffer and if the uncompressed data would not overrun the
-           * buffer, then we can decompress directly into the user buffer.
-           */
-
-          if (filep->f_pos <= blkoffs && ulen <= remaining)
-            {
-              uint32_t voloffs;
-
-              copyoffs = 0;
-              copysize = ulen;
-
-              /* Get the address and offset in the CROMFS image to obtain
-               * the data.  Check if we already have this offset in the
-               * cache.
-               */
-
-              src     = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
-              voloffs = cromfs_addr2offset(fs, src);
-              if (voloffs != ff->ff_offset)
-                {
-                  unsigned int decomplen;
-
-                  decomplen = lzf_decompress(src, clen, dest, fs->cv_bsize);
-
-                  ff->ff_offset = voloffs;
-                  ff->ff_ulen   = decomplen;
-                }
-
-              finfo("voloffs=%" PRIu32 " blkoffs=%" PRIu32
-                    " ulen=%" PRIu16 " ff_offset=%" PRIu32 " copysize=%u\n",
-                    voloffs, blkoffs, ulen, ff->ff_offset, copysize);
-              DEBUGASSERT(ff->ff_ulen >= copysize);
-            }
-          else
-            {
-              uint32_t voloffs;
-
-              /* No, we will need to decompress into the our intermediate
-               * decompression buffer.
-               */
-
-              copyoffs = (blkoffs >= filep->f_pos) ?
-                            0 : filep->f_pos - blkoffs;
-              DEBUGASSERT(ulen > copyoffs);
-              copysize = ulen - copyoffs;
-
-              if (copysize > remaining)
-                {
-                  /* Clip to the size really needed */
-
-                  copysize = remaining;
-                }
-
-              DEBUGASSERT((copyoffs + copysize) <=  fs->cv_bsize);
-
-              src = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
-              voloffs = cromfs_addr2offset(fs, src);
-              if (voloffs != ff->ff_offset)
-                {
-                  unsigned int decomplen;
-
-                  decomplen = lzf_decompress(src, clen, ff->ff_buffer,
-                                             fs->cv_bsize);
-
-                  ff->ff_offset = voloffs;
-                  ff->ff_ulen   = decomplen;
-                }
-
-              finfo("voloffs=%" PRIu32 " blkoffs=%" PRIu32 " ulen=%" PRIu16
-                    " clen=%" PRIu16 " ff_offset=%" PRIu32
-                    "  copyoffs=%u copysize=%u\n",
-                    voloffs, blkoffs, ulen, clen, ff->ff_offset,
-                    copyoffs, copysize);
-              DEBUGASSERT(ff->ff_ulen >= (copyoffs + copysize));
-
-              /* Then copy to user buffer */
-
-              memcpy(dest, &ff->ff_buffer[copyoffs], copysize);
-            }
+          break;
         }
 
       /* Adjust pointers counts and offset */
 
-      dest      += copysize;
-      remaining -= copysize;
-      fpos      += copysize;
+      dest      += nread;
+      remaining -= nread;
+      fpos      += nread;
     }
 
   /* Update the file pointer */
 
   filep->f_pos = fpos;
-  return buflen;
+  return buflen - remaining;
 }
 
 /****************************************************************************
@@ -1115,7 +1426,7 @@ static int cromfs_dup(FAR const struct file *oldp, FAR struct file *newp)
   /* Get the open file instance from the file structure */
 
   oldff = oldp->f_priv;
-  DEBUGASSERT(oldff->ff_node != NULL && oldff->ff_buffer != NULL);
+  DEBUGASSERT(oldff->ff_node != NULL);
 
   /* Allocate and initialize an new open file instance referring to the
    * same node.
@@ -1127,6 +1438,7 @@ static int cromfs_dup(FAR const struct file *oldp, FAR struct file *newp)
       return -ENOMEM;
     }
 
+#if CONFIG_FS_CROMFS_CACHE_NBLOCKS == 0
   /* Create a file buffer to support partial sector accesses */
 
   newff->ff_buffer = fs_heap_malloc(fs->cv_bsize);
@@ -1135,6 +1447,7 @@ static int cromfs_dup(FAR const struct file *oldp, FAR struct file *newp)
       fs_heap_free(newff);
       return -ENOMEM;
     }
+#endif
 
   /* Save the node in the open file instance */
 
@@ -1172,7 +1485,7 @@ static int cromfs_fstat(FAR const struct file *filep, FAR struct stat *buf)
    */
 
   ff              = filep->f_priv;
-  DEBUGASSERT(ff->ff_node != NULL && ff->ff_buffer != NULL);
+  DEBUGASSERT(ff->ff_node != NULL);
 
   inode           = filep->f_inode;
   fs              = inode->i_private;
@@ -1429,11 +1742,43 @@ static int cromfs_rewinddir(FAR struct inode *mountpt,
 static int cromfs_bind(FAR struct inode *blkdriver, FAR const void *data,
                        FAR void **handle)
 {
+#if CONFIG_FS_CROMFS_CACHE_NBLOCKS > 0
+  int ret;
+
+#endif
   finfo("blkdriver: %p data: %p handle: %p\n", blkdriver, data, handle);
 
   DEBUGASSERT(blkdriver == NULL && handle != NULL);
   DEBUGASSERT(g_cromfs_image.cv_magic == CROMFS_MAGIC);
 
+#if CONFIG_FS_CROMFS_CACHE_NBLOCKS > 0
+  /* Allocate the block cache with the first mount */
+
+  ret = nxmutex_lock(&g_cromfs_cache.cc_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (g_cromfs_cache.cc_refs == 0)
+    {
+      g_cromfs_cache.cc_buffer =
+        fs_heap_malloc(CONFIG_FS_CROMFS_CACHE_NBLOCKS *
+                       g_cromfs_image.cv_bsize);
+      if (g_cromfs_cache.cc_buffer == NULL)
+        {
+          nxmutex_unlock(&g_cromfs_cache.cc_lock);
+          return -ENOMEM;
+        }
+
+      memset(g_cromfs_cache.cc_blocks, 0, sizeof(g_cromfs_cache.cc_blocks));
+      g_cromfs_cache.cc_clock = 0;
+    }
+
+  g_cromfs_cache.cc_refs++;
+  nxmutex_unlock(&g_cromfs_cache.cc_lock);
+#endif
+
   /* Return the new file system handle */
 
   *handle = (FAR void *)&g_cromfs_image;
@@ -1453,6 +1798,21 @@ static int cromfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
 {
   finfo("handle: %p blkdriver: %p flags: %02x\n",
         handle, blkdriver, flags);
+
+#if CONFIG_FS_CROMFS_CACHE_NBLOCKS > 0
+  /* Free the block cache with the last mount */
+
+  nxmutex_lock(&g_cromfs_cache.cc_lock);
+  DEBUGASSERT(g_cromfs_cache.cc_refs > 0);
+  if (--g_cromfs_cache.cc_refs == 0)
+    {
+      fs_heap_free(g_cromfs_cache.cc_buffer);
+      g_cromfs_cache.cc_buffer = NULL;
+    }
+
+  nxmutex_unlock(&g_cromfs_cache.cc_lock);
+#endif
+
   return OK;
 }
 
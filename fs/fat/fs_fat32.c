@@ -1489,6 +1489,15 @@ static int fat_sync(FAR struct file *filep)
       ret          = fat_updatefsinfo(fs);
     }
 
+#ifdef CONFIG_FS_FAT_PAGECACHE
+  /* Then write the cached sectors to the media */
+
+  if (ret >= 0 && fs->fs_pagecache != NULL)
+    {
+      ret = pagecache_flush(fs->fs_pagecache);
+    }
+#endif
+
 errout_with_lock:
   nxmutex_unlock(&fs->fs_lock);
   return ret;
@@ -2246,6 +2255,14 @@ static int fat_bind(FAR struct inode *blkdriver, FAR const void *data,
   fs->fs_blkdriver = blkdriver;   /* Save the block driver reference */
   nxmutex_init(&fs->fs_lock);     /* Initialize the mutex that controls access */
 
+#ifdef CONFIG_FS_FAT_PAGECACHE
+  /* Share the page cache of the block driver.  If it cannot be cached, the
+   * device is accessed directly.
+   */
+
+  fs->fs_pagecache = pagecache_attach(blkdriver);
+#endif
+
   /* Then get information about the FAT32 filesystem on the devices managed
    * by this block driver.
    */
@@ -2253,6 +2270,13 @@ static int fat_bind(FAR struct inode *blkdriver, FAR const void *data,
   ret = fat_mount(fs, true);
   if (ret != 0)
     {
+#ifdef CONFIG_FS_FAT_PAGECACHE
+      if (fs->fs_pagecache != NULL)
+        {
+          pagecache_detach(fs->fs_pagecache);
+        }
+#endif
+
       nxmutex_destroy(&fs->fs_lock);
       fs_heap_free(fs);
       return ret;
@@ -2323,6 +2347,29 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
         }
     }
 
+#ifdef CONFIG_FS_FAT_PAGECACHE
+  /* Write the cached sectors back and stop caching the device.  If they
+   * cannot be written, the volume stays mounted unless the unmount is
+   * forced, which loses them.
+   */
+
+  if (fs->fs_pagecache != NULL)
+    {
+      ret = pagecache_detach(fs->fs_pagecache);
+      if (ret < 0 && (flags & MNT_FORCE) != 0)
+        {
+          pagecache_invalidate(fs->fs_pagecache);
+          ret = pagecache_detach(fs->fs_pagecache);
+        }
+
+      if (ret < 0)
+        {
+          nxmutex_unlock(&fs->fs_lock);
+          return ret;
+        }
+    }
+#endif
+
   /* Unmount ... close the block driver */
 
   if (fs->fs_blkdriver)
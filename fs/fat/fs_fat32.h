@@ -38,6 +38,7 @@
 #include <nuttx/mutex.h>
 
 #include "fs_heap.h"
+#include "pagecache/pagecache.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -867,6 +868,9 @@ struct fat_mountpt_s
 {
   FAR struct inode      *fs_blkdriver; /* The block driver inode that hosts the FAT32 fs */
   FAR struct fat_file_s *fs_head;      /* A list to all files opened on this mountpoint */
+#ifdef CONFIG_FS_FAT_PAGECACHE
+  FAR struct pagecache_s *fs_pagecache; /* Page cache of the block driver, if any */
+#endif
 
   mutex_t  fs_lock;                /* Used to assume thread-safe access */
   off_t    fs_hwsectorsize;        /* HW: Sector size reported by block driver */
@@ -683,6 +683,15 @@ int fat_checkmount(struct fat_mountpt_s *fs)
        * still the case
        */
 
+#ifdef CONFIG_FS_FAT_PAGECACHE
+      if (fs->fs_pagecache != NULL &&
+          pagecache_checkmedia(fs->fs_pagecache) < 0)
+        {
+          fs->fs_mounted = false;
+          return -ENODEV;
+        }
+#endif
+
       if (fs->fs_blkdriver)
         {
           struct inode *inode = fs->fs_blkdriver;
@@ -718,6 +727,14 @@ int fat_hwread(struct fat_mountpt_s *fs, uint8_t *buffer,  off_t sector,
                unsigned int nsectors)
 {
   int ret = -ENODEV;
+
+#ifdef CONFIG_FS_FAT_PAGECACHE
+  if (fs && fs->fs_pagecache)
+    {
+      return pagecache_read(fs->fs_pagecache, buffer, sector, nsectors);
+    }
+#endif
+
   if (fs && fs->fs_blkdriver)
     {
       struct inode *inode = fs->fs_blkdriver;
@@ -751,6 +768,14 @@ int fat_hwwrite(struct fat_mountpt_s *fs, uint8_t *buffer, off_t sector,
                 unsigned int nsectors)
 {
   int ret = -ENODEV;
+
+#ifdef CONFIG_FS_FAT_PAGECACHE
+  if (fs && fs->fs_pagecache)
+    {
+      return pagecache_write(fs->fs_pagecache, buffer, sector, nsectors);
+    }
+#endif
+
   if (fs && fs->fs_blkdriver)
     {
       struct inode *inode = fs->fs_blkdriver;
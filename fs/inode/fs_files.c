@@ -56,6 +56,7 @@
 
 #include "sched/sched.h"
 #include "inode/inode.h"
+#include "pagecache/pagecache.h"
 #include "fs_heap.h"
 
 /****************************************************************************
@@ -1126,4 +1127,10 @@ int close(int fd)
 void sync(void)
 {
   nxsched_foreach(task_fssync, NULL);
+
+#ifdef CONFIG_FS_PAGECACHE
+  /* Write back the sectors cached by the file systems */
+
+  pagecache_flush(NULL);
+#endif
 }
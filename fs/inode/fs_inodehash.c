@@ -0,0 +1,168 @@
+/****************************************************************************
+ * fs/inode/fs_inodehash.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <stdint.h>
+
+#include <nuttx/fs/fs.h>
+
+#include "inode/inode.h"
+
+#if CONFIG_PSEUDOFS_HASHSIZE > 0
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Every inode but the root is linked into the bucket selected by its
+ * parent and its name.
+ */
+
+static FAR struct inode *g_inode_hash[CONFIG_PSEUDOFS_HASHSIZE];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_hash
+ *
+ * Description:
+ *   Hash the parent inode and the first segment of 'name'.  The segment
+ *   ends at '/' or at the NUL terminator.
+ *
+ ****************************************************************************/
+
+static unsigned int inode_hash(FAR const struct inode *parent,
+                               FAR const char *name)
+{
+  uint32_t hash = (uint32_t)((uintptr_t)parent >> 2);
+
+  while (*name != '\0' && *name != '/')
+    {
+      hash = hash * 31 + (uint8_t)*name++;
+    }
+
+  return hash % CONFIG_PSEUDOFS_HASHSIZE;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_hashadd
+ *
+ * Description:
+ *   Make the inode visible to inode_hashfind() under its current parent.
+ *
+ * Assumptions:
+ *   The caller holds the inode lock for writing.
+ *
+ ****************************************************************************/
+
+void inode_hashadd(FAR struct inode *inode)
+{
+  unsigned int index = inode_hash(inode->i_parent, inode->i_name);
+
+  inode->i_hash       = g_inode_hash[index];
+  g_inode_hash[index] = inode;
+}
+
+/****************************************************************************
+ * Name: inode_hashremove
+ *
+ * Description:
+ *   Remove the inode from the hash table.  Nothing happens if it is not
+ *   there.  This must be done before the parent of the inode changes.
+ *
+ * Assumptions:
+ *   The caller holds the inode lock for writing.
+ *
+ ****************************************************************************/
+
+void inode_hashremove(FAR struct inode *inode)
+{
+  FAR struct inode **prev;
+
+  prev = &g_inode_hash[inode_hash(inode->i_parent, inode->i_name)];
+  for (; *prev != NULL; prev = &(*prev)->i_hash)
+    {
+      if (*prev == inode)
+        {
+          *prev = inode->i_hash;
+          inode->i_hash = NULL;
+          break;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: inode_hashfind
+ *
+ * Description:
+ *   Return the child of 'parent' named by the first segment of 'name', or
+ *   NULL if there is none.
+ *
+ * Assumptions:
+ *   The caller holds the inode lock.
+ *
+ ****************************************************************************/
+
+FAR struct inode *inode_hashfind(FAR const struct inode *parent,
+                                 FAR const char *name)
+{
+  FAR struct inode *inode;
+
+  inode = g_inode_hash[inode_hash(parent, name)];
+  for (; inode != NULL; inode = inode->i_hash)
+    {
+      FAR const char *fname = name;
+      FAR const char *nname = inode->i_name;
+
+      if (inode->i_parent != parent)
+        {
+          continue;
+        }
+
+      while (*nname != '\0' && *nname == *fname)
+        {
+          nname++;
+          fname++;
+        }
+
+      if (*nname == '\0' && (*fname == '\0' || *fname == '/'))
+        {
+          return inode;
+        }
+    }
+
+  return NULL;
+}
+
+#endif /* CONFIG_PSEUDOFS_HASHSIZE > 0 */
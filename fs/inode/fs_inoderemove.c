@@ -76,23 +76,43 @@ static FAR struct inode *inode_unlink(FAR const char *path)
   ret = inode_search(&desc);
   if (ret >= 0)
     {
+      FAR struct inode *peer = desc.peer;
+
       inode = desc.node;
-      DEBUGASSERT(inode != NULL);
+      DEBUGASSERT(inode != NULL && desc.parent != NULL);
+
+#if CONFIG_PSEUDOFS_HASHSIZE > 0
+      /* The search does not report the peer of an inode found by hashing */
+
+      peer = desc.parent->i_child;
+      if (peer == inode)
+        {
+          peer = NULL;
+        }
+      else
+        {
+          while (peer->i_peer != inode)
+            {
+              peer = peer->i_peer;
+            }
+        }
+
+      inode_hashremove(inode);
+#endif
 
       /* If peer is non-null, then remove the node from the right of
        * of that peer node.
        */
 
-      if (desc.peer != NULL)
+      if (peer != NULL)
         {
-          desc.peer->i_peer = inode->i_peer;
+          peer->i_peer = inode->i_peer;
         }
 
       /* Then remove the node from head of the list of children. */
 
       else
         {
-          DEBUGASSERT(desc.parent != NULL);
           desc.parent->i_child = inode->i_peer;
         }
 
@@ -129,6 +129,8 @@ static void inode_insert(FAR struct inode *inode,
       inode->i_parent = parent;
       parent->i_child = inode;
     }
+
+  inode_hashadd(inode);
 }
 
 /****************************************************************************
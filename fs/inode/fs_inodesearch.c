@@ -386,7 +386,19 @@ static int _inode_search(FAR struct inode_search_s *desc)
 
               above = inode;
               left  = NULL;
+#if CONFIG_PSEUDOFS_HASHSIZE > 0
+              /* Go straight to the matching child.  If there is none, walk
+               * the peers anyway to find where the name would be inserted.
+               */
+
+              inode = inode_hashfind(above, name);
+              if (inode == NULL)
+                {
+                  inode = above->i_child;
+                }
+#else
               inode = inode->i_child;
+#endif
             }
         }
     }
@@ -100,7 +100,9 @@
  *  node     - INPUT:  (not used)
  *             OUTPUT: On success, holds the pointer to the inode found.
  *  peer     - INPUT:  (not used)
- *             OUTPUT: The inode to the "left" of the inode found.
+ *             OUTPUT: If the inode was not found, the inode to the "left"
+ *                     of where it would be inserted.  It is not set if
+ *                     the inode was found by hashing.
  *  parent   - INPUT:  (not used)
  *             OUTPUT: The inode to the "above" of the inode found.
  *  relpath  - INPUT:  (not used)
@@ -325,6 +327,25 @@ int inode_getpath(FAR struct inode *inode, FAR char *path, size_t len);
 
 void inode_free(FAR struct inode *inode);
 
+/****************************************************************************
+ * Name: inode_hashadd, inode_hashremove and inode_hashfind
+ *
+ * Description:
+ *   Maintain and query the table that finds the child of a directory by
+ *   name without walking the list of its peers.
+ *
+ ****************************************************************************/
+
+#if CONFIG_PSEUDOFS_HASHSIZE > 0
+void inode_hashadd(FAR struct inode *inode);
+void inode_hashremove(FAR struct inode *inode);
+FAR struct inode *inode_hashfind(FAR const struct inode *parent,
+                                 FAR const char *name);
+#else
+#  define inode_hashadd(inode)
+#  define inode_hashremove(inode)
+#endif
+
 /****************************************************************************
  * Name: inode_nextname
  *
@@ -32,6 +32,7 @@
 
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/fs/littlefs.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/mutex.h>
@@ -80,6 +81,35 @@ struct littlefs_mountpt_s
   struct mtd_geometry_s geo;
   struct lfs_config     cfg;
   struct lfs            lfs;
+  struct littlefs_stats_s stats;
+
+#if CONFIG_FS_LITTLEFS_READAHEAD > 0
+  /* Read-ahead buffer of rabufsize bytes.  It holds rasize bytes of block
+   * rablock from offset raoff.  rasize is zero if the buffer is empty.
+   * lastblock and lastend locate the end of the previous read, to detect
+   * sequential readers.
+   */
+
+  FAR uint8_t          *rabuf;
+  lfs_size_t            rabufsize;
+  lfs_block_t           rablock;
+  lfs_off_t             raoff;
+  lfs_size_t            rasize;
+  lfs_block_t           lastblock;
+  lfs_off_t             lastend;
+#endif
+
+#if CONFIG_FS_LITTLEFS_WRITEBEHIND > 0
+  /* Write-behind buffer of wbbufsize bytes.  It holds wbsize bytes to be
+   * programmed to block wbblock from offset wboff.
+   */
+
+  FAR uint8_t          *wbbuf;
+  lfs_size_t            wbbufsize;
+  lfs_block_t           wbblock;
+  lfs_off_t             wboff;
+  lfs_size_t            wbsize;
+#endif
 };
 
 struct littlefs_attr_s
@@ -624,6 +654,34 @@ static int littlefs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+      case FIOC_LFSSTATS:
+        {
+          FAR struct littlefs_stats_s *stats =
+            (FAR struct littlefs_stats_s *)(uintptr_t)arg;
+
+          if (stats == NULL)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          memcpy(stats, &fs->stats, sizeof(*stats));
+          stats->read_size      = fs->cfg.read_size;
+          stats->prog_size      = fs->cfg.prog_size;
+          stats->block_size     = fs->cfg.block_size;
+          stats->block_count    = fs->cfg.block_count;
+          stats->cache_size     = fs->cfg.cache_size;
+          stats->lookahead_size = fs->cfg.lookahead_size;
+#if CONFIG_FS_LITTLEFS_READAHEAD > 0
+          stats->readahead      = fs->rabufsize;
+#endif
+#if CONFIG_FS_LITTLEFS_WRITEBEHIND > 0
+          stats->writebehind    = fs->wbbufsize;
+#endif
+          ret = OK;
+        }
+        break;
+
       default:
         {
           if (INODE_IS_MTD(drv))
@@ -1075,28 +1133,21 @@ static int littlefs_rewinddir(FAR struct inode *mountpt,
 }
 
 /****************************************************************************
- * Name: littlefs_bind
- *
- * Description: This implements a portion of the mount operation. This
- *  function allocates and initializes the mountpoint private data and
- *  binds the driver inode to the filesystem private data. The final
- *  binding of the private data (containing the driver) to the
- *  mountpoint is performed by mount().
- *
+ * Name: littlefs_devread
  ****************************************************************************/
 
-static int littlefs_read_block(FAR const struct lfs_config *c,
-                               lfs_block_t block, lfs_off_t off,
-                               FAR void *buffer, lfs_size_t size)
+static int littlefs_devread(FAR struct littlefs_mountpt_s *fs,
+                            lfs_block_t block, lfs_off_t off,
+                            FAR void *buffer, lfs_size_t size)
 {
-  FAR struct littlefs_mountpt_s *fs = c->context;
   FAR struct mtd_geometry_s *geo = &fs->geo;
   FAR struct inode *drv = fs->drv;
   int ret;
 
-  block = (block * c->block_size + off) / geo->blocksize;
+  block = (block * fs->cfg.block_size + off) / geo->blocksize;
   size  = size / geo->blocksize;
 
+  fs->stats.devreads++;
   if (INODE_IS_MTD(drv))
     {
       ret = MTD_BREAD(drv->u.i_mtd, block, size, buffer);
@@ -1110,21 +1161,21 @@ static int littlefs_read_block(FAR const struct lfs_config *c,
 }
 
 /****************************************************************************
- * Name: littlefs_write_block
+ * Name: littlefs_devwrite
  ****************************************************************************/
 
-static int littlefs_write_block(FAR const struct lfs_config *c,
-                                lfs_block_t block, lfs_off_t off,
-                                FAR const void *buffer, lfs_size_t size)
+static int littlefs_devwrite(FAR struct littlefs_mountpt_s *fs,
+                             lfs_block_t block, lfs_off_t off,
+                             FAR const void *buffer, lfs_size_t size)
 {
-  FAR struct littlefs_mountpt_s *fs = c->context;
   FAR struct mtd_geometry_s *geo = &fs->geo;
   FAR struct inode *drv = fs->drv;
   int ret;
 
-  block = (block * c->block_size + off) / geo->blocksize;
+  block = (block * fs->cfg.block_size + off) / geo->blocksize;
   size  = size / geo->blocksize;
 
+  fs->stats.devwrites++;
   if (INODE_IS_MTD(drv))
     {
       ret = MTD_BWRITE(drv->u.i_mtd, block, size, buffer);
@@ -1137,6 +1188,174 @@ static int littlefs_write_block(FAR const struct lfs_config *c,
   return ret >= 0 ? OK : ret;
 }
 
+/****************************************************************************
+ * Name: littlefs_flush
+ *
+ * Description: Program the data held in the write-behind buffer.
+ *
+ ****************************************************************************/
+
+static int littlefs_flush(FAR struct littlefs_mountpt_s *fs)
+{
+#if CONFIG_FS_LITTLEFS_WRITEBEHIND > 0
+  int ret = OK;
+
+  if (fs->wbsize > 0)
+    {
+      ret = littlefs_devwrite(fs, fs->wbblock, fs->wboff, fs->wbbuf,
+                              fs->wbsize);
+      fs->wbsize = 0;
+    }
+
+  return ret;
+#else
+  return OK;
+#endif
+}
+
+/****************************************************************************
+ * Name: littlefs_invalidate
+ *
+ * Description: Drop the read-ahead data of a block about to change.
+ *
+ ****************************************************************************/
+
+static void littlefs_invalidate(FAR struct littlefs_mountpt_s *fs,
+                                lfs_block_t block)
+{
+#if CONFIG_FS_LITTLEFS_READAHEAD > 0
+  if (fs->rablock == block)
+    {
+      fs->rasize = 0;
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: littlefs_read_block
+ *
+ * Description: Read on behalf of littlefs.  When littlefs reads on from
+ *   where its previous read ended, the rest of the erase block is read
+ *   ahead, up to CONFIG_FS_LITTLEFS_READAHEAD bytes.
+ *
+ ****************************************************************************/
+
+static int littlefs_read_block(FAR const struct lfs_config *c,
+                               lfs_block_t block, lfs_off_t off,
+                               FAR void *buffer, lfs_size_t size)
+{
+  FAR struct littlefs_mountpt_s *fs = c->context;
+  int ret;
+
+  fs->stats.reads++;
+
+#if CONFIG_FS_LITTLEFS_WRITEBEHIND > 0
+  /* The device has to see the pending data before it is read back */
+
+  if (fs->wbsize > 0 && fs->wbblock == block)
+    {
+      ret = littlefs_flush(fs);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+#endif
+
+#if CONFIG_FS_LITTLEFS_READAHEAD > 0
+  if (fs->rabuf != NULL)
+    {
+      bool sequential = block == fs->lastblock && off == fs->lastend;
+
+      fs->lastblock = block;
+      fs->lastend   = off + size;
+
+      if (fs->rasize > 0 && block == fs->rablock && off >= fs->raoff &&
+          off + size <= fs->raoff + fs->rasize)
+        {
+          memcpy(buffer, fs->rabuf + off - fs->raoff, size);
+          fs->stats.rahits++;
+          return OK;
+        }
+
+      if (sequential && size < fs->rabufsize &&
+          size < c->block_size - off)
+        {
+          lfs_size_t rasize = lfs_min(fs->rabufsize, c->block_size - off);
+
+          fs->rasize = 0;
+          ret = littlefs_devread(fs, block, off, fs->rabuf, rasize);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          fs->rablock = block;
+          fs->raoff   = off;
+          fs->rasize  = rasize;
+          memcpy(buffer, fs->rabuf, size);
+          return OK;
+        }
+    }
+#endif
+
+  ret = littlefs_devread(fs, block, off, buffer, size);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: littlefs_write_block
+ *
+ * Description: Program on behalf of littlefs.  Programs that continue each
+ *   other within a block are collected, up to
+ *   CONFIG_FS_LITTLEFS_WRITEBEHIND bytes, and written to the device in one
+ *   request.
+ *
+ ****************************************************************************/
+
+static int littlefs_write_block(FAR const struct lfs_config *c,
+                                lfs_block_t block, lfs_off_t off,
+                                FAR const void *buffer, lfs_size_t size)
+{
+  FAR struct littlefs_mountpt_s *fs = c->context;
+  int ret;
+
+  fs->stats.progs++;
+  littlefs_invalidate(fs, block);
+
+#if CONFIG_FS_LITTLEFS_WRITEBEHIND > 0
+  if (fs->wbbuf != NULL)
+    {
+      if (fs->wbsize > 0 &&
+          (block != fs->wbblock || off != fs->wboff + fs->wbsize ||
+           fs->wbsize + size > fs->wbbufsize))
+        {
+          ret = littlefs_flush(fs);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+
+      if (size < fs->wbbufsize)
+        {
+          if (fs->wbsize == 0)
+            {
+              fs->wbblock = block;
+              fs->wboff   = off;
+            }
+
+          memcpy(fs->wbbuf + fs->wbsize, buffer, size);
+          fs->wbsize += size;
+          return OK;
+        }
+    }
+#endif
+
+  ret = littlefs_devwrite(fs, block, off, buffer, size);
+  return ret;
+}
+
 /****************************************************************************
  * Name: littlefs_erase_block
  ****************************************************************************/
@@ -1146,9 +1365,13 @@ static int littlefs_erase_block(FAR const struct lfs_config *c,
 {
   FAR struct littlefs_mountpt_s *fs = c->context;
   FAR struct inode *drv = fs->drv;
-  int ret = OK;
+  int ret;
 
-  if (INODE_IS_MTD(drv))
+  fs->stats.erases++;
+  littlefs_invalidate(fs, block);
+
+  ret = littlefs_flush(fs);
+  if (ret >= 0 && INODE_IS_MTD(drv))
     {
       FAR struct mtd_geometry_s *geo = &fs->geo;
       size_t size = c->block_size / geo->erasesize;
@@ -1170,6 +1393,14 @@ static int littlefs_sync_block(FAR const struct lfs_config *c)
   FAR struct inode *drv = fs->drv;
   int ret;
 
+  fs->stats.syncs++;
+
+  ret = littlefs_flush(fs);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
   if (INODE_IS_MTD(drv))
     {
       ret = MTD_IOCTL(drv->u.i_mtd, BIOC_FLUSH, 0);
@@ -1297,6 +1528,39 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
   fs->cfg.lookahead_size = CONFIG_FS_LITTLEFS_LOOKAHEAD_SIZE;
 #endif
 
+  /* Allocate the read-ahead and write-behind buffers.  They are optional,
+   * littlefs accesses the device directly if they are not available.
+   */
+
+#if CONFIG_FS_LITTLEFS_READAHEAD > 0
+  fs->rabufsize = lfs_min(CONFIG_FS_LITTLEFS_READAHEAD, fs->cfg.block_size);
+  fs->rabufsize = fs->rabufsize / fs->cfg.read_size * fs->cfg.read_size;
+  if (fs->rabufsize > fs->cfg.read_size)
+    {
+      fs->rabuf = fs_heap_malloc(fs->rabufsize);
+    }
+
+  if (fs->rabuf == NULL)
+    {
+      fs->rabufsize = 0;
+    }
+#endif
+
+#if CONFIG_FS_LITTLEFS_WRITEBEHIND > 0
+  fs->wbbufsize = lfs_min(CONFIG_FS_LITTLEFS_WRITEBEHIND,
+                          fs->cfg.block_size);
+  fs->wbbufsize = fs->wbbufsize / fs->cfg.prog_size * fs->cfg.prog_size;
+  if (fs->wbbufsize > fs->cfg.prog_size)
+    {
+      fs->wbbuf = fs_heap_malloc(fs->wbbufsize);
+    }
+
+  if (fs->wbbuf == NULL)
+    {
+      fs->wbbufsize = 0;
+    }
+#endif
+
   /* Then get information about the littlefs filesystem on the devices
    * managed by this driver.
    */
@@ -1341,6 +1605,12 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
   return OK;
 
 errout_with_fs:
+#if CONFIG_FS_LITTLEFS_READAHEAD > 0
+  fs_heap_free(fs->rabuf);
+#endif
+#if CONFIG_FS_LITTLEFS_WRITEBEHIND > 0
+  fs_heap_free(fs->wbbuf);
+#endif
   nxmutex_destroy(&fs->lock);
   fs_heap_free(fs);
 errout_with_block:
@@ -1376,6 +1646,11 @@ static int littlefs_unbind(FAR void *handle, FAR struct inode **driver,
     }
 
   ret = littlefs_convert_result(lfs_unmount(&fs->lfs));
+  if (ret >= 0)
+    {
+      ret = littlefs_flush(fs);
+    }
+
   nxmutex_unlock(&fs->lock);
 
   if (ret >= 0)
@@ -1400,6 +1675,12 @@ static int littlefs_unbind(FAR void *handle, FAR struct inode **driver,
 
       /* Release the mountpoint private data */
 
+#if CONFIG_FS_LITTLEFS_READAHEAD > 0
+      fs_heap_free(fs->rabuf);
+#endif
+#if CONFIG_FS_LITTLEFS_WRITEBEHIND > 0
+      fs_heap_free(fs->wbbuf);
+#endif
       nxmutex_destroy(&fs->lock);
       fs_heap_free(fs);
     }
@@ -30,6 +30,7 @@
 #include <sys/mman.h>
 #include <sys/ioctl.h>
 #include <stdint.h>
+#include <string.h>
 #include <errno.h>
 #include <fcntl.h>
 #include <debug.h>
@@ -198,6 +199,60 @@ int file_mmap(FAR struct file *filep, FAR void *start, size_t length,
                     prot, flags, offset, MAP_KERNEL, mapped);
 }
 
+/****************************************************************************
+ * Name: file_mmap_direct
+ *
+ * Description:
+ *   Get direct, read-only access to the content of a memory backed file
+ *   (e.g. ROMFS on XIP media or TMPFS).  Unlike file_mmap(), this never
+ *   falls back to rammap():  If the file system cannot map the requested
+ *   range in place, -ENOTTY is returned and the caller should use the
+ *   normal read path instead.
+ *
+ * Input Parameters:
+ *   filep  - The file to map
+ *   offset - The offset into the file to map
+ *   length - The length of the mapping
+ *   entry  - The mapping description returned to the caller.  If
+ *            entry->munmap is not NULL on return, the mapping must be
+ *            released with file_munmap(entry->vaddr, entry->length).
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on any failure.
+ *
+ ****************************************************************************/
+
+int file_mmap_direct(FAR struct file *filep, off_t offset, size_t length,
+                     FAR struct mm_map_entry_s *entry)
+{
+  int ret = -ENOTTY;
+
+  memset(entry, 0, sizeof(*entry));
+  entry->length = length;
+  entry->offset = offset;
+  entry->prot   = PROT_READ;
+  entry->flags  = MAP_SHARED;
+
+  if (filep == NULL || length == 0)
+    {
+      return -EINVAL;
+    }
+
+  if ((filep->f_oflags & O_RDOK) == 0)
+    {
+      return -EACCES;
+    }
+
+  if (filep->f_inode &&
+      filep->f_inode->u.i_ops->mmap != NULL)
+    {
+      ret = filep->f_inode->u.i_ops->mmap(filep, entry);
+    }
+
+  return ret;
+}
+
 /****************************************************************************
  * Name: mmap
  *
@@ -27,16 +27,23 @@
 #include <nuttx/config.h>
 #include <sys/types.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/param.h>
+#include <sys/stat.h>
 
 #include <assert.h>
 #include <debug.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <inttypes.h>
 #include <string.h>
 #include <unistd.h>
 
 #include <nuttx/fs/fs.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/queue.h>
 #include <nuttx/sched.h>
 
 #include "fs_rammap.h"
@@ -44,84 +51,338 @@
 #include "fs_heap.h"
 
 /****************************************************************************
- * Public Data
+ * Pre-processor Definitions
  ****************************************************************************/
 
+/* Kernel heap regions are visible to every task group.  User heap regions
+ * are only visible to every task group if there are no per-process address
+ * environments.
+ */
+
+#ifdef CONFIG_ARCH_ADDRENV
+#  define RAMMAP_SHAREABLE(type) ((type) == MAP_KERNEL)
+#else
+#  define RAMMAP_SHAREABLE(type) ((type) != MAP_XIP)
+#endif
+
+/* Changes are tracked per page of the image */
+
+#define RAMMAP_PAGESIZE        CONFIG_FS_RAMMAP_PAGESIZE
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One in-memory image of a range of a file.  MAP_SHARED mappings of the
+ * same file that fall inside an existing image reuse that image.
+ */
+
+struct rammap_region_s
+{
+  sq_entry_t node;               /* Entry in g_rammap_regions */
+  FAR struct file *filep;        /* File used to load and write back */
+  FAR uint8_t *vaddr;            /* Start of the image */
+  FAR uint8_t *shadow;           /* The image as in the file, NULL if the
+                                  * image is never written back */
+  off_t offset;                  /* File offset of the image */
+  size_t length;                 /* Length of the image */
+  enum mm_map_type_e type;       /* Memory the image lives in */
+  int crefs;                     /* Number of mappings of the image */
+  bool shared;                   /* True: Image is in g_rammap_regions */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static sq_queue_t g_rammap_regions;
+static mutex_t g_rammap_lock = NXMUTEX_INITIALIZER;
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: msync_rammap
+ * Name: rammap_free
  ****************************************************************************/
 
-static int msync_rammap(FAR struct mm_map_entry_s *entry, FAR void *start,
-                        size_t length, int flags)
+static void rammap_free(FAR struct rammap_region_s *region)
 {
-  FAR struct file *filep = (FAR void *)((uintptr_t)entry->priv.p & ~3);
-  FAR uint8_t *wrbuffer = start;
-  ssize_t nwrite = 0;
-  off_t offset;
-  off_t fpos;
-  off_t opos;
+  if (region->type == MAP_KERNEL)
+    {
+      fs_heap_free(region->vaddr);
+    }
+  else if (region->type == MAP_USER)
+    {
+      kumm_free(region->vaddr);
+    }
 
-  offset = (uintptr_t)start - (uintptr_t)entry->vaddr;
-  if (length > entry->length - offset)
+  fs_heap_free(region->shadow);
+  fs_heap_free(region);
+}
+
+/****************************************************************************
+ * Name: rammap_release
+ *
+ * Description:
+ *   Drop one mapping of the region.  The image is freed with the last one.
+ *   The caller must hold g_rammap_lock.
+ *
+ ****************************************************************************/
+
+static void rammap_release(FAR struct rammap_region_s *region)
+{
+  DEBUGASSERT(region->crefs > 0);
+
+  if (--region->crefs > 0)
     {
-      length = entry->length - offset;
+      return;
     }
 
-  opos = file_seek(filep, 0, SEEK_CUR);
-  if (opos < 0)
+  if (region->shared)
     {
-      ferr("ERROR: Get current position failed\n");
-      return opos;
+      sq_rem(&region->node, &g_rammap_regions);
     }
 
-  fpos = file_seek(filep, entry->offset + offset, SEEK_SET);
+  fs_putfilep(region->filep);
+  rammap_free(region);
+}
+
+/****************************************************************************
+ * Name: rammap_find
+ *
+ * Description:
+ *   Find a shared image of the file that covers the requested range.  The
+ *   caller must hold g_rammap_lock.
+ *
+ ****************************************************************************/
+
+static FAR struct rammap_region_s *
+rammap_find(FAR struct file *filep, off_t offset, size_t length,
+            enum mm_map_type_e type)
+{
+  FAR struct rammap_region_s *region;
+  FAR sq_entry_t *node;
+
+  sq_for_every(&g_rammap_regions, node)
+    {
+      region = container_of(node, struct rammap_region_s, node);
+      if (region->filep->f_inode == filep->f_inode &&
+          region->type == type && offset >= region->offset &&
+          offset + length <= region->offset + region->length)
+        {
+          return region;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: rammap_load
+ *
+ * Description:
+ *   Read the file into a new image.  Any part of the image beyond the end
+ *   of the file is zeroed.
+ *
+ ****************************************************************************/
+
+static int rammap_load(FAR struct file *filep, FAR uint8_t *rdbuffer,
+                       off_t offset, size_t length)
+{
+  ssize_t nread;
+  off_t fpos;
+
+  /* Seek to the specified file offset */
+
+  fpos = file_seek(filep, offset, SEEK_SET);
   if (fpos < 0)
     {
-      ferr("ERROR: Seek to position %"PRIdOFF" failed\n", fpos);
+      /* Seek failed... errno has already been set, but EINVAL is probably
+       * the correct response.
+       */
+
+      ferr("ERROR: Seek to position %"PRIdOFF" failed\n", offset);
       return fpos;
     }
 
+  /* Read the file data into the memory region */
+
   while (length > 0)
     {
-      nwrite = file_write(filep, wrbuffer, length);
-      if (nwrite < 0)
+      nread = file_read(filep, rdbuffer, length);
+      if (nread < 0)
         {
-          /* Handle the special case where the write was interrupted by a
+          /* Handle the special case where the read was interrupted by a
            * signal.
            */
 
-          if (nwrite != -EINTR)
+          if (nread == -EINTR)
             {
+              continue;
+            }
+
+          /* All other read errors are bad. */
+
+          ferr("ERROR: Read failed: offset=%"PRIdOFF" ret=%zd\n",
+               offset, nread);
+          return nread;
+        }
+
+      /* Check for end of file. */
+
+      if (nread == 0)
+        {
+          break;
+        }
+
+      /* Increment number of bytes read */
+
+      rdbuffer += nread;
+      length   -= nread;
+    }
+
+  /* Zero any memory beyond the amount read from the file */
+
+  memset(rdbuffer, 0, length);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: rammap_writeback
+ *
+ * Description:
+ *   Write the pages of the image that overlap a range and were modified
+ *   back to the file.  'offset' is relative to the start of the image.
+ *   A page is modified if it differs from the shadow copy of the file
+ *   content.  Nothing is written beyond the end of the file:  The image is
+ *   zero filled there and a mapping does not extend the file.
+ *
+ ****************************************************************************/
+
+static int rammap_writeback(FAR struct rammap_region_s *region,
+                            off_t offset, size_t length)
+{
+  FAR struct file *filep = region->filep;
+  struct stat buf;
+  ssize_t nwrite;
+  size_t nbytes;
+  size_t page;
+  off_t start;
+  off_t pos;
+  off_t end;
+  off_t size;
+  int ret;
+
+  DEBUGASSERT(region->shadow != NULL);
+
+  ret = file_fstat(filep, &buf);
+  if (ret < 0)
+    {
+      ferr("ERROR: Get file size failed: %d\n", ret);
+      return ret;
+    }
+
+  /* The end of the range, the image and the file, relative to the image */
+
+  size = MIN(buf.st_size - region->offset, (off_t)region->length);
+  end  = MIN(offset + (off_t)length, size);
+
+  for (page = offset / RAMMAP_PAGESIZE;
+       (start = page * RAMMAP_PAGESIZE) < end; page++)
+    {
+      /* Skip the pages that have not changed since they were read or last
+       * written.
+       */
+
+      nbytes = MIN(RAMMAP_PAGESIZE, size - start);
+      if (memcmp(region->vaddr + start, region->shadow + start,
+                 nbytes) == 0)
+        {
+          continue;
+        }
+
+      for (pos = start; pos < start + (off_t)nbytes; )
+        {
+          nwrite = file_pwrite(filep, region->vaddr + pos,
+                               start + nbytes - pos, region->offset + pos);
+          if (nwrite < 0)
+            {
+              /* Handle the special case where the write was interrupted
+               * by a signal.
+               */
+
+              if (nwrite == -EINTR)
+                {
+                  continue;
+                }
+
               /* All other write errors are bad. */
 
               ferr("ERROR: Write failed: offset=%"PRIdOFF" nwrite=%zd\n",
-                   entry->offset, nwrite);
-              break;
+                   region->offset + pos, nwrite);
+              return nwrite;
             }
-        }
 
-      /* Increment number of bytes written */
+          pos += nwrite;
+        }
 
-      wrbuffer += nwrite;
-      length   -= nwrite;
+      memcpy(region->shadow + start, region->vaddr + start, nbytes);
     }
 
-  /* Restore file pos */
+  return OK;
+}
 
-  fpos = file_seek(filep, opos, SEEK_SET);
-  if (fpos < 0)
+/****************************************************************************
+ * Name: rammap_canwrite
+ *
+ * Description:
+ *   Changes to the image reach the file only for shared mappings of files
+ *   that are not executed in place.
+ *
+ ****************************************************************************/
+
+static bool rammap_canwrite(FAR struct mm_map_entry_s *entry)
+{
+  FAR struct rammap_region_s *region = entry->priv.p;
+
+  return (entry->flags & MAP_SHARED) != 0 && region->type != MAP_XIP;
+}
+
+/****************************************************************************
+ * Name: msync_rammap
+ ****************************************************************************/
+
+static int msync_rammap(FAR struct mm_map_entry_s *entry, FAR void *start,
+                        size_t length, int flags)
+{
+  FAR struct rammap_region_s *region = entry->priv.p;
+  off_t offset;
+  int ret;
+
+  /* Like munmap(), write back only through a writable descriptor */
+
+  if (!rammap_canwrite(entry) || (region->filep->f_oflags & O_WROK) == 0)
     {
-      /* Ensure that we finally seek back to the current file pos */
+      return OK;
+    }
 
-      ferr("ERROR: Seek back to position %"PRIdOFF" failed\n", fpos);
-      return fpos;
+  offset = (uintptr_t)start - (uintptr_t)entry->vaddr;
+  if (length > entry->length - offset)
+    {
+      length = entry->length - offset;
+    }
+
+  ret = nxmutex_lock(&g_rammap_lock);
+  if (ret < 0)
+    {
+      return ret;
     }
 
-  return nwrite >= 0 ? 0 : nwrite;
+  ret = rammap_writeback(region, entry->offset - region->offset + offset,
+                         length);
+  nxmutex_unlock(&g_rammap_lock);
+  return ret;
 }
 
 /****************************************************************************
@@ -133,12 +394,10 @@ static int unmap_rammap(FAR struct task_group_s *group,
                         FAR void *start,
                         size_t length)
 {
-  FAR struct file *filep = (FAR void *)((uintptr_t)entry->priv.p & ~3);
-  enum mm_map_type_e type =
-                    (enum mm_map_type_e)((uintptr_t)entry->priv.p & 3);
+  FAR struct rammap_region_s *region = entry->priv.p;
   FAR void *newaddr = NULL;
   off_t offset;
-  int ret = OK;
+  int ret;
 
   /* Get the offset from the beginning of the region and the actual number
    * of bytes to "unmap".  All mappings must extend to the end of the region.
@@ -160,22 +419,34 @@ static int unmap_rammap(FAR struct task_group_s *group,
 
   length = entry->length - offset;
 
-  /* Are we unmapping the entire region (offset == 0)? */
-
-  if (length >= entry->length)
+  ret = nxmutex_lock(&g_rammap_lock);
+  if (ret < 0)
     {
-      /* Free the region */
+      return ret;
+    }
 
-      if (type == MAP_KERNEL)
-        {
-          fs_heap_free(entry->vaddr);
-        }
-      else if (type == MAP_USER)
+  /* Changes to a shared mapping must reach the file.  The mapping goes away
+   * even if they cannot be written:  There is nobody left to retry.
+   */
+
+  if (rammap_canwrite(entry) && (region->filep->f_oflags & O_WROK) != 0)
+    {
+      ret = rammap_writeback(region,
+                             entry->offset - region->offset + offset,
+                             length);
+      if (ret < 0)
         {
-          kumm_free(entry->vaddr);
+          ferr("ERROR: Write back failed: %d\n", ret);
         }
+    }
+
+  /* Are we unmapping the entire region (offset == 0)? */
+
+  if (offset == 0)
+    {
+      /* Drop our reference to the image */
 
-      fs_putfilep(filep);
+      rammap_release(region);
 
       /* Then remove the mapping from the list */
 
@@ -183,25 +454,36 @@ static int unmap_rammap(FAR struct task_group_s *group,
     }
 
   /* No.. We have been asked to "unmap' only a portion of the memory
-   * (offset > 0).
+   * (offset > 0).  The image can only shrink if nobody else maps it.
    */
 
   else
     {
-      if (type == MAP_KERNEL)
+      if (region->crefs == 1 && region->vaddr == entry->vaddr)
         {
-          newaddr = fs_heap_realloc(entry->vaddr, length);
-        }
-      else if (type == MAP_USER)
-        {
-          newaddr = kumm_realloc(entry->vaddr, length);
+          if (region->type == MAP_KERNEL)
+            {
+              newaddr = fs_heap_realloc(region->vaddr, offset);
+            }
+          else if (region->type == MAP_USER)
+            {
+              newaddr = kumm_realloc(region->vaddr, offset);
+            }
+
+          if (region->type != MAP_XIP)
+            {
+              DEBUGASSERT(newaddr == region->vaddr);
+              region->vaddr  = newaddr;
+              region->length = offset;
+              entry->vaddr   = newaddr;
+            }
         }
 
-      DEBUGASSERT(newaddr == entry->vaddr);
-      entry->vaddr = newaddr;
-      entry->length = length;
+      entry->length = offset;
+      ret = OK;
     }
 
+  nxmutex_unlock(&g_rammap_lock);
   return ret;
 }
 
@@ -237,123 +519,129 @@ static int unmap_rammap(FAR struct task_group_s *group,
 int rammap(FAR struct file *filep, FAR struct mm_map_entry_s *entry,
            enum mm_map_type_e type)
 {
-  FAR uint8_t *rdbuffer;
-  ssize_t nread;
-  off_t fpos;
+  FAR struct rammap_region_s *region;
+  FAR void *xipbase;
+  bool shareable;
   int ret;
-  size_t length = entry->length;
 
-  ret = file_ioctl(filep, BIOC_XIPBASE, (unsigned long)&entry->vaddr);
+  ret = file_ioctl(filep, BIOC_XIPBASE, (unsigned long)&xipbase);
   if (ret == OK)
     {
       type = MAP_XIP;
-      goto out;
     }
 
-  /* There is a major design flaw that I have not yet thought of fix for:
-   * The goal is to have a single region of memory that represents a single
-   * file and can be shared by many threads.  That is, given a filename a
-   * thread should be able to open the file, get a file descriptor, and
-   * call mmap() to get a memory region.  Different file descriptors opened
-   * with the same file path should get the same memory region when mapped.
-   *
-   * The design flaw is that I don't have sufficient knowledge to know that
-   * these different file descriptors map to the same file.  So, for the time
-   * being, a new memory region is created each time that rammap() is called.
-   * Not very useful!
-   */
-
-  /* Allocate a region of memory of the specified size */
+  shareable = (entry->flags & MAP_SHARED) != 0 && RAMMAP_SHAREABLE(type);
 
-  rdbuffer = type == MAP_KERNEL ? fs_heap_malloc(length)
-                                : kumm_malloc(length);
-  if (!rdbuffer)
+  ret = nxmutex_lock(&g_rammap_lock);
+  if (ret < 0)
     {
-      ferr("ERROR: Region allocation failed, length: %zu\n", length);
-      return -ENOMEM;
+      return ret;
     }
 
-  entry->vaddr = rdbuffer; /* save the buffer firstly */
-
-  /* Seek to the specified file offset */
+  /* Different file descriptors opened on the same file get the same memory
+   * for shared mappings.  Hand out the existing image if it covers the
+   * requested range.
+   */
 
-  fpos = file_seek(filep, entry->offset, SEEK_SET);
-  if (fpos < 0)
+  region = shareable ? rammap_find(filep, entry->offset, entry->length,
+                                   type) : NULL;
+  if (region != NULL)
     {
-      /* Seek failed... errno has already been set, but EINVAL is probably
-       * the correct response.
-       */
+      /* Write back through a writable descriptor if there is one */
 
-      ferr("ERROR: Seek to position %zu failed\n", (size_t)entry->offset);
-      ret = fpos;
-      goto errout_with_region;
-    }
+      if ((filep->f_oflags & O_WROK) != 0 &&
+          (region->filep->f_oflags & O_WROK) == 0)
+        {
+          fs_reffilep(filep);
+          fs_putfilep(region->filep);
+          region->filep = filep;
+        }
 
-  /* Read the file data into the memory region */
+      region->crefs++;
+      goto out;
+    }
 
-  while (length > 0)
+  region = fs_heap_zalloc(sizeof(struct rammap_region_s));
+  if (region == NULL)
     {
-      nread = file_read(filep, rdbuffer, length);
-      if (nread < 0)
-        {
-          /* Handle the special case where the read was interrupted by a
-           * signal.
-           */
+      ret = -ENOMEM;
+      goto errout_with_lock;
+    }
 
-          if (nread != -EINTR)
-            {
-              /* All other read errors are bad. */
+  region->offset = entry->offset;
+  region->length = entry->length;
+  region->type   = type;
+  region->crefs  = 1;
 
-              ferr("ERROR: Read failed: offset=%zu ret=%zd\n",
-                   (size_t)entry->offset, nread);
+  if (type == MAP_XIP)
+    {
+      region->vaddr = xipbase;
+    }
+  else
+    {
+      /* Allocate a region of memory of the specified size */
 
-              ret = nread;
-              goto errout_with_region;
-            }
+      region->vaddr = type == MAP_KERNEL ? fs_heap_malloc(entry->length)
+                                         : kumm_malloc(entry->length);
+      if (region->vaddr == NULL)
+        {
+          ferr("ERROR: Region allocation failed, length: %zu\n",
+               entry->length);
+          fs_heap_free(region);
+          ret = -ENOMEM;
+          goto errout_with_lock;
         }
 
-      /* Check for end of file. */
-
-      if (nread == 0)
+      ret = rammap_load(filep, region->vaddr, entry->offset,
+                        entry->length);
+      if (ret < 0)
         {
-          break;
+          rammap_free(region);
+          goto errout_with_lock;
         }
 
-      /* Increment number of bytes read */
+      /* Keep a copy of the file content of a shared image, so that only
+       * the pages that were modified are written back.
+       */
 
-      rdbuffer += nread;
-      length   -= nread;
+      if ((entry->flags & MAP_SHARED) != 0)
+        {
+          region->shadow = fs_heap_malloc(entry->length);
+          if (region->shadow == NULL)
+            {
+              rammap_free(region);
+              ret = -ENOMEM;
+              goto errout_with_lock;
+            }
+
+          memcpy(region->shadow, region->vaddr, entry->length);
+        }
     }
 
-  /* Zero any memory beyond the amount read from the file */
+  fs_reffilep(filep);
+  region->filep = filep;
 
-  memset(rdbuffer, 0, length);
+  if (shareable)
+    {
+      region->shared = true;
+      sq_addlast(&region->node, &g_rammap_regions);
+    }
 
   /* Add the buffer to the list of regions */
 
 out:
-  fs_reffilep(filep);
-  entry->priv.p = (FAR void *)((uintptr_t)filep | type);
+  entry->vaddr  = region->vaddr + (entry->offset - region->offset);
+  entry->priv.p = region;
   entry->munmap = unmap_rammap;
-  entry->msync = msync_rammap;
+  entry->msync  = msync_rammap;
 
   ret = mm_map_add(get_current_mm(), entry);
   if (ret < 0)
     {
-      goto errout_with_region;
-    }
-
-  return OK;
-
-errout_with_region:
-  if (type == MAP_KERNEL)
-    {
-      fs_heap_free(entry->vaddr);
-    }
-  else if (type == MAP_USER)
-    {
-      kumm_free(entry->vaddr);
+      rammap_release(region);
     }
 
+errout_with_lock:
+  nxmutex_unlock(&g_rammap_lock);
   return ret;
 }
@@ -29,11 +29,16 @@
  * This copied file has many of the properties of a standard memory mapped
  * file except:
  *
- * - All of the file must be present in memory.  This limits the size of
- *   files that may be memory mapped (especially on MCUs with no significant
- *   RAM resources).
- * - All mapped files are read-only.  You can write to the in-memory image,
- *   but the file contents will not change.
+ * - All of the mapped range must be present in memory.  This limits the
+ *   size of files that may be memory mapped (especially on MCUs with no
+ *   significant RAM resources).
+ * - MAP_SHARED mappings of the same file share one in-memory image as long
+ *   as the new range lies inside an existing image.  Without per-process
+ *   address environments this works across task groups too.  Changes to
+ *   the file made with write() after the image was loaded are not seen.
+ * - The modified pages of a MAP_SHARED image reach the file on msync() and
+ *   munmap().  The file is never extended.  Changes to a MAP_PRIVATE image
+ *   never reach the file.
  * - There are not access privileges.
  */
 
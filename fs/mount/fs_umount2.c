@@ -35,6 +35,7 @@
 
 #include "inode/inode.h"
 #include "notify/notify.h"
+#include "writeback/writeback.h"
 
 /****************************************************************************
  * Public Functions
@@ -127,6 +128,12 @@ int nx_umount2(FAR const char *target, unsigned int flags)
       goto errout_with_lock;
     }
 
+#ifdef CONFIG_FS_WRITEBACK
+  /* Forget the dirty data accounting of the file system */
+
+  writeback_unmount(mountpt_inode);
+#endif
+
   /* Successfully unbound.  Convert the mountpoint inode to regular
    * pseudo-file inode.
    */
@@ -0,0 +1,1040 @@
+/****************************************************************************
+ * fs/pagecache/fs_pagecache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/mutex.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/fs/fs.h>
+
+#include "fs_heap.h"
+#include "pagecache/pagecache.h"
+
+#ifdef CONFIG_FS_PAGECACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define PAGECACHE_PAGESIZE  CONFIG_FS_PAGECACHE_PAGESIZE
+#define PAGECACHE_NPAGES    CONFIG_FS_PAGECACHE_NPAGES
+#define PAGECACHE_HASHSIZE  CONFIG_FS_PAGECACHE_HASHSIZE
+
+#if (PAGECACHE_PAGESIZE & (PAGECACHE_PAGESIZE - 1)) != 0
+#  error CONFIG_FS_PAGECACHE_PAGESIZE must be a power of two
+#endif
+
+#if (PAGECACHE_HASHSIZE & (PAGECACHE_HASHSIZE - 1)) != 0
+#  error CONFIG_FS_PAGECACHE_HASHSIZE must be a power of two
+#endif
+
+/* Page flags */
+
+#define PAGE_REFERENCED     (1 << 0) /* Used since the clock hand passed */
+#define PAGE_DIRTY          (1 << 1) /* Modified, not written back yet */
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One block device attached to the page cache */
+
+struct pagecache_s
+{
+  FAR struct pagecache_s *pc_flink;   /* Next attached device */
+  FAR struct inode *pc_inode;         /* The block driver inode */
+  blkcnt_t pc_nsectors;               /* Number of sectors on the device */
+  uint16_t pc_sectorsize;             /* Size of one sector */
+  uint16_t pc_secperpage;             /* Number of sectors in one page */
+  uint16_t pc_crefs;                  /* Number of pagecache_attach() */
+  uint32_t pc_nextpage;               /* Page a sequential reader reads next */
+  bool pc_changed;                    /* The medium was removed or changed */
+};
+
+/* One page of device data */
+
+struct pagecache_page_s
+{
+  FAR struct pagecache_page_s *pg_flink; /* Hash chain or free list link */
+  FAR struct pagecache_s *pg_pc;         /* Cached device, NULL if unused */
+  FAR uint8_t *pg_data;                  /* The page memory */
+  uint32_t pg_index;                     /* Page number on the device */
+  uint8_t pg_flags;                      /* See PAGE_* definitions */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Protects everything below and serializes the cached device I/O */
+
+static mutex_t g_pagecache_lock = NXMUTEX_INITIALIZER;
+
+/* The attached devices */
+
+static FAR struct pagecache_s *g_pagecache_devs;
+
+/* The page descriptors.  The first g_pagecache_nused have been used, those
+ * that were released since are on the free list.
+ */
+
+static struct pagecache_page_s g_pagecache_pages[PAGECACHE_NPAGES];
+static FAR struct pagecache_page_s *g_pagecache_free;
+static unsigned int g_pagecache_nused;
+
+/* The pages holding device data, hashed by device and page number */
+
+static FAR struct pagecache_page_s *g_pagecache_hash[PAGECACHE_HASHSIZE];
+
+/* The clock hand of the page replacement */
+
+static unsigned int g_pagecache_hand;
+
+/* Writes the dirty pages back */
+
+static struct work_s g_pagecache_work;
+
+static struct pagecache_stats_s g_pagecache_stats;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pagecache_hash
+ *
+ * Description:
+ *   Return the hash chain of a device page.
+ *
+ ****************************************************************************/
+
+static FAR struct pagecache_page_s **
+pagecache_hash(FAR struct pagecache_s *pc, uint32_t index)
+{
+  uint32_t hash = (uint32_t)((uintptr_t)pc >> 4) * 31 + index;
+
+  return &g_pagecache_hash[hash & (PAGECACHE_HASHSIZE - 1)];
+}
+
+/****************************************************************************
+ * Name: pagecache_find
+ *
+ * Description:
+ *   Find the cached copy of a device page.
+ *
+ ****************************************************************************/
+
+static FAR struct pagecache_page_s *
+pagecache_find(FAR struct pagecache_s *pc, uint32_t index)
+{
+  FAR struct pagecache_page_s *page;
+
+  for (page = *pagecache_hash(pc, index); page != NULL;
+       page = page->pg_flink)
+    {
+      if (page->pg_pc == pc && page->pg_index == index)
+        {
+          break;
+        }
+    }
+
+  return page;
+}
+
+/****************************************************************************
+ * Name: pagecache_unhash
+ *
+ * Description:
+ *   Remove a page from its hash chain.
+ *
+ ****************************************************************************/
+
+static void pagecache_unhash(FAR struct pagecache_page_s *page)
+{
+  FAR struct pagecache_page_s **link;
+
+  link = pagecache_hash(page->pg_pc, page->pg_index);
+  while (*link != page)
+    {
+      link = &(*link)->pg_flink;
+    }
+
+  *link = page->pg_flink;
+  page->pg_flink = NULL;
+}
+
+/****************************************************************************
+ * Name: pagecache_devio
+ *
+ * Description:
+ *   Transfer a whole page between the cache and the device.  The last page
+ *   of the device may be incomplete.
+ *
+ ****************************************************************************/
+
+static int pagecache_devio(FAR struct pagecache_page_s *page, bool write)
+{
+  FAR struct pagecache_s *pc = page->pg_pc;
+  FAR struct inode *inode = pc->pc_inode;
+  blkcnt_t sector = (blkcnt_t)page->pg_index * pc->pc_secperpage;
+  unsigned int nsectors = MIN(pc->pc_secperpage, pc->pc_nsectors - sector);
+  ssize_t ret;
+
+  if (write)
+    {
+      ret = inode->u.i_bops->write(inode, page->pg_data, sector, nsectors);
+    }
+  else
+    {
+      ret = inode->u.i_bops->read(inode, page->pg_data, sector, nsectors);
+    }
+
+  if (ret < 0)
+    {
+      ferr("ERROR: %s of page %" PRIu32 " failed: %zd\n",
+           write ? "Write" : "Read", page->pg_index, ret);
+      return ret;
+    }
+
+  return ret == nsectors ? OK : -EIO;
+}
+
+/****************************************************************************
+ * Name: pagecache_direct
+ *
+ * Description:
+ *   Access the device directly when no page can be had.
+ *
+ ****************************************************************************/
+
+static int pagecache_direct(FAR struct pagecache_s *pc, FAR uint8_t *buffer,
+                            blkcnt_t sector, unsigned int nsectors,
+                            bool write)
+{
+  FAR struct inode *inode = pc->pc_inode;
+  ssize_t ret;
+
+  if (write)
+    {
+      ret = inode->u.i_bops->write(inode, buffer, sector, nsectors);
+    }
+  else
+    {
+      ret = inode->u.i_bops->read(inode, buffer, sector, nsectors);
+    }
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  return ret == nsectors ? OK : -EIO;
+}
+
+/****************************************************************************
+ * Name: pagecache_release
+ *
+ * Description:
+ *   Drop a page, without writing it back, and free its memory.
+ *
+ ****************************************************************************/
+
+static void pagecache_release(FAR struct pagecache_page_s *page)
+{
+  pagecache_unhash(page);
+
+  if ((page->pg_flags & PAGE_DIRTY) != 0)
+    {
+      g_pagecache_stats.ndirty--;
+    }
+
+  fs_heap_free(page->pg_data);
+  memset(page, 0, sizeof(*page));
+
+  page->pg_flink   = g_pagecache_free;
+  g_pagecache_free = page;
+  g_pagecache_stats.npages--;
+}
+
+/****************************************************************************
+ * Name: pagecache_drop
+ *
+ * Description:
+ *   Drop all pages of a device without writing them back.
+ *
+ ****************************************************************************/
+
+static void pagecache_drop(FAR struct pagecache_s *pc)
+{
+  unsigned int i;
+
+  for (i = 0; i < g_pagecache_nused; i++)
+    {
+      if (g_pagecache_pages[i].pg_pc == pc)
+        {
+          pagecache_release(&g_pagecache_pages[i]);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: pagecache_checkmedia_locked
+ *
+ * Description:
+ *   Check that the medium of the device is still the one that was cached.
+ *   The pages of a removed or changed medium are dropped: its dirty data
+ *   must not reach the new medium.  The block driver reports a change only
+ *   once, so the cache remembers it for the file systems.
+ *
+ ****************************************************************************/
+
+static int pagecache_checkmedia_locked(FAR struct pagecache_s *pc)
+{
+  FAR struct inode *inode = pc->pc_inode;
+  struct geometry geo;
+
+  if (!pc->pc_changed &&
+      inode->u.i_bops->geometry(inode, &geo) >= 0 &&
+      geo.geo_available && !geo.geo_mediachanged)
+    {
+      return OK;
+    }
+
+  if (!pc->pc_changed)
+    {
+      ferr("ERROR: Medium removed or changed, dropping its pages\n");
+      pc->pc_changed = true;
+      pagecache_drop(pc);
+    }
+
+  return -ENODEV;
+}
+
+/****************************************************************************
+ * Name: pagecache_writeback
+ *
+ * Description:
+ *   Write a dirty page back to the device.
+ *
+ ****************************************************************************/
+
+static int pagecache_writeback(FAR struct pagecache_page_s *page)
+{
+  int ret;
+
+  ret = pagecache_checkmedia_locked(page->pg_pc);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = pagecache_devio(page, true);
+  if (ret >= 0)
+    {
+      page->pg_flags &= ~PAGE_DIRTY;
+      g_pagecache_stats.ndirty--;
+      g_pagecache_stats.writebacks++;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pagecache_evict
+ *
+ * Description:
+ *   Take the memory of the least recently used page, writing it back
+ *   first if necessary.  The hand sweeps the pages, giving a second chance
+ *   to those used since it last passed.
+ *
+ ****************************************************************************/
+
+static FAR struct pagecache_page_s *pagecache_evict(void)
+{
+  FAR struct pagecache_page_s *page;
+  unsigned int i;
+
+  for (i = 0; i < 2 * g_pagecache_nused; i++)
+    {
+      page = &g_pagecache_pages[g_pagecache_hand];
+      if (++g_pagecache_hand >= g_pagecache_nused)
+        {
+          g_pagecache_hand = 0;
+        }
+
+      if (page->pg_pc == NULL)
+        {
+          continue;
+        }
+
+      if ((page->pg_flags & PAGE_REFERENCED) != 0)
+        {
+          page->pg_flags &= ~PAGE_REFERENCED;
+          continue;
+        }
+
+      if ((page->pg_flags & PAGE_DIRTY) != 0 &&
+          pagecache_writeback(page) < 0)
+        {
+          continue;
+        }
+
+      pagecache_unhash(page);
+      page->pg_pc = NULL;
+      g_pagecache_stats.npages--;
+      g_pagecache_stats.evictions++;
+      return page;
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: pagecache_alloc
+ *
+ * Description:
+ *   Allocate a page for a device page that is not cached.  The page
+ *   content is undefined.
+ *
+ ****************************************************************************/
+
+static FAR struct pagecache_page_s *
+pagecache_alloc(FAR struct pagecache_s *pc, uint32_t index)
+{
+  FAR struct pagecache_page_s **link;
+  FAR struct pagecache_page_s *page;
+
+  /* Use a new page while the bound and the heap allow it */
+
+  page = g_pagecache_free;
+  if (page != NULL)
+    {
+      g_pagecache_free = page->pg_flink;
+    }
+  else if (g_pagecache_nused < PAGECACHE_NPAGES)
+    {
+      page = &g_pagecache_pages[g_pagecache_nused++];
+    }
+
+  if (page != NULL)
+    {
+      page->pg_data = fs_heap_malloc(PAGECACHE_PAGESIZE);
+      if (page->pg_data == NULL)
+        {
+          page->pg_flink   = g_pagecache_free;
+          g_pagecache_free = page;
+          page             = NULL;
+        }
+    }
+
+  /* Otherwise recycle the least recently used one */
+
+  if (page == NULL)
+    {
+      page = pagecache_evict();
+      if (page == NULL)
+        {
+          return NULL;
+        }
+    }
+
+  link           = pagecache_hash(pc, index);
+  page->pg_pc    = pc;
+  page->pg_index = index;
+  page->pg_flags = PAGE_REFERENCED;
+  page->pg_flink = *link;
+  *link          = page;
+
+  g_pagecache_stats.npages++;
+  return page;
+}
+
+/****************************************************************************
+ * Name: pagecache_get
+ *
+ * Description:
+ *   Return the page holding a device page, reading it from the device if
+ *   requested.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOMEM if no page is available, or the error of
+ *   the device read.
+ *
+ ****************************************************************************/
+
+static int pagecache_get(FAR struct pagecache_s *pc, uint32_t index,
+                         bool fill, FAR struct pagecache_page_s **ppage)
+{
+  FAR struct pagecache_page_s *page;
+  int ret;
+
+  page = pagecache_find(pc, index);
+  if (page != NULL)
+    {
+      page->pg_flags |= PAGE_REFERENCED;
+      g_pagecache_stats.hits++;
+      *ppage = page;
+      return OK;
+    }
+
+  page = pagecache_alloc(pc, index);
+  if (page == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  if (fill)
+    {
+      g_pagecache_stats.misses++;
+
+      ret = pagecache_devio(page, false);
+      if (ret < 0)
+        {
+          pagecache_release(page);
+          return ret;
+        }
+    }
+
+  *ppage = page;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pagecache_readahead
+ *
+ * Description:
+ *   Read the pages following a sequential read.  They are not marked as
+ *   referenced so that they go first if the reader stops.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_PAGECACHE_READAHEAD > 0
+static void pagecache_readahead(FAR struct pagecache_s *pc, uint32_t index)
+{
+  FAR struct pagecache_page_s *page;
+  int i;
+
+  for (i = 0; i < CONFIG_FS_PAGECACHE_READAHEAD; i++, index++)
+    {
+      if ((blkcnt_t)index * pc->pc_secperpage >= pc->pc_nsectors)
+        {
+          break;
+        }
+
+      if (pagecache_find(pc, index) != NULL)
+        {
+          continue;
+        }
+
+      page = pagecache_alloc(pc, index);
+      if (page == NULL)
+        {
+          break;
+        }
+
+      if (pagecache_devio(page, false) < 0)
+        {
+          pagecache_release(page);
+          break;
+        }
+
+      page->pg_flags &= ~PAGE_REFERENCED;
+      g_pagecache_stats.readahead++;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: pagecache_flush_locked
+ *
+ * Description:
+ *   Write back the dirty pages of one device, or of all devices.
+ *
+ ****************************************************************************/
+
+static int pagecache_flush_locked(FAR struct pagecache_s *pc)
+{
+  FAR struct pagecache_page_s *page;
+  unsigned int i;
+  int ret = OK;
+  int err;
+
+  for (i = 0; i < g_pagecache_nused && g_pagecache_stats.ndirty > 0; i++)
+    {
+      page = &g_pagecache_pages[i];
+      if (page->pg_pc != NULL && (pc == NULL || page->pg_pc == pc) &&
+          (page->pg_flags & PAGE_DIRTY) != 0)
+        {
+          err = pagecache_writeback(page);
+          if (err < 0 && ret == OK)
+            {
+              ret = err;
+            }
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pagecache_worker
+ *
+ * Description:
+ *   Write back the dirty pages.  Pages that could not be written are tried
+ *   again later.
+ *
+ ****************************************************************************/
+
+static void pagecache_worker(FAR void *arg)
+{
+  if (nxmutex_lock(&g_pagecache_lock) < 0)
+    {
+      return;
+    }
+
+  pagecache_flush_locked(NULL);
+
+  if (g_pagecache_stats.ndirty > 0)
+    {
+      work_queue(LPWORK, &g_pagecache_work, pagecache_worker, NULL,
+                 MSEC2TICK(CONFIG_FS_PAGECACHE_WBDELAY));
+    }
+
+  nxmutex_unlock(&g_pagecache_lock);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pagecache_attach
+ *
+ * Description:
+ *   Start caching a block device.  A device mounted more than once shares
+ *   one set of pages.
+ *
+ * Input Parameters:
+ *   inode - The block driver inode.
+ *
+ * Returned Value:
+ *   The cache handle, or NULL if the device cannot be cached (its sector
+ *   size does not divide CONFIG_FS_PAGECACHE_PAGESIZE, or no memory); the
+ *   caller then accesses the device directly.
+ *
+ ****************************************************************************/
+
+FAR struct pagecache_s *pagecache_attach(FAR struct inode *inode)
+{
+  FAR struct pagecache_s *pc;
+  struct geometry geo;
+
+  DEBUGASSERT(inode != NULL && inode->u.i_bops != NULL);
+
+  if (inode->u.i_bops->geometry == NULL ||
+      inode->u.i_bops->geometry(inode, &geo) < 0 ||
+      !geo.geo_available || geo.geo_sectorsize == 0 ||
+      geo.geo_sectorsize > PAGECACHE_PAGESIZE ||
+      PAGECACHE_PAGESIZE % geo.geo_sectorsize != 0)
+    {
+      return NULL;
+    }
+
+  if (nxmutex_lock(&g_pagecache_lock) < 0)
+    {
+      return NULL;
+    }
+
+  /* A new medium is not cached with the pages of the old one */
+
+  for (pc = g_pagecache_devs; pc != NULL; pc = pc->pc_flink)
+    {
+      if (pc->pc_inode == inode && !pc->pc_changed)
+        {
+          pc->pc_crefs++;
+          goto out;
+        }
+    }
+
+  pc = fs_heap_zalloc(sizeof(struct pagecache_s));
+  if (pc != NULL)
+    {
+      pc->pc_inode      = inode;
+      pc->pc_nsectors   = geo.geo_nsectors;
+      pc->pc_sectorsize = geo.geo_sectorsize;
+      pc->pc_secperpage = PAGECACHE_PAGESIZE / geo.geo_sectorsize;
+      pc->pc_crefs      = 1;
+      pc->pc_flink      = g_pagecache_devs;
+      g_pagecache_devs  = pc;
+    }
+
+out:
+  nxmutex_unlock(&g_pagecache_lock);
+  return pc;
+}
+
+/****************************************************************************
+ * Name: pagecache_detach
+ *
+ * Description:
+ *   Write back the dirty pages of the device and drop the reference taken
+ *   by pagecache_attach().  The pages are released with the last one.
+ *
+ * Input Parameters:
+ *   pc - The cache handle.
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  A negated errno value if a dirty page could not
+ *   be written back; the pages and the reference are kept then, so that
+ *   the caller can try again or call pagecache_invalidate() first.
+ *
+ ****************************************************************************/
+
+int pagecache_detach(FAR struct pagecache_s *pc)
+{
+  FAR struct pagecache_s **link;
+  int ret;
+
+  DEBUGASSERT(pc != NULL && pc->pc_crefs > 0);
+
+  ret = nxmutex_lock(&g_pagecache_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = pagecache_flush_locked(pc);
+  if (ret < 0 && !pc->pc_changed)
+    {
+      goto out;
+    }
+
+  /* The pages of a removed medium were dropped already */
+
+  ret = OK;
+  if (--pc->pc_crefs == 0)
+    {
+      pagecache_drop(pc);
+
+      for (link = &g_pagecache_devs; *link != pc;
+           link = &(*link)->pc_flink)
+        {
+        }
+
+      *link = pc->pc_flink;
+      fs_heap_free(pc);
+    }
+
+out:
+  nxmutex_unlock(&g_pagecache_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pagecache_invalidate
+ *
+ * Description:
+ *   Drop the pages of the device without writing them back.
+ *
+ * Input Parameters:
+ *   pc - The cache handle.
+ *
+ ****************************************************************************/
+
+void pagecache_invalidate(FAR struct pagecache_s *pc)
+{
+  nxmutex_lock(&g_pagecache_lock);
+  pagecache_drop(pc);
+  nxmutex_unlock(&g_pagecache_lock);
+}
+
+/****************************************************************************
+ * Name: pagecache_checkmedia
+ *
+ * Description:
+ *   Check that the medium of the device has not been removed or changed
+ *   since it was attached.  The pages of a removed or changed medium are
+ *   dropped without being written back.  File systems call this instead of
+ *   checking the geometry themselves: the block driver reports a change
+ *   only once and the cache may have seen it first.
+ *
+ * Input Parameters:
+ *   pc - The cache handle.
+ *
+ * Returned Value:
+ *   Zero (OK) if the medium is unchanged; -ENODEV otherwise.
+ *
+ ****************************************************************************/
+
+int pagecache_checkmedia(FAR struct pagecache_s *pc)
+{
+  int ret;
+
+  ret = nxmutex_lock(&g_pagecache_lock);
+  if (ret >= 0)
+    {
+      ret = pagecache_checkmedia_locked(pc);
+      nxmutex_unlock(&g_pagecache_lock);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pagecache_read
+ *
+ * Description:
+ *   Read sectors of the device through the page cache.
+ *
+ * Input Parameters:
+ *   pc       - The cache handle.
+ *   buffer   - Location to return the data.
+ *   sector   - First sector to read.
+ *   nsectors - Number of sectors to read.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int pagecache_read(FAR struct pagecache_s *pc, FAR uint8_t *buffer,
+                   blkcnt_t sector, unsigned int nsectors)
+{
+  FAR struct pagecache_page_s *page;
+  unsigned int offset;
+  unsigned int count;
+  uint32_t index;
+  bool sequential;
+  int ret;
+
+  ret = nxmutex_lock(&g_pagecache_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (pc->pc_changed)
+    {
+      ret = -ENODEV;
+      goto out;
+    }
+
+  index      = sector / pc->pc_secperpage;
+  sequential = index == pc->pc_nextpage;
+
+  while (nsectors > 0)
+    {
+      index  = sector / pc->pc_secperpage;
+      offset = sector % pc->pc_secperpage;
+      count  = MIN(nsectors, pc->pc_secperpage - offset);
+
+      ret = pagecache_get(pc, index, true, &page);
+      if (ret == -ENOMEM)
+        {
+          ret = pagecache_direct(pc, buffer, sector, count, false);
+        }
+      else if (ret >= 0)
+        {
+          memcpy(buffer, page->pg_data + offset * pc->pc_sectorsize,
+                 count * pc->pc_sectorsize);
+        }
+
+      if (ret < 0)
+        {
+          goto out;
+        }
+
+      buffer   += count * pc->pc_sectorsize;
+      sector   += count;
+      nsectors -= count;
+    }
+
+  pc->pc_nextpage = index + 1;
+
+#if CONFIG_FS_PAGECACHE_READAHEAD > 0
+  if (sequential)
+    {
+      pagecache_readahead(pc, index + 1);
+    }
+#endif
+
+out:
+  nxmutex_unlock(&g_pagecache_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pagecache_write
+ *
+ * Description:
+ *   Write sectors of the device into the page cache.  The data reaches the
+ *   device after CONFIG_FS_PAGECACHE_WBDELAY milliseconds at the latest,
+ *   or on pagecache_flush().
+ *
+ * Input Parameters:
+ *   pc       - The cache handle.
+ *   buffer   - The data to write.
+ *   sector   - First sector to write.
+ *   nsectors - Number of sectors to write.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int pagecache_write(FAR struct pagecache_s *pc, FAR const uint8_t *buffer,
+                    blkcnt_t sector, unsigned int nsectors)
+{
+  FAR struct pagecache_page_s *page;
+  unsigned int offset;
+  unsigned int count;
+  uint32_t index;
+  bool whole;
+  int ret;
+
+  if (pc->pc_inode->u.i_bops->write == NULL)
+    {
+      return -ENODEV;
+    }
+
+  ret = nxmutex_lock(&g_pagecache_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (pc->pc_changed)
+    {
+      nxmutex_unlock(&g_pagecache_lock);
+      return -ENODEV;
+    }
+
+  while (nsectors > 0)
+    {
+      index  = sector / pc->pc_secperpage;
+      offset = sector % pc->pc_secperpage;
+      count  = MIN(nsectors, pc->pc_secperpage - offset);
+
+      /* No need to read a page that is overwritten completely */
+
+      whole = offset == 0 &&
+              (count == pc->pc_secperpage ||
+               sector + count >= pc->pc_nsectors);
+
+      ret = pagecache_get(pc, index, !whole, &page);
+      if (ret == -ENOMEM)
+        {
+          ret = pagecache_direct(pc, (FAR uint8_t *)buffer, sector, count,
+                                 true);
+        }
+      else if (ret >= 0)
+        {
+          memcpy(page->pg_data + offset * pc->pc_sectorsize, buffer,
+                 count * pc->pc_sectorsize);
+
+          if ((page->pg_flags & PAGE_DIRTY) == 0)
+            {
+              page->pg_flags |= PAGE_DIRTY;
+              g_pagecache_stats.ndirty++;
+            }
+        }
+
+      if (ret < 0)
+        {
+          break;
+        }
+
+      buffer   += count * pc->pc_sectorsize;
+      sector   += count;
+      nsectors -= count;
+    }
+
+  /* Start the write back timer */
+
+  if (g_pagecache_stats.ndirty > 0 && work_available(&g_pagecache_work))
+    {
+      work_queue(LPWORK, &g_pagecache_work, pagecache_worker, NULL,
+                 MSEC2TICK(CONFIG_FS_PAGECACHE_WBDELAY));
+    }
+
+  nxmutex_unlock(&g_pagecache_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pagecache_flush
+ *
+ * Description:
+ *   Write back the dirty pages of a device.
+ *
+ * Input Parameters:
+ *   pc - The cache handle, or NULL to write back all devices.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value if a write back failed.
+ *
+ ****************************************************************************/
+
+int pagecache_flush(FAR struct pagecache_s *pc)
+{
+  int ret;
+
+  ret = nxmutex_lock(&g_pagecache_lock);
+  if (ret >= 0)
+    {
+      ret = pagecache_flush_locked(pc);
+      nxmutex_unlock(&g_pagecache_lock);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pagecache_getstats
+ *
+ * Description:
+ *   Return a snapshot of the page cache statistics.
+ *
+ ****************************************************************************/
+
+void pagecache_getstats(FAR struct pagecache_stats_s *stats)
+{
+  nxmutex_lock(&g_pagecache_lock);
+  memcpy(stats, &g_pagecache_stats, sizeof(*stats));
+  nxmutex_unlock(&g_pagecache_lock);
+}
+
+#endif /* CONFIG_FS_PAGECACHE */
@@ -0,0 +1,283 @@
+/****************************************************************************
+ * fs/pagecache/fs_procfspagecache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "fs_heap.h"
+#include "pagecache/pagecache.h"
+
+#if defined(CONFIG_FS_PAGECACHE) && defined(CONFIG_FS_PROCFS) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_PAGECACHE)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define PAGECACHE_LINELEN 80
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct pagecache_file_s
+{
+  struct procfs_file_s base;      /* Base open file structure */
+  char line[PAGECACHE_LINELEN];   /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     pagecache_open(FAR struct file *filep,
+                 FAR const char *relpath, int oflags, mode_t mode);
+static int     pagecache_close(FAR struct file *filep);
+static ssize_t pagecache_procread(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     pagecache_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     pagecache_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_procfs.c -- this structure is explicitly externed there. */
+
+const struct procfs_operations g_pagecache_operations =
+{
+  pagecache_open,      /* open */
+  pagecache_close,     /* close */
+  pagecache_procread,  /* read */
+  NULL,                /* write */
+  NULL,                /* poll */
+  pagecache_dup,       /* dup */
+  NULL,                /* opendir */
+  NULL,                /* closedir */
+  NULL,                /* readdir */
+  NULL,                /* rewinddir */
+  pagecache_stat       /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pagecache_open
+ ****************************************************************************/
+
+static int pagecache_open(FAR struct file *filep, FAR const char *relpath,
+                          int oflags, mode_t mode)
+{
+  FAR struct pagecache_file_s *procfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  procfile = fs_heap_zalloc(sizeof(struct pagecache_file_s));
+  if (!procfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = procfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pagecache_close
+ ****************************************************************************/
+
+static int pagecache_close(FAR struct file *filep)
+{
+  FAR struct pagecache_file_s *procfile = filep->f_priv;
+
+  DEBUGASSERT(procfile);
+
+  /* Release the file attributes structure */
+
+  fs_heap_free(procfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pagecache_procread
+ ****************************************************************************/
+
+static ssize_t pagecache_procread(FAR struct file *filep, FAR char *buffer,
+                                  size_t buflen)
+{
+  FAR struct pagecache_file_s *procfile = filep->f_priv;
+  struct pagecache_stats_s stats;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  off_t offset;
+
+  DEBUGASSERT(procfile && buffer != NULL && buflen > 0);
+  offset = filep->f_pos;
+
+  /* The first line is the page usage */
+
+  linesize  = procfs_snprintf(procfile->line, PAGECACHE_LINELEN,
+                              "%10s%10s%10s%10s\n",
+                              "pagesize", "maxpages", "nused", "ndirty");
+  copysize  = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                            &offset);
+  totalsize = copysize;
+  buffer   += copysize;
+  buflen   -= copysize;
+
+  pagecache_getstats(&stats);
+  linesize   = procfs_snprintf(procfile->line, PAGECACHE_LINELEN,
+                               "%10d%10d%10u%10u\n",
+                               CONFIG_FS_PAGECACHE_PAGESIZE,
+                               CONFIG_FS_PAGECACHE_NPAGES,
+                               stats.npages, stats.ndirty);
+  copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                             &offset);
+  totalsize += copysize;
+  buffer    += copysize;
+  buflen    -= copysize;
+
+  /* Then the counters */
+
+  linesize   = procfs_snprintf(procfile->line, PAGECACHE_LINELEN,
+                               "%10s%10s%10s%10s%10s\n",
+                               "hits", "misses", "readahead", "writeback",
+                               "evicted");
+  copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                             &offset);
+  totalsize += copysize;
+  buffer    += copysize;
+  buflen    -= copysize;
+
+  linesize   = procfs_snprintf(procfile->line, PAGECACHE_LINELEN,
+                               "%10" PRIu32 "%10" PRIu32 "%10" PRIu32
+                               "%10" PRIu32 "%10" PRIu32 "\n",
+                               stats.hits, stats.misses, stats.readahead,
+                               stats.writebacks, stats.evictions);
+  copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                             &offset);
+  totalsize += copysize;
+
+  /* Update the file offset */
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: pagecache_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int pagecache_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct pagecache_file_s *oldattr = oldp->f_priv;
+  FAR struct pagecache_file_s *newattr;
+
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the attributes */
+
+  newattr = fs_heap_malloc(sizeof(struct pagecache_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct pagecache_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pagecache_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int pagecache_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "fs/pagecache" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* CONFIG_FS_PAGECACHE && CONFIG_FS_PROCFS &&
+        * !CONFIG_FS_PROCFS_EXCLUDE_PAGECACHE */
@@ -0,0 +1,204 @@
+/****************************************************************************
+ * fs/pagecache/pagecache.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __FS_PAGECACHE_PAGECACHE_H
+#define __FS_PAGECACHE_PAGECACHE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#include <nuttx/fs/fs.h>
+
+#ifdef CONFIG_FS_PAGECACHE
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+/* One block device attached to the page cache (opaque) */
+
+struct pagecache_s;
+
+/* Page cache statistics, as reported in /proc/fs/pagecache */
+
+struct pagecache_stats_s
+{
+  uint32_t hits;        /* Page lookups satisfied from the cache */
+  uint32_t misses;      /* Page lookups that read the device */
+  uint32_t readahead;   /* Pages read ahead of a sequential reader */
+  uint32_t writebacks;  /* Dirty pages written to the device */
+  uint32_t evictions;   /* Pages recycled for another device sector */
+  uint16_t npages;      /* Pages currently holding device data */
+  uint16_t ndirty;      /* Pages not yet written back */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pagecache_attach
+ *
+ * Description:
+ *   Start caching a block device.  A device mounted more than once shares
+ *   one set of pages.
+ *
+ * Input Parameters:
+ *   inode - The block driver inode.
+ *
+ * Returned Value:
+ *   The cache handle, or NULL if the device cannot be cached (its sector
+ *   size does not divide CONFIG_FS_PAGECACHE_PAGESIZE, or no memory); the
+ *   caller then accesses the device directly.
+ *
+ ****************************************************************************/
+
+FAR struct pagecache_s *pagecache_attach(FAR struct inode *inode);
+
+/****************************************************************************
+ * Name: pagecache_detach
+ *
+ * Description:
+ *   Write back the dirty pages of the device and drop the reference taken
+ *   by pagecache_attach().  The pages are released with the last one.
+ *
+ * Input Parameters:
+ *   pc - The cache handle.
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  A negated errno value if a dirty page could not
+ *   be written back; the pages and the reference are kept then, so that
+ *   the caller can try again or call pagecache_invalidate() first.
+ *
+ ****************************************************************************/
+
+int pagecache_detach(FAR struct pagecache_s *pc);
+
+/****************************************************************************
+ * Name: pagecache_invalidate
+ *
+ * Description:
+ *   Drop the pages of the device without writing them back.
+ *
+ * Input Parameters:
+ *   pc - The cache handle.
+ *
+ ****************************************************************************/
+
+void pagecache_invalidate(FAR struct pagecache_s *pc);
+
+/****************************************************************************
+ * Name: pagecache_checkmedia
+ *
+ * Description:
+ *   Check that the medium of the device has not been removed or changed
+ *   since it was attached.  The pages of a removed or changed medium are
+ *   dropped without being written back.  File systems call this instead of
+ *   checking the geometry themselves: the block driver reports a change
+ *   only once and the cache may have seen it first.
+ *
+ * Input Parameters:
+ *   pc - The cache handle.
+ *
+ * Returned Value:
+ *   Zero (OK) if the medium is unchanged; -ENODEV otherwise.
+ *
+ ****************************************************************************/
+
+int pagecache_checkmedia(FAR struct pagecache_s *pc);
+
+/****************************************************************************
+ * Name: pagecache_read
+ *
+ * Description:
+ *   Read sectors of the device through the page cache.
+ *
+ * Input Parameters:
+ *   pc       - The cache handle.
+ *   buffer   - Location to return the data.
+ *   sector   - First sector to read.
+ *   nsectors - Number of sectors to read.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int pagecache_read(FAR struct pagecache_s *pc, FAR uint8_t *buffer,
+                   blkcnt_t sector, unsigned int nsectors);
+
+/****************************************************************************
+ * Name: pagecache_write
+ *
+ * Description:
+ *   Write sectors of the device into the page cache.  The data reaches the
+ *   device after CONFIG_FS_PAGECACHE_WBDELAY milliseconds at the latest,
+ *   or on pagecache_flush().
+ *
+ * Input Parameters:
+ *   pc       - The cache handle.
+ *   buffer   - The data to write.
+ *   sector   - First sector to write.
+ *   nsectors - Number of sectors to write.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int pagecache_write(FAR struct pagecache_s *pc, FAR const uint8_t *buffer,
+                    blkcnt_t sector, unsigned int nsectors);
+
+/****************************************************************************
+ * Name: pagecache_flush
+ *
+ * Description:
+ *   Write back the dirty pages of a device.
+ *
+ * Input Parameters:
+ *   pc - The cache handle, or NULL to write back all devices.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value if a write back failed.
+ *
+ ****************************************************************************/
+
+int pagecache_flush(FAR struct pagecache_s *pc);
+
+/****************************************************************************
+ * Name: pagecache_getstats
+ *
+ * Description:
+ *   Return a snapshot of the page cache statistics.
+ *
+ ****************************************************************************/
+
+void pagecache_getstats(FAR struct pagecache_stats_s *stats);
+
+#endif /* CONFIG_FS_PAGECACHE */
+#endif /* __FS_PAGECACHE_PAGECACHE_H */
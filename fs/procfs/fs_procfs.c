@@ -83,6 +83,8 @@ extern const struct procfs_operations g_pressure_operations;
  */
 
 extern const struct procfs_operations g_mount_operations;
+extern const struct procfs_operations g_pagecache_operations;
+extern const struct procfs_operations g_writeback_operations;
 extern const struct procfs_operations g_net_operations;
 extern const struct procfs_operations g_netroute_operations;
 extern const struct procfs_operations g_part_operations;
@@ -138,6 +140,11 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "fs/mount",     &g_mount_operations,    PROCFS_FILE_TYPE   },
 #endif
 
+#if defined(CONFIG_FS_PAGECACHE) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_PAGECACHE)
+  { "fs/pagecache", &g_pagecache_operations, PROCFS_FILE_TYPE  },
+#endif
+
 #if defined(CONFIG_FS_SMARTFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
   { "fs/smartfs**", &g_smartfs_procfs_operations,  PROCFS_UNKOWN_TYPE },
 #endif
@@ -146,6 +153,11 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "fs/usage",     &g_mount_operations,    PROCFS_FILE_TYPE   },
 #endif
 
+#if defined(CONFIG_FS_WRITEBACK) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_WRITEBACK)
+  { "fs/writeback", &g_writeback_operations, PROCFS_FILE_TYPE  },
+#endif
+
 #if defined(CONFIG_MM_IOB) && !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
   { "iobinfo",      &g_iobinfo_operations,  PROCFS_FILE_TYPE   },
 #endif
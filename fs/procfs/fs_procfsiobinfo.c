@@ -30,6 +30,7 @@
 #include <sys/stat.h>
 
 #include <stdint.h>
+#include <inttypes.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -183,6 +184,10 @@ static ssize_t iobinfo_read(FAR struct file *filep, FAR char *buffer,
 {
   FAR struct iobinfo_file_s *iobfile;
   FAR struct iob_stats_s stats;
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  struct iob_cachestats_s cstats;
+  int cpu;
+#endif
   size_t linesize;
   size_t copysize;
   size_t totalsize;
@@ -223,6 +228,60 @@ static ssize_t iobinfo_read(FAR struct file *filep, FAR char *buffer,
                              &offset);
   totalsize += copysize;
 
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+  /* Then the usage of the large I/O buffers */
+
+  buffer    += copysize;
+  buflen    -= copysize;
+
+  linesize   = procfs_snprintf(iobfile->line, IOBINFO_LINELEN,
+                               "%10s%10s\n", "nlarge", "nlargefree");
+  copysize   = procfs_memcpy(iobfile->line, linesize, buffer, buflen,
+                             &offset);
+  totalsize += copysize;
+  buffer    += copysize;
+  buflen    -= copysize;
+
+  linesize   = procfs_snprintf(iobfile->line, IOBINFO_LINELEN,
+                               "%10d%10d\n",
+                               stats.nlarge_total, stats.nlarge_free);
+  copysize   = procfs_memcpy(iobfile->line, linesize, buffer, buflen,
+                             &offset);
+  totalsize += copysize;
+#endif
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  /* Then the usage of the per-CPU caches */
+
+  buffer    += copysize;
+  buflen    -= copysize;
+
+  linesize   = procfs_snprintf(iobfile->line, IOBINFO_LINELEN,
+                               "%10s%10s%10s%10s%10s\n",
+                               "cpu", "ncached", "nhit", "nrefill",
+                               "nspill");
+  copysize   = procfs_memcpy(iobfile->line, linesize, buffer, buflen,
+                             &offset);
+  totalsize += copysize;
+  buffer    += copysize;
+  buflen    -= copysize;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      iob_getcachestats(cpu, &cstats);
+      linesize   = procfs_snprintf(iobfile->line, IOBINFO_LINELEN,
+                                   "%10d%10d%10" PRIu32 "%10" PRIu32
+                                   "%10" PRIu32 "\n",
+                                   cpu, cstats.ncached, cstats.nhit,
+                                   cstats.nrefill, cstats.nspill);
+      copysize   = procfs_memcpy(iobfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+      buffer    += copysize;
+      buflen    -= copysize;
+    }
+#endif
+
   /* Update the file offset */
 
   filep->f_pos += totalsize;
@@ -1149,6 +1149,13 @@ errout_with_buffer:
       fs_heap_free(rm->rm_buffer);
     }
 
+#ifdef CONFIG_FS_ROMFS_PAGECACHE
+  if (rm->rm_pagecache != NULL)
+    {
+      pagecache_detach(rm->rm_pagecache);
+    }
+#endif
+
 errout_with_mount:
   nxrmutex_destroy(&rm->rm_lock);
   fs_heap_free(rm);
@@ -1240,6 +1247,13 @@ static int romfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
           fs_heap_free(rm->rm_buffer);
         }
 
+#ifdef CONFIG_FS_ROMFS_PAGECACHE
+      if (rm->rm_pagecache != NULL)
+        {
+          pagecache_detach(rm->rm_pagecache);
+        }
+#endif
+
 #ifdef CONFIG_FS_ROMFS_CACHE_NODE
       romfs_freenode(rm->rm_root);
 #endif
@@ -33,6 +33,7 @@
 #include <stdbool.h>
 
 #include "inode/inode.h"
+#include "pagecache/pagecache.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -61,6 +62,21 @@
 #define ROMFS_FHDR_NAME    16  /* 16-..: Zero terminated volume name, padded
                                 *        to 16 byte boundary. */
 
+/* Sorted directory index (multi-byte values are big-endian).  This is a
+ * NuttX extension of the format.  The index of a directory is stored as the
+ * data of its "." entry, which other readers ignore because "." is a hard
+ * link (or, in the root directory, a directory).  It lists the offsets of
+ * the file headers of the directory, except "." and "..", in the order of
+ * their names as compared by memcmp().
+ */
+
+#define ROMFS_IDX_MAGIC     0  /*  0-3:  "RIDX" */
+#define ROMFS_IDX_COUNT     4  /*  4-7:  Number of entries */
+#define ROMFS_IDX_ENTRY     8  /*  8-..: Offsets of the file headers */
+
+#define ROMFS_IDX_MAGICSTR  "RIDX"
+#define ROMFS_IDX_MAGICLEN  4
+
 /* Bits 0-3 of the rf_next offset provide mode information.  These are the
  * values specified in
  */
@@ -141,6 +157,9 @@ struct romfs_mountpt_s
   uint32_t rm_cachesector;        /* Current sector in the rm_buffer */
   FAR uint8_t *rm_xipbase;        /* Base address of directly accessible media */
   FAR uint8_t *rm_buffer;         /* Device sector buffer, allocated if rm_xipbase==0 */
+#ifdef CONFIG_FS_ROMFS_PAGECACHE
+  FAR struct pagecache_s *rm_pagecache; /* Page cache of the block driver, if any */
+#endif
 };
 
 /* This structure represents on open file under the mountpoint.  An instance
@@ -169,6 +188,7 @@ struct romfs_nodeinfo_s
   FAR struct romfs_nodeinfo_s **rn_child;  /* The node array for link to lower level */
   uint16_t rn_count;                       /* The count of node in rn_child level */
   uint8_t  rn_namesize;                    /* The length of name of the entry */
+  bool     rn_cached;                      /* rn_child holds the directory entries */
   char     rn_name[1];                     /* The name to the entry */
 #endif
 };
@@ -266,6 +266,150 @@ static int romfs_followhardlinks(FAR struct romfs_mountpt_s *rm,
   return -ELOOP;
 }
 
+/****************************************************************************
+ * Name: romfs_findindex
+ *
+ * Description:
+ *   Check if the directory whose first entry is at offset has a sorted
+ *   index.  The index is the data of the "." entry.
+ *
+ * Return value:
+ *   < 0  :  An error occurred
+ *     0  :  The directory has no index
+ *     1  :  pindex and pcount are the offset and size of the index
+ *
+ ****************************************************************************/
+
+static int romfs_findindex(FAR struct romfs_mountpt_s *rm, uint32_t offset,
+                           FAR uint32_t *pindex, FAR uint32_t *pcount)
+{
+  uint32_t next;
+  uint32_t size;
+  uint32_t count;
+  int16_t  ndx;
+
+  ndx = romfs_devcacheread(rm, offset);
+  if (ndx < 0)
+    {
+      return ndx;
+    }
+
+  next = romfs_devread32(rm, ndx + ROMFS_FHDR_NEXT);
+  size = romfs_devread32(rm, ndx + ROMFS_FHDR_SIZE);
+  if ((!IS_HARDLINK(next) && !IS_DIRECTORY(next)) || size < ROMFS_IDX_ENTRY)
+    {
+      return 0;
+    }
+
+  ndx = romfs_devcacheread(rm, offset + ROMFS_FHDR_NAME);
+  if (ndx < 0)
+    {
+      return ndx;
+    }
+
+  if (memcmp(&rm->rm_buffer[ndx], ".", 2) != 0)
+    {
+      return 0;
+    }
+
+  /* The name "." fits in one 16-byte chunk, the data follows it */
+
+  offset += ROMFS_FHDR_NAME + ROMFS_ALIGNMENT;
+  ndx = romfs_devcacheread(rm, offset);
+  if (ndx < 0)
+    {
+      return ndx;
+    }
+
+  if (memcmp(&rm->rm_buffer[ndx + ROMFS_IDX_MAGIC], ROMFS_IDX_MAGICSTR,
+             ROMFS_IDX_MAGICLEN) != 0)
+    {
+      return 0;
+    }
+
+  count = romfs_devread32(rm, ndx + ROMFS_IDX_COUNT);
+  if ((size - ROMFS_IDX_ENTRY) / 4 != count ||
+      offset + size > rm->rm_volsize)
+    {
+      return 0;
+    }
+
+  *pindex = offset;
+  *pcount = count;
+  return 1;
+}
+
+/****************************************************************************
+ * Name: romfs_searchindex
+ *
+ * Description:
+ *   Binary search the sorted index of a directory for entryname.  The
+ *   names are compared in place, so nothing is allocated.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_FS_ROMFS_CACHE_NODE
+static int romfs_searchindex(FAR struct romfs_mountpt_s *rm,
+                             uint32_t index, uint32_t count,
+                             FAR const char *entryname, int entrylen,
+                             FAR struct romfs_nodeinfo_s *nodeinfo)
+{
+  char name[NAME_MAX + 1];
+  uint32_t offset;
+  uint32_t first = 0;
+  uint32_t last = count;
+  uint32_t mid;
+  int16_t  ndx;
+  int      namelen;
+  int      ret;
+
+  while (first < last)
+    {
+      mid = first + (last - first) / 2;
+
+      ndx = romfs_devcacheread(rm, index + ROMFS_IDX_ENTRY + 4 * mid);
+      if (ndx < 0)
+        {
+          return ndx;
+        }
+
+      offset = romfs_devread32(rm, ndx);
+      ret = romfs_parsefilename(rm, offset, name);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      /* Compare like memcmp() on the whole names, a name sorts after its
+       * prefixes.
+       */
+
+      namelen = strlen(name);
+      ret = memcmp(entryname, name, namelen < entrylen ? namelen : entrylen);
+      if (ret == 0)
+        {
+          ret = entrylen - namelen;
+        }
+
+      if (ret == 0)
+        {
+          return romfs_checkentry(rm, offset, entryname, entrylen,
+                                  nodeinfo);
+        }
+      else if (ret < 0)
+        {
+          last = mid;
+        }
+      else
+        {
+          first = mid + 1;
+        }
+    }
+
+  return -ENOENT;
+}
+#endif
+
 /****************************************************************************
  * Name: romfs_nodeinfo_search/romfs_nodeinfo_compare
  *
@@ -316,195 +460,340 @@ static int romfs_nodeinfo_compare(FAR const void *a, FAR const void *b)
 #endif
 
 /****************************************************************************
- * Name: romfs_searchdir
+ * Name: romfs_cachenode
  *
  * Description:
- *   This is part of the romfs_finddirentry.  Search the directory
- *   beginning at nodeinfo->rn_offset for entryname.
+ *   Allocate the node of one entry.  The entries of a directory are only
+ *   read by romfs_cachedir(), when the directory is first looked into.
  *
  ****************************************************************************/
 
-static inline int romfs_searchdir(FAR struct romfs_mountpt_s *rm,
-                                  FAR const char *entryname, int entrylen,
-                                  FAR struct romfs_nodeinfo_s *nodeinfo)
-{
 #ifdef CONFIG_FS_ROMFS_CACHE_NODE
-  FAR struct romfs_nodeinfo_s **cnodeinfo;
-  struct romfs_entryname_s entry;
+static int romfs_cachenode(uint32_t offset, uint32_t next, uint32_t size,
+                           FAR const char *name,
+                           FAR struct romfs_nodeinfo_s **pnodeinfo)
+{
+  FAR struct romfs_nodeinfo_s *nodeinfo;
+  size_t nsize;
 
-  entry.re_name = entryname;
-  entry.re_len = entrylen;
-  cnodeinfo = bsearch(&entry, nodeinfo->rn_child, nodeinfo->rn_count,
-                      sizeof(*nodeinfo->rn_child), romfs_nodeinfo_search);
-  if (cnodeinfo)
+  nsize = strlen(name);
+  nodeinfo = fs_heap_zalloc(sizeof(struct romfs_nodeinfo_s) + nsize);
+  if (nodeinfo == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  *pnodeinfo              = nodeinfo;
+  nodeinfo->rn_offset     = offset;
+  nodeinfo->rn_next       = next;
+  nodeinfo->rn_namesize   = nsize;
+  memcpy(nodeinfo->rn_name, name, nsize + 1);
+  if (!IS_DIRECTORY(next))
+    {
+      nodeinfo->rn_size = size;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: romfs_cacheentry
+ *
+ * Description:
+ *   Add the entry at offset to the nodes of a directory.  *pnum is the
+ *   size of the rn_child array.
+ *
+ ****************************************************************************/
+
+static int romfs_cacheentry(FAR struct romfs_mountpt_s *rm,
+                            FAR struct romfs_nodeinfo_s *nodeinfo,
+                            uint32_t offset, FAR size_t *pnum)
+{
+  char childname[NAME_MAX + 1];
+  uint32_t linkoffset;
+  uint32_t next;
+  uint32_t info;
+  uint32_t size;
+  int ret;
+
+  /* Parse the directory entry at this offset (which may be re-directed
+   * to some other entry if HARLINKED).
+   */
+
+  ret = romfs_parsedirentry(rm, offset, &linkoffset, &next, &info, &size);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = romfs_parsefilename(rm, offset, childname);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (strcmp(childname, ".") == 0 || strcmp(childname, "..") == 0)
     {
-      memcpy(nodeinfo, *cnodeinfo, sizeof(*nodeinfo));
       return 0;
     }
-#else
+
+  if (nodeinfo->rn_count == UINT16_MAX)
+    {
+      return -EFBIG;
+    }
+
+  /* Keep a NULL entry at the end of the array, it ends readdir() */
+
+  if (nodeinfo->rn_count + 1 >= *pnum)
+    {
+      FAR void *tmp;
+
+      tmp = fs_heap_realloc(nodeinfo->rn_child,
+            (*pnum + NODEINFO_NINCR) * sizeof(*nodeinfo->rn_child));
+      if (tmp == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      nodeinfo->rn_child = tmp;
+      memset(nodeinfo->rn_child + *pnum, 0, NODEINFO_NINCR *
+             sizeof(*nodeinfo->rn_child));
+      *pnum += NODEINFO_NINCR;
+    }
+
+  if (IS_DIRECTORY(next))
+    {
+      linkoffset = info;
+    }
+
+  ret = romfs_cachenode(linkoffset, next, size, childname,
+                        &nodeinfo->rn_child[nodeinfo->rn_count]);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  nodeinfo->rn_count++;
+  return 0;
+}
+
+/****************************************************************************
+ * Name: romfs_cachedir
+ *
+ * Description:
+ *   Read the entries of a directory into rn_child, sorted by name, unless
+ *   this was already done.
+ *
+ ****************************************************************************/
+
+static int romfs_cachedir(FAR struct romfs_mountpt_s *rm,
+                          FAR struct romfs_nodeinfo_s *nodeinfo)
+{
   uint32_t offset;
+  uint32_t index;
+  uint32_t count;
   uint32_t next;
+  size_t   num = 0;
   int16_t  ndx;
   int      ret;
+  int      i;
 
-  /* Then loop through the current directory until the directory
-   * with the matching name is found.  Or until all of the entries
-   * the directory have been examined.
+  if (nodeinfo->rn_cached)
+    {
+      return 0;
+    }
+
+  /* The index, if any, tells how many entries there are.  The entries are
+   * still read in the order they are stored, which keeps the device
+   * accesses sequential.
    */
 
+  ret = romfs_findindex(rm, nodeinfo->rn_offset, &index, &count);
+  if (ret < 0)
+    {
+      return ret;
+    }
+  else if (ret > 0 && count > 0 && count < UINT16_MAX)
+    {
+      nodeinfo->rn_child = fs_heap_zalloc((count + 1) *
+                                          sizeof(*nodeinfo->rn_child));
+      if (nodeinfo->rn_child == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      num = count + 1;
+    }
+
   offset = nodeinfo->rn_offset;
 
   do
     {
-      /* Read the sector into memory (do this before calling
-       * romfs_checkentry() so we won't have to read the sector
-       * twice in the event that the offset refers to a hardlink).
-       */
-
       ndx = romfs_devcacheread(rm, offset);
       if (ndx < 0)
         {
-          return ndx;
+          ret = ndx;
+          break;
         }
 
-      /* Because everything is chunked and aligned to 16-bit boundaries,
-       * we know that most the basic node info fits into the sector.
-       */
-
-      next = romfs_devread32(rm, ndx + ROMFS_FHDR_NEXT) & RFNEXT_OFFSETMASK;
+      next   = romfs_devread32(rm, ndx + ROMFS_FHDR_NEXT);
+      ret    = romfs_cacheentry(rm, nodeinfo, offset, &num);
+      offset = next & RFNEXT_OFFSETMASK;
+    }
+  while (ret >= 0 && offset != 0);
 
-      /* Check if the name this entry is a directory with the matching
-       * name
-       */
+  if (ret < 0)
+    {
+      /* Leave the directory as it was, so that it can be read again */
 
-      ret = romfs_checkentry(rm, offset, entryname, entrylen, nodeinfo);
-      if (ret >= 0)
+      for (i = 0; i < nodeinfo->rn_count; i++)
         {
-          /* Its a match! Return success */
-
-          return ret;
+          romfs_freenode(nodeinfo->rn_child[i]);
         }
 
-      /* No match... select the offset to the next entry */
-
-      offset = next;
+      fs_heap_free(nodeinfo->rn_child);
+      nodeinfo->rn_child = NULL;
+      nodeinfo->rn_count = 0;
+      return ret;
     }
-  while (next != 0);
-#endif
 
-  /* There is nothing in this directory with that name */
+  if (nodeinfo->rn_count > 1)
+    {
+      qsort(nodeinfo->rn_child, nodeinfo->rn_count,
+            sizeof(*nodeinfo->rn_child), romfs_nodeinfo_compare);
+    }
 
-  return -ENOENT;
+  nodeinfo->rn_cached = true;
+  return 0;
 }
 
 /****************************************************************************
- * Name: romfs_cachenode
+ * Name: romfs_searchnode
  *
  * Description:
- *   Alloc all entry node at once when filesystem is mounted
+ *   This is part of the romfs_finddirentry.  Search the directory *pnodeinfo
+ *   for entryname and return its node in *pnodeinfo.
  *
  ****************************************************************************/
 
-#ifdef CONFIG_FS_ROMFS_CACHE_NODE
-static int romfs_cachenode(FAR struct romfs_mountpt_s *rm,
-                           uint32_t offset, uint32_t next,
-                           uint32_t size, FAR const char *name,
-                           FAR struct romfs_nodeinfo_s **pnodeinfo)
+static int romfs_searchnode(FAR struct romfs_mountpt_s *rm,
+                            FAR const char *entryname, int entrylen,
+                            FAR struct romfs_nodeinfo_s **pnodeinfo)
 {
-  FAR struct romfs_nodeinfo_s **child;
-  FAR struct romfs_nodeinfo_s *nodeinfo;
-  char childname[NAME_MAX + 1];
-  uint32_t linkoffset;
-  uint32_t info;
-  uint8_t num = 0;
-  size_t nsize;
+  FAR struct romfs_nodeinfo_s **cnodeinfo;
+  struct romfs_entryname_s entry;
   int ret;
 
-  nsize = strlen(name);
-  nodeinfo = fs_heap_zalloc(sizeof(struct romfs_nodeinfo_s) + nsize);
-  if (nodeinfo == NULL)
+  ret = romfs_cachedir(rm, *pnodeinfo);
+  if (ret < 0)
     {
-      return -ENOMEM;
+      return ret;
     }
 
-  *pnodeinfo              = nodeinfo;
-  nodeinfo->rn_offset     = offset;
-  nodeinfo->rn_next       = next;
-  nodeinfo->rn_namesize   = nsize;
-  memcpy(nodeinfo->rn_name, name, nsize + 1);
-  if (!IS_DIRECTORY(next))
+  entry.re_name = entryname;
+  entry.re_len = entrylen;
+  cnodeinfo = bsearch(&entry, (*pnodeinfo)->rn_child,
+                      (*pnodeinfo)->rn_count,
+                      sizeof(*(*pnodeinfo)->rn_child),
+                      romfs_nodeinfo_search);
+  if (cnodeinfo)
     {
-      nodeinfo->rn_size = size;
+      *pnodeinfo = *cnodeinfo;
       return 0;
     }
 
-  child = nodeinfo->rn_child;
+  /* There is nothing in this directory with that name */
 
-  do
-    {
-      /* Parse the directory entry at this offset (which may be re-directed
-       * to some other entry if HARLINKED).
-       */
+  return -ENOENT;
+}
+#else
+
+/****************************************************************************
+ * Name: romfs_searchdir
+ *
+ * Description:
+ *   This is part of the romfs_finddirentry.  Search the directory
+ *   beginning at nodeinfo->rn_offset for entryname.
+ *
+ ****************************************************************************/
 
-      ret = romfs_parsedirentry(rm, offset, &linkoffset, &next, &info,
-                                &size);
+static inline int romfs_searchdir(FAR struct romfs_mountpt_s *rm,
+                                  FAR const char *entryname, int entrylen,
+                                  FAR struct romfs_nodeinfo_s *nodeinfo)
+{
+  uint32_t offset;
+  uint32_t index;
+  uint32_t count;
+  uint32_t next;
+  int16_t  ndx;
+  int      ret;
+
+  /* Binary search the sorted index, if the directory has one.  "." and
+   * "..", which are not in the index, are the first entries anyway.
+   */
+
+  if (entryname[0] != '.' || entrylen > 2 ||
+      (entrylen == 2 && entryname[1] != '.'))
+    {
+      ret = romfs_findindex(rm, nodeinfo->rn_offset, &index, &count);
       if (ret < 0)
         {
           return ret;
         }
-
-      ret = romfs_parsefilename(rm, offset, childname);
-      if (ret < 0)
+      else if (ret > 0)
         {
-          return ret;
+          return romfs_searchindex(rm, index, count, entryname, entrylen,
+                                   nodeinfo);
         }
+    }
 
-      if (strcmp(childname, ".") != 0 && strcmp(childname, "..") != 0)
+  /* Then loop through the current directory until the directory
+   * with the matching name is found.  Or until all of the entries
+   * the directory have been examined.
+   */
+
+  offset = nodeinfo->rn_offset;
+
+  do
+    {
+      /* Read the sector into memory (do this before calling
+       * romfs_checkentry() so we won't have to read the sector
+       * twice in the event that the offset refers to a hardlink).
+       */
+
+      ndx = romfs_devcacheread(rm, offset);
+      if (ndx < 0)
         {
-          if (child == NULL || nodeinfo->rn_count == num - 1)
-            {
-              FAR void *tmp;
-
-              tmp = fs_heap_realloc(nodeinfo->rn_child,
-                    (num + NODEINFO_NINCR) * sizeof(*nodeinfo->rn_child));
-              if (tmp == NULL)
-                {
-                  return -ENOMEM;
-                }
-
-              nodeinfo->rn_child = tmp;
-              memset(nodeinfo->rn_child + num, 0, NODEINFO_NINCR *
-                     sizeof(*nodeinfo->rn_child));
-              num += NODEINFO_NINCR;
-            }
+          return ndx;
+        }
 
-          child = &nodeinfo->rn_child[nodeinfo->rn_count++];
-          if (IS_DIRECTORY(next))
-            {
-              linkoffset = info;
-            }
+      /* Because everything is chunked and aligned to 16-bit boundaries,
+       * we know that most the basic node info fits into the sector.
+       */
 
-          ret = romfs_cachenode(rm, linkoffset, next, size,
-                                childname, child);
-          if (ret < 0)
-            {
-              nodeinfo->rn_count--;
-              return ret;
-            }
+      next = romfs_devread32(rm, ndx + ROMFS_FHDR_NEXT) & RFNEXT_OFFSETMASK;
+
+      /* Check if the name this entry is a directory with the matching
+       * name
+       */
+
+      ret = romfs_checkentry(rm, offset, entryname, entrylen, nodeinfo);
+      if (ret >= 0)
+        {
+          /* Its a match! Return success */
+
+          return ret;
         }
 
-      next &= RFNEXT_OFFSETMASK;
+      /* No match... select the offset to the next entry */
+
       offset = next;
     }
   while (next != 0);
 
-  if (nodeinfo->rn_count > 1)
-    {
-      qsort(nodeinfo->rn_child, nodeinfo->rn_count,
-            sizeof(*nodeinfo->rn_child), romfs_nodeinfo_compare);
-    }
+  /* There is nothing in this directory with that name */
 
-  return 0;
+  return -ENOENT;
 }
 #endif
 
@@ -539,8 +828,16 @@ int romfs_hwread(FAR struct romfs_mountpt_s *rm, FAR uint8_t *buffer,
       /* In non-XIP mode, we have to read the data from the device */
 
       FAR struct inode *inode = rm->rm_blkdriver;
-      ssize_t nsectorsread =
-        inode->u.i_bops->read(inode, buffer, sector, nsectors);
+      ssize_t nsectorsread;
+
+#ifdef CONFIG_FS_ROMFS_PAGECACHE
+      if (rm->rm_pagecache != NULL)
+        {
+          return pagecache_read(rm->rm_pagecache, buffer, sector, nsectors);
+        }
+#endif
+
+      nsectorsread = inode->u.i_bops->read(inode, buffer, sector, nsectors);
 
       if (nsectorsread < 0)
         {
@@ -685,6 +982,15 @@ int romfs_hwconfigure(FAR struct romfs_mountpt_s *rm)
       return -ENOMEM;
     }
 
+#ifdef CONFIG_FS_ROMFS_PAGECACHE
+  /* Share the page cache of the block driver, if it can be cached */
+
+  if (INODE_IS_BLOCK(inode))
+    {
+      rm->rm_pagecache = pagecache_attach(inode);
+    }
+#endif
+
   return 0;
 }
 
@@ -729,12 +1035,11 @@ int romfs_fsconfigure(FAR struct romfs_mountpt_s *rm)
 
   name              = (FAR const char *)&rm->rm_buffer[ROMFS_VHDR_VOLNAME];
 #ifdef CONFIG_FS_ROMFS_CACHE_NODE
-  ndx               = romfs_cachenode(rm, ROMFS_ALIGNUP(ROMFS_VHDR_VOLNAME +
-                                                        strlen(name) + 1),
+  ndx               = romfs_cachenode(ROMFS_ALIGNUP(ROMFS_VHDR_VOLNAME +
+                                                    strlen(name) + 1),
                                       RFNEXT_DIRECTORY, 0, "", &rm->rm_root);
   if (ndx < 0)
     {
-      romfs_freenode(rm->rm_root);
       return ndx;
     }
 #else
@@ -837,6 +1142,16 @@ int romfs_checkmount(FAR struct romfs_mountpt_s *rm)
        */
 
       inode = rm->rm_blkdriver;
+
+#ifdef CONFIG_FS_ROMFS_PAGECACHE
+      if (rm->rm_pagecache != NULL &&
+          pagecache_checkmedia(rm->rm_pagecache) < 0)
+        {
+          rm->rm_mounted = false;
+          return -ENODEV;
+        }
+#endif
+
       if (inode->u.i_bops->geometry)
         {
           ret = inode->u.i_bops->geometry(inode, &geo);
@@ -894,6 +1209,9 @@ int romfs_finddirentry(FAR struct romfs_mountpt_s *rm,
                        FAR struct romfs_nodeinfo_s *nodeinfo,
                        FAR const char *path)
 {
+#ifdef CONFIG_FS_ROMFS_CACHE_NODE
+  FAR struct romfs_nodeinfo_s *node;
+#endif
   FAR const char *entryname;
   FAR const char *terminator;
   int entrylen;
@@ -902,23 +1220,18 @@ int romfs_finddirentry(FAR struct romfs_mountpt_s *rm,
   /* Start with the first element after the root directory */
 
 #ifdef CONFIG_FS_ROMFS_CACHE_NODE
-  memcpy(nodeinfo, rm->rm_root, sizeof(*nodeinfo));
+  node = rm->rm_root;
 #else
   nodeinfo->rn_offset = rm->rm_rootoffset;
   nodeinfo->rn_next   = RFNEXT_DIRECTORY;
   nodeinfo->rn_size   = 0;
 #endif
 
-  /* The root directory is a special case */
-
-  if (!path || path[0] == '\0')
-    {
-      return 0;
-    }
-
-  /* Then loop for each directory/file component in the full path */
+  /* Then loop for each directory/file component in the full path.  An
+   * empty path is the root directory.
+   */
 
-  entryname  = path;
+  entryname  = path != NULL ? path : "";
   terminator = NULL;
 
   for (; ; )
@@ -941,7 +1254,7 @@ int romfs_finddirentry(FAR struct romfs_mountpt_s *rm,
 
       if (entrylen == 0)
         {
-          return 0;
+          break;
         }
 
       /* Long path segment names will be truncated to NAME_MAX */
@@ -955,7 +1268,11 @@ int romfs_finddirentry(FAR struct romfs_mountpt_s *rm,
        * matching name.
        */
 
+#ifdef CONFIG_FS_ROMFS_CACHE_NODE
+      ret = romfs_searchnode(rm, entryname, entrylen, &node);
+#else
       ret = romfs_searchdir(rm, entryname, entrylen, nodeinfo);
+#endif
       if (ret < 0)
         {
           return ret;
@@ -965,16 +1282,18 @@ int romfs_finddirentry(FAR struct romfs_mountpt_s *rm,
 
       if (!terminator)
         {
-          /* Yes.. return success */
-
-          return 0;
+          break;
         }
 
       /* No... If that was not the last path component, then it had
        * better have been a directory
        */
 
+#ifdef CONFIG_FS_ROMFS_CACHE_NODE
+      if (!IS_DIRECTORY(node->rn_next))
+#else
       if (!IS_DIRECTORY(nodeinfo->rn_next))
+#endif
         {
           return -ENOTDIR;
         }
@@ -986,7 +1305,22 @@ int romfs_finddirentry(FAR struct romfs_mountpt_s *rm,
       entryname = terminator;
     }
 
-  return -EINVAL; /* Won't get here */
+#ifdef CONFIG_FS_ROMFS_CACHE_NODE
+  /* The caller may list the directory, read its entries now */
+
+  if (IS_DIRECTORY(node->rn_next))
+    {
+      ret = romfs_cachedir(rm, node);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  memcpy(nodeinfo, node, sizeof(*nodeinfo));
+#endif
+
+  return 0;
 }
 
 /****************************************************************************
@@ -94,6 +94,13 @@ struct tmpfs_dir_s
 
 static int  tmpfs_realloc_directory(FAR struct tmpfs_directory_s *tdo,
               unsigned int nentries);
+static size_t tmpfs_page_alloc(FAR struct tmpfs_file_s *tfo,
+                               unsigned int index);
+static void tmpfs_free_pages(FAR struct tmpfs_file_s *tfo,
+                             unsigned int first);
+static FAR uint8_t *tmpfs_get_page(FAR struct tmpfs_file_s *tfo,
+                                   unsigned int index, size_t need);
+static int  tmpfs_flatten(FAR struct tmpfs_file_s *tfo);
 static int  tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
               size_t newsize);
 static void tmpfs_release_lockedobject(FAR struct tmpfs_object_s *to);
@@ -266,81 +273,300 @@ static int tmpfs_realloc_directory(FAR struct tmpfs_directory_s *tdo,
   return ret;
 }
 
+/****************************************************************************
+ * Name: tmpfs_page_alloc
+ *
+ * Description:
+ *   Return the allocated size of one page of the file.
+ *
+ ****************************************************************************/
+
+static size_t tmpfs_page_alloc(FAR struct tmpfs_file_s *tfo,
+                               unsigned int index)
+{
+  if (tfo->tfo_pages[index] == NULL)
+    {
+      return 0;
+    }
+
+  return index == tfo->tfo_npages - 1 ? tfo->tfo_lastalloc : TMPFS_PAGESIZE;
+}
+
+/****************************************************************************
+ * Name: tmpfs_free_pages
+ *
+ * Description:
+ *   Free the pages from 'first' to the end of the file.  The page array is
+ *   freed too if no page is left.  The contiguous memory is freed once no
+ *   page lives in it and it is not mapped.
+ *
+ ****************************************************************************/
+
+static void tmpfs_free_pages(FAR struct tmpfs_file_s *tfo,
+                             unsigned int first)
+{
+  while (tfo->tfo_npages > first)
+    {
+      unsigned int index = tfo->tfo_npages - 1;
+
+      tfo->tfo_alloc -= tmpfs_page_alloc(tfo, index);
+      if (index < tfo->tfo_nflat)
+        {
+          tfo->tfo_nflat = index;
+        }
+      else
+        {
+          fs_heap_free(tfo->tfo_pages[index]);
+        }
+
+      tfo->tfo_pages[index] = NULL;
+      tfo->tfo_npages = index;
+      tfo->tfo_lastalloc = index > 0 && tfo->tfo_pages[index - 1] ?
+                           TMPFS_PAGESIZE : 0;
+    }
+
+  if (tfo->tfo_npages == 0 && tfo->tfo_pages != NULL)
+    {
+      fs_heap_free(tfo->tfo_pages);
+      tfo->tfo_pages    = NULL;
+      tfo->tfo_maxpages = 0;
+      tfo->tfo_alloc    = 0;
+    }
+
+  if (tfo->tfo_nflat == 0 && tfo->tfo_nmaps == 0)
+    {
+      fs_heap_free(tfo->tfo_flat);
+      tfo->tfo_flat = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: tmpfs_get_page
+ *
+ * Description:
+ *   Return a page of the file with at least 'need' bytes allocated.  Holes
+ *   are filled with zeroed memory.  Only the last page may be smaller than
+ *   TMPFS_PAGESIZE.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *tmpfs_get_page(FAR struct tmpfs_file_s *tfo,
+                                   unsigned int index, size_t need)
+{
+  FAR uint8_t *page;
+  size_t allocsize;
+  size_t oldsize;
+
+  DEBUGASSERT(index < tfo->tfo_npages && need <= TMPFS_PAGESIZE);
+
+  oldsize = tmpfs_page_alloc(tfo, index);
+  if (need <= oldsize)
+    {
+      return tfo->tfo_pages[index];
+    }
+
+  /* Added some additional amount to the last page to account frequent
+   * reallocations.
+   */
+
+  allocsize = TMPFS_PAGESIZE;
+  if (index == tfo->tfo_npages - 1 &&
+      need + CONFIG_FS_TMPFS_FILE_ALLOCGUARD < TMPFS_PAGESIZE)
+    {
+      allocsize = need + CONFIG_FS_TMPFS_FILE_ALLOCGUARD;
+    }
+
+  page = fs_heap_realloc(tfo->tfo_pages[index], allocsize);
+  if (page == NULL)
+    {
+      return NULL;
+    }
+
+  memset(page + oldsize, 0, allocsize - oldsize);
+
+  tfo->tfo_pages[index] = page;
+  tfo->tfo_alloc       += allocsize - oldsize;
+  if (index == tfo->tfo_npages - 1)
+    {
+      tfo->tfo_lastalloc = allocsize;
+    }
+
+  return page;
+}
+
 /****************************************************************************
  * Name: tmpfs_realloc_file
+ *
+ * Description:
+ *   Change the size of the file.  Memory beyond the end of the file is
+ *   always zero, so growing the file only has to make room for the new
+ *   pages.  They are allocated when they are written.
+ *
  ****************************************************************************/
 
 static int tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
                               size_t newsize)
 {
-  FAR uint8_t *newdata;
+  FAR uint8_t **newpages;
+  unsigned int npages = TMPFS_NPAGES(newsize);
+  unsigned int maxpages;
+  FAR uint8_t *page;
   size_t allocsize;
-  size_t delta;
+  size_t used;
 
   /* Are we growing or shrinking the object? */
 
-  if (newsize <= tfo->tfo_alloc)
+  if (newsize <= tfo->tfo_size)
     {
-      /* Shrinking ... Shrink unconditionally if the size is shrinking to
-       * zero.
-       */
+      /* Shrinking ... Free the pages beyond the new end of the file */
 
-      if (newsize == 0)
+      tmpfs_free_pages(tfo, npages);
+      tfo->tfo_size = newsize;
+      if (npages == 0 || tfo->tfo_pages[npages - 1] == NULL)
         {
-          /* Free the file object */
+          return OK;
+        }
 
-          fs_heap_free(tfo->tfo_data);
-          tfo->tfo_data = NULL;
-          tfo->tfo_alloc = 0;
-          tfo->tfo_size = 0;
+      /* We should make sure the shrunked memory be zero */
+
+      page = tfo->tfo_pages[npages - 1];
+      used = newsize - (npages - 1) * TMPFS_PAGESIZE;
+      if (used >= tfo->tfo_lastalloc)
+        {
           return OK;
         }
-      else if (newsize > 0)
+
+      memset(page + used, 0, tfo->tfo_lastalloc - used);
+
+      /* Don't realloc the last page unless it has shrunk by a lot.  A page
+       * in the contiguous memory is never reallocated.
+       */
+
+      allocsize = used + CONFIG_FS_TMPFS_FILE_ALLOCGUARD;
+      if (npages > tfo->tfo_nflat &&
+          tfo->tfo_lastalloc - used > CONFIG_FS_TMPFS_FILE_FREEGUARD &&
+          allocsize < tfo->tfo_lastalloc)
         {
-          /* Otherwise, don't realloc unless the object has shrunk by a
-           * lot.
-           */
+          page = fs_heap_realloc(page, allocsize);
+          if (page != NULL)
+            {
+              tfo->tfo_pages[npages - 1] = page;
+              tfo->tfo_alloc    -= tfo->tfo_lastalloc - allocsize;
+              tfo->tfo_lastalloc = allocsize;
+            }
+        }
 
-          delta = tfo->tfo_alloc - newsize;
+      return OK;
+    }
 
-          /* We should make sure the shrunked memory be zero */
+  if (npages > tfo->tfo_npages)
+    {
+      /* Grow the page array.  Double it to keep appends cheap. */
 
-          memset(tfo->tfo_data + newsize, 0, delta);
-          if (delta <= CONFIG_FS_TMPFS_FILE_FREEGUARD)
+      if (npages > tfo->tfo_maxpages)
+        {
+          maxpages = tfo->tfo_maxpages * 2;
+          if (maxpages < npages)
             {
-              /* Hasn't shrunk enough.. Return doing nothing for now */
+              maxpages = npages;
+            }
 
-              tfo->tfo_size = newsize;
-              return OK;
+          newpages = fs_heap_realloc(tfo->tfo_pages,
+                                     maxpages * sizeof(FAR uint8_t *));
+          if (newpages == NULL)
+            {
+              return -ENOMEM;
             }
+
+          memset(&newpages[tfo->tfo_maxpages], 0,
+                 (maxpages - tfo->tfo_maxpages) * sizeof(FAR uint8_t *));
+
+          tfo->tfo_alloc   += (maxpages - tfo->tfo_maxpages) *
+                              sizeof(FAR uint8_t *);
+          tfo->tfo_pages    = newpages;
+          tfo->tfo_maxpages = maxpages;
         }
+
+      /* The old last page is no longer the last one and must be full */
+
+      if (tfo->tfo_npages > 0 &&
+          tfo->tfo_pages[tfo->tfo_npages - 1] != NULL &&
+          tmpfs_get_page(tfo, tfo->tfo_npages - 1, TMPFS_PAGESIZE) == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      tfo->tfo_npages    = npages;
+      tfo->tfo_lastalloc = 0;
     }
 
-  /* Added some additional amount to the new size to account frequent
-   * reallocations.
-   */
+  tfo->tfo_size = newsize;
+  return OK;
+}
 
-  allocsize = newsize + CONFIG_FS_TMPFS_FILE_ALLOCGUARD;
-  if (allocsize < newsize)
-    {
-      /* There must have been an integer overflow */
+/****************************************************************************
+ * Name: tmpfs_flatten
+ *
+ * Description:
+ *   Move all pages of the file into one contiguous block of memory, so
+ *   that the file can be accessed in place.  The pages keep pointing into
+ *   that block and pages added later are allocated separately again.  The
+ *   block cannot move while it is mapped.
+ *
+ * Returned Value:
+ *   Zero (OK) if tfo_flat holds the whole file; -EBUSY if the file has
+ *   grown since a mapping pinned tfo_flat; -ENOMEM if out of memory.
+ *
+ ****************************************************************************/
 
-      return -ENOMEM;
+static int tmpfs_flatten(FAR struct tmpfs_file_s *tfo)
+{
+  FAR uint8_t *flat;
+  unsigned int index;
+  size_t alloc;
+
+  if (tfo->tfo_nflat == tfo->tfo_npages)
+    {
+      return OK;
     }
 
-  /* Realloc the file object */
+  if (tfo->tfo_nmaps > 0)
+    {
+      return -EBUSY;
+    }
 
-  newdata = fs_heap_realloc(tfo->tfo_data, allocsize);
-  if (newdata == NULL)
+  flat = fs_heap_malloc(tfo->tfo_npages * TMPFS_PAGESIZE);
+  if (flat == NULL)
     {
       return -ENOMEM;
     }
 
-  /* Return the new address of the reallocated file object */
+  for (index = 0; index < tfo->tfo_npages; index++)
+    {
+      FAR uint8_t *page = flat + index * TMPFS_PAGESIZE;
+
+      alloc = tmpfs_page_alloc(tfo, index);
+      if (alloc > 0)
+        {
+          memcpy(page, tfo->tfo_pages[index], alloc);
+        }
 
-  tfo->tfo_alloc = allocsize;
-  tfo->tfo_size  = newsize;
-  tfo->tfo_data  = newdata;
+      memset(page + alloc, 0, TMPFS_PAGESIZE - alloc);
+
+      if (index >= tfo->tfo_nflat)
+        {
+          fs_heap_free(tfo->tfo_pages[index]);
+        }
+
+      tfo->tfo_pages[index] = page;
+      tfo->tfo_alloc       += TMPFS_PAGESIZE - alloc;
+    }
+
+  fs_heap_free(tfo->tfo_flat);
+
+  tfo->tfo_flat      = flat;
+  tfo->tfo_nflat     = tfo->tfo_npages;
+  tfo->tfo_lastalloc = TMPFS_PAGESIZE;
   return OK;
 }
 
@@ -381,7 +607,7 @@ static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo)
     {
       tmpfs_unlock_file(tfo);
       nxrmutex_destroy(&tfo->tfo_lock);
-      fs_heap_free(tfo->tfo_data);
+      tmpfs_free_pages(tfo, 0);
       fs_heap_free(tfo);
     }
 
@@ -580,7 +806,7 @@ tmpfs_alloc_file(FAR struct tmpfs_directory_s *parent)
   tfo->tfo_parent = parent;
   tfo->tfo_flags  = 0;
   tfo->tfo_size   = 0;
-  tfo->tfo_data   = NULL;
+  tfo->tfo_pages  = NULL;
 
   nxrmutex_init(&tfo->tfo_lock);
   tmpfs_lock_file(tfo);
@@ -1179,7 +1405,11 @@ static int tmpfs_statfs_callout(FAR struct tmpfs_directory_s *tdo,
 
       tmptfo             = (FAR struct tmpfs_file_s *)to;
       tmpbuf->tsf_alloc += sizeof(struct tmpfs_file_s);
-      tmpbuf->tsf_avail += to->to_alloc - tmptfo->tfo_size;
+      if (to->to_alloc > tmptfo->tfo_size)
+        {
+          tmpbuf->tsf_avail += to->to_alloc - tmptfo->tfo_size;
+        }
+
       tmpbuf->tsf_files++;
     }
   else /* if (to->to_type == TMPFS_DIRECTORY) */
@@ -1255,7 +1485,7 @@ static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
           return TMPFS_UNLINKED;
         }
 
-      fs_heap_free(tfo->tfo_data);
+      tmpfs_free_pages(tfo, 0);
     }
   else /* if (to->to_type == TMPFS_DIRECTORY) */
     {
@@ -1574,18 +1804,37 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
       nread  = endpos - startpos;
     }
 
-  /* Copy data from the memory object to the user buffer */
+  /* Copy data from the memory object to the user buffer.  Holes and
+   * memory beyond the allocated part of the last page read as zero.
+   */
 
-  if (tfo->tfo_data != NULL)
-    {
-      memcpy(buffer, &tfo->tfo_data[startpos], nread);
-      filep->f_pos += nread;
-    }
-  else
+  while (startpos < endpos)
     {
-      DEBUGASSERT(tfo->tfo_size == 0 && nread == 0);
+      unsigned int index = TMPFS_PAGE(startpos);
+      size_t offset = TMPFS_PAGEOFFSET(startpos);
+      size_t alloc = tmpfs_page_alloc(tfo, index);
+      size_t ncopy = TMPFS_PAGESIZE - offset;
+      size_t nvalid = 0;
+
+      if (ncopy > endpos - startpos)
+        {
+          ncopy = endpos - startpos;
+        }
+
+      if (offset < alloc)
+        {
+          nvalid = alloc - offset < ncopy ? alloc - offset : ncopy;
+          memcpy(buffer, tfo->tfo_pages[index] + offset, nvalid);
+        }
+
+      memset(buffer + nvalid, 0, ncopy - nvalid);
+
+      buffer   += ncopy;
+      startpos += ncopy;
     }
 
+  filep->f_pos += nread;
+
   /* Release the lock on the file */
 
   tmpfs_unlock_file(tfo);
@@ -1603,6 +1852,7 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
   ssize_t nwritten;
   off_t startpos;
   off_t endpos;
+  size_t oldsize;
   int ret;
 
   finfo("filep: %p buffer: %p buflen: %lu\n",
@@ -1632,8 +1882,9 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
       startpos = filep->f_pos;
     }
 
-  nwritten = buflen;
+  nwritten = 0;
   endpos   = startpos + buflen;
+  oldsize  = tfo->tfo_size;
 
   if (endpos > tfo->tfo_size)
     {
@@ -1646,18 +1897,52 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
         }
     }
 
-  /* Copy data from the memory object to the user buffer */
+  /* Copy data from the user buffer to the memory object one page at a
+   * time, allocating the pages as they are written.
+   */
 
-  if (tfo->tfo_data != NULL)
+  while (startpos < endpos)
     {
-      memcpy(&tfo->tfo_data[startpos], buffer, nwritten);
-    }
-  else
-    {
-      DEBUGASSERT(tfo->tfo_size == 0 && nwritten == 0);
+      unsigned int index = TMPFS_PAGE(startpos);
+      size_t offset = TMPFS_PAGEOFFSET(startpos);
+      size_t ncopy = TMPFS_PAGESIZE - offset;
+      FAR uint8_t *page;
+
+      if (ncopy > endpos - startpos)
+        {
+          ncopy = endpos - startpos;
+        }
+
+      page = tmpfs_get_page(tfo, index, offset + ncopy);
+      if (page == NULL)
+        {
+          /* Out of memory.  Drop the part of the file that could not be
+           * written and report what was.
+           */
+
+          if (endpos > oldsize)
+            {
+              tmpfs_realloc_file(tfo, startpos > oldsize ?
+                                      (size_t)startpos : oldsize);
+            }
+
+          if (nwritten == 0)
+            {
+              ret = -ENOMEM;
+              goto errout_with_lock;
+            }
+
+          break;
+        }
+
+      memcpy(page + offset, buffer, ncopy);
+
+      buffer   += ncopy;
+      startpos += ncopy;
+      nwritten += ncopy;
     }
 
-  filep->f_pos = endpos;
+  filep->f_pos = startpos;
 
   /* Release the lock on the file */
 
@@ -1743,7 +2028,20 @@ static int tmpfs_unmap(FAR struct task_group_s *group,
       ret = mm_map_remove(get_group_mm(group), entry);
       if (ret >= 0)
         {
-          ret = tmpfs_release_file(tfo);
+          ret = tmpfs_lock_file(tfo);
+        }
+
+      if (ret >= 0)
+        {
+          /* The contiguous memory may move or go away again */
+
+          if (--tfo->tfo_nmaps == 0 && tfo->tfo_nflat == 0)
+            {
+              fs_heap_free(tfo->tfo_flat);
+              tfo->tfo_flat = NULL;
+            }
+
+          tmpfs_release_lockedfile(tfo);
         }
     }
 
@@ -1754,9 +2052,7 @@ static int tmpfs_unmap(FAR struct task_group_s *group,
   else
     {
       entry->length = offset;
-      tmpfs_lock_file(tfo);
-      ret = tmpfs_realloc_file(tfo, offset);
-      tmpfs_unlock_file(tfo);
+      ret = OK;
     }
 
   return ret;
@@ -1765,7 +2061,7 @@ static int tmpfs_unmap(FAR struct task_group_s *group,
 static int tmpfs_mmap(FAR struct file *filep, FAR struct mm_map_entry_s *map)
 {
   FAR struct tmpfs_file_s *tfo;
-  int ret = -EINVAL;
+  int ret;
 
   DEBUGASSERT(filep->f_priv != NULL);
 
@@ -1775,22 +2071,43 @@ static int tmpfs_mmap(FAR struct file *filep, FAR struct mm_map_entry_s *map)
 
   DEBUGASSERT(tfo != NULL);
 
+  ret = tmpfs_lock_file(tfo);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
   if (map->offset >= 0 && map->offset < tfo->tfo_size &&
       map->length && map->offset + map->length <= tfo->tfo_size)
     {
-      map->vaddr = tfo->tfo_data + map->offset;
+      /* Make the file contiguous.  It stays where it is until the last
+       * mapping goes away, even if the file is truncated meanwhile.
+       */
+
+      ret = tmpfs_flatten(tfo);
+      if (ret < 0)
+        {
+          goto out;
+        }
+
+      map->vaddr = tfo->tfo_flat + map->offset;
       map->priv.p = tfo;
       map->munmap = tmpfs_unmap;
       ret = mm_map_add(get_current_mm(), map);
 
       if (ret >= 0)
         {
-          tmpfs_lock_file(tfo);
           tfo->tfo_refs++;
-          tmpfs_unlock_file(tfo);
+          tfo->tfo_nmaps++;
         }
     }
+  else
+    {
+      ret = -EINVAL;
+    }
 
+out:
+  tmpfs_unlock_file(tfo);
   return ret;
 }
 
@@ -1832,8 +2149,23 @@ static int tmpfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
     {
       FAR uintptr_t *ptr = (FAR uintptr_t *)arg;
 
-      *ptr = (uintptr_t)tfo->tfo_data;
-      return OK;
+      /* Make the file contiguous.  Unlike a mapping, this does not pin the
+       * memory:  It is only valid until the file is written or truncated.
+       */
+
+      ret = tmpfs_lock_file(tfo);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      ret = tmpfs_flatten(tfo);
+      if (ret == OK)
+        {
+          *ptr = (uintptr_t)tfo->tfo_flat;
+        }
+
+      tmpfs_unlock_file(tfo);
     }
 
   return ret;
@@ -1958,29 +2290,15 @@ static int tmpfs_truncate(FAR struct file *filep, off_t length)
   oldsize = tfo->tfo_size;
   if (oldsize != length)
     {
-      /* The size is changing.. up or down.  Reallocate the file memory. */
-
-      ret = tmpfs_realloc_file(tfo, (size_t)length);
-      if (ret < 0)
-        {
-          goto errout_with_lock;
-        }
-
-      /* If the size has increased, then we need to zero the newly added
-       * memory.
+      /* The size is changing.. up or down.  Reallocate the file memory.
+       * Any newly added part of the file is a hole that reads as zero.
        */
 
-      if (length > oldsize)
-        {
-          memset(&tfo->tfo_data[oldsize], 0, length - oldsize);
-        }
-
-      ret = OK;
+      ret = tmpfs_realloc_file(tfo, (size_t)length);
     }
 
   /* Release the lock on the file */
 
-errout_with_lock:
   tmpfs_unlock_file(tfo);
   return ret;
 }
@@ -2416,7 +2734,7 @@ static int tmpfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
   else
     {
       nxrmutex_destroy(&tfo->tfo_lock);
-      fs_heap_free(tfo->tfo_data);
+      tmpfs_free_pages(tfo, 0);
       fs_heap_free(tfo);
     }
 
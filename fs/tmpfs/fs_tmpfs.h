@@ -42,6 +42,16 @@
 
 #define TFO_FLAG_UNLINKED (1 << 0)  /* Bit 0: File is unlinked */
 
+/* File data is kept in pages of CONFIG_FS_TMPFS_PAGESIZE bytes.  Every
+ * allocated page but the last one is full size.  The last page grows
+ * with CONFIG_FS_TMPFS_FILE_ALLOCGUARD like the whole file used to.
+ */
+
+#define TMPFS_PAGESIZE        CONFIG_FS_TMPFS_PAGESIZE
+#define TMPFS_PAGE(pos)       ((pos) / TMPFS_PAGESIZE)
+#define TMPFS_PAGEOFFSET(pos) ((pos) % TMPFS_PAGESIZE)
+#define TMPFS_NPAGES(size)    (((size) + TMPFS_PAGESIZE - 1) / TMPFS_PAGESIZE)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -126,9 +136,15 @@ struct tmpfs_file_s
 
   /* Remaining fields are unique to a directory object */
 
-  uint8_t       tfo_flags; /* See TFO_FLAG_* definitions */
-  size_t        tfo_size;  /* Valid file size */
-  FAR uint8_t  *tfo_data;  /* File data starts here */
+  uint8_t       tfo_flags;     /* See TFO_FLAG_* definitions */
+  size_t        tfo_size;      /* Valid file size */
+  size_t        tfo_lastalloc; /* Allocated size of the last page */
+  unsigned int  tfo_npages;    /* Number of pages covering tfo_size */
+  unsigned int  tfo_maxpages;  /* Allocated size of tfo_pages */
+  FAR uint8_t **tfo_pages;     /* File data pages, NULL for holes */
+  FAR uint8_t  *tfo_flat;      /* Contiguous memory of the first pages */
+  unsigned int  tfo_nflat;     /* Number of pages that live in tfo_flat */
+  unsigned int  tfo_nmaps;     /* Number of mappings pinning tfo_flat */
 };
 
 /* This structure represents one instance of a TMPFS file system */
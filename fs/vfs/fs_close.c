@@ -37,6 +37,7 @@
 #include "notify/notify.h"
 #include "inode/inode.h"
 #include "vfs/lock.h"
+#include "writeback/writeback.h"
 
 /****************************************************************************
  * Private Functions
@@ -124,6 +125,12 @@ int file_close_without_clear(FAR struct file *filep)
 
       if (ret >= 0)
         {
+#ifdef CONFIG_FS_WRITEBACK
+          /* The file systems sync the file data on close */
+
+          writeback_clean(filep);
+#endif
+
 #ifdef CONFIG_FS_NOTIFY
           if (path != NULL)
             {
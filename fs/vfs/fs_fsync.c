@@ -37,6 +37,7 @@
 #include <nuttx/fs/ioctl.h>
 
 #include "inode/inode.h"
+#include "writeback/writeback.h"
 
 /****************************************************************************
  * Public Functions
@@ -72,7 +73,15 @@ int file_fsync(FAR struct file *filep)
             {
               /* Yes, then tell the mountpoint to sync this file */
 
-              return inode->u.i_mops->sync(filep);
+              ret = inode->u.i_mops->sync(filep);
+#ifdef CONFIG_FS_WRITEBACK
+              if (ret >= 0)
+                {
+                  writeback_clean(filep);
+                }
+#endif
+
+              return ret;
             }
         }
       else
@@ -70,6 +70,9 @@ static int pseudorename(FAR const char *oldpath, FAR struct inode *oldinode,
 {
   struct inode_search_s newdesc;
   FAR struct inode *newinode;
+#if CONFIG_PSEUDOFS_HASHSIZE > 0
+  FAR struct inode *child;
+#endif
   FAR char *subdir = NULL;
 #ifdef CONFIG_FS_NOTIFY
   bool isdir = INODE_IS_PSEUDODIR(oldinode);
@@ -240,6 +243,15 @@ next_subdir:
 
   /* Remove all of the children from the unlinked inode */
 
+#if CONFIG_PSEUDOFS_HASHSIZE > 0
+  for (child = newinode->i_child; child != NULL; child = child->i_peer)
+    {
+      inode_hashremove(child);
+      child->i_parent = newinode;
+      inode_hashadd(child);
+    }
+#endif
+
   oldinode->i_child  = NULL;
   oldinode->i_parent = NULL;
   ret = OK;
@@ -27,6 +27,7 @@
 #include <nuttx/config.h>
 
 #include <sys/sendfile.h>
+#include <sys/stat.h>
 #include <stdbool.h>
 #include <errno.h>
 #include <debug.h>
@@ -40,6 +41,113 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: copyfile_direct
+ *
+ * Description:
+ *   Transfer data from a memory backed input file (ROMFS on XIP media,
+ *   TMPFS, ...) by writing directly from the file content.  This avoids
+ *   both the intermediate I/O buffer and the copy performed by read().
+ *
+ * Returned Value:
+ *   The number of bytes transferred or a negated errno value.  -ENOTTY is
+ *   returned if the input file cannot be mapped in place; the caller
+ *   should then fall back to copyfile().
+ *
+ ****************************************************************************/
+
+static ssize_t copyfile_direct(FAR struct file *outfile,
+                               FAR struct file *infile,
+                               FAR off_t *offset, size_t count)
+{
+  struct mm_map_entry_s entry;
+  FAR const uint8_t *wrbuffer;
+  struct stat buf;
+  ssize_t nbyteswritten;
+  size_t ntransferred;
+  off_t startpos;
+  int ret;
+
+  if (offset)
+    {
+      startpos = *offset;
+    }
+  else
+    {
+      startpos = file_seek(infile, 0, SEEK_CUR);
+      if (startpos < 0)
+        {
+          return startpos;
+        }
+    }
+
+  /* The mapping may not extend beyond the end of the file */
+
+  ret = file_fstat(infile, &buf);
+  if (ret < 0 || !S_ISREG(buf.st_mode) || startpos >= buf.st_size)
+    {
+      return -ENOTTY;
+    }
+
+  if (count > buf.st_size - startpos)
+    {
+      count = buf.st_size - startpos;
+    }
+
+  ret = file_mmap_direct(infile, startpos, count, &entry);
+  if (ret < 0)
+    {
+      return -ENOTTY;
+    }
+
+  /* Write the file content from its backing memory */
+
+  wrbuffer = entry.vaddr;
+  for (ntransferred = 0; ntransferred < count; )
+    {
+      nbyteswritten = file_write(outfile, wrbuffer + ntransferred,
+                                 count - ntransferred);
+      if (nbyteswritten < 0)
+        {
+          /* EINTR is a special case as in copyfile() */
+
+          if (nbyteswritten != -EINTR || ntransferred == 0)
+            {
+              ntransferred = nbyteswritten;
+            }
+
+          break;
+        }
+
+      ntransferred += nbyteswritten;
+    }
+
+  if (entry.munmap != NULL)
+    {
+      file_munmap(entry.vaddr, entry.length);
+    }
+
+  /* Update the file position the same way copyfile() does */
+
+  if ((ssize_t)ntransferred > 0)
+    {
+      if (offset)
+        {
+          *offset = startpos + ntransferred;
+        }
+      else
+        {
+          ret = file_seek(infile, startpos + ntransferred, SEEK_SET);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+    }
+
+  return ntransferred;
+}
+
 static ssize_t copyfile(FAR struct file *outfile, FAR struct file *infile,
                         FAR off_t *offset, size_t count)
 {
@@ -249,6 +357,8 @@ static ssize_t copyfile(FAR struct file *outfile, FAR struct file *infile,
 ssize_t file_sendfile(FAR struct file *outfile, FAR struct file *infile,
                       FAR off_t *offset, size_t count)
 {
+  ssize_t ret;
+
   if (count == 0)
     {
       nwarn("WARNING: sendfile count is zero\n");
@@ -267,7 +377,7 @@ ssize_t file_sendfile(FAR struct file *outfile, FAR struct file *infile,
     {
       /* Then let psock_sendfile do the work. */
 
-      int ret = psock_sendfile(psock, infile, offset, count);
+      ret = psock_sendfile(psock, infile, offset, count);
       if (ret >= 0 || ret != -ENOSYS)
         {
           return ret;
@@ -279,10 +389,17 @@ ssize_t file_sendfile(FAR struct file *outfile, FAR struct file *infile,
     }
 #endif
 
-  /* No... then this is probably a file-to-file transfer.  The generic
-   * copyfile() can handle that case.
+  /* No... then this is probably a file-to-file transfer.  Write directly
+   * from the input file content if it is memory backed, otherwise the
+   * generic copyfile() can handle that case.
    */
 
+  ret = copyfile_direct(outfile, infile, offset, count);
+  if (ret != -ENOTTY)
+    {
+      return ret;
+    }
+
   return copyfile(outfile, infile, offset, count);
 }
 
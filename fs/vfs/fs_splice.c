@@ -0,0 +1,385 @@
+/****************************************************************************
+ * fs/vfs/fs_splice.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/ioctl.h>
+#include <sys/param.h>
+#include <sys/uio.h>
+#include <stdbool.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <errno.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+
+#include "inode/inode.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: file_splice
+ *
+ * Description:
+ *   Equivalent to the standard splice() function except that is accepts
+ *   struct file instances instead of file descriptors.
+ *
+ ****************************************************************************/
+
+ssize_t file_splice(FAR struct file *infile, FAR off_t *inoffset,
+                    FAR struct file *outfile, FAR off_t *outoffset,
+                    size_t len, unsigned int flags)
+{
+  struct pipe_splice_s splice;
+
+  if ((infile->f_oflags & O_RDOK) == 0 ||
+      (outfile->f_oflags & O_WROK) == 0)
+    {
+      return -EBADF;
+    }
+
+  if (len == 0)
+    {
+      return 0;
+    }
+
+  splice.len   = len;
+  splice.flags = flags;
+
+  /* The pipe driver does the transfer directly from or into its buffer.
+   * A pipe to pipe transfer is handled by the input pipe.
+   */
+
+  if (INODE_IS_PIPE(infile->f_inode))
+    {
+      if (inoffset != NULL)
+        {
+          return -ESPIPE;
+        }
+
+      splice.filep  = outfile;
+      splice.offset = outoffset;
+      return file_ioctl(infile, PIPEIOC_SPLICEOUT, &splice);
+    }
+  else if (INODE_IS_PIPE(outfile->f_inode))
+    {
+      if (outoffset != NULL)
+        {
+          return -ESPIPE;
+        }
+
+      splice.filep  = infile;
+      splice.offset = inoffset;
+      return file_ioctl(outfile, PIPEIOC_SPLICEIN, &splice);
+    }
+
+  /* One end of the transfer must be a pipe */
+
+  return -EINVAL;
+}
+
+/****************************************************************************
+ * Name: file_tee
+ *
+ * Description:
+ *   Equivalent to the standard tee() function except that is accepts
+ *   struct file instances instead of file descriptors.
+ *
+ ****************************************************************************/
+
+ssize_t file_tee(FAR struct file *infile, FAR struct file *outfile,
+                 size_t len, unsigned int flags)
+{
+  struct pipe_splice_s splice;
+
+  if ((infile->f_oflags & O_RDOK) == 0 ||
+      (outfile->f_oflags & O_WROK) == 0)
+    {
+      return -EBADF;
+    }
+
+  if (!INODE_IS_PIPE(infile->f_inode) || !INODE_IS_PIPE(outfile->f_inode))
+    {
+      return -EINVAL;
+    }
+
+  if (len == 0)
+    {
+      return 0;
+    }
+
+  splice.filep  = outfile;
+  splice.offset = NULL;
+  splice.len    = len;
+  splice.flags  = flags;
+
+  return file_ioctl(infile, PIPEIOC_TEE, &splice);
+}
+
+/****************************************************************************
+ * Name: splice
+ *
+ * Description:
+ *   splice() moves data between two file descriptors without copying it
+ *   through user space.  One of the descriptors must refer to a pipe.  The
+ *   other file (a regular file, a socket, a character driver or another
+ *   pipe) is read into or written from the pipe buffer directly.
+ *
+ *   NOTE: This interface is not specified in POSIX.  It follows the Linux
+ *   splice() interface.
+ *
+ * Input Parameters:
+ *   fd_in   - The descriptor to read from.
+ *   off_in  - The offset to read from, updated on return.  Must be NULL if
+ *             fd_in is a pipe.  If NULL, the file position is used.
+ *   fd_out  - The descriptor to write to.
+ *   off_out - The offset to write to, updated on return.  Must be NULL if
+ *             fd_out is a pipe.  If NULL, the file position is used.
+ *   len     - The maximum number of bytes to move.
+ *   flags   - A bit mask of SPLICE_F_* values.  Only SPLICE_F_NONBLOCK has
+ *             any effect:  The pipe operation does not block.
+ *
+ * Returned Value:
+ *   The number of bytes moved is returned; zero means end of input.  On
+ *   error, -1 is returned and errno is set appropriately:
+ *
+ *   EAGAIN - SPLICE_F_NONBLOCK was given or the pipe is non-blocking and
+ *            the operation would block.
+ *   EBADF  - A descriptor is not valid or not opened with the right mode.
+ *   EINVAL - Neither descriptor refers to a pipe, or both refer to the
+ *            same pipe.
+ *   ESPIPE - An offset was given for a pipe.
+ *
+ ****************************************************************************/
+
+ssize_t splice(int fd_in, FAR off_t *off_in, int fd_out,
+               FAR off_t *off_out, size_t len, unsigned int flags)
+{
+  FAR struct file *infile;
+  FAR struct file *outfile;
+  ssize_t ret;
+
+  ret = fs_getfilep(fd_in, &infile);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = fs_getfilep(fd_out, &outfile);
+  if (ret < 0)
+    {
+      fs_putfilep(infile);
+      goto errout;
+    }
+
+  ret = file_splice(infile, off_in, outfile, off_out, len, flags);
+  fs_putfilep(outfile);
+  fs_putfilep(infile);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  return ret;
+
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: tee
+ *
+ * Description:
+ *   tee() duplicates up to 'len' bytes from the pipe 'fd_in' into the pipe
+ *   'fd_out' without consuming them from 'fd_in'.
+ *
+ *   NOTE: This interface is not specified in POSIX.  It follows the Linux
+ *   tee() interface.
+ *
+ * Returned Value:
+ *   The number of bytes duplicated is returned; zero means end of input.
+ *   On error, -1 is returned and errno is set appropriately.  EINVAL is
+ *   reported if either descriptor is not a pipe or both refer to the same
+ *   pipe.
+ *
+ ****************************************************************************/
+
+ssize_t tee(int fd_in, int fd_out, size_t len, unsigned int flags)
+{
+  FAR struct file *infile;
+  FAR struct file *outfile;
+  ssize_t ret;
+
+  ret = fs_getfilep(fd_in, &infile);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = fs_getfilep(fd_out, &outfile);
+  if (ret < 0)
+    {
+      fs_putfilep(infile);
+      goto errout;
+    }
+
+  ret = file_tee(infile, outfile, len, flags);
+  fs_putfilep(outfile);
+  fs_putfilep(infile);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  return ret;
+
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: vmsplice
+ *
+ * Description:
+ *   vmsplice() moves user memory described by 'iov' into the pipe 'fd' if
+ *   it was opened for writing, or fills it from the pipe if it was opened
+ *   for reading.  The pipe buffer is accessed directly, so the data is
+ *   copied exactly once.
+ *
+ *   NOTE: This interface is not specified in POSIX.  It follows the Linux
+ *   vmsplice() interface.  User pages are never referenced by the pipe,
+ *   so SPLICE_F_GIFT has no effect.  SPLICE_F_NONBLOCK limits the transfer
+ *   to what the pipe can take (or holds) at the time of the call.
+ *
+ * Returned Value:
+ *   The number of bytes transferred is returned.  On error, -1 is returned
+ *   and errno is set appropriately.  EBADF is reported if 'fd' is not a
+ *   pipe.
+ *
+ ****************************************************************************/
+
+ssize_t vmsplice(int fd, FAR const struct iovec *iov, size_t nr_segs,
+                 unsigned int flags)
+{
+  FAR struct file *filep;
+  ssize_t ntransferred = 0;
+  ssize_t nbytes;
+  ssize_t ret;
+  size_t limit = SSIZE_MAX;
+  size_t size;
+  bool wrok;
+  size_t i;
+
+  ret = fs_getfilep(fd, &filep);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  if (!INODE_IS_PIPE(filep->f_inode))
+    {
+      ret = -EBADF;
+      goto errout_with_filep;
+    }
+
+  wrok = (filep->f_oflags & O_WROK) != 0;
+
+  /* With SPLICE_F_NONBLOCK, move no more than the pipe can take (or has)
+   * right now.
+   */
+
+  if ((flags & SPLICE_F_NONBLOCK) != 0)
+    {
+      int avail;
+
+      ret = file_ioctl(filep, wrok ? FIONSPACE : FIONREAD, &avail);
+      if (ret < 0)
+        {
+          goto errout_with_filep;
+        }
+      else if (avail <= 0)
+        {
+          ret = -EAGAIN;
+          goto errout_with_filep;
+        }
+
+      limit = avail;
+    }
+
+  for (i = 0; i < nr_segs && (size_t)ntransferred < limit; i++)
+    {
+      size = MIN(iov[i].iov_len, limit - ntransferred);
+      if (size == 0)
+        {
+          continue;
+        }
+
+      if (wrok)
+        {
+          nbytes = file_write(filep, iov[i].iov_base, size);
+        }
+      else
+        {
+          nbytes = file_read(filep, iov[i].iov_base, size);
+        }
+
+      if (nbytes < 0)
+        {
+          if (ntransferred == 0)
+            {
+              ntransferred = nbytes;
+            }
+
+          break;
+        }
+
+      ntransferred += nbytes;
+      if ((size_t)nbytes < size)
+        {
+          break;
+        }
+    }
+
+  ret = ntransferred;
+
+errout_with_filep:
+  fs_putfilep(filep);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  return ret;
+
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
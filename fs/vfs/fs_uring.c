@@ -0,0 +1,1120 @@
+/****************************************************************************
+ * fs/vfs/fs_uring.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/uring.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <debug.h>
+
+#include <nuttx/cancelpt.h>
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wdog.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/fs/fs.h>
+
+#ifdef CONFIG_NET
+#  include <nuttx/net/net.h>
+#endif
+
+#include "inode/inode.h"
+#include "fs_heap.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* States of a request */
+
+#define URING_REQ_FREE      0  /* In the free list */
+#define URING_REQ_QUEUED    1  /* Queued to or performed by a worker */
+#define URING_REQ_ARMED     2  /* Waiting for its timeout or poll event */
+#define URING_REQ_FIRED     3  /* Timeout or poll event delivered */
+
+/* Returned by uring_socket() when an accepted socket still has to be
+ * installed by a thread of the owning task.
+ */
+
+#define URING_DEFERRED      1
+
+/* Fired timeout and poll requests are finished on a kernel work queue, not
+ * on the ring workers:  Blocking requests may occupy all of those.
+ */
+
+#ifdef CONFIG_SCHED_HPWORK
+#  define URING_FIREWORK    HPWORK
+#else
+#  define URING_FIREWORK    LPWORK
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct uring_s;
+struct uring_req_s
+{
+  struct work_s           work;     /* Performs the request on a worker */
+  FAR struct uring_s     *ring;     /* The ring of the request */
+  FAR struct uring_req_s *flink;    /* Free or deferred list link */
+  FAR struct file        *filep;    /* The file operated on, if any */
+  struct uring_sqe        sqe;      /* Copy of the submission */
+  uint8_t                 state;    /* See URING_REQ_* definitions */
+  union
+  {
+    struct wdog_s         wdog;     /* URING_OP_TIMEOUT */
+    struct pollfd         fds;      /* URING_OP_POLL_ADD */
+#ifdef CONFIG_NET
+    FAR struct socket    *newsock;  /* URING_OP_ACCEPT */
+#endif
+  } u;
+};
+
+/* The application can write anything to the shared queue descriptions.
+ * The kernel only reads their head and tail indexes from there; the sizes
+ * and addresses of the queues are kept in private copies.
+ */
+
+struct uring_s
+{
+  mutex_t                 lock;       /* Serializes the submissions */
+  spinlock_t              spinlock;   /* Protects the fields below */
+  sem_t                   waitsem;    /* Posted on completions */
+  FAR struct uring_sq    *sq;         /* Shared submission queue */
+  FAR struct uring_cq    *cq;         /* Shared completion queue */
+  FAR struct uring_sqe   *sqes;       /* Kernel copy of sq->sqes */
+  FAR struct uring_cqe   *cqes;       /* Kernel copy of cq->cqes */
+  FAR struct uring_req_s *freereq;    /* List of free requests */
+  FAR struct uring_req_s *deferred;   /* Accepted sockets to install */
+  uint32_t                sqmask;     /* Kernel copy of sq->mask */
+  uint32_t                cqmask;     /* Kernel copy of cq->mask */
+  uint32_t                cqentries;  /* Kernel copy of cq->entries */
+  uint32_t                sqhead;     /* Kernel copy of sq->head */
+  uint32_t                cqtail;     /* Kernel copy of cq->tail */
+  uint32_t                inflight;   /* Requests not completed yet */
+  uint8_t                 crefs;      /* Open references (max: 255) */
+  struct uring_req_s      reqs[1];    /* One request per completion slot */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int uring_open(FAR struct file *filep);
+static int uring_close(FAR struct file *filep);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_uring_fops =
+{
+  uring_open,  /* open */
+  uring_close, /* close */
+  NULL,        /* read */
+  NULL,        /* write */
+  NULL,        /* seek */
+  NULL,        /* ioctl */
+  NULL,        /* mmap */
+  NULL,        /* truncate */
+  NULL         /* poll */
+};
+
+static struct inode g_uring_inode =
+{
+  NULL,                   /* i_parent */
+  NULL,                   /* i_peer */
+  NULL,                   /* i_child */
+  1,                      /* i_crefs */
+  FSNODEFLAG_TYPE_DRIVER, /* i_flags */
+  {
+    &g_uring_fops         /* u */
+  }
+};
+
+/* The worker pool shared by all rings, created on first use */
+
+static FAR struct kwork_wqueue_s *g_uring_wqueue;
+static mutex_t g_uring_lock = NXMUTEX_INITIALIZER;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: uring_free
+ ****************************************************************************/
+
+static void uring_free(FAR struct uring_s *ring)
+{
+  kumm_free(ring->sqes);
+  nxsem_destroy(&ring->waitsem);
+  nxmutex_destroy(&ring->lock);
+  fs_heap_free(ring);
+}
+
+/****************************************************************************
+ * Name: uring_wakeup
+ *
+ * Description:
+ *   Wake up every thread waiting for completions on the ring.
+ *
+ ****************************************************************************/
+
+static void uring_wakeup(FAR struct uring_s *ring)
+{
+  int semcount;
+
+  nxsem_get_value(&ring->waitsem, &semcount);
+  while (semcount++ < 1)
+    {
+      nxsem_post(&ring->waitsem);
+    }
+}
+
+/****************************************************************************
+ * Name: uring_ncqes
+ *
+ * Description:
+ *   Return the number of completions the application has not consumed
+ *   yet.  A head moved past the kernel's tail counts as a full queue.
+ *   Called with the spinlock held.
+ *
+ ****************************************************************************/
+
+static uint32_t uring_ncqes(FAR struct uring_s *ring)
+{
+  uint32_t ncqes;
+
+  ncqes = ring->cqtail - atomic_load_explicit(&ring->cq->head,
+                                              memory_order_relaxed);
+  return ncqes > ring->cqentries ? ring->cqentries : ncqes;
+}
+
+/****************************************************************************
+ * Name: uring_alloc
+ *
+ * Description:
+ *   Allocate a request.  There is one request per completion slot, and a
+ *   request is only handed out if its completion will find a free slot.
+ *
+ ****************************************************************************/
+
+static FAR struct uring_req_s *uring_alloc(FAR struct uring_s *ring)
+{
+  FAR struct uring_req_s *req;
+  irqstate_t flags;
+  uint32_t ncqes;
+
+  flags = spin_lock_irqsave(&ring->spinlock);
+
+  ncqes = uring_ncqes(ring);
+  req   = ring->freereq;
+  if (req != NULL && ring->inflight + ncqes < ring->cqentries)
+    {
+      ring->freereq = req->flink;
+      ring->inflight++;
+    }
+  else
+    {
+      req = NULL;
+    }
+
+  spin_unlock_irqrestore(&ring->spinlock, flags);
+
+  if (req != NULL)
+    {
+      memset(&req->u, 0, sizeof(req->u));
+      req->filep = NULL;
+      req->state = URING_REQ_QUEUED;
+    }
+
+  return req;
+}
+
+/****************************************************************************
+ * Name: uring_complete
+ *
+ * Description:
+ *   Post the completion of a request and free the request.  The ring is
+ *   released with its last request once it has been closed.
+ *
+ ****************************************************************************/
+
+static void uring_complete(FAR struct uring_req_s *req, int res)
+{
+  FAR struct uring_s *ring = req->ring;
+  FAR struct uring_cqe *cqe;
+  irqstate_t flags;
+  bool release;
+
+  if (req->filep != NULL)
+    {
+      fs_putfilep(req->filep);
+      req->filep = NULL;
+    }
+
+  flags = spin_lock_irqsave(&ring->spinlock);
+
+  cqe            = &ring->cqes[ring->cqtail & ring->cqmask];
+  cqe->user_data = req->sqe.user_data;
+  cqe->res       = res;
+  cqe->flags     = 0;
+  atomic_store_explicit(&ring->cq->tail, ++ring->cqtail,
+                        memory_order_release);
+
+  req->state     = URING_REQ_FREE;
+  req->flink     = ring->freereq;
+  ring->freereq  = req;
+  release        = --ring->inflight == 0 && ring->crefs == 0;
+  if (!release)
+    {
+      uring_wakeup(ring);
+    }
+
+  spin_unlock_irqrestore(&ring->spinlock, flags);
+
+  if (release)
+    {
+      uring_free(ring);
+    }
+}
+
+/****************************************************************************
+ * Name: uring_rwv
+ *
+ * Description:
+ *   Perform URING_OP_READV or URING_OP_WRITEV.  The transfer stops at the
+ *   first short transfer, like readv() and writev() do.
+ *
+ ****************************************************************************/
+
+static ssize_t uring_rwv(FAR struct uring_req_s *req)
+{
+  FAR const struct iovec *iov =
+    (FAR const struct iovec *)(uintptr_t)req->sqe.addr;
+  bool write = req->sqe.opcode == URING_OP_WRITEV;
+  ssize_t ntotal = 0;
+  ssize_t ret = 0;
+  uint32_t i;
+
+  for (i = 0; i < req->sqe.len; i++)
+    {
+      if (iov[i].iov_len == 0)
+        {
+          continue;
+        }
+
+      if (req->sqe.off == URING_OFF_CURRENT)
+        {
+          ret = write ?
+                file_write(req->filep, iov[i].iov_base, iov[i].iov_len) :
+                file_read(req->filep, iov[i].iov_base, iov[i].iov_len);
+        }
+      else
+        {
+          off_t pos = (off_t)req->sqe.off + ntotal;
+
+          ret = write ?
+                file_pwrite(req->filep, iov[i].iov_base, iov[i].iov_len,
+                            pos) :
+                file_pread(req->filep, iov[i].iov_base, iov[i].iov_len,
+                           pos);
+        }
+
+      if (ret < 0)
+        {
+          return ntotal > 0 ? ntotal : ret;
+        }
+
+      ntotal += ret;
+      if ((size_t)ret < iov[i].iov_len)
+        {
+          break;
+        }
+    }
+
+  return ntotal;
+}
+
+/****************************************************************************
+ * Name: uring_socket
+ *
+ * Description:
+ *   Perform URING_OP_SEND, URING_OP_RECV or URING_OP_ACCEPT.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET
+static ssize_t uring_socket(FAR struct uring_req_s *req)
+{
+  FAR struct socket *psock = file_socket(req->filep);
+  FAR struct uring_s *ring = req->ring;
+  FAR struct uring_sqe *sqe = &req->sqe;
+  FAR void *buf = (FAR void *)(uintptr_t)sqe->addr;
+  FAR struct socket *newsock;
+  irqstate_t flags;
+  bool closed;
+  int ret;
+
+  if (psock == NULL)
+    {
+      return -ENOTSOCK;
+    }
+
+  if (sqe->opcode == URING_OP_SEND)
+    {
+      return psock_send(psock, buf, sqe->len, sqe->op_flags);
+    }
+  else if (sqe->opcode == URING_OP_RECV)
+    {
+      return psock_recv(psock, buf, sqe->len, sqe->op_flags);
+    }
+
+  newsock = fs_heap_zalloc(sizeof(*newsock));
+  if (newsock == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ret = psock_accept(psock, buf, (FAR socklen_t *)(uintptr_t)sqe->off,
+                     newsock, sqe->op_flags);
+  if (ret < 0)
+    {
+      fs_heap_free(newsock);
+      return ret;
+    }
+
+  /* The worker has no descriptor table of its own.  Hand the socket to the
+   * next thread that enters the ring, unless the ring was closed meanwhile.
+   */
+
+  fs_putfilep(req->filep);
+  req->filep     = NULL;
+  req->u.newsock = newsock;
+
+  flags  = spin_lock_irqsave(&ring->spinlock);
+  closed = ring->crefs == 0;
+  if (!closed)
+    {
+      req->flink     = ring->deferred;
+      ring->deferred = req;
+      uring_wakeup(ring);
+    }
+
+  spin_unlock_irqrestore(&ring->spinlock, flags);
+
+  if (closed)
+    {
+      psock_close(newsock);
+      fs_heap_free(newsock);
+      return -ECANCELED;
+    }
+
+  return URING_DEFERRED;
+}
+#endif
+
+/****************************************************************************
+ * Name: uring_worker
+ *
+ * Description:
+ *   Perform a request on a worker thread.
+ *
+ ****************************************************************************/
+
+static void uring_worker(FAR void *arg)
+{
+  FAR struct uring_req_s *req = arg;
+  FAR struct uring_sqe *sqe = &req->sqe;
+  FAR void *buf = (FAR void *)(uintptr_t)sqe->addr;
+  ssize_t ret;
+
+  switch (sqe->opcode)
+    {
+      case URING_OP_READ:
+        ret = sqe->off == URING_OFF_CURRENT ?
+              file_read(req->filep, buf, sqe->len) :
+              file_pread(req->filep, buf, sqe->len, (off_t)sqe->off);
+        break;
+
+      case URING_OP_WRITE:
+        ret = sqe->off == URING_OFF_CURRENT ?
+              file_write(req->filep, buf, sqe->len) :
+              file_pwrite(req->filep, buf, sqe->len, (off_t)sqe->off);
+        break;
+
+      case URING_OP_READV:
+      case URING_OP_WRITEV:
+        ret = uring_rwv(req);
+        break;
+
+#ifdef CONFIG_NET
+      case URING_OP_SEND:
+      case URING_OP_RECV:
+      case URING_OP_ACCEPT:
+        ret = uring_socket(req);
+        if (ret == URING_DEFERRED)
+          {
+            return;
+          }
+        break;
+#endif
+
+      default:
+        ret = -ENOSYS;
+        break;
+    }
+
+  uring_complete(req, ret);
+}
+
+/****************************************************************************
+ * Name: uring_fired
+ *
+ * Description:
+ *   Finish a timeout or poll request after it fired.
+ *
+ ****************************************************************************/
+
+static void uring_fired(FAR void *arg)
+{
+  FAR struct uring_req_s *req = arg;
+  int ret = -ETIME;
+
+  if (req->sqe.opcode == URING_OP_POLL_ADD)
+    {
+      file_poll(req->filep, &req->u.fds, false);
+      ret = req->u.fds.revents;
+    }
+
+  uring_complete(req, ret);
+}
+
+/****************************************************************************
+ * Name: uring_fire
+ *
+ * Description:
+ *   A timeout expired or a poll event arrived.  This may run in interrupt
+ *   context, so the request is finished on the kernel work queue.
+ *
+ ****************************************************************************/
+
+static void uring_fire(FAR struct uring_req_s *req)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&req->ring->spinlock);
+  if (req->state == URING_REQ_ARMED)
+    {
+      req->state = URING_REQ_FIRED;
+      work_queue(URING_FIREWORK, &req->work, uring_fired, req, 0);
+    }
+
+  spin_unlock_irqrestore(&req->ring->spinlock, flags);
+}
+
+static void uring_timeout(wdparm_t arg)
+{
+  uring_fire((FAR struct uring_req_s *)arg);
+}
+
+static void uring_pollnotify(FAR struct pollfd *fds)
+{
+  uring_fire(fds->arg);
+}
+
+/****************************************************************************
+ * Name: uring_disarm
+ *
+ * Description:
+ *   Take a request that failed to arm back from the timeout or the poll
+ *   callback.  Returns false if the callback got it first.
+ *
+ ****************************************************************************/
+
+static bool uring_disarm(FAR struct uring_req_s *req)
+{
+  irqstate_t flags;
+  bool armed;
+
+  flags = spin_lock_irqsave(&req->ring->spinlock);
+  armed = req->state == URING_REQ_ARMED;
+  req->state = URING_REQ_FIRED;
+  spin_unlock_irqrestore(&req->ring->spinlock, flags);
+
+  return armed;
+}
+
+/****************************************************************************
+ * Name: uring_submit
+ *
+ * Description:
+ *   Start a request in the context of the submitting thread, so that the
+ *   file descriptor is looked up in its task.
+ *
+ ****************************************************************************/
+
+static void uring_submit(FAR struct uring_req_s *req)
+{
+  FAR struct uring_sqe *sqe = &req->sqe;
+  int ret;
+
+  if (sqe->opcode >= URING_NOPS || sqe->flags != 0 || sqe->reserved != 0)
+    {
+      ret = -EINVAL;
+      goto out;
+    }
+
+  if (sqe->opcode == URING_OP_NOP)
+    {
+      ret = OK;
+      goto out;
+    }
+
+  if (sqe->opcode == URING_OP_TIMEOUT)
+    {
+      FAR const struct timespec *ts =
+        (FAR const struct timespec *)(uintptr_t)sqe->addr;
+
+      if (ts == NULL)
+        {
+          ret = -EFAULT;
+          goto out;
+        }
+
+      req->state = URING_REQ_ARMED;
+      ret = wd_start(&req->u.wdog, clock_time2ticks(ts), uring_timeout,
+                     (wdparm_t)req);
+      if (ret < 0 && uring_disarm(req))
+        {
+          goto out;
+        }
+
+      return;
+    }
+
+  ret = fs_getfilep(sqe->fd, &req->filep);
+  if (ret < 0)
+    {
+      goto out;
+    }
+
+  if (sqe->opcode == URING_OP_POLL_ADD)
+    {
+      req->u.fds.fd     = sqe->fd;
+      req->u.fds.events = sqe->op_flags;
+      req->u.fds.arg    = req;
+      req->u.fds.cb     = uring_pollnotify;
+      req->state        = URING_REQ_ARMED;
+
+      ret = file_poll(req->filep, &req->u.fds, true);
+      if (ret < 0 && uring_disarm(req))
+        {
+          goto out;
+        }
+
+      return;
+    }
+
+  ret = work_queue_wq(g_uring_wqueue, &req->work, uring_worker, req, 0);
+  if (ret >= 0)
+    {
+      return;
+    }
+
+out:
+  uring_complete(req, ret);
+}
+
+/****************************************************************************
+ * Name: uring_install
+ *
+ * Description:
+ *   Give the sockets accepted by the workers a descriptor in the task of
+ *   the calling thread and post their completions.
+ *
+ ****************************************************************************/
+
+static void uring_install(FAR struct uring_s *ring)
+{
+#ifdef CONFIG_NET
+  FAR struct uring_req_s *req;
+  irqstate_t flags;
+  int oflags;
+  int ret;
+
+  for (; ; )
+    {
+      flags = spin_lock_irqsave(&ring->spinlock);
+      req = ring->deferred;
+      if (req != NULL)
+        {
+          ring->deferred = req->flink;
+        }
+
+      spin_unlock_irqrestore(&ring->spinlock, flags);
+
+      if (req == NULL)
+        {
+          break;
+        }
+
+      oflags = O_RDWR;
+      if ((req->sqe.op_flags & SOCK_CLOEXEC) != 0)
+        {
+          oflags |= O_CLOEXEC;
+        }
+
+      if ((req->sqe.op_flags & SOCK_NONBLOCK) != 0)
+        {
+          oflags |= O_NONBLOCK;
+        }
+
+      ret = sockfd_allocate(req->u.newsock, oflags);
+      if (ret < 0)
+        {
+          psock_close(req->u.newsock);
+          fs_heap_free(req->u.newsock);
+          ret = -ENFILE;
+        }
+
+      uring_complete(req, ret);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: uring_open
+ ****************************************************************************/
+
+static int uring_open(FAR struct file *filep)
+{
+  FAR struct uring_s *ring = filep->f_priv;
+  irqstate_t flags;
+  int ret = OK;
+
+  flags = spin_lock_irqsave(&ring->spinlock);
+  if (ring->crefs >= 255)
+    {
+      /* More than 255 opens; uint8_t would overflow to zero */
+
+      ret = -EMFILE;
+    }
+  else
+    {
+      ring->crefs++;
+    }
+
+  spin_unlock_irqrestore(&ring->spinlock, flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: uring_close
+ *
+ * Description:
+ *   On the last close, cancel the armed timeouts and poll requests and drop
+ *   the accepted sockets that were not installed.  Requests still running
+ *   on a worker keep the ring alive until they complete.
+ *
+ ****************************************************************************/
+
+static int uring_close(FAR struct file *filep)
+{
+  FAR struct uring_s *ring = filep->f_priv;
+  FAR struct uring_req_s *cancel = NULL;
+  FAR struct uring_req_s *req;
+  irqstate_t flags;
+  bool release;
+  uint32_t i;
+
+  flags = spin_lock_irqsave(&ring->spinlock);
+  if (--ring->crefs > 0)
+    {
+      spin_unlock_irqrestore(&ring->spinlock, flags);
+      return OK;
+    }
+
+  /* Hold the ring while the requests are canceled */
+
+  ring->inflight++;
+
+  for (i = 0; i < ring->cqentries; i++)
+    {
+      req = &ring->reqs[i];
+      if (req->state == URING_REQ_ARMED)
+        {
+          req->state = URING_REQ_FIRED;
+          req->flink = cancel;
+          cancel     = req;
+        }
+    }
+
+  spin_unlock_irqrestore(&ring->spinlock, flags);
+
+  while (cancel != NULL)
+    {
+      req    = cancel;
+      cancel = req->flink;
+
+      if (req->sqe.opcode == URING_OP_TIMEOUT)
+        {
+          wd_cancel(&req->u.wdog);
+        }
+      else
+        {
+          file_poll(req->filep, &req->u.fds, false);
+        }
+
+      uring_complete(req, -ECANCELED);
+    }
+
+#ifdef CONFIG_NET
+  flags = spin_lock_irqsave(&ring->spinlock);
+  cancel = ring->deferred;
+  ring->deferred = NULL;
+  spin_unlock_irqrestore(&ring->spinlock, flags);
+
+  while (cancel != NULL)
+    {
+      req    = cancel;
+      cancel = req->flink;
+
+      psock_close(req->u.newsock);
+      fs_heap_free(req->u.newsock);
+      uring_complete(req, -ECANCELED);
+    }
+#endif
+
+  flags = spin_lock_irqsave(&ring->spinlock);
+  release = --ring->inflight == 0;
+  spin_unlock_irqrestore(&ring->spinlock, flags);
+
+  if (release)
+    {
+      uring_free(ring);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: uring_setup
+ *
+ * Description:
+ *   Create a submission/completion ring pair.  The rings live in memory
+ *   shared with the application; their addresses are returned in params.
+ *   The completion queue has twice as many entries as the submission
+ *   queue.
+ *
+ * Input Parameters:
+ *   entries - Minimum number of submission queue entries, rounded up to a
+ *             power of two
+ *   params  - Returns the ring description.  flags must be zero.
+ *
+ * Returned Value:
+ *   The file descriptor of the ring on success.  On failure, -1 (ERROR) is
+ *   returned and errno is set appropriately.
+ *
+ ****************************************************************************/
+
+int uring_setup(unsigned int entries, FAR struct uring_params *params)
+{
+  FAR struct uring_s *ring;
+  FAR struct uring_sqe *sqes;
+  FAR struct uring_cqe *cqes;
+  uint32_t sqentries;
+  uint32_t cqentries;
+  uint32_t i;
+  int ret;
+
+  if (params == NULL || params->flags != 0 || entries == 0 ||
+      entries > CONFIG_FS_URING_MAXENTRIES)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  for (sqentries = 1; sqentries < entries; sqentries <<= 1);
+  cqentries = 2 * sqentries;
+
+  /* Create the worker pool on first use */
+
+  ret = nxmutex_lock(&g_uring_lock);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  if (g_uring_wqueue == NULL)
+    {
+      g_uring_wqueue = work_queue_create("uring", CONFIG_FS_URING_PRIORITY,
+                                         NULL, CONFIG_FS_URING_STACKSIZE,
+                                         CONFIG_FS_URING_NTHREADS);
+    }
+
+  nxmutex_unlock(&g_uring_lock);
+  if (g_uring_wqueue == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  ring = fs_heap_zalloc(sizeof(struct uring_s) +
+                        (cqentries - 1) * sizeof(struct uring_req_s));
+  if (ring == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  /* The shared memory must be reachable from the application */
+
+  sqes = kumm_zalloc(sqentries * sizeof(struct uring_sqe) +
+                     cqentries * sizeof(struct uring_cqe) +
+                     sizeof(struct uring_sq) + sizeof(struct uring_cq));
+  if (sqes == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_ring;
+    }
+
+  cqes              = (FAR struct uring_cqe *)(sqes + sqentries);
+  ring->sq          = (FAR struct uring_sq *)(cqes + cqentries);
+  ring->cq          = (FAR struct uring_cq *)(ring->sq + 1);
+  ring->sq->mask    = sqentries - 1;
+  ring->sq->entries = sqentries;
+  ring->sq->sqes    = sqes;
+  ring->cq->mask    = cqentries - 1;
+  ring->cq->entries = cqentries;
+  ring->cq->cqes    = cqes;
+  ring->sqes        = sqes;
+  ring->cqes        = cqes;
+  ring->sqmask      = sqentries - 1;
+  ring->cqmask      = cqentries - 1;
+  ring->cqentries   = cqentries;
+  ring->crefs       = 1;
+
+  for (i = 0; i < cqentries; i++)
+    {
+      ring->reqs[i].ring  = ring;
+      ring->reqs[i].flink = ring->freereq;
+      ring->freereq       = &ring->reqs[i];
+    }
+
+  nxmutex_init(&ring->lock);
+  nxsem_init(&ring->waitsem, 0, 0);
+  spin_lock_init(&ring->spinlock);
+
+  ret = file_allocate(&g_uring_inode, O_RDWR | O_CLOEXEC, 0, ring, 0, true);
+  if (ret < 0)
+    {
+      goto errout_with_sem;
+    }
+
+  params->sq_entries = sqentries;
+  params->cq_entries = cqentries;
+  params->sq         = ring->sq;
+  params->cq         = ring->cq;
+  return ret;
+
+errout_with_sem:
+  nxsem_destroy(&ring->waitsem);
+  nxmutex_destroy(&ring->lock);
+  kumm_free(sqes);
+errout_with_ring:
+  fs_heap_free(ring);
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: uring_enter
+ *
+ * Description:
+ *   Submit the entries the application added to the submission queue and
+ *   optionally wait for completions.  One call submits a whole batch; the
+ *   requests are performed by a pool of kernel workers, which post the
+ *   completions directly to the shared completion queue.
+ *
+ *   The descriptors named in the entries are looked up in the task of the
+ *   calling thread.  Sockets accepted by URING_OP_ACCEPT get their
+ *   descriptor in the task of the next thread that enters the ring.
+ *
+ * Input Parameters:
+ *   fd           - The ring returned by uring_setup()
+ *   to_submit    - Maximum number of entries to submit
+ *   min_complete - With URING_ENTER_GETEVENTS, wait until the completion
+ *                  queue holds at least this many entries
+ *   flags        - URING_ENTER_* flags
+ *
+ * Returned Value:
+ *   The number of entries submitted on success.  A failed submission
+ *   still counts; its error is returned in its completion.  On failure,
+ *   -1 (ERROR) is returned and errno is set appropriately:
+ *
+ *   EBADF  - fd is not a ring.
+ *   EBUSY  - No entry could be submitted because the completion queue
+ *            would overflow.
+ *   EINTR  - A signal interrupted the wait and nothing was submitted.
+ *   EINVAL - Invalid flags.
+ *
+ ****************************************************************************/
+
+int uring_enter(int fd, unsigned int to_submit, unsigned int min_complete,
+                unsigned int flags)
+{
+  FAR struct uring_req_s *req;
+  FAR struct uring_s *ring;
+  FAR struct file *filep;
+  unsigned int submitted = 0;
+  irqstate_t irqflags;
+  bool busy;
+  uint32_t ncqes;
+  uint32_t tail;
+  int ret;
+
+  /* uring_enter() is a cancellation point */
+
+  enter_cancellation_point();
+
+  if ((flags & ~URING_ENTER_GETEVENTS) != 0)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  ret = fs_getfilep(fd, &filep);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  if (filep->f_inode != &g_uring_inode)
+    {
+      ret = -EBADF;
+      goto errout_with_filep;
+    }
+
+  ring = filep->f_priv;
+  ret = nxmutex_lock(&ring->lock);
+  if (ret < 0)
+    {
+      goto errout_with_filep;
+    }
+
+  /* Free completion slots for new submissions first */
+
+  uring_install(ring);
+
+  tail = atomic_load_explicit(&ring->sq->tail, memory_order_acquire);
+  while (submitted < to_submit && ring->sqhead != tail)
+    {
+      req = uring_alloc(ring);
+      if (req == NULL)
+        {
+          break;
+        }
+
+      memcpy(&req->sqe, &ring->sqes[ring->sqhead & ring->sqmask],
+             sizeof(struct uring_sqe));
+      atomic_store_explicit(&ring->sq->head, ++ring->sqhead,
+                            memory_order_release);
+
+      uring_submit(req);
+      submitted++;
+    }
+
+  busy = submitted == 0 && to_submit > 0 && ring->sqhead != tail;
+  nxmutex_unlock(&ring->lock);
+
+  if (busy)
+    {
+      ret = -EBUSY;
+      goto errout_with_filep;
+    }
+
+  if ((flags & URING_ENTER_GETEVENTS) != 0)
+    {
+      if (min_complete > ring->cqentries)
+        {
+          min_complete = ring->cqentries;
+        }
+
+      for (; ; )
+        {
+          uring_install(ring);
+
+          irqflags = spin_lock_irqsave(&ring->spinlock);
+          ncqes = uring_ncqes(ring);
+          spin_unlock_irqrestore(&ring->spinlock, irqflags);
+
+          if (ncqes >= min_complete)
+            {
+              break;
+            }
+
+          ret = nxsem_wait(&ring->waitsem);
+          if (ret < 0)
+            {
+              if (submitted == 0)
+                {
+                  goto errout_with_filep;
+                }
+
+              break;
+            }
+        }
+    }
+
+  fs_putfilep(filep);
+  leave_cancellation_point();
+  return submitted;
+
+errout_with_filep:
+  fs_putfilep(filep);
+errout:
+  leave_cancellation_point();
+  set_errno(-ret);
+  return ERROR;
+}
@@ -37,6 +37,7 @@
 
 #include "notify/notify.h"
 #include "inode/inode.h"
+#include "writeback/writeback.h"
 
 /****************************************************************************
  * Public Functions
@@ -98,6 +99,13 @@ ssize_t file_write(FAR struct file *filep, FAR const void *buf,
     }
 #endif
 
+#ifdef CONFIG_FS_WRITEBACK
+  if (ret > 0)
+    {
+      writeback_dirty(filep, ret);
+    }
+#endif
+
   return ret;
 }
 
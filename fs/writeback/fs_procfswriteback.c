@@ -0,0 +1,379 @@
+/****************************************************************************
+ * fs/writeback/fs_procfswriteback.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+#include <nuttx/lib/lib.h>
+
+#include "fs_heap.h"
+#include "inode/inode.h"
+#include "writeback/writeback.h"
+
+#if defined(CONFIG_FS_WRITEBACK) && defined(CONFIG_FS_PROCFS) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_WRITEBACK)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define WRITEBACK_LINELEN 96
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct writeback_file_s
+{
+  struct procfs_file_s base;      /* Base open file structure */
+  char line[WRITEBACK_LINELEN];   /* Pre-allocated buffer for formatted lines */
+};
+
+/* State of one read */
+
+struct writeback_read_s
+{
+  FAR struct writeback_file_s *procfile; /* The open file */
+  FAR char *pathbuffer;                  /* Mountpoint path */
+  FAR char *buffer;                      /* Remaining user buffer */
+  size_t buflen;                         /* Size of the remaining buffer */
+  size_t totalsize;                      /* Bytes returned so far */
+  off_t offset;                          /* Bytes still to skip */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* Helpers */
+
+static void    writeback_advance(FAR struct writeback_read_s *ctx,
+                 size_t copysize);
+static int     writeback_sum(FAR struct inode *mountpt,
+                 FAR const struct writeback_stats_s *stats, FAR void *arg);
+static int     writeback_mount(FAR struct inode *mountpt,
+                 FAR const struct writeback_stats_s *stats, FAR void *arg);
+
+/* File system methods */
+
+static int     writeback_open(FAR struct file *filep,
+                 FAR const char *relpath, int oflags, mode_t mode);
+static int     writeback_close(FAR struct file *filep);
+static ssize_t writeback_procread(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     writeback_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     writeback_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_procfs.c -- this structure is explicitly externed there. */
+
+const struct procfs_operations g_writeback_operations =
+{
+  writeback_open,      /* open */
+  writeback_close,     /* close */
+  writeback_procread,  /* read */
+  NULL,                /* write */
+  NULL,                /* poll */
+  writeback_dup,       /* dup */
+  NULL,                /* opendir */
+  NULL,                /* closedir */
+  NULL,                /* readdir */
+  NULL,                /* rewinddir */
+  writeback_stat       /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: writeback_advance
+ ****************************************************************************/
+
+static void writeback_advance(FAR struct writeback_read_s *ctx,
+                              size_t copysize)
+{
+  ctx->totalsize += copysize;
+  ctx->buffer    += copysize;
+  ctx->buflen    -= copysize;
+}
+
+/****************************************************************************
+ * Name: writeback_sum
+ *
+ * Description:
+ *   Add up the dirty data of all file systems.
+ *
+ ****************************************************************************/
+
+static int writeback_sum(FAR struct inode *mountpt,
+                         FAR const struct writeback_stats_s *stats,
+                         FAR void *arg)
+{
+  *(FAR size_t *)arg += stats->dirty;
+  return 0;
+}
+
+/****************************************************************************
+ * Name: writeback_mount
+ *
+ * Description:
+ *   Show the accounting of one file system.
+ *
+ ****************************************************************************/
+
+static int writeback_mount(FAR struct inode *mountpt,
+                           FAR const struct writeback_stats_s *stats,
+                           FAR void *arg)
+{
+  FAR struct writeback_read_s *ctx = arg;
+  size_t linesize;
+  size_t copysize;
+  size_t len;
+
+  /* inode_getpath() appends a '/' to mountpoints */
+
+  if (inode_getpath(mountpt, ctx->pathbuffer, PATH_MAX) < 0)
+    {
+      ctx->pathbuffer[0] = '\0';
+    }
+
+  len = strlen(ctx->pathbuffer);
+  if (len > 1 && ctx->pathbuffer[len - 1] == '/')
+    {
+      ctx->pathbuffer[len - 1] = '\0';
+    }
+
+  linesize = procfs_snprintf(ctx->procfile->line, WRITEBACK_LINELEN,
+                             "%-20s%10zu%10zu%12" PRIu64 "%10" PRIu32
+                             "%10" PRIu32 "\n", ctx->pathbuffer,
+                             stats->dirty, stats->writeback, stats->written,
+                             stats->flushed, stats->throttled);
+  copysize = procfs_memcpy(ctx->procfile->line, linesize, ctx->buffer,
+                           ctx->buflen, &ctx->offset);
+  writeback_advance(ctx, copysize);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: writeback_open
+ ****************************************************************************/
+
+static int writeback_open(FAR struct file *filep, FAR const char *relpath,
+                          int oflags, mode_t mode)
+{
+  FAR struct writeback_file_s *procfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  procfile = fs_heap_zalloc(sizeof(struct writeback_file_s));
+  if (!procfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = procfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: writeback_close
+ ****************************************************************************/
+
+static int writeback_close(FAR struct file *filep)
+{
+  FAR struct writeback_file_s *procfile = filep->f_priv;
+
+  DEBUGASSERT(procfile);
+
+  /* Release the file attributes structure */
+
+  fs_heap_free(procfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: writeback_procread
+ ****************************************************************************/
+
+static ssize_t writeback_procread(FAR struct file *filep, FAR char *buffer,
+                                  size_t buflen)
+{
+  FAR struct writeback_file_s *procfile = filep->f_priv;
+  struct writeback_read_s ctx;
+  size_t dirty = 0;
+  size_t linesize;
+  size_t copysize;
+
+  DEBUGASSERT(procfile && buffer != NULL && buflen > 0);
+
+  ctx.pathbuffer = lib_get_pathbuffer();
+  if (ctx.pathbuffer == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ctx.procfile  = procfile;
+  ctx.buffer    = buffer;
+  ctx.buflen    = buflen;
+  ctx.offset    = filep->f_pos;
+  ctx.totalsize = 0;
+
+  /* The mountpoints stay valid while the inode tree is locked */
+
+  inode_rlock();
+  writeback_foreach(writeback_sum, &dirty);
+
+  /* The first lines are the dirty total and the thresholds */
+
+  linesize  = procfs_snprintf(procfile->line, WRITEBACK_LINELEN,
+                              "%10s%11s%10s\n",
+                              "dirty", "background", "limit");
+  copysize  = procfs_memcpy(procfile->line, linesize, ctx.buffer,
+                            ctx.buflen, &ctx.offset);
+  writeback_advance(&ctx, copysize);
+
+  linesize  = procfs_snprintf(procfile->line, WRITEBACK_LINELEN,
+                              "%10zu%11d%10d\n", dirty,
+                              CONFIG_FS_WRITEBACK_BACKGROUND,
+                              CONFIG_FS_WRITEBACK_LIMIT);
+  copysize  = procfs_memcpy(procfile->line, linesize, ctx.buffer,
+                            ctx.buflen, &ctx.offset);
+  writeback_advance(&ctx, copysize);
+
+  /* Then one line per mounted file system */
+
+  linesize  = procfs_snprintf(procfile->line, WRITEBACK_LINELEN,
+                              "%-20s%10s%10s%12s%10s%10s\n", "mount",
+                              "dirty", "writeback", "written", "flushed",
+                              "throttled");
+  copysize  = procfs_memcpy(procfile->line, linesize, ctx.buffer,
+                            ctx.buflen, &ctx.offset);
+  writeback_advance(&ctx, copysize);
+
+  writeback_foreach(writeback_mount, &ctx);
+  inode_runlock();
+
+  lib_put_pathbuffer(ctx.pathbuffer);
+
+  /* Update the file offset */
+
+  filep->f_pos += ctx.totalsize;
+  return ctx.totalsize;
+}
+
+/****************************************************************************
+ * Name: writeback_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int writeback_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct writeback_file_s *oldattr = oldp->f_priv;
+  FAR struct writeback_file_s *newattr;
+
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the attributes */
+
+  newattr = fs_heap_malloc(sizeof(struct writeback_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct writeback_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: writeback_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int writeback_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "fs/writeback" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* CONFIG_FS_WRITEBACK && CONFIG_FS_PROCFS &&
+        * !CONFIG_FS_PROCFS_EXCLUDE_WRITEBACK */
@@ -0,0 +1,518 @@
+/****************************************************************************
+ * fs/writeback/fs_writeback.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/mutex.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/fs/fs.h>
+
+#include "fs_heap.h"
+#include "inode/inode.h"
+#include "writeback/writeback.h"
+
+#ifdef CONFIG_FS_WRITEBACK
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define WRITEBACK_LIMIT       CONFIG_FS_WRITEBACK_LIMIT
+#define WRITEBACK_BACKGROUND  CONFIG_FS_WRITEBACK_BACKGROUND
+#define WRITEBACK_BATCH       CONFIG_FS_WRITEBACK_BATCH
+#define WRITEBACK_INTERVAL    MSEC2TICK(CONFIG_FS_WRITEBACK_INTERVAL)
+
+#if WRITEBACK_BACKGROUND > WRITEBACK_LIMIT
+#  error CONFIG_FS_WRITEBACK_BACKGROUND must not exceed CONFIG_FS_WRITEBACK_LIMIT
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The accounting of one mounted file system.  The dirty bytes of an open
+ * file only count while the file's generation matches the generation of
+ * its file system; the flusher moves to a new generation each time it
+ * syncs the whole file system.
+ */
+
+struct writeback_mount_s
+{
+  FAR struct writeback_mount_s *wm_flink; /* Next mounted file system */
+  FAR struct inode *wm_inode;             /* The mountpoint inode */
+  struct writeback_stats_s wm_stats;      /* Dirty data and counters */
+  unsigned int wm_gen;                    /* Current generation */
+  bool wm_syncfs;                         /* The flusher can sync it */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Protects everything below */
+
+static mutex_t g_writeback_lock = NXMUTEX_INITIALIZER;
+
+/* The file systems written to since they were mounted */
+
+static FAR struct writeback_mount_s *g_writeback_mounts;
+
+/* Dirty bytes of all file systems */
+
+static size_t g_writeback_dirty;
+
+/* The background flusher, and whether it has been asked to run now */
+
+static struct work_s g_writeback_work;
+static bool g_writeback_urgent;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: writeback_find
+ *
+ * Description:
+ *   Find the accounting of a file system, optionally creating it.  Called
+ *   with g_writeback_lock held.
+ *
+ ****************************************************************************/
+
+static FAR struct writeback_mount_s *
+writeback_find(FAR struct inode *mountpt, bool create)
+{
+  FAR struct writeback_mount_s *wm;
+
+  for (wm = g_writeback_mounts; wm != NULL; wm = wm->wm_flink)
+    {
+      if (wm->wm_inode == mountpt)
+        {
+          return wm;
+        }
+    }
+
+  if (create)
+    {
+      wm = fs_heap_zalloc(sizeof(struct writeback_mount_s));
+      if (wm != NULL)
+        {
+          wm->wm_inode       = mountpt;
+          wm->wm_syncfs      = mountpt->u.i_mops->syncfs != NULL;
+          wm->wm_flink       = g_writeback_mounts;
+          g_writeback_mounts = wm;
+        }
+    }
+
+  return wm;
+}
+
+/****************************************************************************
+ * Name: writeback_current
+ *
+ * Description:
+ *   Forget the dirty bytes of a file that were accounted before its file
+ *   system was last synced as a whole.  Called with g_writeback_lock held.
+ *
+ ****************************************************************************/
+
+static void writeback_current(FAR struct file *filep,
+                              FAR struct writeback_mount_s *wm)
+{
+  if (filep->f_wbgen != wm->wm_gen)
+    {
+      filep->f_dirty = 0;
+      filep->f_wbgen = wm->wm_gen;
+    }
+}
+
+/****************************************************************************
+ * Name: writeback_sync
+ *
+ * Description:
+ *   Sync one file, accounting its dirty data as under writeback meanwhile.
+ *
+ ****************************************************************************/
+
+static int writeback_sync(FAR struct file *filep,
+                          FAR struct writeback_mount_s *wm)
+{
+  size_t nbytes;
+  int ret;
+
+  nxmutex_lock(&g_writeback_lock);
+  writeback_current(filep, wm);
+  nbytes = filep->f_dirty;
+  wm->wm_stats.writeback += nbytes;
+  nxmutex_unlock(&g_writeback_lock);
+
+  /* file_fsync() accounts the data as written on success */
+
+  ret = file_fsync(filep);
+
+  nxmutex_lock(&g_writeback_lock);
+  wm->wm_stats.writeback -= nbytes;
+  nxmutex_unlock(&g_writeback_lock);
+
+  if (ret < 0)
+    {
+      ferr("ERROR: Write back failed: %d\n", ret);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: writeback_pending
+ *
+ * Description:
+ *   Return true if a file system the flusher can sync has dirty data.
+ *   Called with g_writeback_lock held.
+ *
+ ****************************************************************************/
+
+static bool writeback_pending(void)
+{
+  FAR struct writeback_mount_s *wm;
+
+  for (wm = g_writeback_mounts; wm != NULL; wm = wm->wm_flink)
+    {
+      if (wm->wm_syncfs && wm->wm_stats.dirty > 0)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: writeback_worker
+ *
+ * Description:
+ *   The background flusher.  It syncs the file systems with dirty data
+ *   through their syncfs() method, so it never touches the open files of
+ *   other tasks.  Each pass syncs at most CONFIG_FS_WRITEBACK_BATCH file
+ *   systems, then gives the work queue to other work before it continues.
+ *
+ ****************************************************************************/
+
+static void writeback_worker(FAR void *arg)
+{
+  FAR struct writeback_mount_s *wm;
+  FAR struct inode *mountpt;
+  unsigned int npicked = 0;
+  unsigned int nsynced = 0;
+  size_t nbytes;
+  int ret;
+
+  /* The inode lock keeps the file systems mounted during the pass */
+
+  inode_rlock();
+  nxmutex_lock(&g_writeback_lock);
+  g_writeback_urgent = false;
+
+  for (wm = g_writeback_mounts; wm != NULL && npicked < WRITEBACK_BATCH;
+       wm = wm->wm_flink)
+    {
+      if (!wm->wm_syncfs || wm->wm_stats.dirty == 0)
+        {
+          continue;
+        }
+
+      /* The sync covers all the data dirty now.  Start a new generation,
+       * so that the files written to before it do not account their share
+       * a second time.
+       */
+
+      mountpt = wm->wm_inode;
+      nbytes  = wm->wm_stats.dirty;
+      wm->wm_stats.writeback += nbytes;
+      wm->wm_gen++;
+      npicked++;
+      nxmutex_unlock(&g_writeback_lock);
+
+      ret = mountpt->u.i_mops->syncfs(mountpt);
+
+      nxmutex_lock(&g_writeback_lock);
+      wm->wm_stats.writeback -= nbytes;
+      if (ret >= 0)
+        {
+          DEBUGASSERT(g_writeback_dirty >= nbytes);
+          wm->wm_stats.dirty   -= nbytes;
+          wm->wm_stats.written += nbytes;
+          wm->wm_stats.flushed++;
+          g_writeback_dirty    -= nbytes;
+          nsynced++;
+        }
+      else
+        {
+          /* The bytes stay dirty until a later pass syncs them */
+
+          ferr("ERROR: Write back failed: %d\n", ret);
+        }
+    }
+
+  if (writeback_pending())
+    {
+      if (wm != NULL && nsynced > 0)
+        {
+          /* The batch was used up, continue right after other work */
+
+          g_writeback_urgent = true;
+          work_queue(LPWORK, &g_writeback_work, writeback_worker, NULL, 0);
+        }
+      else
+        {
+          /* Data dirtied during the pass, or failed writes, wait for the
+           * next interval.
+           */
+
+          work_queue(LPWORK, &g_writeback_work, writeback_worker, NULL,
+                     WRITEBACK_INTERVAL);
+        }
+    }
+
+  nxmutex_unlock(&g_writeback_lock);
+  inode_runlock();
+}
+
+/****************************************************************************
+ * Name: writeback_kick
+ *
+ * Description:
+ *   Schedule the background flusher.  Dirty data is synced
+ *   CONFIG_FS_WRITEBACK_INTERVAL milliseconds after it was written at the
+ *   latest, or right away above the background threshold.  Only the file
+ *   systems with a syncfs() method are synced in the background.  Called
+ *   with g_writeback_lock held.
+ *
+ ****************************************************************************/
+
+static void writeback_kick(FAR struct writeback_mount_s *wm)
+{
+  if (!wm->wm_syncfs)
+    {
+      return;
+    }
+
+  if (g_writeback_dirty > WRITEBACK_BACKGROUND)
+    {
+      if (!g_writeback_urgent)
+        {
+          g_writeback_urgent = true;
+          work_queue(LPWORK, &g_writeback_work, writeback_worker, NULL, 0);
+        }
+    }
+  else if (g_writeback_dirty > 0 && work_available(&g_writeback_work))
+    {
+      work_queue(LPWORK, &g_writeback_work, writeback_worker, NULL,
+                 WRITEBACK_INTERVAL);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: writeback_dirty
+ *
+ * Description:
+ *   Account data written to a file of a mounted file system.  Starts the
+ *   background flusher above CONFIG_FS_WRITEBACK_BACKGROUND dirty bytes.
+ *   Above CONFIG_FS_WRITEBACK_LIMIT, the caller syncs its own file before
+ *   it returns.
+ *
+ * Input Parameters:
+ *   filep  - The file written to.
+ *   nbytes - Number of bytes written.
+ *
+ ****************************************************************************/
+
+void writeback_dirty(FAR struct file *filep, size_t nbytes)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct writeback_mount_s *wm;
+  bool throttle;
+
+  /* Only file systems that can sync have data to write back */
+
+  if (!INODE_IS_MOUNTPT(inode) || inode->u.i_mops->sync == NULL)
+    {
+      return;
+    }
+
+  nxmutex_lock(&g_writeback_lock);
+  wm = writeback_find(inode, true);
+  if (wm == NULL)
+    {
+      nxmutex_unlock(&g_writeback_lock);
+      return;
+    }
+
+  writeback_current(filep, wm);
+  filep->f_dirty        += nbytes;
+  wm->wm_stats.dirty    += nbytes;
+  g_writeback_dirty     += nbytes;
+
+  /* A writer that pushes the dirty data above the limit writes its own
+   * file back.  This slows down the heavy writers, not the others.
+   */
+
+  throttle = g_writeback_dirty > WRITEBACK_LIMIT;
+  if (throttle)
+    {
+      wm->wm_stats.throttled++;
+    }
+
+  writeback_kick(wm);
+  nxmutex_unlock(&g_writeback_lock);
+
+  if (throttle)
+    {
+      writeback_sync(filep, wm);
+    }
+}
+
+/****************************************************************************
+ * Name: writeback_clean
+ *
+ * Description:
+ *   Account the dirty data of a file as written, after the file was synced
+ *   or closed.
+ *
+ * Input Parameters:
+ *   filep - The file synced or closed.
+ *
+ ****************************************************************************/
+
+void writeback_clean(FAR struct file *filep)
+{
+  FAR struct writeback_mount_s *wm;
+
+  if (filep->f_dirty == 0)
+    {
+      return;
+    }
+
+  nxmutex_lock(&g_writeback_lock);
+  wm = writeback_find(filep->f_inode, false);
+  if (wm != NULL && filep->f_wbgen == wm->wm_gen)
+    {
+      DEBUGASSERT(g_writeback_dirty >= filep->f_dirty);
+      wm->wm_stats.dirty   -= filep->f_dirty;
+      wm->wm_stats.written += filep->f_dirty;
+      g_writeback_dirty    -= filep->f_dirty;
+    }
+
+  filep->f_dirty = 0;
+  nxmutex_unlock(&g_writeback_lock);
+}
+
+/****************************************************************************
+ * Name: writeback_unmount
+ *
+ * Description:
+ *   Forget the accounting of a file system that is being unmounted.  The
+ *   caller holds the inode lock.
+ *
+ * Input Parameters:
+ *   mountpt - The mountpoint inode.
+ *
+ ****************************************************************************/
+
+void writeback_unmount(FAR struct inode *mountpt)
+{
+  FAR struct writeback_mount_s **link;
+  FAR struct writeback_mount_s *wm;
+
+  nxmutex_lock(&g_writeback_lock);
+  for (link = &g_writeback_mounts; *link != NULL; link = &wm->wm_flink)
+    {
+      wm = *link;
+      if (wm->wm_inode == mountpt)
+        {
+          /* No file is open any more.  Bytes left dirty by a failed sync
+           * of the whole file system are dropped with the accounting.
+           */
+
+          DEBUGASSERT(g_writeback_dirty >= wm->wm_stats.dirty);
+          g_writeback_dirty -= wm->wm_stats.dirty;
+          *link = wm->wm_flink;
+          fs_heap_free(wm);
+          break;
+        }
+    }
+
+  nxmutex_unlock(&g_writeback_lock);
+}
+
+/****************************************************************************
+ * Name: writeback_foreach
+ *
+ * Description:
+ *   Call a function with the accounting of each file system that has been
+ *   written to.  The caller holds the inode lock, so the mountpoints stay
+ *   valid.  The traversal stops when the callback returns non-zero.
+ *
+ * Input Parameters:
+ *   handler - The callback.
+ *   arg     - Passed to the callback.
+ *
+ * Returned Value:
+ *   The last value returned by the callback.
+ *
+ ****************************************************************************/
+
+int writeback_foreach(writeback_foreach_t handler, FAR void *arg)
+{
+  FAR struct writeback_mount_s *wm;
+  int ret;
+
+  ret = nxmutex_lock(&g_writeback_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (wm = g_writeback_mounts; wm != NULL && ret == 0; wm = wm->wm_flink)
+    {
+      ret = handler(wm->wm_inode, &wm->wm_stats, arg);
+    }
+
+  nxmutex_unlock(&g_writeback_lock);
+  return ret;
+}
+
+#endif /* CONFIG_FS_WRITEBACK */
@@ -0,0 +1,133 @@
+/****************************************************************************
+ * fs/writeback/writeback.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __FS_WRITEBACK_WRITEBACK_H
+#define __FS_WRITEBACK_WRITEBACK_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#include <nuttx/fs/fs.h>
+
+#ifdef CONFIG_FS_WRITEBACK
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+/* Dirty data accounting of one mounted file system, as reported in
+ * /proc/fs/writeback
+ */
+
+struct writeback_stats_s
+{
+  size_t   dirty;       /* Bytes written but not yet synced */
+  size_t   writeback;   /* Bytes being synced right now */
+  uint64_t written;     /* Bytes synced since the mount */
+  uint32_t flushed;     /* Syncs by the background flusher */
+  uint32_t throttled;   /* Writes that had to sync their own file */
+};
+
+/* Callback of writeback_foreach() */
+
+typedef CODE int (*writeback_foreach_t)(FAR struct inode *mountpt,
+                                        FAR const struct
+                                        writeback_stats_s *stats,
+                                        FAR void *arg);
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: writeback_dirty
+ *
+ * Description:
+ *   Account data written to a file of a mounted file system.  Starts the
+ *   background flusher above CONFIG_FS_WRITEBACK_BACKGROUND dirty bytes.
+ *   Above CONFIG_FS_WRITEBACK_LIMIT, the caller syncs its own file before
+ *   it returns.
+ *
+ * Input Parameters:
+ *   filep  - The file written to.
+ *   nbytes - Number of bytes written.
+ *
+ ****************************************************************************/
+
+void writeback_dirty(FAR struct file *filep, size_t nbytes);
+
+/****************************************************************************
+ * Name: writeback_clean
+ *
+ * Description:
+ *   Account the dirty data of a file as written, after the file was synced
+ *   or closed.
+ *
+ * Input Parameters:
+ *   filep - The file synced or closed.
+ *
+ ****************************************************************************/
+
+void writeback_clean(FAR struct file *filep);
+
+/****************************************************************************
+ * Name: writeback_unmount
+ *
+ * Description:
+ *   Forget the accounting of a file system that is being unmounted.  The
+ *   caller holds the inode lock.
+ *
+ * Input Parameters:
+ *   mountpt - The mountpoint inode.
+ *
+ ****************************************************************************/
+
+void writeback_unmount(FAR struct inode *mountpt);
+
+/****************************************************************************
+ * Name: writeback_foreach
+ *
+ * Description:
+ *   Call a function with the accounting of each file system that has been
+ *   written to.  The caller holds the inode lock, so the mountpoints stay
+ *   valid.  The traversal stops when the callback returns non-zero.
+ *
+ * Input Parameters:
+ *   handler - The callback.
+ *   arg     - Passed to the callback.
+ *
+ * Returned Value:
+ *   The last value returned by the callback.
+ *
+ ****************************************************************************/
+
+int writeback_foreach(writeback_foreach_t handler, FAR void *arg);
+
+#endif /* CONFIG_FS_WRITEBACK */
+
+#endif /* __FS_WRITEBACK_WRITEBACK_H */
@@ -433,6 +433,9 @@ struct inode
   struct timespec   i_atime;    /* Time of last access */
   struct timespec   i_mtime;    /* Time of last modification */
   struct timespec   i_ctime;    /* Time of last status change */
+#endif
+#if CONFIG_PSEUDOFS_HASHSIZE > 0
+  FAR struct inode *i_hash;     /* Link to inode in the same hash bucket */
 #endif
   FAR void         *i_private;  /* Per inode driver private data */
   char              i_name[1];  /* Name of inode (variable) */
@@ -493,6 +496,11 @@ struct file
   FAR void         *f_backtrace[CONFIG_FS_BACKTRACE]; /* Backtrace to while file opens */
 #endif
 
+#ifdef CONFIG_FS_WRITEBACK
+  size_t            f_dirty;    /* Bytes written but not yet synced */
+  unsigned int      f_wbgen;    /* Writeback generation of f_dirty */
+#endif
+
 #if CONFIG_FS_LOCK_BUCKET_SIZE > 0
   bool              locked; /* Filelock state: false - unlocked, true - locked */
 #endif
@@ -1525,6 +1533,31 @@ ssize_t file_pwrite(FAR struct file *filep, FAR const void *buf,
 ssize_t file_sendfile(FAR struct file *outfile, FAR struct file *infile,
                       FAR off_t *offset, size_t count);
 
+/****************************************************************************
+ * Name: file_splice
+ *
+ * Description:
+ *   Equivalent to the standard splice function except that is accepts
+ *   struct file instances instead of file descriptors.
+ *
+ ****************************************************************************/
+
+ssize_t file_splice(FAR struct file *infile, FAR off_t *inoffset,
+                    FAR struct file *outfile, FAR off_t *outoffset,
+                    size_t len, unsigned int flags);
+
+/****************************************************************************
+ * Name: file_tee
+ *
+ * Description:
+ *   Equivalent to the standard tee function except that is accepts
+ *   struct file instances instead of file descriptors.
+ *
+ ****************************************************************************/
+
+ssize_t file_tee(FAR struct file *infile, FAR struct file *outfile,
+                 size_t len, unsigned int flags);
+
 /****************************************************************************
  * Name: file_seek
  *
@@ -1602,6 +1635,19 @@ int file_truncate(FAR struct file *filep, off_t length);
 int file_mmap(FAR struct file *filep, FAR void *start, size_t length,
               int prot, int flags, off_t offset, FAR void **mapped);
 
+/****************************************************************************
+ * Name: file_mmap_direct
+ *
+ * Description:
+ *   Get direct, read-only access to the content of a memory backed file
+ *   without falling back to a RAM copy of the file.  If entry->munmap is
+ *   not NULL on return, the mapping must be released with file_munmap().
+ *
+ ****************************************************************************/
+
+int file_mmap_direct(FAR struct file *filep, off_t offset, size_t length,
+                     FAR struct mm_map_entry_s *entry);
+
 /****************************************************************************
  * Name: file_mummap
  *
@@ -232,6 +232,10 @@
 #define FIOC_XIPBASE        _FIOC(0x0015) /* IN:  uinptr_t *
                                            * OUT: Current file xip base address
                                            */
+#define FIOC_LFSSTATS       _FIOC(0x0016) /* IN:  FAR struct littlefs_stats_s *
+                                           * OUT: I/O statistics of the littlefs
+                                           *      volume of the file
+                                           */
 
 /* NuttX file system ioctl definitions **************************************/
 
@@ -501,6 +505,25 @@
                                                * IN: None
                                                * OUT: int */
 
+#define PIPEIOC_SPLICEOUT   _PIPEIOC(0x0007)  /* Move data out of the pipe
+                                               * IN: pipe_splice_s
+                                               * OUT: Length of data */
+
+#define PIPEIOC_SPLICEIN    _PIPEIOC(0x0008)  /* Move data into the pipe
+                                               * IN: pipe_splice_s
+                                               * OUT: Length of data */
+
+#define PIPEIOC_TEE         _PIPEIOC(0x0009)  /* Duplicate data to a pipe
+                                               * IN: pipe_splice_s
+                                               * OUT: Length of data */
+
+#define PIPEIOC_SPSC        _PIPEIOC(0x000a)  /* Set lock-free single
+                                               * reader/writer mode
+                                               * IN: unsigned long integer
+                                               *     0=disable (default)
+                                               *     1=enable
+                                               * OUT: None */
+
 /* RTC driver ioctl definitions *********************************************/
 
 /* (see nuttx/include/rtc.h */
@@ -765,6 +788,20 @@ struct pipe_peek_s
   size_t size;
 };
 
+/* The argument of PIPEIOC_SPLICEOUT, PIPEIOC_SPLICEIN and PIPEIOC_TEE.
+ * filep is the file at the other end of the transfer, offset the optional
+ * position in that file and flags the SPLICE_F_* flags of <fcntl.h>.
+ */
+
+struct file; /* Forward reference */
+struct pipe_splice_s
+{
+  FAR struct file *filep;
+  FAR off_t *offset;
+  size_t len;
+  unsigned int flags;
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -0,0 +1,68 @@
+/****************************************************************************
+ * include/nuttx/fs/littlefs.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_FS_LITTLEFS_H
+#define __INCLUDE_NUTTX_FS_LITTLEFS_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <stdint.h>
+
+/****************************************************************************
+ * Type Definitions
+ ****************************************************************************/
+
+/* Returned by the FIOC_LFSSTATS ioctl on any file of a littlefs mount.  The
+ * counters start at zero when the volume is mounted.
+ */
+
+struct littlefs_stats_s
+{
+  /* Geometry used by littlefs, in bytes */
+
+  uint32_t read_size;      /* Minimum read */
+  uint32_t prog_size;      /* Minimum program */
+  uint32_t block_size;     /* littlefs block (one or more erase blocks) */
+  uint32_t block_count;    /* Number of littlefs blocks */
+  uint32_t cache_size;     /* Size of each littlefs cache */
+  uint32_t lookahead_size; /* Size of the block allocation bitmap */
+  uint32_t readahead;      /* Read-ahead buffer, 0 if disabled */
+  uint32_t writebehind;    /* Write-behind buffer, 0 if disabled */
+
+  /* Requests from littlefs */
+
+  uint32_t reads;          /* Read requests */
+  uint32_t progs;          /* Program requests */
+  uint32_t erases;         /* Erase requests */
+  uint32_t syncs;          /* Sync requests */
+
+  /* Requests to the device */
+
+  uint32_t devreads;       /* Reads, including read-ahead */
+  uint32_t devwrites;      /* Writes, after write-behind */
+  uint32_t rahits;         /* Reads served from the read-ahead buffer */
+};
+
+#endif /* __INCLUDE_NUTTX_FS_LITTLEFS_H */
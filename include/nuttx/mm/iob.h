@@ -78,10 +78,15 @@
 #  define CONFIG_IOB_ALIGNMENT      1
 #endif
 
+#if CONFIG_IOB_LARGE_NBUFFERS > 0 && \
+    CONFIG_IOB_LARGE_BUFSIZE <= CONFIG_IOB_BUFSIZE
+#  error CONFIG_IOB_LARGE_BUFSIZE <= CONFIG_IOB_BUFSIZE
+#endif
+
 /* IOB helpers */
 
 #define IOB_DATA(p)      (&(p)->io_data[(p)->io_offset])
-#define IOB_FREESPACE(p) (CONFIG_IOB_BUFSIZE - (p)->io_len - (p)->io_offset)
+#define IOB_FREESPACE(p) (IOB_BUFSIZE(p) - (p)->io_len - (p)->io_offset)
 
 #if CONFIG_IOB_NCHAINS > 0
 /* Queue helpers */
@@ -168,7 +173,26 @@ struct iob_stats_s
   int nfree;
   int nwait;
   int nthrottle;
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  int ncached;
+#endif
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+  int nlarge_total;
+  int nlarge_free;
+#endif
+};
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+/* Usage statistics of the I/O buffer cache of one CPU */
+
+struct iob_cachestats_s
+{
+  int      ncached;   /* Number of free I/O buffers in the cache */
+  uint32_t nhit;      /* Allocations served by the cache */
+  uint32_t nrefill;   /* Refills from the global free list */
+  uint32_t nspill;    /* Frees that overflowed to the global free list */
 };
+#endif
 
 /****************************************************************************
  * Public Function Prototypes
@@ -221,6 +245,45 @@ FAR struct iob_s *iob_alloc(bool throttled);
 
 FAR struct iob_s *iob_tryalloc(bool throttled);
 
+/****************************************************************************
+ * Name: iob_tryalloc_chain
+ *
+ * Description:
+ *   Try to allocate a chain of 'n' I/O buffers in one go, without waiting
+ *   for buffers to become free.  Either all 'n' buffers are allocated or
+ *   none is.
+ *
+ * Input Parameters:
+ *   n         - The number of I/O buffers in the chain
+ *   throttled - An indication of the IOB allocation is "throttled"
+ *
+ * Returned Value:
+ *   The head of the new chain, NULL if not enough buffers are free.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_chain(unsigned int n, bool throttled);
+
+/****************************************************************************
+ * Name: iob_tryalloc_size
+ *
+ * Description:
+ *   Try to allocate the I/O buffer that best fits 'size' bytes of payload
+ *   without waiting.  This is a large buffer if 'size' does not fit into
+ *   a normal one and the large pool is not empty, otherwise a normal
+ *   buffer; the caller must be prepared to extend the chain.
+ *
+ * Input Parameters:
+ *   size      - The number of payload bytes that will be stored
+ *   throttled - An indication of the IOB allocation is "throttled"
+ *
+ * Returned Value:
+ *   The new I/O buffer, NULL if none is free.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_size(unsigned int size, bool throttled);
+
 #ifdef CONFIG_IOB_ALLOC
 /****************************************************************************
  * Name: iob_alloc_dynamic
@@ -357,7 +420,7 @@ void iob_notifier_teardown(int key);
  *
  * Description:
  *   Free an entire buffer chain, starting at the beginning of the I/O
- *   buffer chain
+ *   buffer chain.  All buffers are returned to the free list in one go.
  *
  ****************************************************************************/
 
@@ -605,7 +668,8 @@ FAR struct iob_s *iob_trimtail(FAR struct iob_s *iob, unsigned int trimlen);
  * Description:
  *   Pack all data in the I/O buffer chain so that the data offset is zero
  *   and all but the final buffer in the chain are filled.  Any emptied
- *   buffers at the end of the chain are freed.
+ *   buffers at the end of the chain are freed.  A packet that spans
+ *   several buffers but fits into a large one is moved there.
  *
  ****************************************************************************/
 
@@ -691,6 +755,25 @@ void iob_dump(FAR const char *msg, FAR struct iob_s *iob, unsigned int len,
 #if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
     !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
 void iob_getstats(FAR struct iob_stats_s *stats);
+
+/****************************************************************************
+ * Name: iob_getcachestats
+ *
+ * Description:
+ *   Return the usage statistics of the I/O buffer cache of one CPU
+ *
+ * Input Parameters:
+ *   cpu   - The CPU of interest
+ *   stats - Location to return the statistics
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+void iob_getcachestats(int cpu, FAR struct iob_cachestats_s *stats);
+#endif
 #endif
 
 #endif /* CONFIG_MM_IOB */
@@ -217,6 +217,23 @@ struct ipv6_stats_s
                            * were neither ICMP, UDP nor TCP */
 };
 #endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_ARP
+struct arp_stats_s
+{
+  net_stats_t hits;       /* Number of outgoing packets with a known
+                           * destination MAC address */
+  net_stats_t misses;     /* Number of outgoing packets without one */
+  net_stats_t requests;   /* Number of ARP requests sent to resolve
+                           * an address */
+  net_stats_t timeouts;   /* Number of addresses that did not answer */
+  net_stats_t queued;     /* Number of packets held during resolution */
+  net_stats_t flushed;    /* Number of held packets sent */
+  net_stats_t qdrops;     /* Number of held packets dropped */
+  net_stats_t expired;    /* Number of ARP table entries aged out */
+  net_stats_t evicted;    /* Number of ARP table entries replaced */
+};
+#endif /* CONFIG_NET_ARP */
 #endif /* CONFIG_NET_STATISTICS */
 
 #ifdef CONFIG_NET_ARP_ACD
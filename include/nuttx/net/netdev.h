@@ -162,6 +162,8 @@
 #    define NETDEV_RXARP(dev)
 #  endif
 #  define NETDEV_RXDROPPED(dev)   _NETDEV_STATISTIC(dev,rx_dropped)
+#  define NETDEV_RXINTERRUPTS(dev) _NETDEV_STATISTIC(dev,rx_interrupts)
+#  define NETDEV_RXPOLLS(dev)     _NETDEV_STATISTIC(dev,rx_polls)
 
 #  define NETDEV_TXPACKETS(dev) \
     do { \
@@ -174,6 +176,14 @@
 #  define NETDEV_TXTIMEOUTS(dev)  _NETDEV_ERROR(dev,tx_timeouts)
 #  define NETDEV_ERRORS(dev)      _NETDEV_STATISTIC(dev,errors)
 
+#  ifdef CONFIG_NETDEV_MULTIQUEUE
+#    define NETDEV_RXQUEUE(dev,q) _NETDEV_STATISTIC(dev,rxq_packets[q])
+#    define NETDEV_TXQUEUE(dev,q) _NETDEV_STATISTIC(dev,txq_packets[q])
+#  else
+#    define NETDEV_RXQUEUE(dev,q)
+#    define NETDEV_TXQUEUE(dev,q)
+#  endif
+
 #else
 #  define NETDEV_RESET_STATISTICS(dev)
 #  define NETDEV_RXPACKETS(dev)
@@ -183,6 +193,8 @@
 #  define NETDEV_RXIPV6(dev)
 #  define NETDEV_RXARP(dev)
 #  define NETDEV_RXDROPPED(dev)
+#  define NETDEV_RXINTERRUPTS(dev)
+#  define NETDEV_RXPOLLS(dev)
 
 #  define NETDEV_TXPACKETS(dev)
 #  define NETDEV_TXDONE(dev)
@@ -190,6 +202,8 @@
 #  define NETDEV_TXTIMEOUTS(dev)
 
 #  define NETDEV_ERRORS(dev)
+#  define NETDEV_RXQUEUE(dev,q)
+#  define NETDEV_TXQUEUE(dev,q)
 #endif
 
 /* There are some helper pointers for accessing the contents of the IP
@@ -243,6 +257,8 @@ struct netdev_statistics_s
   uint32_t rx_arp;         /* Number of Rx ARP packets received */
 #endif
   uint32_t rx_dropped;     /* Unsupported Rx packets received */
+  uint32_t rx_interrupts;  /* Number of Rx ready notifications */
+  uint32_t rx_polls;       /* Number of Rx queue polls */
   uint64_t rx_bytes;       /* Number of bytes received */
 
   /* Tx Status */
@@ -257,6 +273,13 @@ struct netdev_statistics_s
 
   uint32_t errors;         /* Total number of errors */
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  /* Per-queue status of multi-queue lower half drivers */
+
+  uint32_t rxq_packets[CONFIG_NETDEV_MAX_QUEUES]; /* Packets received */
+  uint32_t txq_packets[CONFIG_NETDEV_MAX_QUEUES]; /* Packets queued */
+#endif
+
 #if CONFIG_NETDEV_STATISTICS_LOG_PERIOD > 0
   struct work_s logwork;   /* For periodic log work */
 #endif
@@ -1331,6 +1354,32 @@ int netdev_ipv6_foreach(FAR struct net_driver_s *dev,
                         devif_ipv6_callback_t callback, FAR void *arg);
 #endif
 
+/****************************************************************************
+ * Name: netdev_flow_hash
+ *
+ * Description:
+ *   Calculate the Toeplitz hash of a flow 4-tuple.  Addresses and ports
+ *   are given as stored in the connection structures (network order).
+ *   This is the hash reported by SIOCNOTIFYRECVCPU.
+ *
+ * Input Parameters:
+ *   domain   - The layer 3 protocol, PF_INET/PF_INET6
+ *   src_addr - The source (local) address
+ *   src_port - The source (local) port
+ *   dst_addr - The destination (remote) address
+ *   dst_port - The destination (remote) port
+ *
+ * Returned Value:
+ *  The hash value
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_RSS
+uint32_t netdev_flow_hash(uint8_t domain,
+                          FAR const void *src_addr, uint16_t src_port,
+                          FAR const void *dst_addr, uint16_t dst_port);
+#endif
+
 /****************************************************************************
  * Name: netdev_statistics_log
  *
@@ -119,6 +119,15 @@ struct netdev_lowerhalf_s
 
   atomic_int quota[NETPKT_TYPENUM];
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  /* Number of RX/TX queue pairs, set by the lower half before
+   * registration.  Zero or one means a single queue driven by the
+   * transmit/receive operations only.
+   */
+
+  uint8_t nqueues;
+#endif
+
   /* The structure used by net stack.
    * Note: Do not change its fields unless you know what you are doing.
    *
@@ -172,6 +181,29 @@ struct netdev_ops_s
   /* reclaim - try to reclaim packets sent by netdev. */
 
   CODE void (*reclaim)(FAR struct netdev_lowerhalf_s *dev);
+
+  /* rxint - Mask (enable = false) or unmask the RX interrupt of a queue.
+   *         Optional, the upper half masks it on netdev_lower_rxready and
+   *         unmasks it only after receive/receiveq has drained the queue,
+   *         so a busy queue is polled without taking interrupts.
+   *         May be called from the interrupt handler.
+   */
+
+  CODE void (*rxint)(FAR struct netdev_lowerhalf_s *dev, int queue,
+                     bool enable);
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  /* transmitq/receiveq - Same as transmit/receive but on the queue pair
+   *                      'queue' (0 ~ nqueues - 1).  Needed only if
+   *                      nqueues > 1, queue 0 may share the code of
+   *                      transmit/receive.
+   */
+
+  CODE int (*transmitq)(FAR struct netdev_lowerhalf_s *dev,
+                        FAR netpkt_t *pkt, int queue);
+  CODE FAR netpkt_t *(*receiveq)(FAR struct netdev_lowerhalf_s *dev,
+                                 int queue);
+#endif
 };
 
 /* This structure is a set of wireless handlers, leave unsupported operations
@@ -308,6 +340,43 @@ void netdev_lower_rxready(FAR struct netdev_lowerhalf_s *dev);
 
 void netdev_lower_txdone(FAR struct netdev_lowerhalf_s *dev);
 
+/****************************************************************************
+ * Name: netdev_lower_rxready_queue
+ *
+ * Description:
+ *   Notifies the networking layer about an RX packet is ready to read on
+ *   one queue of a multi-queue device.  Only the worker of that queue is
+ *   woken up.
+ *
+ * Input Parameters:
+ *   dev   - The lower half device driver structure
+ *   queue - The queue that has packets ready
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+void netdev_lower_rxready_queue(FAR struct netdev_lowerhalf_s *dev,
+                                int queue);
+#endif
+
+/****************************************************************************
+ * Name: netdev_lower_txdone_queue
+ *
+ * Description:
+ *   Notifies the networking layer about a TX packet is sent on one queue
+ *   of a multi-queue device.
+ *
+ * Input Parameters:
+ *   dev   - The lower half device driver structure
+ *   queue - The queue that completed the transmission
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+void netdev_lower_txdone_queue(FAR struct netdev_lowerhalf_s *dev,
+                               int queue);
+#endif
+
 /****************************************************************************
  * Name: netdev_lower_quota_load
  *
@@ -0,0 +1,153 @@
+/****************************************************************************
+ * include/sys/uring.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_SYS_URING_H
+#define __INCLUDE_SYS_URING_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/atomic.h>
+
+#include <stdint.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Operations.  Unless stated otherwise, fd selects the file or socket, addr
+ * the user buffer and len its size.  The completion result is what the
+ * synchronous call would have returned, or a negated errno value.
+ */
+
+#define URING_OP_NOP        0  /* Complete immediately with zero */
+#define URING_OP_READ       1  /* read(), or pread() at off */
+#define URING_OP_WRITE      2  /* write(), or pwrite() at off */
+#define URING_OP_READV      3  /* addr: struct iovec array, len: count */
+#define URING_OP_WRITEV     4  /* addr: struct iovec array, len: count */
+#define URING_OP_SEND       5  /* send(), op_flags: MSG_* flags */
+#define URING_OP_RECV       6  /* recv(), op_flags: MSG_* flags */
+#define URING_OP_POLL_ADD   7  /* op_flags: events, result: revents */
+#define URING_OP_ACCEPT     8  /* addr: sockaddr, off: socklen_t pointer,
+                                * op_flags: SOCK_NONBLOCK, SOCK_CLOEXEC,
+                                * result: new descriptor */
+#define URING_OP_TIMEOUT    9  /* addr: relative struct timespec,
+                                * result: -ETIME */
+#define URING_NOPS          10
+
+/* Value of off for operations on the current file position */
+
+#define URING_OFF_CURRENT   ((uint64_t)-1)
+
+/* uring_enter() flags */
+
+#define URING_ENTER_GETEVENTS (1 << 0) /* Wait for min_complete completions */
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+/* Submission queue entry */
+
+struct uring_sqe
+{
+  uint8_t  opcode;    /* URING_OP_* */
+  uint8_t  flags;     /* Reserved, must be zero */
+  uint16_t reserved;  /* Reserved, must be zero */
+  int32_t  fd;        /* File or socket descriptor */
+  uint64_t off;       /* File offset or URING_OFF_CURRENT */
+  uint64_t addr;      /* Buffer address */
+  uint32_t len;       /* Buffer size */
+  uint32_t op_flags;  /* Operation specific flags */
+  uint64_t user_data; /* Returned unchanged in the completion */
+};
+
+/* Completion queue entry */
+
+struct uring_cqe
+{
+  uint64_t user_data; /* user_data of the submission */
+  int32_t  res;       /* Result of the operation */
+  uint32_t flags;     /* Reserved */
+};
+
+/* The rings are shared between the application and the kernel.  The
+ * producer owns the tail and the consumer owns the head.  Entry i lives in
+ * slot (i & mask).  The application fills a submission slot before it
+ * advances sq->tail with release ordering, and reads a completion slot
+ * after it loads cq->tail with acquire ordering.  mask, entries and the
+ * entry addresses are informational; the kernel keeps its own copies.
+ */
+
+struct uring_sq
+{
+  atomic_uint           head;    /* Next entry the kernel consumes */
+  atomic_uint           tail;    /* Next entry the application fills */
+  uint32_t              mask;    /* Number of entries minus one */
+  uint32_t              entries; /* Number of entries */
+  FAR struct uring_sqe *sqes;    /* The entries */
+};
+
+struct uring_cq
+{
+  atomic_uint           head;    /* Next entry the application consumes */
+  atomic_uint           tail;    /* Next entry the kernel posts */
+  uint32_t              mask;    /* Number of entries minus one */
+  uint32_t              entries; /* Number of entries */
+  FAR struct uring_cqe *cqes;    /* The entries */
+};
+
+/* Returned by uring_setup() */
+
+struct uring_params
+{
+  uint32_t            sq_entries; /* Size of the submission queue */
+  uint32_t            cq_entries; /* Size of the completion queue */
+  uint32_t            flags;      /* Reserved, must be zero */
+  FAR struct uring_sq *sq;        /* The submission queue */
+  FAR struct uring_cq *cq;        /* The completion queue */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+int uring_setup(unsigned int entries, FAR struct uring_params *params);
+int uring_enter(int fd, unsigned int to_submit, unsigned int min_complete,
+                unsigned int flags);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_SYS_URING_H */
@@ -53,6 +53,41 @@
 #  define iobinfo                _none
 #endif /* CONFIG_DEBUG_FEATURES && CONFIG_IOB_DEBUG */
 
+/* Per-CPU caches are refilled and spilled in batches of half their size */
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+#  define IOB_CACHE_BATCH        ((CONFIG_IOB_PERCPU_CACHE + 1) / 2)
+#endif
+
+/* Pool buffers of the large size class.  Heap buffers are recognized by
+ * their io_free callback before this is checked.
+ */
+
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+#  define IOB_ISLARGE(p)         ((p)->io_bufsize == CONFIG_IOB_LARGE_BUFSIZE)
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+/* The free I/O buffers cached by one CPU.  Only the owning CPU takes
+ * buffers from or adds buffers to its cache; the lock is contended only
+ * when another CPU drains the cache.
+ */
+
+struct iob_cache_s
+{
+  spinlock_t lock;                /* Protects the cache */
+  FAR struct iob_s *head;         /* List of cached free I/O buffers */
+  int16_t count;                  /* Number of cached I/O buffers */
+  uint32_t nhit;                  /* Allocations served by the cache */
+  uint32_t nrefill;               /* Refills from the global free list */
+  uint32_t nspill;                /* Frees that overflowed the cache */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -98,12 +133,109 @@ extern sem_t g_qentry_sem;
 extern volatile int16_t g_qentry_count;
 #endif
 
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+/* A list of all free, unallocated large I/O buffers */
+
+extern FAR struct iob_s *g_iob_largelist;
+
+/* Counts free large I/O buffers */
+
+extern volatile int16_t g_iob_large_count;
+#endif
+
 extern volatile spinlock_t g_iob_lock;
 
+#if CONFIG_IOB_PERCPU_CACHE > 0
+/* The per-CPU caches of free I/O buffers */
+
+extern struct iob_cache_s g_iob_cache[CONFIG_SMP_NCPUS];
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: iob_tryalloc_internal
+ *
+ * Description:
+ *   Take one I/O buffer from the global free list.  The caller must hold
+ *   g_iob_lock.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_internal(bool throttled);
+
+/****************************************************************************
+ * Name: iob_tryalloc_large
+ *
+ * Description:
+ *   Try to allocate an I/O buffer from the large pool without waiting.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+FAR struct iob_s *iob_tryalloc_large(void);
+#endif
+
+/****************************************************************************
+ * Name: iob_free_list
+ *
+ * Description:
+ *   Return a list of pool I/O buffers, linked through io_flink, to the
+ *   global free list or to the waiters in one hold of g_iob_lock.
+ *
+ ****************************************************************************/
+
+void iob_free_list(FAR struct iob_s *iob);
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+/****************************************************************************
+ * Name: iob_cache_get
+ *
+ * Description:
+ *   Take a free I/O buffer from the cache of the local CPU, refilling the
+ *   cache from the global free list if it is empty.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_cache_get(void);
+
+/****************************************************************************
+ * Name: iob_cache_put
+ *
+ * Description:
+ *   Add a list of free I/O buffers, linked through io_flink, to the cache
+ *   of the local CPU.  The buffers that do not fit are returned.  Nothing
+ *   is cached while the global free list is exhausted, so that buffers
+ *   always reach the threads waiting for them.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_cache_put(FAR struct iob_s *iob);
+
+/****************************************************************************
+ * Name: iob_cache_drain
+ *
+ * Description:
+ *   Return the content of all caches to the global free list.  Called by
+ *   a thread that is about to wait for a free I/O buffer.
+ *
+ ****************************************************************************/
+
+void iob_cache_drain(void);
+
+/****************************************************************************
+ * Name: iob_cache_navail
+ *
+ * Description:
+ *   Return the number of free I/O buffers held in all caches.
+ *
+ ****************************************************************************/
+
+int iob_cache_navail(void);
+#endif
+
 /****************************************************************************
  * Name: iob_alloc_qentry
  *
@@ -163,5 +295,25 @@ FAR struct iob_qentry_s *iob_free_qentry(FAR struct iob_qentry_s *iobq);
 void iob_notifier_signal(void);
 #endif
 
+/****************************************************************************
+ * Name: iob_notifier_freed
+ *
+ * Description:
+ *   IOBs have been returned to the free list or to a per-CPU cache.  Signal
+ *   the waiters if the number of available IOBs went past a multiple of
+ *   CONFIG_IOB_NOTIFIER_DIV.
+ *
+ * Input Parameters:
+ *   nfreed - The number of IOBs freed.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_NOTIFIER
+void iob_notifier_freed(int nfreed);
+#endif
+
 #endif /* CONFIG_MM_IOB */
 #endif /* __MM_IOB_IOB_H */
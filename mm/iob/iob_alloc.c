@@ -101,78 +101,6 @@ static FAR struct iob_s *iob_alloc_committed(void)
   return iob;
 }
 
-static FAR struct iob_s *iob_tryalloc_internal(bool throttled)
-{
-  FAR struct iob_s *iob;
-#if CONFIG_IOB_THROTTLE > 0
-  int16_t count;
-#endif
-
-#if CONFIG_IOB_THROTTLE > 0
-  /* Select the count to check. */
-
-  count = (throttled ? g_throttle_count : g_iob_count);
-#endif
-
-  /* We don't know what context we are called from so we use extreme measures
-   * to protect the free list:  We disable interrupts very briefly.
-   */
-
-#if CONFIG_IOB_THROTTLE > 0
-  /* If there are free I/O buffers for this allocation */
-
-  if (count > 0)
-#endif
-    {
-      /* Take the I/O buffer from the head of the free list */
-
-      iob = g_iob_freelist;
-      if (iob != NULL)
-        {
-          /* Remove the I/O buffer from the free list and decrement the
-           * counting semaphore(s) that tracks the number of available
-           * IOBs.
-           */
-
-          g_iob_freelist = iob->io_flink;
-
-          /* Take a semaphore count.  Note that we cannot do this in
-           * in the orthodox way by calling nxsem_wait() or nxsem_trywait()
-           * because this function may be called from an interrupt
-           * handler. Fortunately we know at at least one free buffer
-           * so a simple decrement is all that is needed.
-           */
-
-          g_iob_count--;
-          DEBUGASSERT(g_iob_count >= 0);
-
-#if CONFIG_IOB_THROTTLE > 0
-          /* The throttle semaphore is used to throttle the number of
-           * free buffers that are available.  It is used to prevent
-           * the overrunning of the free buffer list. Please note that
-           * it can only be decremented to zero, which indicates no
-           * throttled buffers are available.
-           */
-
-          if (g_throttle_count > 0)
-            {
-              g_throttle_count--;
-            }
-#endif
-
-          /* Put the I/O buffer in a known state */
-
-          iob->io_flink  = NULL; /* Not in a chain */
-          iob->io_len    = 0;    /* Length of the data in the entry */
-          iob->io_offset = 0;    /* Offset to the beginning of data */
-          iob->io_pktlen = 0;    /* Total length of the packet */
-          return iob;
-        }
-    }
-
-  return NULL;
-}
-
 /****************************************************************************
  * Name: iob_allocwait
  *
@@ -201,6 +129,19 @@ static FAR struct iob_s *iob_allocwait(bool throttled, unsigned int timeout)
   sem = &g_iob_sem;
 #endif
 
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  /* Try the cache of this CPU first */
+
+  if (!throttled)
+    {
+      iob = iob_cache_get();
+      if (iob != NULL)
+        {
+          return iob;
+        }
+    }
+#endif
+
   /* The following must be atomic; interrupt must be disabled so that there
    * is no conflict with interrupt level I/O buffer allocations.  This is
    * not as bad as it sounds because interrupts will be re-enabled while
@@ -226,6 +167,15 @@ static FAR struct iob_s *iob_allocwait(bool throttled, unsigned int timeout)
 
       spin_unlock_irqrestore(&g_iob_lock, flags);
 
+#if CONFIG_IOB_PERCPU_CACHE > 0
+      /* Buffers may still be sitting in the caches of the CPUs.  Return
+       * them; now that we are counted as a waiter they will be committed
+       * to us.
+       */
+
+      iob_cache_drain();
+#endif
+
       if (timeout == UINT_MAX)
         {
           ret = nxsem_wait_uninterruptible(sem);
@@ -275,6 +225,83 @@ static void iob_free_dynamic(FAR void *data)
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: iob_tryalloc_internal
+ *
+ * Description:
+ *   Take one I/O buffer from the global free list.  The caller must hold
+ *   g_iob_lock.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_internal(bool throttled)
+{
+  FAR struct iob_s *iob;
+#if CONFIG_IOB_THROTTLE > 0
+  int16_t count;
+#endif
+
+#if CONFIG_IOB_THROTTLE > 0
+  /* Select the count to check. */
+
+  count = (throttled ? g_throttle_count : g_iob_count);
+#endif
+
+#if CONFIG_IOB_THROTTLE > 0
+  /* If there are free I/O buffers for this allocation */
+
+  if (count > 0)
+#endif
+    {
+      /* Take the I/O buffer from the head of the free list */
+
+      iob = g_iob_freelist;
+      if (iob != NULL)
+        {
+          /* Remove the I/O buffer from the free list and decrement the
+           * counting semaphore(s) that tracks the number of available
+           * IOBs.
+           */
+
+          g_iob_freelist = iob->io_flink;
+
+          /* Take a semaphore count.  Note that we cannot do this in
+           * in the orthodox way by calling nxsem_wait() or nxsem_trywait()
+           * because this function may be called from an interrupt
+           * handler. Fortunately we know at at least one free buffer
+           * so a simple decrement is all that is needed.
+           */
+
+          g_iob_count--;
+          DEBUGASSERT(g_iob_count >= 0);
+
+#if CONFIG_IOB_THROTTLE > 0
+          /* The throttle semaphore is used to throttle the number of
+           * free buffers that are available.  It is used to prevent
+           * the overrunning of the free buffer list. Please note that
+           * it can only be decremented to zero, which indicates no
+           * throttled buffers are available.
+           */
+
+          if (g_throttle_count > 0)
+            {
+              g_throttle_count--;
+            }
+#endif
+
+          /* Put the I/O buffer in a known state */
+
+          iob->io_flink  = NULL; /* Not in a chain */
+          iob->io_len    = 0;    /* Length of the data in the entry */
+          iob->io_offset = 0;    /* Offset to the beginning of data */
+          iob->io_pktlen = 0;    /* Total length of the packet */
+          return iob;
+        }
+    }
+
+  return NULL;
+}
+
 /****************************************************************************
  * Name: iob_timedalloc
  *
@@ -333,6 +360,19 @@ FAR struct iob_s *iob_tryalloc(bool throttled)
   FAR struct iob_s *iob;
   irqstate_t flags;
 
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  /* Non-throttled allocations are served by the cache of this CPU */
+
+  if (!throttled)
+    {
+      iob = iob_cache_get();
+      if (iob != NULL)
+        {
+          return iob;
+        }
+    }
+#endif
+
   /* We don't know what context we are called from so we use extreme measures
    * to protect the free list:  We disable interrupts very briefly.
    */
@@ -343,6 +383,123 @@ FAR struct iob_s *iob_tryalloc(bool throttled)
   return iob;
 }
 
+/****************************************************************************
+ * Name: iob_tryalloc_large
+ *
+ * Description:
+ *   Try to allocate an I/O buffer from the large pool without waiting.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+FAR struct iob_s *iob_tryalloc_large(void)
+{
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_iob_lock);
+
+  iob = g_iob_largelist;
+  if (iob != NULL)
+    {
+      g_iob_largelist = iob->io_flink;
+      g_iob_large_count--;
+      DEBUGASSERT(g_iob_large_count >= 0);
+
+      /* Put the I/O buffer in a known state */
+
+      iob->io_flink  = NULL; /* Not in a chain */
+      iob->io_len    = 0;    /* Length of the data in the entry */
+      iob->io_offset = 0;    /* Offset to the beginning of data */
+      iob->io_pktlen = 0;    /* Total length of the packet */
+    }
+
+  spin_unlock_irqrestore(&g_iob_lock, flags);
+  return iob;
+}
+#endif
+
+/****************************************************************************
+ * Name: iob_tryalloc_size
+ *
+ * Description:
+ *   Try to allocate the I/O buffer that best fits 'size' bytes of payload
+ *   without waiting.  This is a large buffer if 'size' does not fit into
+ *   a normal one and the large pool is not empty, otherwise a normal
+ *   buffer; the caller must be prepared to extend the chain.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_size(unsigned int size, bool throttled)
+{
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+  FAR struct iob_s *iob;
+
+  if (size > CONFIG_IOB_BUFSIZE)
+    {
+      iob = iob_tryalloc_large();
+      if (iob != NULL)
+        {
+          return iob;
+        }
+    }
+#endif
+
+  return iob_tryalloc(throttled);
+}
+
+/****************************************************************************
+ * Name: iob_tryalloc_chain
+ *
+ * Description:
+ *   Try to allocate a chain of 'n' I/O buffers in one go, without waiting
+ *   for buffers to become free.  Either all 'n' buffers are allocated or
+ *   none is.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_chain(unsigned int n, bool throttled)
+{
+  FAR struct iob_s *head = NULL;
+  FAR struct iob_s *tail = NULL;
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+  int16_t count;
+
+  DEBUGASSERT(n > 0);
+
+  flags = spin_lock_irqsave(&g_iob_lock);
+
+#if CONFIG_IOB_THROTTLE > 0
+  count = (throttled ? g_throttle_count : g_iob_count);
+#else
+  count = g_iob_count;
+#endif
+
+  if (count >= 0 && (unsigned int)count >= n)
+    {
+      while (n-- > 0)
+        {
+          iob = iob_tryalloc_internal(throttled);
+          DEBUGASSERT(iob != NULL);
+
+          if (tail == NULL)
+            {
+              head = iob;
+            }
+          else
+            {
+              tail->io_flink = iob;
+            }
+
+          tail = iob;
+        }
+    }
+
+  spin_unlock_irqrestore(&g_iob_lock, flags);
+  return head;
+}
+
 #ifdef CONFIG_IOB_ALLOC
 
 /****************************************************************************
@@ -0,0 +1,250 @@
+/****************************************************************************
+ * mm/iob/iob_cache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The per-CPU caches of free I/O buffers */
+
+struct iob_cache_s g_iob_cache[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_cache_get
+ *
+ * Description:
+ *   Take a free I/O buffer from the cache of the local CPU, refilling the
+ *   cache from the global free list if it is empty.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_cache_get(void)
+{
+  FAR struct iob_cache_s *cache;
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+  int n;
+
+  /* Interrupts stay disabled so that we are not moved to another CPU */
+
+  flags = up_irq_save();
+  cache = &g_iob_cache[this_cpu()];
+  spin_lock(&cache->lock);
+
+  if (cache->head == NULL)
+    {
+      /* Refill a batch in one hold of the global lock.  Beyond the buffer
+       * that is needed now, leave a cache worth of buffers to the others.
+       */
+
+      spin_lock(&g_iob_lock);
+
+      for (n = 0; n < IOB_CACHE_BATCH; n++)
+        {
+          if (n > 0 && g_iob_count <= CONFIG_IOB_PERCPU_CACHE)
+            {
+              break;
+            }
+
+          iob = iob_tryalloc_internal(false);
+          if (iob == NULL)
+            {
+              break;
+            }
+
+          iob->io_flink = cache->head;
+          cache->head   = iob;
+          cache->count++;
+        }
+
+      spin_unlock(&g_iob_lock);
+
+      if (n > 0)
+        {
+          cache->nrefill++;
+        }
+    }
+  else
+    {
+      cache->nhit++;
+    }
+
+  iob = cache->head;
+  if (iob != NULL)
+    {
+      cache->head = iob->io_flink;
+      cache->count--;
+
+      /* Put the I/O buffer in a known state */
+
+      iob->io_flink  = NULL; /* Not in a chain */
+      iob->io_len    = 0;    /* Length of the data in the entry */
+      iob->io_offset = 0;    /* Offset to the beginning of data */
+      iob->io_pktlen = 0;    /* Total length of the packet */
+    }
+
+  spin_unlock(&cache->lock);
+  up_irq_restore(flags);
+  return iob;
+}
+
+/****************************************************************************
+ * Name: iob_cache_put
+ *
+ * Description:
+ *   Add a list of free I/O buffers, linked through io_flink, to the cache
+ *   of the local CPU.  The buffers that do not fit are returned.  Nothing
+ *   is cached while the global free list is exhausted, so that buffers
+ *   always reach the threads waiting for them.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_cache_put(FAR struct iob_s *iob)
+{
+  FAR struct iob_cache_s *cache;
+  FAR struct iob_s *next;
+  irqstate_t flags;
+  int ncached = 0;
+
+  flags = up_irq_save();
+  cache = &g_iob_cache[this_cpu()];
+  spin_lock(&cache->lock);
+
+  /* A waiter first counts itself in g_iob_count or g_throttle_count and
+   * then drains the caches under their locks, so a buffer cached here
+   * after the check below is always seen by that drain.
+   */
+
+#if CONFIG_IOB_THROTTLE > 0
+  if (g_iob_count > 0 && g_throttle_count >= 0)
+#else
+  if (g_iob_count > 0)
+#endif
+    {
+      while (iob != NULL && cache->count < CONFIG_IOB_PERCPU_CACHE)
+        {
+          next          = iob->io_flink;
+          iob->io_flink = cache->head;
+          cache->head   = iob;
+          cache->count++;
+          iob           = next;
+          ncached++;
+        }
+
+      if (iob != NULL)
+        {
+          cache->nspill++;
+        }
+    }
+
+  spin_unlock(&cache->lock);
+  up_irq_restore(flags);
+
+#ifdef CONFIG_IOB_NOTIFIER
+  /* Cached buffers are available to iob_tryalloc() as well */
+
+  if (ncached > 0)
+    {
+      iob_notifier_freed(ncached);
+    }
+#endif
+
+  UNUSED(ncached);
+  return iob;
+}
+
+/****************************************************************************
+ * Name: iob_cache_drain
+ *
+ * Description:
+ *   Return the content of all caches to the global free list.  Called by
+ *   a thread that is about to wait for a free I/O buffer.
+ *
+ ****************************************************************************/
+
+void iob_cache_drain(void)
+{
+  FAR struct iob_cache_s *cache;
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      cache = &g_iob_cache[cpu];
+
+      flags = spin_lock_irqsave(&cache->lock);
+      iob          = cache->head;
+      cache->head  = NULL;
+      cache->count = 0;
+      spin_unlock_irqrestore(&cache->lock, flags);
+
+      if (iob != NULL)
+        {
+          iob_free_list(iob);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: iob_cache_navail
+ *
+ * Description:
+ *   Return the number of free I/O buffers held in all caches.
+ *
+ ****************************************************************************/
+
+int iob_cache_navail(void)
+{
+  int navail = 0;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      navail += g_iob_cache[cpu].count;
+    }
+
+  return navail;
+}
+
+#endif /* CONFIG_IOB_PERCPU_CACHE > 0 */
@@ -28,6 +28,7 @@
 
 #include <stdint.h>
 #include <string.h>
+#include <sys/param.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
@@ -37,9 +38,56 @@
 #include "iob.h"
 
 /****************************************************************************
- * Public Functions
+ * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: iob_copyin_extend
+ *
+ * Description:
+ *  Allocate the chain of I/O buffers that holds the 'len' bytes remaining
+ *  to be copied in one go, and account for it in the packet length.
+ *
+ * Returned Value:
+ *  The new chain, NULL if fewer than two buffers are needed or if they
+ *  are not available.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *iob_copyin_extend(FAR struct iob_s *head,
+                                           unsigned int len, bool throttled)
+{
+  FAR struct iob_s *chain = NULL;
+  FAR struct iob_s *iob;
+  unsigned int nbufs;
+
+  nbufs = (len + CONFIG_IOB_BUFSIZE - 1) / CONFIG_IOB_BUFSIZE;
+  if (nbufs < 2)
+    {
+      return NULL;
+    }
+
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+  /* A large buffer is the best fit */
+
+  chain = iob_tryalloc_large();
+#endif
+
+  if (chain == NULL)
+    {
+      chain = iob_tryalloc_chain(nbufs, throttled);
+    }
+
+  for (iob = chain; iob != NULL; iob = iob->io_flink)
+    {
+      iob->io_len      = MIN(len, IOB_BUFSIZE(iob));
+      head->io_pktlen += iob->io_len;
+      len             -= iob->io_len;
+    }
+
+  return chain;
+}
+
 /****************************************************************************
  * Name: iob_copyin_internal
  *
@@ -178,7 +226,21 @@ static int iob_copyin_internal(FAR struct iob_s *iob, FAR const uint8_t *src,
 
       if (len > 0 && !next)
         {
-          /* Yes.. allocate a new buffer.
+          /* Yes.. try to allocate all of the buffers that are still
+           * needed in one go, then fill them as if they were already part
+           * of the chain.
+           */
+
+          next = iob_copyin_extend(head, len, throttled);
+          if (next != NULL)
+            {
+              iob->io_flink = next;
+              iob = next;
+              offset = 0;
+              continue;
+            }
+
+          /* Otherwise allocate a new buffer.
            *
            * Copy as many bytes as possible. Block if we're allowed.
            */
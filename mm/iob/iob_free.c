@@ -40,32 +40,142 @@
 #include "iob.h"
 
 /****************************************************************************
- * Pre-processor Definitions
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_free_list
+ *
+ * Description:
+ *   Return a list of pool I/O buffers, linked through io_flink, to the
+ *   global free list or to the waiters in one hold of g_iob_lock.
+ *
  ****************************************************************************/
 
+void iob_free_list(FAR struct iob_s *iob)
+{
+  FAR struct iob_s *next;
+  irqstate_t flags;
+  int npost = 0;
+#if CONFIG_IOB_THROTTLE > 0
+  int ntpost = 0;
+#endif
 #ifdef CONFIG_IOB_NOTIFIER
-#  if !defined(CONFIG_IOB_NOTIFIER_DIV) || CONFIG_IOB_NOTIFIER_DIV < 2
-#    define IOB_DIVIDER 1
-#  elif CONFIG_IOB_NOTIFIER_DIV < 4
-#    define IOB_DIVIDER 2
-#  elif CONFIG_IOB_NOTIFIER_DIV < 8
-#    define IOB_DIVIDER 4
-#  elif CONFIG_IOB_NOTIFIER_DIV < 16
-#    define IOB_DIVIDER 8
-#  elif CONFIG_IOB_NOTIFIER_DIV < 32
-#    define IOB_DIVIDER 16
-#  elif CONFIG_IOB_NOTIFIER_DIV < 64
-#    define IOB_DIVIDER 32
-#  else
-#    define IOB_DIVIDER 64
-#  endif
+  int nfreed = 0;
 #endif
 
-#define IOB_MASK      (IOB_DIVIDER - 1)
+  /* Free the I/O buffers by adding them to the head of the free or the
+   * committed list. We don't know what context we are called from so
+   * we use extreme measures to protect the free list:  We disable
+   * interrupts very briefly.
+   */
 
-/****************************************************************************
- * Public Functions
- ****************************************************************************/
+  flags = spin_lock_irqsave(&g_iob_lock);
+
+  for (; iob != NULL; iob = next)
+    {
+      next = iob->io_flink;
+
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+      /* Large buffers have their own pool and are never waited for */
+
+      if (IOB_ISLARGE(iob))
+        {
+          iob->io_flink   = g_iob_largelist;
+          g_iob_largelist = iob;
+          g_iob_large_count++;
+          DEBUGASSERT(g_iob_large_count <= CONFIG_IOB_LARGE_NBUFFERS);
+          continue;
+        }
+#endif
+
+#ifdef CONFIG_IOB_NOTIFIER
+      nfreed++;
+#endif
+
+      /* Which list?  If there is a task waiting for an IOB, then put
+       * the IOB on either the free list or on the committed list where
+       * it is reserved for that allocation (and not available to
+       * iob_tryalloc()). This is true for both throttled and non-throttled
+       * cases.
+       */
+
+#if CONFIG_IOB_THROTTLE > 0
+      if ((g_iob_count < 0) ||
+          ((g_iob_count >= CONFIG_IOB_THROTTLE) &&
+           (g_throttle_count < 0)))
+#else
+      if (g_iob_count < 0)
+#endif
+        {
+          iob->io_flink   = g_iob_committed;
+          g_iob_committed = iob;
+
+#if CONFIG_IOB_THROTTLE > 0
+          if (g_iob_count < 0)
+            {
+              g_iob_count++;
+              npost++;
+            }
+          else
+            {
+              g_throttle_count++;
+              ntpost++;
+            }
+#else
+          g_iob_count++;
+          npost++;
+#endif
+        }
+      else
+        {
+          g_iob_count++;
+#if CONFIG_IOB_THROTTLE > 0
+          if (g_iob_count > CONFIG_IOB_THROTTLE)
+            {
+              g_throttle_count++;
+            }
+#endif
+
+          iob->io_flink   = g_iob_freelist;
+          g_iob_freelist  = iob;
+        }
+    }
+
+  spin_unlock_irqrestore(&g_iob_lock, flags);
+
+  /* Wake up the waiters that the buffers were committed to */
+
+  while (npost-- > 0)
+    {
+      nxsem_post(&g_iob_sem);
+    }
+
+#if CONFIG_IOB_THROTTLE > 0
+  while (ntpost-- > 0)
+    {
+      nxsem_post(&g_throttle_sem);
+    }
+#endif
+
+  DEBUGASSERT(g_iob_count <= CONFIG_IOB_NBUFFERS);
+
+#if CONFIG_IOB_THROTTLE > 0
+  DEBUGASSERT(g_throttle_count <=
+              (CONFIG_IOB_NBUFFERS - CONFIG_IOB_THROTTLE));
+#endif
+
+#ifdef CONFIG_IOB_NOTIFIER
+  /* Signal any threads that have requested a signal notification when an
+   * IOB becomes available.
+   */
+
+  if (nfreed > 0)
+    {
+      iob_notifier_freed(nfreed);
+    }
+#endif
+}
 
 /****************************************************************************
  * Name: iob_free
@@ -79,10 +189,6 @@
 FAR struct iob_s *iob_free(FAR struct iob_s *iob)
 {
   FAR struct iob_s *next = iob->io_flink;
-  irqstate_t flags;
-#ifdef CONFIG_IOB_NOTIFIER
-  int16_t navail;
-#endif
 
   iobinfo("iob=%p io_pktlen=%u io_len=%u next=%p\n",
           iob, iob->io_pktlen, iob->io_len, next);
@@ -126,89 +232,23 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob)
     }
 #endif
 
-  /* Free the I/O buffer by adding it to the head of the free or the
-   * committed list. We don't know what context we are called from so
-   * we use extreme measures to protect the free list:  We disable
-   * interrupts very briefly.
-   */
+  iob->io_flink = NULL;
 
-  flags = spin_lock_irqsave(&g_iob_lock);
-
-  /* Which list?  If there is a task waiting for an IOB, then put
-   * the IOB on either the free list or on the committed list where
-   * it is reserved for that allocation (and not available to
-   * iob_tryalloc()). This is true for both throttled and non-throttled
-   * cases.
-   */
-
-#if CONFIG_IOB_THROTTLE > 0
-  if ((g_iob_count < 0) ||
-      ((g_iob_count >= CONFIG_IOB_THROTTLE) &&
-       (g_throttle_count < 0)))
-#else
-  if (g_iob_count < 0)
-#endif
-    {
-      FAR sem_t *sem;
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  /* Keep the buffer in the cache of this CPU if there is room */
 
-      iob->io_flink   = g_iob_committed;
-      g_iob_committed = iob;
-
-#if CONFIG_IOB_THROTTLE > 0
-      if (g_iob_count < 0)
-        {
-          g_iob_count++;
-          sem = &g_iob_sem;
-        }
-      else
-        {
-          g_throttle_count++;
-          sem = &g_throttle_sem;
-        }
-#else
-      g_iob_count++;
-      sem = &g_iob_sem;
-#endif
-      spin_unlock_irqrestore(&g_iob_lock, flags);
-      nxsem_post(sem);
-    }
-  else
+#  if CONFIG_IOB_LARGE_NBUFFERS > 0
+  if (!IOB_ISLARGE(iob))
+#  endif
     {
-      g_iob_count++;
-#if CONFIG_IOB_THROTTLE > 0
-      if (g_iob_count > CONFIG_IOB_THROTTLE)
-        {
-          g_throttle_count++;
-        }
-#endif
-
-      iob->io_flink   = g_iob_freelist;
-      g_iob_freelist  = iob;
-      spin_unlock_irqrestore(&g_iob_lock, flags);
+      iob = iob_cache_put(iob);
     }
 
-  DEBUGASSERT(g_iob_count <= CONFIG_IOB_NBUFFERS);
-
-#if CONFIG_IOB_THROTTLE > 0
-  DEBUGASSERT(g_throttle_count <=
-              (CONFIG_IOB_NBUFFERS - CONFIG_IOB_THROTTLE));
+  if (iob != NULL)
 #endif
-
-#ifdef CONFIG_IOB_NOTIFIER
-  /* Check if the IOB was claimed by a thread that is blocked waiting
-   * for an IOB.
-   */
-
-  navail = iob_navail(false);
-  if (navail > 0 && (navail & IOB_MASK) == 0)
     {
-      /* Signal any threads that have requested a signal notification
-       * when an IOB becomes available.
-       */
-
-      iob_notifier_signal();
+      iob_free_list(iob);
     }
-#endif
 
   /* And return the I/O buffer after the one that was freed */
 
@@ -27,6 +27,9 @@
 #include <nuttx/config.h>
 
 #include <nuttx/arch.h>
+#ifdef CONFIG_IOB_ALLOC
+#  include <nuttx/kmalloc.h>
+#endif
 #include <nuttx/mm/iob.h>
 
 #include "iob.h"
@@ -40,18 +43,64 @@
  *
  * Description:
  *   Free an entire buffer chain, starting at the beginning of the I/O
- *   buffer chain
+ *   buffer chain.  All buffers are returned to the free list in one go.
  *
  ****************************************************************************/
 
 void iob_free_chain(FAR struct iob_s *iob)
 {
-  FAR struct iob_s *next;
+#ifdef CONFIG_IOB_ALLOC
+  FAR struct iob_s **prev = &iob;
+  FAR struct iob_s *curr;
+#  if CONFIG_IOB_LARGE_NBUFFERS > 0
+  FAR struct iob_s *large = NULL;
+#  endif
 
-  /* Free each IOB in the chain -- one at a time to keep the count straight */
+  /* Buffers allocated from the heap are not returned to the free list,
+   * large buffers are returned to their own pool.
+   */
 
-  for (; iob; iob = next)
+  while ((curr = *prev) != NULL)
     {
-      next = iob_free(iob);
+      if (curr->io_free != NULL)
+        {
+          *prev = curr->io_flink;
+          curr->io_free(curr->io_data);
+          kmm_free(curr);
+        }
+#  if CONFIG_IOB_LARGE_NBUFFERS > 0
+      else if (IOB_ISLARGE(curr))
+        {
+          *prev          = curr->io_flink;
+          curr->io_flink = large;
+          large          = curr;
+        }
+#  endif
+      else
+        {
+          prev = &curr->io_flink;
+        }
+    }
+
+#  if CONFIG_IOB_LARGE_NBUFFERS > 0
+  if (large != NULL)
+    {
+      iob_free_list(large);
+    }
+#  endif
+#endif
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  /* Fill the cache of this CPU first */
+
+  if (iob != NULL)
+    {
+      iob = iob_cache_put(iob);
+    }
+#endif
+
+  if (iob != NULL)
+    {
+      iob_free_list(iob);
     }
 }
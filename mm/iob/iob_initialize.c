@@ -48,6 +48,15 @@
 #define IOB_BUFFER_SIZE   (IOB_ALIGN_SIZE * CONFIG_IOB_NBUFFERS + \
                            CONFIG_IOB_ALIGNMENT - 1)
 
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+#  define IOB_LARGE_ALIGN_SIZE  ROUNDUP(sizeof(struct iob_s) + \
+                                        CONFIG_IOB_LARGE_BUFSIZE, \
+                                        CONFIG_IOB_ALIGNMENT)
+#  define IOB_LARGE_BUFFER_SIZE (IOB_LARGE_ALIGN_SIZE * \
+                                 CONFIG_IOB_LARGE_NBUFFERS + \
+                                 CONFIG_IOB_ALIGNMENT - 1)
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -63,6 +72,17 @@ static uint8_t g_iob_buffer[IOB_BUFFER_SIZE] locate_data(IOB_SECTION);
 static uint8_t g_iob_buffer[IOB_BUFFER_SIZE];
 #endif
 
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+/* The same for the large I/O buffers */
+
+#  ifdef IOB_SECTION
+static uint8_t g_iob_largebuffer[IOB_LARGE_BUFFER_SIZE]
+                                 locate_data(IOB_SECTION);
+#  else
+static uint8_t g_iob_largebuffer[IOB_LARGE_BUFFER_SIZE];
+#  endif
+#endif
+
 #if CONFIG_IOB_NCHAINS > 0
 /* This is a pool of pre-allocated iob_qentry_s buffers */
 
@@ -115,6 +135,16 @@ sem_t g_qentry_sem = SEM_INITIALIZER(0);
 volatile int16_t g_qentry_count = CONFIG_IOB_NCHAINS;
 #endif
 
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+/* A list of all free, unallocated large I/O buffers */
+
+FAR struct iob_s *g_iob_largelist;
+
+/* Counts free large I/O buffers */
+
+volatile int16_t g_iob_large_count = CONFIG_IOB_LARGE_NBUFFERS;
+#endif
+
 volatile spinlock_t g_iob_lock = SP_UNLOCKED;
 
 /****************************************************************************
@@ -159,6 +189,25 @@ void iob_initialize(void)
       g_iob_freelist  = iob;
     }
 
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+  /* Then the large I/O buffers, aligned the same way */
+
+  buf = ROUNDUP((uintptr_t)g_iob_largebuffer +
+                offsetof(struct iob_s, io_data),
+                CONFIG_IOB_ALIGNMENT) - offsetof(struct iob_s, io_data);
+
+  for (i = 0; i < CONFIG_IOB_LARGE_NBUFFERS; i++)
+    {
+      FAR struct iob_s *iob =
+        (FAR struct iob_s *)(buf + i * IOB_LARGE_ALIGN_SIZE);
+
+      iob->io_flink    = g_iob_largelist;
+      iob->io_bufsize  = CONFIG_IOB_LARGE_BUFSIZE;
+      iob->io_data     = (FAR uint8_t *)(iob + 1);
+      g_iob_largelist  = iob;
+    }
+#endif
+
 #if CONFIG_IOB_NCHAINS > 0
   /* Add each I/O buffer chain queue container to the free list */
 
@@ -60,6 +60,15 @@ int iob_navail(bool throttled)
     }
 #endif
 
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  /* Non-throttled allocations may also use the cached buffers */
+
+  if (!throttled)
+    {
+      ret += iob_cache_navail();
+    }
+#endif
+
   if (ret < 0)
     {
       ret = 0;
@@ -36,6 +36,28 @@
 
 #ifdef CONFIG_IOB_NOTIFIER
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if !defined(CONFIG_IOB_NOTIFIER_DIV) || CONFIG_IOB_NOTIFIER_DIV < 2
+#  define IOB_DIVIDER 1
+#elif CONFIG_IOB_NOTIFIER_DIV < 4
+#  define IOB_DIVIDER 2
+#elif CONFIG_IOB_NOTIFIER_DIV < 8
+#  define IOB_DIVIDER 4
+#elif CONFIG_IOB_NOTIFIER_DIV < 16
+#  define IOB_DIVIDER 8
+#elif CONFIG_IOB_NOTIFIER_DIV < 32
+#  define IOB_DIVIDER 16
+#elif CONFIG_IOB_NOTIFIER_DIV < 64
+#  define IOB_DIVIDER 32
+#else
+#  define IOB_DIVIDER 64
+#endif
+
+#define IOB_MASK      (IOB_DIVIDER - 1)
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -132,4 +154,36 @@ void iob_notifier_signal(void)
   work_notifier_signal(WORK_IOB_AVAIL, NULL);
 }
 
+/****************************************************************************
+ * Name: iob_notifier_freed
+ *
+ * Description:
+ *   IOBs have been returned to the free list or to a per-CPU cache.  Signal
+ *   the waiters if the number of available IOBs went past a multiple of
+ *   CONFIG_IOB_NOTIFIER_DIV, however many IOBs were freed at once.
+ *
+ * Input Parameters:
+ *   nfreed - The number of IOBs freed.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void iob_notifier_freed(int nfreed)
+{
+  int navail = iob_navail(false);
+  int before = navail - nfreed;
+
+  if (before < 0)
+    {
+      before = 0;
+    }
+
+  if (navail > 0 && (navail & ~IOB_MASK) != (before & ~IOB_MASK))
+    {
+      iob_notifier_signal();
+    }
+}
+
 #endif /* CONFIG_IOB_NOTIFIER */
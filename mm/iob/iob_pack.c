@@ -42,7 +42,8 @@
  * Description:
  *   Pack all data in the I/O buffer chain so that the data offset is zero
  *   and all but the final buffer in the chain are filled.  Any emptied
- *   buffers at the end of the chain are freed.
+ *   buffers at the end of the chain are freed.  A packet that spans
+ *   several buffers but fits into a large one is moved there.
  *
  ****************************************************************************/
 
@@ -60,6 +61,26 @@ FAR struct iob_s *iob_pack(FAR struct iob_s *iob)
       iob = iob_free(iob);
     }
 
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+  /* If the packet spans several buffers but fits into a large one, move
+   * it there.
+   */
+
+  if (iob->io_pktlen > IOB_BUFSIZE(iob) &&
+      iob->io_pktlen <= CONFIG_IOB_LARGE_BUFSIZE)
+    {
+      head = iob_tryalloc_large();
+      if (head != NULL)
+        {
+          head->io_len    = iob_copyout(head->io_data, iob,
+                                        iob->io_pktlen, 0);
+          head->io_pktlen = head->io_len;
+          iob_free_chain(iob);
+          return head;
+        }
+    }
+#endif
+
   /* Now remember the head of the chain (for the return value) */
 
   head = iob;
@@ -26,6 +26,8 @@
 
 #include <nuttx/config.h>
 
+#include <assert.h>
+
 #include <nuttx/mm/iob.h>
 
 #include "iob.h"
@@ -78,7 +80,45 @@ void iob_getstats(FAR struct iob_stats_s *stats)
     {
       stats->nthrottle = 0;
     }
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  stats->ncached = iob_cache_navail();
+#endif
+
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+  stats->nlarge_total = CONFIG_IOB_LARGE_NBUFFERS;
+  stats->nlarge_free  = g_iob_large_count;
+#endif
+}
+
+/****************************************************************************
+ * Name: iob_getcachestats
+ *
+ * Description:
+ *   Return the usage statistics of the I/O buffer cache of one CPU
+ *
+ * Input Parameters:
+ *   cpu   - The CPU of interest
+ *   stats - Location to return the statistics
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+void iob_getcachestats(int cpu, FAR struct iob_cachestats_s *stats)
+{
+  FAR struct iob_cache_s *cache = &g_iob_cache[cpu];
+
+  DEBUGASSERT(cpu >= 0 && cpu < CONFIG_SMP_NCPUS);
+
+  stats->ncached = cache->count;
+  stats->nhit    = cache->nhit;
+  stats->nrefill = cache->nrefill;
+  stats->nspill  = cache->nspill;
 }
+#endif
 
 #endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
         * !CONFIG_FS_PROCFS_EXCLUDE_IOBINFO */
@@ -68,6 +68,18 @@
 #  define CONFIG_ARP_SEND_DELAYMSEC 20
 #endif
 
+/* Outgoing packets are held on unresolved ARP table entries */
+
+#if defined(CONFIG_NET_ARP_SEND) && CONFIG_NET_ARP_PENDQ_SIZE > 0
+#  define NET_ARP_PENDQ 1
+#endif
+
+#ifdef CONFIG_NET_STATISTICS
+#  define ARP_STATINCR(p) ((p)++)
+#else
+#  define ARP_STATINCR(p)
+#endif
+
 /* ARP Definitions **********************************************************/
 
 #define ARP_REQUEST    1
@@ -77,6 +89,11 @@
 
 #define RASIZE         4  /* Size of ROUTER ALERT */
 
+/* ARP table entry flags */
+
+#define ARP_ENTRY_PENDING  (1 << 0) /* The address is being resolved */
+#define ARP_ENTRY_FLUSH    (1 << 1) /* Resolved, held packets not sent yet */
+
 /* Allocate a new ARP data callback */
 
 #define arp_callback_alloc(dev)   devif_callback_alloc(dev, \
@@ -161,10 +178,20 @@ struct arp_notify_s
 
 struct arp_entry_s
 {
+  FAR struct arp_entry_s  *at_flink;    /* Hash chain or free list link */
   in_addr_t                at_ipaddr;   /* IP address */
   struct ether_addr        at_ethaddr;  /* Hardware address */
   clock_t                  at_time;     /* Time of last usage */
   FAR struct net_driver_s *at_dev;      /* The device driver structure */
+#ifdef NET_ARP_PENDQ
+  uint8_t                  at_flags;    /* See ARP_ENTRY_* definitions */
+  uint8_t                  at_tries;    /* ARP requests sent while pending */
+  uint8_t                  at_npend;    /* Number of held packets */
+
+  /* Packets waiting for the address to be resolved, oldest first */
+
+  FAR struct iob_s        *at_pend[CONFIG_NET_ARP_PENDQ_SIZE];
+#endif
 };
 
 /****************************************************************************
@@ -176,6 +203,20 @@ struct arp_entry_s
  ****************************************************************************/
 
 #ifdef CONFIG_NET_ARP
+/****************************************************************************
+ * Name: arp_initialize
+ *
+ * Description:
+ *   Initialize the ARP table and its hash index.
+ *
+ * Assumptions:
+ *   Called early in the initialization sequence so that no special
+ *   protection is required.
+ *
+ ****************************************************************************/
+
+void arp_initialize(void);
+
 /****************************************************************************
  * Name: arp_format
  *
@@ -508,6 +549,63 @@ int arp_update(FAR struct net_driver_s *dev, in_addr_t ipaddr,
 void arp_hdr_update(FAR struct net_driver_s *dev, FAR uint16_t *pipaddr,
                     FAR const uint8_t *ethaddr);
 
+/****************************************************************************
+ * Name: arp_pend
+ *
+ * Description:
+ *   Hold an outgoing packet on the ARP table entry of an address that is
+ *   being resolved, creating the entry if there is none.  When the entry
+ *   already holds CONFIG_NET_ARP_PENDQ_SIZE packets, the oldest one is
+ *   dropped.
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure
+ *   ipaddr - The IP address being resolved
+ *   iob    - The outgoing IPv4 packet
+ *
+ * Returned Value:
+ *   The packet is now owned by the ARP table if a non-negative value is
+ *   returned:  One if a new resolution was started and the caller must
+ *   send the first ARP request, zero if the address was already being
+ *   resolved and the ARP timer sends the next request.  A negated errno
+ *   value is returned if it cannot be held; the caller still owns the
+ *   packet then.
+ *
+ * Assumptions
+ *   The network is locked to assure exclusive access to the ARP table
+ *
+ ****************************************************************************/
+
+#ifdef NET_ARP_PENDQ
+int arp_pend(FAR struct net_driver_s *dev, in_addr_t ipaddr,
+             FAR struct iob_s *iob);
+#endif
+
+/****************************************************************************
+ * Name: arp_pend_poll
+ *
+ * Description:
+ *   Send the packets held on ARP table entries of this device whose
+ *   address has been resolved.
+ *
+ * Input Parameters:
+ *   dev      - The device driver structure
+ *   callback - The actual sending API provided by the driver
+ *
+ * Returned Value:
+ *   Zero indicated the polling will continue, else stop the polling.
+ *
+ * Assumptions:
+ *   This function is called from the MAC device driver indirectly through
+ *   devif_poll().  The network must be locked.
+ *
+ ****************************************************************************/
+
+#ifdef NET_ARP_PENDQ
+int arp_pend_poll(FAR struct net_driver_s *dev,
+                  devif_poll_callback_t callback);
+#endif
+
 /****************************************************************************
  * Name: arp_snapshot
  *
@@ -611,6 +709,7 @@ void arp_acd_setup(FAR struct net_driver_s *dev);
 
 /* If ARP is disabled, stub out all ARP interfaces */
 
+#  define arp_initialize()
 #  define arp_format(d,i);
 #  define arp_ipin(dev)
 #  define arp_out(dev)
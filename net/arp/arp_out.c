@@ -49,8 +49,10 @@
 #include <string.h>
 #include <debug.h>
 
+#include <nuttx/mm/iob.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
+#include <nuttx/net/netstats.h>
 
 #include "route/route.h"
 #include "arp/arp.h"
@@ -266,6 +268,29 @@ void arp_out(FAR struct net_driver_s *dev)
   if (ret < 0)
     {
       ninfo("ARP request for IP %08lx\n", (unsigned long)ipaddr);
+      ARP_STATINCR(g_netstats.arp.misses);
+
+#ifdef NET_ARP_PENDQ
+      /* Hold the IP packet on the ARP table until the address is resolved
+       * and send the ARP request in a new buffer.  Only the packet that
+       * starts the resolution sends a request, the ARP timer sends the
+       * retries.
+       */
+
+      if (ret == -ENOENT)
+        {
+          iob_update_pktlen(dev->d_iob, dev->d_len, false);
+          ret = arp_pend(dev, ipaddr, dev->d_iob);
+          if (ret >= 0)
+            {
+              netdev_iob_clear(dev);
+              if (ret == 0 || netdev_iob_prepare(dev, false, 0) < 0)
+                {
+                  return;
+                }
+            }
+        }
+#endif
 
       /* The destination address was not in our ARP table, so we overwrite
        * the IP packet with an ARP request.
@@ -273,9 +298,12 @@ void arp_out(FAR struct net_driver_s *dev)
 
       arp_format(dev, ipaddr);
       arp_dump(ARPBUF);
+      ARP_STATINCR(g_netstats.arp.requests);
       return;
     }
 
+  ARP_STATINCR(g_netstats.arp.hits);
+
   /* Build an Ethernet header. */
 
   memcpy(peth->dest, ethaddr.ether_addr_octet, ETHER_ADDR_LEN);
@@ -54,6 +54,15 @@
 
 int arp_poll(FAR struct net_driver_s *dev, devif_poll_callback_t callback)
 {
+#ifdef NET_ARP_PENDQ
+  /* Send the packets held until their address was resolved */
+
+  if (arp_pend_poll(dev, callback))
+    {
+      return true;
+    }
+
+#endif
   /* Setup for the ARP callback (most of these do not apply) */
 
   dev->d_appdata = NULL;
@@ -331,6 +331,15 @@ int arp_send(in_addr_t ipaddr)
           goto out;
         }
 
+#ifdef NET_ARP_PENDQ
+      /* Don't wait for the reply.  arp_out() will hold the outgoing
+       * packets on the ARP table until the address is resolved.
+       */
+
+      ret = OK;
+      goto out;
+#endif
+
       /* Set up the ARP response wait BEFORE we send the ARP request */
 
       arp_wait_setup(ipaddr, &notify);
@@ -48,6 +48,7 @@
 #ifdef CONFIG_NET
 
 #include <sys/ioctl.h>
+#include <sys/param.h>
 #include <stdint.h>
 #include <string.h>
 #include <debug.h>
@@ -56,11 +57,15 @@
 #include <net/ethernet.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/mm/iob.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
+#include <nuttx/net/netstats.h>
 #include <nuttx/net/ip.h>
 
+#include "devif/devif.h"
 #include "netdev/netdev.h"
 #include "netlink/netlink.h"
 #include "arp/arp.h"
@@ -72,6 +77,13 @@
  ****************************************************************************/
 
 #define ARP_MAXAGE_TICK SEC2TICK(10 * CONFIG_NET_ARP_MAXAGE)
+#define ARP_RESEND_TICK MSEC2TICK(CONFIG_ARP_SEND_DELAYMSEC)
+
+#define ARP_HASHSIZE    CONFIG_NET_ARPTAB_HASHSIZE
+
+#if (ARP_HASHSIZE & (ARP_HASHSIZE - 1)) != 0
+#  error CONFIG_NET_ARPTAB_HASHSIZE must be a power of two
+#endif
 
 /****************************************************************************
  * Private Types
@@ -91,6 +103,24 @@ struct arp_table_info_s
 
 static struct arp_entry_s g_arptable[CONFIG_NET_ARPTAB_SIZE];
 
+/* The entries in use, hashed by IP address, and the unused entries */
+
+static FAR struct arp_entry_s *g_arphash[ARP_HASHSIZE];
+static FAR struct arp_entry_s *g_arpfree;
+
+#ifdef NET_ARP_PENDQ
+/* Number of entries with held packets ready to be sent */
+
+static unsigned int g_arpnflush;
+
+/* Work that re-sends the ARP requests and ages the ARP table out, and the
+ * time it is scheduled for
+ */
+
+static struct work_s g_arpwork;
+static clock_t g_arpworktime;
+#endif
+
 static const struct ether_addr g_zero_ethaddr =
 {
   {
@@ -149,72 +179,122 @@ static int arp_match(FAR struct net_driver_s *dev, FAR void *arg)
 }
 
 /****************************************************************************
- * Name: arp_return_old_entry
+ * Name: arp_hash
  *
  * Description:
- *   Compare and return the old ARP table entry.
+ *   Return the hash chain of an IP address.
  *
  ****************************************************************************/
 
-static FAR struct arp_entry_s *
-arp_return_old_entry(FAR struct arp_entry_s *e1, FAR struct arp_entry_s *e2)
+static FAR struct arp_entry_s **arp_hash(in_addr_t ipaddr)
 {
-  if (e1->at_ipaddr == 0)
-    {
-      return e1;
-    }
-  else if (e2->at_ipaddr == 0)
+  uint32_t hash = (uint32_t)ipaddr;
+
+  hash ^= hash >> 16;
+  hash ^= hash >> 8;
+  return &g_arphash[hash & (ARP_HASHSIZE - 1)];
+}
+
+/****************************************************************************
+ * Name: arp_hashfind
+ *
+ * Description:
+ *   Find the ARP table entry of an IP address on a device, regardless of
+ *   its age.
+ *
+ ****************************************************************************/
+
+static FAR struct arp_entry_s *arp_hashfind(in_addr_t ipaddr,
+                                            FAR struct net_driver_s *dev)
+{
+  FAR struct arp_entry_s *tabptr;
+
+  for (tabptr = *arp_hash(ipaddr); tabptr != NULL;
+       tabptr = tabptr->at_flink)
     {
-      return e2;
+      if (tabptr->at_dev == dev &&
+          net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr))
+        {
+          break;
+        }
     }
-  else if ((int)(e1->at_time - e2->at_time) <= 0)
+
+  return tabptr;
+}
+
+#ifdef NET_ARP_PENDQ
+/****************************************************************************
+ * Name: arp_pend_drop
+ *
+ * Description:
+ *   Drop the packets held on an ARP table entry.
+ *
+ ****************************************************************************/
+
+static void arp_pend_drop(FAR struct arp_entry_s *tabptr)
+{
+  while (tabptr->at_npend > 0)
     {
-      return e1;
+      iob_free_chain(tabptr->at_pend[--tabptr->at_npend]);
+      ARP_STATINCR(g_netstats.arp.qdrops);
     }
-  else
+
+  if ((tabptr->at_flags & ARP_ENTRY_FLUSH) != 0)
     {
-      return e2;
+      g_arpnflush--;
     }
+
+  tabptr->at_flags = 0;
 }
 
 /****************************************************************************
- * Name: arp_lookup
+ * Name: arp_timer_start
  *
  * Description:
- *   Find the ARP entry corresponding to this IP address in the ARP table.
+ *   Make sure that the ARP table work runs within 'delay' ticks.
  *
- * Input Parameters:
- *   ipaddr - Refers to an IP address in network order
- *   dev    - Device structure
+ ****************************************************************************/
+
+static void arp_timer_work(FAR void *arg);
+
+static void arp_timer_start(clock_t delay)
+{
+  clock_t when = clock_systime_ticks() + delay;
+
+  if (work_available(&g_arpwork) || (sclock_t)(when - g_arpworktime) < 0)
+    {
+      g_arpworktime = when;
+      work_queue(LPWORK, &g_arpwork, arp_timer_work, NULL, delay);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: arp_release
  *
- * Assumptions:
- *   The network is locked to assure exclusive access to the ARP table.
- *   The return value will become unstable when the network is unlocked.
+ * Description:
+ *   Remove an entry from the hash table and return it to the free list.
  *
  ****************************************************************************/
 
-static FAR struct arp_entry_s *arp_lookup(in_addr_t ipaddr,
-                                          FAR struct net_driver_s *dev)
+static void arp_release(FAR struct arp_entry_s *tabptr)
 {
-  FAR struct arp_entry_s *tabptr;
-  int i;
+  FAR struct arp_entry_s **link = arp_hash(tabptr->at_ipaddr);
 
-  /* Check if the IPv4 address is already in the ARP table. */
-
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  while (*link != tabptr)
     {
-      tabptr = &g_arptable[i];
-      if (tabptr->at_dev == dev &&
-          net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr) &&
-          clock_systime_ticks() - tabptr->at_time <= ARP_MAXAGE_TICK)
-        {
-          return tabptr;
-        }
+      link = &(*link)->at_flink;
     }
 
-  /* Not found */
+  *link = tabptr->at_flink;
 
-  return NULL;
+#ifdef NET_ARP_PENDQ
+  arp_pend_drop(tabptr);
+#endif
+
+  memset(tabptr, 0, sizeof(*tabptr));
+  tabptr->at_flink = g_arpfree;
+  g_arpfree        = tabptr;
 }
 
 /****************************************************************************
@@ -249,101 +329,309 @@ static void arp_get_arpreq(FAR struct arpreq *output,
 #endif
 
 /****************************************************************************
- * Public Functions
+ * Name: arp_alloc
+ *
+ * Description:
+ *   Allocate an ARP table entry for an IP address and add it to the hash
+ *   table.  When all entries are in use, the least recently updated one is
+ *   replaced.
+ *
  ****************************************************************************/
 
+static FAR struct arp_entry_s *arp_alloc(FAR struct net_driver_s *dev,
+                                         in_addr_t ipaddr)
+{
+  FAR struct arp_entry_s *tabptr = g_arpfree;
+  FAR struct arp_entry_s **link;
+#ifdef CONFIG_NETLINK_ROUTE
+  struct arpreq arp_notify;
+#endif
+  int i;
+
+  if (tabptr == NULL)
+    {
+      /* Record the oldest entry */
+
+      tabptr = &g_arptable[0];
+      for (i = 1; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+        {
+          if ((int)(g_arptable[i].at_time - tabptr->at_time) < 0)
+            {
+              tabptr = &g_arptable[i];
+            }
+        }
+
+      /* When overwite old entry, notify old entry RTM_DELNEIGH */
+
+#ifdef CONFIG_NETLINK_ROUTE
+      arp_get_arpreq(&arp_notify, tabptr);
+      netlink_neigh_notify(&arp_notify, RTM_DELNEIGH, AF_INET);
+#endif
+
+      ARP_STATINCR(g_netstats.arp.evicted);
+      arp_release(tabptr);
+    }
+
+  g_arpfree = tabptr->at_flink;
+
+  link              = arp_hash(ipaddr);
+  tabptr->at_ipaddr = ipaddr;
+  tabptr->at_dev    = dev;
+  tabptr->at_flink  = *link;
+  *link             = tabptr;
+
+  return tabptr;
+}
+
 /****************************************************************************
- * Name: arp_update
+ * Name: arp_lookup
  *
  * Description:
- *   Add the IP/HW address mapping to the ARP table -OR- change the IP
- *   address of an existing association.
+ *   Find the ARP entry corresponding to this IP address in the ARP table.
  *
  * Input Parameters:
- *   dev     - The device driver structure
- *   ipaddr  - The IP address as an inaddr_t
- *   ethaddr - Refers to a HW address uint8_t[IFHWADDRLEN]
+ *   ipaddr - Refers to an IP address in network order
+ *   dev    - Device structure
  *
- * Returned Value:
- *   Zero (OK) if the ARP table entry was successfully modified.  A negated
- *   errno value is returned on any error.
+ * Assumptions:
+ *   The network is locked to assure exclusive access to the ARP table.
+ *   The return value will become unstable when the network is unlocked.
  *
- * Assumptions
- *   The network is locked to assure exclusive access to the ARP table
+ ****************************************************************************/
+
+static FAR struct arp_entry_s *arp_lookup(in_addr_t ipaddr,
+                                          FAR struct net_driver_s *dev)
+{
+  FAR struct arp_entry_s *tabptr;
+
+  /* Check if the IPv4 address is already in the ARP table. */
+
+  tabptr = arp_hashfind(ipaddr, dev);
+  if (tabptr != NULL &&
+      clock_systime_ticks() - tabptr->at_time <= ARP_MAXAGE_TICK)
+    {
+      return tabptr;
+    }
+
+  /* Not found */
+
+  return NULL;
+}
+
+#ifdef NET_ARP_PENDQ
+/****************************************************************************
+ * Name: arp_timer_work
+ *
+ * Description:
+ *   Re-send the ARP requests of the addresses being resolved, give up on
+ *   the ones that did not answer and remove the expired entries.
  *
  ****************************************************************************/
 
-int arp_update(FAR struct net_driver_s *dev, in_addr_t ipaddr,
-               FAR const uint8_t *ethaddr)
+static void arp_timer_work(FAR void *arg)
 {
-  FAR struct arp_entry_s *tabptr = &g_arptable[0];
+  FAR struct arp_entry_s *tabptr;
 #ifdef CONFIG_NETLINK_ROUTE
   struct arpreq arp_notify;
-  bool found = false;
-  bool new_entry;
 #endif
+  clock_t delay = ARP_MAXAGE_TICK;
+  clock_t elapsed;
+  clock_t now;
+  bool inuse = false;
   int i;
 
-  /* Walk through the ARP mapping table and try to find an entry to
-   * update. If none is found, the IP -> MAC address mapping is
-   * inserted in the ARP table.
-   */
+  net_lock();
 
+  now = clock_systime_ticks();
   for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
     {
-      /* Check if the source IP address of the incoming packet matches
-       * the IP address in this ARP table entry.
-       */
-
-      if (g_arptable[i].at_dev == dev &&
-          g_arptable[i].at_ipaddr != 0 &&
-          net_ipv4addr_cmp(ipaddr, g_arptable[i].at_ipaddr))
+      tabptr = &g_arptable[i];
+      if (tabptr->at_ipaddr == 0)
         {
-          /* An old entry found, break. */
+          continue;
+        }
 
-          tabptr = &g_arptable[i];
+      elapsed = now - tabptr->at_time;
+      if ((tabptr->at_flags & ARP_ENTRY_PENDING) != 0)
+        {
+          if (elapsed < ARP_RESEND_TICK)
+            {
+              delay = MIN(delay, ARP_RESEND_TICK - elapsed);
+            }
+          else if (tabptr->at_tries < CONFIG_ARP_SEND_MAXTRIES)
+            {
+              /* No reply yet, ask again */
+
+              tabptr->at_tries++;
+              tabptr->at_time = now;
+              arp_send_async(tabptr->at_ipaddr, NULL);
+              ARP_STATINCR(g_netstats.arp.requests);
+
+              delay = MIN(delay, ARP_RESEND_TICK);
+            }
+          else
+            {
+              /* Give up and drop the held packets.  Leave the MAC address
+               * marked with all zeros so that senders fail quickly until
+               * the entry expires.
+               */
+
+              nerr("ERROR: No ARP reply from %u.%u.%u.%u\n",
+                   ip4_addr1(tabptr->at_ipaddr),
+                   ip4_addr2(tabptr->at_ipaddr),
+                   ip4_addr3(tabptr->at_ipaddr),
+                   ip4_addr4(tabptr->at_ipaddr));
+
+              ARP_STATINCR(g_netstats.arp.timeouts);
+              arp_pend_drop(tabptr);
+              tabptr->at_time = now;
+            }
+
+          inuse = true;
+        }
+      else if (elapsed > ARP_MAXAGE_TICK)
+        {
 #ifdef CONFIG_NETLINK_ROUTE
-          found = true;
+          arp_get_arpreq(&arp_notify, tabptr);
+          netlink_neigh_notify(&arp_notify, RTM_DELNEIGH, AF_INET);
 #endif
-          break;
+
+          ARP_STATINCR(g_netstats.arp.expired);
+          arp_release(tabptr);
         }
       else
         {
-          /* Record the oldest entry. */
-
-          tabptr = arp_return_old_entry(tabptr, &g_arptable[i]);
+          delay = MIN(delay, ARP_MAXAGE_TICK - elapsed + 1);
+          inuse = true;
         }
     }
 
-  if (ethaddr == NULL)
+  if (inuse)
     {
-      ethaddr = g_zero_ethaddr.ether_addr_octet;
+      g_arpworktime = now + delay;
+      work_queue(LPWORK, &g_arpwork, arp_timer_work, NULL, delay);
     }
 
-  /* When overwite old entry, notify old entry RTM_DELNEIGH */
+  net_unlock();
+}
+#endif
 
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: arp_initialize
+ *
+ * Description:
+ *   Initialize the ARP table and its hash index.
+ *
+ * Assumptions:
+ *   Called early in the initialization sequence so that no special
+ *   protection is required.
+ *
+ ****************************************************************************/
+
+void arp_initialize(void)
+{
+  int i;
+
+  for (i = CONFIG_NET_ARPTAB_SIZE - 1; i >= 0; i--)
+    {
+      g_arptable[i].at_flink = g_arpfree;
+      g_arpfree              = &g_arptable[i];
+    }
+}
+
+/****************************************************************************
+ * Name: arp_update
+ *
+ * Description:
+ *   Add the IP/HW address mapping to the ARP table -OR- change the IP
+ *   address of an existing association.
+ *
+ * Input Parameters:
+ *   dev     - The device driver structure
+ *   ipaddr  - The IP address as an inaddr_t
+ *   ethaddr - Refers to a HW address uint8_t[IFHWADDRLEN]
+ *
+ * Returned Value:
+ *   Zero (OK) if the ARP table entry was successfully modified.  A negated
+ *   errno value is returned on any error.
+ *
+ * Assumptions
+ *   The network is locked to assure exclusive access to the ARP table
+ *
+ ****************************************************************************/
+
+int arp_update(FAR struct net_driver_s *dev, in_addr_t ipaddr,
+               FAR const uint8_t *ethaddr)
+{
+  FAR struct arp_entry_s *tabptr;
 #ifdef CONFIG_NETLINK_ROUTE
-  if (!found && tabptr->at_ipaddr != 0)
+  struct arpreq arp_notify;
+  bool new_entry;
+#endif
+
+  if (ethaddr == NULL)
     {
-      arp_get_arpreq(&arp_notify, tabptr);
-      netlink_neigh_notify(&arp_notify, RTM_DELNEIGH, AF_INET);
+      ethaddr = g_zero_ethaddr.ether_addr_octet;
     }
 
+  /* Look up the entry to update.  If none is found, the IP -> MAC address
+   * mapping is inserted in the ARP table.
+   */
+
+  tabptr = arp_hashfind(ipaddr, dev);
+
+#ifdef CONFIG_NETLINK_ROUTE
   /* Need to notify when entry is not found or changes in table */
 
-  new_entry = !found || memcmp(tabptr->at_ethaddr.ether_addr_octet,
-                               ethaddr, ETHER_ADDR_LEN) != 0;
+  new_entry = tabptr == NULL ||
+              memcmp(tabptr->at_ethaddr.ether_addr_octet,
+                     ethaddr, ETHER_ADDR_LEN) != 0;
 #endif
 
+  if (tabptr == NULL)
+    {
+      tabptr = arp_alloc(dev, ipaddr);
+    }
+
   /* Now, tabptr is the ARP table entry which we will fill with the new
    * information.
    */
 
-  tabptr->at_ipaddr = ipaddr;
   memcpy(tabptr->at_ethaddr.ether_addr_octet, ethaddr, ETHER_ADDR_LEN);
-  tabptr->at_dev = dev;
   tabptr->at_time = clock_systime_ticks();
 
+#ifdef NET_ARP_PENDQ
+  if ((tabptr->at_flags & ARP_ENTRY_PENDING) != 0)
+    {
+      if (ethaddr == g_zero_ethaddr.ether_addr_octet)
+        {
+          /* The resolution failed, nothing to send */
+
+          arp_pend_drop(tabptr);
+        }
+      else
+        {
+          /* Resolved, let the driver poll for the held packets */
+
+          tabptr->at_flags &= ~ARP_ENTRY_PENDING;
+          if (tabptr->at_npend > 0)
+            {
+              tabptr->at_flags |= ARP_ENTRY_FLUSH;
+              g_arpnflush++;
+              netdev_txnotify_dev(dev);
+            }
+        }
+    }
+
+  /* Age the entry out */
+
+  arp_timer_start(ARP_MAXAGE_TICK + 1);
+#endif
+
   /* Notify the new entry */
 
 #ifdef CONFIG_NETLINK_ROUTE
@@ -388,6 +676,181 @@ void arp_hdr_update(FAR struct net_driver_s *dev, FAR uint16_t *pipaddr,
   arp_update(dev, ipaddr, ethaddr);
 }
 
+#ifdef NET_ARP_PENDQ
+/****************************************************************************
+ * Name: arp_pend
+ *
+ * Description:
+ *   Hold an outgoing packet on the ARP table entry of an address that is
+ *   being resolved, creating the entry if there is none.  When the entry
+ *   already holds CONFIG_NET_ARP_PENDQ_SIZE packets, the oldest one is
+ *   dropped.
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure
+ *   ipaddr - The IP address being resolved
+ *   iob    - The outgoing IPv4 packet
+ *
+ * Returned Value:
+ *   The packet is now owned by the ARP table if a non-negative value is
+ *   returned:  One if a new resolution was started and the caller must
+ *   send the first ARP request, zero if the address was already being
+ *   resolved and the ARP timer sends the next request.  A negated errno
+ *   value is returned if it cannot be held; the caller still owns the
+ *   packet then.
+ *
+ * Assumptions
+ *   The network is locked to assure exclusive access to the ARP table
+ *
+ ****************************************************************************/
+
+int arp_pend(FAR struct net_driver_s *dev, in_addr_t ipaddr,
+             FAR struct iob_s *iob)
+{
+  FAR struct arp_entry_s *tabptr;
+  int ret = 0;
+
+  tabptr = arp_hashfind(ipaddr, dev);
+  if (tabptr == NULL)
+    {
+      tabptr = arp_alloc(dev, ipaddr);
+    }
+
+  if ((tabptr->at_flags & ARP_ENTRY_PENDING) == 0)
+    {
+      /* Start resolving the address.  The caller sends the first ARP
+       * request, the timer sends the next ones.
+       */
+
+      if ((tabptr->at_flags & ARP_ENTRY_FLUSH) != 0)
+        {
+          g_arpnflush--;
+        }
+
+      memset(&tabptr->at_ethaddr, 0, sizeof(tabptr->at_ethaddr));
+      tabptr->at_flags = ARP_ENTRY_PENDING;
+      tabptr->at_tries = 1;
+      tabptr->at_time  = clock_systime_ticks();
+      arp_timer_start(ARP_RESEND_TICK);
+      ret = 1;
+    }
+
+  if (tabptr->at_npend >= CONFIG_NET_ARP_PENDQ_SIZE)
+    {
+      /* Make room by dropping the oldest packet */
+
+      iob_free_chain(tabptr->at_pend[0]);
+      ARP_STATINCR(g_netstats.arp.qdrops);
+
+      tabptr->at_npend--;
+      memmove(&tabptr->at_pend[0], &tabptr->at_pend[1],
+              tabptr->at_npend * sizeof(tabptr->at_pend[0]));
+    }
+
+  tabptr->at_pend[tabptr->at_npend++] = iob;
+  ARP_STATINCR(g_netstats.arp.queued);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: arp_pend_poll
+ *
+ * Description:
+ *   Send the packets held on ARP table entries of this device whose
+ *   address has been resolved.
+ *
+ * Input Parameters:
+ *   dev      - The device driver structure
+ *   callback - The actual sending API provided by the driver
+ *
+ * Returned Value:
+ *   Zero indicated the polling will continue, else stop the polling.
+ *
+ * Assumptions:
+ *   This function is called from the MAC device driver indirectly through
+ *   devif_poll().  The network must be locked.
+ *
+ ****************************************************************************/
+
+int arp_pend_poll(FAR struct net_driver_s *dev,
+                  devif_poll_callback_t callback)
+{
+  FAR struct arp_entry_s *tabptr;
+  FAR struct iob_s *iob;
+  bool reused = false;
+  int bstop = false;
+  int i;
+
+  for (i = 0; g_arpnflush > 0 && !bstop && i < CONFIG_NET_ARPTAB_SIZE; i++)
+    {
+      tabptr = &g_arptable[i];
+      if (tabptr->at_dev != dev ||
+          (tabptr->at_flags & ARP_ENTRY_FLUSH) == 0)
+        {
+          continue;
+        }
+
+      /* arp_out() may hold the packet again if the entry expired, which
+       * clears the flush flag.
+       */
+
+      while (!bstop && tabptr->at_npend > 0 &&
+             (tabptr->at_flags & ARP_ENTRY_FLUSH) != 0)
+        {
+          iob = tabptr->at_pend[0];
+          tabptr->at_npend--;
+          memmove(&tabptr->at_pend[0], &tabptr->at_pend[1],
+                  tabptr->at_npend * sizeof(tabptr->at_pend[0]));
+
+          /* The held buffer could be reused for other protocols */
+
+          reused = true;
+
+          /* Replace original iob and build the L2 header */
+
+          netdev_iob_replace(dev, iob);
+          devif_out(dev);
+          ARP_STATINCR(g_netstats.arp.flushed);
+
+          /* Call back into the driver */
+
+          if (dev->d_len > 0)
+            {
+              bstop = callback(dev);
+            }
+        }
+
+      if (tabptr->at_npend == 0 &&
+          (tabptr->at_flags & ARP_ENTRY_FLUSH) != 0)
+        {
+          tabptr->at_flags &= ~ARP_ENTRY_FLUSH;
+          g_arpnflush--;
+        }
+    }
+
+  /* Notify the device driver that held packets are still available */
+
+  if (bstop && g_arpnflush > 0)
+    {
+      netdev_txnotify_dev(dev);
+    }
+
+  /* Reuse iob buffer */
+
+  if (!bstop && reused)
+    {
+      if (dev->d_iob != NULL)
+        {
+          iob_update_pktlen(dev->d_iob, 0, false);
+        }
+
+      netdev_iob_prepare(dev, true, 0);
+    }
+
+  return bstop;
+}
+#endif /* NET_ARP_PENDQ */
+
 /****************************************************************************
  * Name: arp_find
  *
@@ -419,6 +882,15 @@ int arp_find(in_addr_t ipaddr, FAR uint8_t *ethaddr,
   tabptr = arp_lookup(ipaddr, dev);
   if (tabptr != NULL)
     {
+#ifdef NET_ARP_PENDQ
+      /* The address is still being resolved */
+
+      if ((tabptr->at_flags & ARP_ENTRY_PENDING) != 0)
+        {
+          return -ENOENT;
+        }
+#endif
+
       /* Addresses that have failed to be searched will return a special
        * error code so that the upper layer can return faster.
        */
@@ -496,9 +968,9 @@ int arp_delete(in_addr_t ipaddr, FAR struct net_driver_s *dev)
       netlink_neigh_notify(&arp_notify, RTM_DELNEIGH, AF_INET);
 #endif
 
-      /* Yes.. Set the IP address to zero to "delete" it */
+      /* Yes.. Return the entry to the free list to "delete" it */
 
-      tabptr->at_ipaddr = 0;
+      arp_release(tabptr);
       return OK;
     }
 
@@ -525,9 +997,9 @@ void arp_cleanup(FAR struct net_driver_s *dev)
 
   for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
     {
-      if (dev == g_arptable[i].at_dev)
+      if (g_arptable[i].at_ipaddr != 0 && dev == g_arptable[i].at_dev)
         {
-          memset(&g_arptable[i], 0, sizeof(g_arptable[i]));
+          arp_release(&g_arptable[i]);
         }
     }
 }
@@ -568,6 +1040,13 @@ unsigned int arp_snapshot(FAR struct arpreq *snapshot,
        i++)
     {
       tabptr = &g_arptable[i];
+#ifdef NET_ARP_PENDQ
+      if ((tabptr->at_flags & ARP_ENTRY_PENDING) != 0)
+        {
+          continue;
+        }
+#endif
+
       if (tabptr->at_ipaddr != 0 &&
           now - tabptr->at_time <= ARP_MAXAGE_TICK)
         {
@@ -291,6 +291,7 @@ uint16_t bluetooth_callback(FAR struct radio_driver_s *radio,
  *   psock    A pointer to a NuttX-specific, internal socket structure
  *   msg      Buffer to receive data
  *   flags    Receive flags
+ *   timeout  Receive timeout in milliseconds, UINT_MAX for none
  *
  * Returned Value:
  *   On success, returns the number of characters received. If no data is
@@ -301,7 +302,7 @@ uint16_t bluetooth_callback(FAR struct radio_driver_s *radio,
  ****************************************************************************/
 
 ssize_t bluetooth_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
-                          int flags);
+                          int flags, unsigned int timeout);
 
 /****************************************************************************
  * Name: bluetooth_find_device
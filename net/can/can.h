@@ -257,11 +257,12 @@ uint16_t can_datahandler(FAR struct net_driver_s *dev,
  *   psock    A pointer to a NuttX-specific, internal socket structure
  *   msg      Buffer to receive the message
  *   flags    Receive flags (ignored)
+ *   timeout  Receive timeout in milliseconds, UINT_MAX for none
  *
  ****************************************************************************/
 
 ssize_t can_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
-                    int flags);
+                    int flags, unsigned int timeout);
 
 /****************************************************************************
  * Name: can_poll
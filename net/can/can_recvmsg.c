@@ -507,11 +507,12 @@ static ssize_t can_recvfrom_result(int result,
  *   psock    A pointer to a NuttX-specific, internal socket structure
  *   msg      Buffer to receive the message
  *   flags    Receive flags (ignored)
+ *   timeout  Receive timeout in milliseconds, UINT_MAX for none
  *
  ****************************************************************************/
 
 ssize_t can_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
-                    int flags)
+                    int flags, unsigned int timeout)
 {
   FAR struct can_conn_s *conn;
   FAR struct net_driver_s *dev;
@@ -334,6 +334,7 @@ ssize_t icmp_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
  *   psock    A pointer to a NuttX-specific, internal socket structure
  *   msg      Buffer to receive the message
  *   flags    Receive flags
+ *   timeout  Receive timeout in milliseconds, UINT_MAX for none
  *
  * Returned Value:
  *   On success, returns the number of characters received. If no data is
@@ -345,7 +346,7 @@ ssize_t icmp_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
 
 #ifdef CONFIG_NET_ICMP_SOCKET
 ssize_t icmp_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
-                     int flags);
+                     int flags, unsigned int timeout);
 #endif
 
 /****************************************************************************
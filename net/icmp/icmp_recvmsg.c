@@ -272,6 +272,7 @@ static inline ssize_t icmp_readahead(FAR struct icmp_conn_s *conn,
  *   psock    A pointer to a NuttX-specific, internal socket structure
  *   msg      Buffer to receive the message
  *   flags    Receive flags
+ *   timeout  Receive timeout in milliseconds, UINT_MAX for none
  *
  * Returned Value:
  *   On success, returns the number of characters received. If no data is
@@ -282,7 +283,7 @@ static inline ssize_t icmp_readahead(FAR struct icmp_conn_s *conn,
  ****************************************************************************/
 
 ssize_t icmp_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
-                     int flags)
+                     int flags, unsigned int timeout)
 {
   FAR void *buf = msg->msg_iov->iov_base;
   size_t len = msg->msg_iov->iov_len;
@@ -373,8 +374,7 @@ ssize_t icmp_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
            * received.
            */
 
-          ret = net_sem_timedwait(&state.recv_sem,
-                              _SO_TIMEOUT(conn->sconn.s_rcvtimeo));
+          ret = net_sem_timedwait(&state.recv_sem, timeout);
           if (ret < 0)
             {
               state.recv_result = ret;
@@ -696,6 +696,7 @@ ssize_t icmpv6_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
  *   psock    A pointer to a NuttX-specific, internal socket structure
  *   msg      Buffer to receive the message
  *   flags    Receive flags
+ *   timeout  Receive timeout in milliseconds, UINT_MAX for none
  *
  * Returned Value:
  *   On success, returns the number of characters received. If no data is
@@ -707,7 +708,7 @@ ssize_t icmpv6_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
 
 #ifdef CONFIG_NET_ICMPv6_SOCKET
 ssize_t icmpv6_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
-                       int flags);
+                       int flags, unsigned int timeout);
 #endif
 
 /****************************************************************************
@@ -283,6 +283,7 @@ static inline ssize_t icmpv6_readahead(FAR struct icmpv6_conn_s *conn,
  *   psock    A pointer to a NuttX-specific, internal socket structure
  *   msg      Buffer to receive the message
  *   flags    Receive flags
+ *   timeout  Receive timeout in milliseconds, UINT_MAX for none
  *
  * Returned Value:
  *   On success, returns the number of characters received. If no data is
@@ -293,7 +294,7 @@ static inline ssize_t icmpv6_readahead(FAR struct icmpv6_conn_s *conn,
  ****************************************************************************/
 
 ssize_t icmpv6_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
-                       int flags)
+                       int flags, unsigned int timeout)
 {
   FAR void *buf = msg->msg_iov->iov_base;
   size_t len = msg->msg_iov->iov_len;
@@ -386,8 +387,7 @@ ssize_t icmpv6_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
            * when the task restarts.
            */
 
-          ret = net_sem_timedwait(&state.recv_sem,
-                              _SO_TIMEOUT(conn->sconn.s_rcvtimeo));
+          ret = net_sem_timedwait(&state.recv_sem, timeout);
           if (ret < 0)
             {
               state.recv_result = ret;
@@ -305,6 +305,7 @@ uint16_t ieee802154_callback(FAR struct radio_driver_s *radio,
  *   psock    A pointer to a NuttX-specific, internal socket structure
  *   msg      Buffer to receive the message
  *   flags    Receive flags
+ *   timeout  Receive timeout in milliseconds, UINT_MAX for none
  *
  * Returned Value:
  *   On success, returns the number of characters received. If no data is
@@ -315,7 +316,7 @@ uint16_t ieee802154_callback(FAR struct radio_driver_s *radio,
  ****************************************************************************/
 
 ssize_t ieee802154_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
-                           int flags);
+                           int flags, unsigned int timeout);
 
 /****************************************************************************
  * Name: ieee802154_find_device
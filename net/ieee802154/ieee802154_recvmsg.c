@@ -291,6 +291,7 @@ static uint16_t
  *   psock    A pointer to a NuttX-specific, internal socket structure
  *   msg      Buffer to receive the message
  *   flags    Receive flags
+ *   timeout  Receive timeout in milliseconds, UINT_MAX for none
  *
  * Returned Value:
  *   On success, returns the number of characters received. If no data is
@@ -304,7 +305,7 @@ static uint16_t
  ****************************************************************************/
 
 ssize_t ieee802154_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
-                           int flags)
+                           int flags, unsigned int timeout)
 {
   FAR void *buf = msg->msg_iov->iov_base;
   size_t len = msg->msg_iov->iov_len;
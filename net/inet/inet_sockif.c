@@ -96,7 +96,8 @@ static ssize_t    inet_sendto(FAR struct socket *psock, FAR const void *buf,
 static ssize_t    inet_sendmsg(FAR struct socket *psock,
                                FAR struct msghdr *msg, int flags);
 static ssize_t    inet_recvmsg(FAR struct socket *psock,
-                               FAR struct msghdr *msg, int flags);
+                               FAR struct msghdr *msg, int flags,
+                               unsigned int timeout);
 static int        inet_ioctl(FAR struct socket *psock,
                              int cmd, unsigned long arg);
 static int        inet_socketpair(FAR struct socket *psocks[2]);
@@ -2259,6 +2260,7 @@ static ssize_t inet_sendfile(FAR struct socket *psock,
  *   psock   - A pointer to a NuttX-specific, internal socket structure
  *   msg     - Buffer to receive the message
  *   flags   - Receive flags
+ *   timeout - Receive timeout in milliseconds, UINT_MAX for none
  *
  * Returned Value:
  *   On success, returns the number of characters received.  If no data is
@@ -2269,7 +2271,8 @@ static ssize_t inet_sendfile(FAR struct socket *psock,
  ****************************************************************************/
 
 static ssize_t inet_recvmsg(FAR struct socket *psock,
-                            FAR struct msghdr *msg, int flags)
+                            FAR struct msghdr *msg, int flags,
+                            unsigned int timeout)
 {
   ssize_t ret;
 
@@ -2322,7 +2325,7 @@ static ssize_t inet_recvmsg(FAR struct socket *psock,
     case SOCK_STREAM:
       {
 #ifdef NET_TCP_HAVE_STACK
-        ret = psock_tcp_recvfrom(psock, msg, flags);
+        ret = psock_tcp_recvfrom(psock, msg, flags, timeout);
 #else
         ret = -ENOSYS;
 #endif
@@ -2334,7 +2337,7 @@ static ssize_t inet_recvmsg(FAR struct socket *psock,
     case SOCK_DGRAM:
       {
 #ifdef NET_UDP_HAVE_STACK
-        ret = psock_udp_recvfrom(psock, msg, flags);
+        ret = psock_udp_recvfrom(psock, msg, flags, timeout);
 #else
         ret = -ENOSYS;
 #endif
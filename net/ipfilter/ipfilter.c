@@ -65,6 +65,21 @@
 #define IPv6_L4HDR(ipv6, proto) \
   ((FAR void *)(net_ipv6_payload((FAR struct ipv6_hdr_s *)(ipv6), &(proto))))
 
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The packet being matched against the filter entries */
+
+struct ipfilter_packet_s
+{
+  FAR const struct net_driver_s *indev;
+  FAR const struct net_driver_s *outdev;
+  FAR const void *iphdr;
+  FAR const void *l4hdr;
+  uint8_t proto;
+};
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -76,6 +91,17 @@ static sq_queue_t g_ipv4_filters[IPFILTER_CHAIN_MAX];
 static sq_queue_t g_ipv6_filters[IPFILTER_CHAIN_MAX];
 #endif
 
+#ifdef CONFIG_NET_IPFILTER_CLASSIFIER
+/* The compiled chains, built by ipfilter_cfg_build() */
+
+#  ifdef CONFIG_NET_IPv4
+static FAR struct ipfilter_class_s *g_ipv4_classes[IPFILTER_CHAIN_MAX];
+#  endif
+#  ifdef CONFIG_NET_IPv6
+static FAR struct ipfilter_class_s *g_ipv6_classes[IPFILTER_CHAIN_MAX];
+#  endif
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -188,6 +214,105 @@ static bool ipfilter_match_proto(FAR const struct ipfilter_entry_s *entry,
     }
 }
 
+/****************************************************************************
+ * Name: ipv4_filter_check / ipv6_filter_check
+ *
+ * Description:
+ *   Match the packet with one filter entry.
+ *
+ * Input Parameters:
+ *   entry - The filter entry to match
+ *   arg   - The packet, a struct ipfilter_packet_s
+ *
+ * Returned Value:
+ *   true  - The packet is matched
+ *   false - The packet is not matched
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static bool ipv4_filter_check(FAR const struct ipfilter_entry_s *entry,
+                              FAR const void *arg)
+{
+  FAR const struct ipv4_filter_entry_s *filter =
+    (FAR const struct ipv4_filter_entry_s *)entry;
+  FAR const struct ipfilter_packet_s *pkt = arg;
+  FAR const struct ipv4_hdr_s *ipv4 = pkt->iphdr;
+  in_addr_t ipaddr;
+  bool matched;
+
+  /* Match device */
+
+  if (!ipfilter_match_device(&filter->common, pkt->indev, pkt->outdev))
+    {
+      return false;
+    }
+
+  /* Match addresses */
+
+  ipaddr  = net_ip4addr_conv32(ipv4->srcipaddr);
+  matched = net_ipv4addr_maskcmp(filter->sip, ipaddr, filter->smsk)
+            ^ filter->common.inv_srcip;
+  if (!matched)
+    {
+      return false;
+    }
+
+  ipaddr  = net_ip4addr_conv32(ipv4->destipaddr);
+  matched = net_ipv4addr_maskcmp(filter->dip, ipaddr, filter->dmsk)
+            ^ filter->common.inv_dstip;
+  if (!matched)
+    {
+      return false;
+    }
+
+  /* Match protocol */
+
+  return ipfilter_match_proto(&filter->common, pkt->l4hdr, pkt->proto);
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static bool ipv6_filter_check(FAR const struct ipfilter_entry_s *entry,
+                              FAR const void *arg)
+{
+  FAR const struct ipv6_filter_entry_s *filter =
+    (FAR const struct ipv6_filter_entry_s *)entry;
+  FAR const struct ipfilter_packet_s *pkt = arg;
+  FAR const struct ipv6_hdr_s *ipv6 = pkt->iphdr;
+  bool matched;
+
+  /* Match device */
+
+  if (!ipfilter_match_device(&filter->common, pkt->indev, pkt->outdev))
+    {
+      return false;
+    }
+
+  /* Match addresses */
+
+  matched = net_ipv6addr_maskcmp(filter->sip, ipv6->srcipaddr,
+                                 filter->smsk)
+            ^ filter->common.inv_srcip;
+  if (!matched)
+    {
+      return false;
+    }
+
+  matched = net_ipv6addr_maskcmp(filter->dip, ipv6->destipaddr,
+                                 filter->dmsk)
+            ^ filter->common.inv_dstip;
+  if (!matched)
+    {
+      return false;
+    }
+
+  /* Match protocol */
+
+  return ipfilter_match_proto(&filter->common, pkt->l4hdr, pkt->proto);
+}
+#endif
+
 /****************************************************************************
  * Name: ipv4_filter_match / ipv6_filter_match
  *
@@ -213,12 +338,9 @@ static int ipv4_filter_match(FAR const struct net_driver_s *indev,
                              FAR const struct ipv4_hdr_s *ipv4,
                              enum ipfilter_chain_e chain)
 {
-  FAR const struct ipv4_filter_entry_s *filter;
   FAR const sq_queue_t *queue = &g_ipv4_filters[chain];
   FAR const sq_entry_t *entry;
-  FAR const void *l4hdr;
-  in_addr_t ipaddr;
-  bool matched;
+  struct ipfilter_packet_s pkt;
 
   /* Handle unexpected status, return ACCEPT to indicate doing nothing. */
 
@@ -227,47 +349,32 @@ static int ipv4_filter_match(FAR const struct net_driver_s *indev,
       return IPFILTER_TARGET_ACCEPT;
     }
 
-  l4hdr = IPv4_L4HDR(ipv4);
+  pkt.indev  = indev;
+  pkt.outdev = outdev;
+  pkt.iphdr  = ipv4;
+  pkt.l4hdr  = IPv4_L4HDR(ipv4);
+  pkt.proto  = ipv4->proto;
 
-  sq_for_every(queue, entry)
+#ifdef CONFIG_NET_IPFILTER_CLASSIFIER
+  if (g_ipv4_classes[chain] != NULL)
     {
-      filter = (FAR struct ipv4_filter_entry_s *)entry;
-
-      /* Match device */
-
-      if (!ipfilter_match_device(&filter->common, indev, outdev))
-        {
-          continue;
-        }
-
-      /* Match addresses */
-
-      ipaddr  = net_ip4addr_conv32(ipv4->srcipaddr);
-      matched = net_ipv4addr_maskcmp(filter->sip, ipaddr, filter->smsk)
-                ^ filter->common.inv_srcip;
-      if (!matched)
-        {
-          continue;
-        }
+      return ipfilter_class_match(g_ipv4_classes[chain], ipv4->srcipaddr,
+                                  ipv4->destipaddr, pkt.proto, pkt.l4hdr,
+                                  ipv4_filter_check, &pkt);
+    }
+#endif
 
-      ipaddr  = net_ip4addr_conv32(ipv4->destipaddr);
-      matched = net_ipv4addr_maskcmp(filter->dip, ipaddr, filter->dmsk)
-                ^ filter->common.inv_dstip;
-      if (!matched)
-        {
-          continue;
-        }
+  sq_for_every(queue, entry)
+    {
+      FAR const struct ipfilter_entry_s *filter =
+        (FAR const struct ipfilter_entry_s *)entry;
 
-      /* Match protocol */
+      /* Return the target action if matched. */
 
-      if (!ipfilter_match_proto(&filter->common, l4hdr, ipv4->proto))
+      if (ipv4_filter_check(filter, &pkt))
         {
-          continue;
+          return filter->target;
         }
-
-      /* Return the target action if matched. */
-
-      return filter->common.target;
     }
 
   /* Normally there should be a default rule in chain, won't reach here. */
@@ -283,12 +390,10 @@ static int ipv6_filter_match(FAR const struct net_driver_s *indev,
                              FAR const struct ipv6_hdr_s *ipv6,
                              enum ipfilter_chain_e chain)
 {
-  FAR const struct ipv6_filter_entry_s *filter;
   FAR const sq_queue_t *queue = &g_ipv6_filters[chain];
   FAR const sq_entry_t *entry;
-  FAR const void *l4hdr;
+  struct ipfilter_packet_s pkt;
   uint8_t proto;
-  bool matched;
 
   /* Handle unexpected status, return ACCEPT to indicate doing nothing. */
 
@@ -297,47 +402,32 @@ static int ipv6_filter_match(FAR const struct net_driver_s *indev,
       return IPFILTER_TARGET_ACCEPT;
     }
 
-  l4hdr = IPv6_L4HDR(ipv6, proto);
+  pkt.indev  = indev;
+  pkt.outdev = outdev;
+  pkt.iphdr  = ipv6;
+  pkt.l4hdr  = IPv6_L4HDR(ipv6, proto);
+  pkt.proto  = proto;
 
-  sq_for_every(queue, entry)
+#ifdef CONFIG_NET_IPFILTER_CLASSIFIER
+  if (g_ipv6_classes[chain] != NULL)
     {
-      filter = (FAR struct ipv6_filter_entry_s *)entry;
-
-      /* Match device */
-
-      if (!ipfilter_match_device(&filter->common, indev, outdev))
-        {
-          continue;
-        }
-
-      /* Match addresses */
-
-      matched = net_ipv6addr_maskcmp(filter->sip, ipv6->srcipaddr,
-                                     filter->smsk)
-                ^ filter->common.inv_srcip;
-      if (!matched)
-        {
-          continue;
-        }
+      return ipfilter_class_match(g_ipv6_classes[chain], ipv6->srcipaddr,
+                                  ipv6->destipaddr, pkt.proto, pkt.l4hdr,
+                                  ipv6_filter_check, &pkt);
+    }
+#endif
 
-      matched = net_ipv6addr_maskcmp(filter->dip, ipv6->destipaddr,
-                                     filter->dmsk)
-                ^ filter->common.inv_dstip;
-      if (!matched)
-        {
-          continue;
-        }
+  sq_for_every(queue, entry)
+    {
+      FAR const struct ipfilter_entry_s *filter =
+        (FAR const struct ipfilter_entry_s *)entry;
 
-      /* Match protocol */
+      /* Return the target action if matched. */
 
-      if (!ipfilter_match_proto(&filter->common, l4hdr, proto))
+      if (ipv6_filter_check(filter, &pkt))
         {
-          continue;
+          return filter->target;
         }
-
-      /* Return the target action if matched. */
-
-      return filter->common.target;
     }
 
   /* Normally there should be a default rule in chain, won't reach here. */
@@ -392,7 +482,8 @@ FAR struct ipfilter_entry_s *ipfilter_cfg_alloc(sa_family_t family)
  *
  * Description:
  *   Add a new filter configuration entry for the given address family to the
- *   end of specified chain.
+ *   end of specified chain.  The chain is matched linearly until
+ *   ipfilter_cfg_build() is called.
  *
  * Input Parameters:
  *   entry  - The filter entry to add
@@ -411,6 +502,10 @@ void ipfilter_cfg_add(FAR struct ipfilter_entry_s *entry,
   if (family == PF_INET)
     {
       sq_addlast((FAR sq_entry_t *)entry, &g_ipv4_filters[chain]);
+#ifdef CONFIG_NET_IPFILTER_CLASSIFIER
+      ipfilter_class_free(g_ipv4_classes[chain]);
+      g_ipv4_classes[chain] = NULL;
+#endif
     }
 #endif
 
@@ -418,10 +513,58 @@ void ipfilter_cfg_add(FAR struct ipfilter_entry_s *entry,
   if (family == PF_INET6)
     {
       sq_addlast((FAR sq_entry_t *)entry, &g_ipv6_filters[chain]);
+#ifdef CONFIG_NET_IPFILTER_CLASSIFIER
+      ipfilter_class_free(g_ipv6_classes[chain]);
+      g_ipv6_classes[chain] = NULL;
+#endif
     }
 #endif
 }
 
+/****************************************************************************
+ * Name: ipfilter_cfg_build
+ *
+ * Description:
+ *   Compile the specified chain into a classifier after its entries were
+ *   changed.  Until then, and if there is not enough memory, the chain is
+ *   matched linearly.
+ *
+ * Input Parameters:
+ *   family - The address family of the chain
+ *   chain  - The chain to compile
+ *
+ * Returned Value:
+ *   OK on success, -ENOMEM if the classifier cannot be allocated.
+ *
+ ****************************************************************************/
+
+int ipfilter_cfg_build(sa_family_t family, enum ipfilter_chain_e chain)
+{
+  int ret = OK;
+
+#ifdef CONFIG_NET_IPFILTER_CLASSIFIER
+#ifdef CONFIG_NET_IPv4
+  if (family == PF_INET)
+    {
+      ipfilter_class_free(g_ipv4_classes[chain]);
+      ret = ipfilter_class_build(&g_ipv4_filters[chain], PF_INET,
+                                 &g_ipv4_classes[chain]);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if (family == PF_INET6)
+    {
+      ipfilter_class_free(g_ipv6_classes[chain]);
+      ret = ipfilter_class_build(&g_ipv6_filters[chain], PF_INET6,
+                                 &g_ipv6_classes[chain]);
+    }
+#endif
+#endif
+
+  return ret;
+}
+
 /****************************************************************************
  * Name: ipfilter_cfg_clear
  *
@@ -444,6 +587,12 @@ void ipfilter_cfg_clear(sa_family_t family, enum ipfilter_chain_e chain)
   if (family == PF_INET)
     {
       FAR sq_queue_t *queue = &g_ipv4_filters[chain];
+
+#ifdef CONFIG_NET_IPFILTER_CLASSIFIER
+      ipfilter_class_free(g_ipv4_classes[chain]);
+      g_ipv4_classes[chain] = NULL;
+#endif
+
       while (!sq_empty(queue))
         {
           kmm_free(sq_remfirst(queue));
@@ -455,6 +604,12 @@ void ipfilter_cfg_clear(sa_family_t family, enum ipfilter_chain_e chain)
   if (family == PF_INET6)
     {
       FAR sq_queue_t *queue = &g_ipv6_filters[chain];
+
+#ifdef CONFIG_NET_IPFILTER_CLASSIFIER
+      ipfilter_class_free(g_ipv6_classes[chain]);
+      g_ipv6_classes[chain] = NULL;
+#endif
+
       while (!sq_empty(queue))
         {
           kmm_free(sq_remfirst(queue));
@@ -33,6 +33,7 @@
 
 #include <nuttx/compiler.h>
 #include <nuttx/net/ip.h>
+#include <nuttx/queue.h>
 
 #ifdef CONFIG_NET_IPFILTER
 
@@ -123,6 +124,18 @@ struct ipv6_filter_entry_s
   net_ipv6addr_t dmsk;
 };
 
+#ifdef CONFIG_NET_IPFILTER_CLASSIFIER
+
+/* A chain compiled by ipfilter_class_build() */
+
+struct ipfilter_class_s;
+
+/* Does the full match of one rule, used to confirm the classifier result */
+
+typedef CODE bool (*ipfilter_verify_t)(
+  FAR const struct ipfilter_entry_s *entry, FAR const void *arg);
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -149,7 +162,8 @@ FAR struct ipfilter_entry_s *ipfilter_cfg_alloc(sa_family_t family);
  *
  * Description:
  *   Add a new filter configuration entry for the given address family to the
- *   end of specified chain.
+ *   end of specified chain.  The chain is matched linearly until
+ *   ipfilter_cfg_build() is called.
  *
  * Input Parameters:
  *   entry  - The filter entry to add
@@ -164,6 +178,28 @@ FAR struct ipfilter_entry_s *ipfilter_cfg_alloc(sa_family_t family);
 void ipfilter_cfg_add(FAR struct ipfilter_entry_s *entry,
                       sa_family_t family, enum ipfilter_chain_e chain);
 
+/****************************************************************************
+ * Name: ipfilter_cfg_build
+ *
+ * Description:
+ *   Compile the specified chain into a classifier after its entries were
+ *   changed.  Until then, and if there is not enough memory, the chain is
+ *   matched linearly.
+ *
+ * Input Parameters:
+ *   family - The address family of the chain
+ *   chain  - The chain to compile
+ *
+ * Returned Value:
+ *   OK on success, -ENOMEM if the classifier cannot be allocated.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int ipfilter_cfg_build(sa_family_t family, enum ipfilter_chain_e chain);
+
 /****************************************************************************
  * Name: ipfilter_cfg_clear
  *
@@ -264,5 +300,82 @@ int ipv6_filter_fwd(FAR struct net_driver_s *indev,
                     FAR struct ipv6_hdr_s *ipv6);
 #endif
 
+/****************************************************************************
+ * Name: ipfilter_class_build
+ *
+ * Description:
+ *   Compile the filter entries of a chain into a classifier.  The lookup
+ *   cost then depends on the number of rules that can match a packet
+ *   rather than on the length of the chain.
+ *
+ * Input Parameters:
+ *   queue  - The chain of filter entries
+ *   family - The address family of the filter entries
+ *   clsp   - Returns the classifier, or NULL if the chain is too short to
+ *            benefit from it.  The chain is then matched linearly.
+ *
+ * Returned Value:
+ *   OK on success, -ENOMEM if there is not enough memory.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFILTER_CLASSIFIER
+int ipfilter_class_build(FAR sq_queue_t *queue, sa_family_t family,
+                         FAR struct ipfilter_class_s **clsp);
+#endif
+
+/****************************************************************************
+ * Name: ipfilter_class_free
+ *
+ * Description:
+ *   Free a classifier built by ipfilter_class_build().  The filter entries
+ *   are not touched.
+ *
+ * Input Parameters:
+ *   cls - The classifier to free, may be NULL
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFILTER_CLASSIFIER
+void ipfilter_class_free(FAR struct ipfilter_class_s *cls);
+#endif
+
+/****************************************************************************
+ * Name: ipfilter_class_match
+ *
+ * Description:
+ *   Find the first rule of a compiled chain that matches a packet.
+ *
+ * Input Parameters:
+ *   cls    - The classifier of the chain
+ *   srcip  - The source address, in network byte order
+ *   dstip  - The destination address, in network byte order
+ *   proto  - The transport protocol
+ *   l4hdr  - The transport header
+ *   verify - Does the full match of a candidate rule
+ *   arg    - Passed to 'verify'
+ *
+ * Returned Value:
+ *   The target of the first matching rule, IPFILTER_TARGET_ACCEPT if there
+ *   is none.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFILTER_CLASSIFIER
+int ipfilter_class_match(FAR const struct ipfilter_class_s *cls,
+                         FAR const void *srcip, FAR const void *dstip,
+                         uint8_t proto, FAR const void *l4hdr,
+                         ipfilter_verify_t verify, FAR const void *arg);
+#endif
+
 #endif /* CONFIG_NET_IPFILTER */
 #endif /* __NET_IPFILTER_IPFILTER_H */
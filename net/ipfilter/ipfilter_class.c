@@ -0,0 +1,609 @@
+/****************************************************************************
+ * net/ipfilter/ipfilter_class.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* The classifier splits the value space of each packet field (addresses,
+ * protocol and ports) into elementary intervals at the boundaries of all
+ * rules, and keeps the bitmap of the rules that accept each interval.  A
+ * lookup does one binary search per field and intersects the bitmaps.  The
+ * lowest set bit is the first candidate rule in chain order.  Whatever a
+ * field cannot express exactly (devices, ICMP types, non-contiguous masks)
+ * is left to the full rule match, which confirms each candidate.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/udp.h>
+#include <nuttx/queue.h>
+
+#include "ipfilter/ipfilter.h"
+
+#ifdef CONFIG_NET_IPFILTER_CLASSIFIER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define IPFILTER_KEY_MAX     16   /* The longest key, an IPv6 address */
+
+#define IPFILTER_SET_BITS    32
+#define IPFILTER_SET_WORDS(n) \
+  (((n) + IPFILTER_SET_BITS - 1) / IPFILTER_SET_BITS)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The packet fields that are classified */
+
+enum ipfilter_dim_e
+{
+  IPFILTER_DIM_SRCIP = 0,
+  IPFILTER_DIM_DSTIP,
+  IPFILTER_DIM_PROTO,
+  IPFILTER_DIM_SPORT,
+  IPFILTER_DIM_DPORT,
+  IPFILTER_DIM_MAX
+};
+
+/* How a rule matches the values of one field */
+
+enum ipfilter_range_e
+{
+  IPFILTER_RANGE_ANY = 0,   /* Every value, or not decided here */
+  IPFILTER_RANGE_IN,        /* The values in [lo, hi] */
+  IPFILTER_RANGE_OUT        /* The values outside of [lo, hi] */
+};
+
+struct ipfilter_dim_s
+{
+  FAR uint8_t  *bounds;     /* Sorted start keys of the intervals */
+  FAR uint32_t *sets;       /* Rule bitmap of each interval */
+  uint16_t      nbounds;    /* Number of keys, 0 = field not classified */
+  uint8_t       keylen;     /* Key length, keys are in network order */
+};
+
+struct ipfilter_class_s
+{
+  struct ipfilter_dim_s dims[IPFILTER_DIM_MAX];
+  FAR struct ipfilter_entry_s **rules; /* The rules in chain order */
+  sa_family_t family;
+  uint16_t nrules;
+  uint16_t nwords;          /* Words in each rule bitmap */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipfilter_class_addr
+ *
+ * Description:
+ *   Get the address and mask of a rule, both in network byte order.
+ *
+ ****************************************************************************/
+
+static void ipfilter_class_addr(FAR const struct ipfilter_entry_s *entry,
+                                sa_family_t family, bool src,
+                                FAR const uint8_t **addr,
+                                FAR const uint8_t **mask)
+{
+#ifdef CONFIG_NET_IPv4
+  if (family == PF_INET)
+    {
+      FAR const struct ipv4_filter_entry_s *filter =
+        (FAR const struct ipv4_filter_entry_s *)entry;
+
+      *addr = (FAR const uint8_t *)(src ? &filter->sip : &filter->dip);
+      *mask = (FAR const uint8_t *)(src ? &filter->smsk : &filter->dmsk);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if (family == PF_INET6)
+    {
+      FAR const struct ipv6_filter_entry_s *filter =
+        (FAR const struct ipv6_filter_entry_s *)entry;
+
+      *addr = (FAR const uint8_t *)(src ? filter->sip : filter->dip);
+      *mask = (FAR const uint8_t *)(src ? filter->smsk : filter->dmsk);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: ipfilter_class_range
+ *
+ * Description:
+ *   Describe the values of one field that a rule accepts as a range of
+ *   keys.  Returns IPFILTER_RANGE_ANY if the field does not restrict the
+ *   rule, or cannot be expressed as a range.  Such rules are then kept as
+ *   candidates for every value and are decided by the full match.
+ *
+ ****************************************************************************/
+
+static enum ipfilter_range_e
+ipfilter_class_range(FAR const struct ipfilter_class_s *cls,
+                     FAR const struct ipfilter_entry_s *entry, int dim,
+                     FAR uint8_t *lo, FAR uint8_t *hi)
+{
+  FAR const uint8_t *addr;
+  FAR const uint8_t *mask;
+  FAR const uint16_t *ports;
+  bool inv;
+  bool tail;
+  int i;
+
+  switch (dim)
+    {
+      case IPFILTER_DIM_SRCIP:
+      case IPFILTER_DIM_DSTIP:
+        ipfilter_class_addr(entry, cls->family, dim == IPFILTER_DIM_SRCIP,
+                            &addr, &mask);
+
+        /* Only a prefix mask gives a single range of addresses */
+
+        tail = false;
+        for (i = 0; i < cls->dims[dim].keylen; i++)
+          {
+            uint8_t host = ~mask[i];
+
+            if ((tail && mask[i] != 0) || (host & (host + 1)) != 0)
+              {
+                return IPFILTER_RANGE_ANY;
+              }
+
+            tail |= host != 0;
+            lo[i] = addr[i] & mask[i];
+            hi[i] = lo[i] | host;
+          }
+
+        inv = dim == IPFILTER_DIM_SRCIP ? entry->inv_srcip :
+                                          entry->inv_dstip;
+        break;
+
+      case IPFILTER_DIM_PROTO:
+        if (entry->proto == 0)
+          {
+            return IPFILTER_RANGE_ANY;
+          }
+
+        lo[0] = entry->proto;
+        hi[0] = entry->proto;
+        inv   = entry->inv_proto;
+        break;
+
+      case IPFILTER_DIM_SPORT:
+      case IPFILTER_DIM_DPORT:
+
+        /* Ports are not checked for an inverted protocol */
+
+        if (!entry->match_tcpudp || entry->inv_proto)
+          {
+            return IPFILTER_RANGE_ANY;
+          }
+
+        if (dim == IPFILTER_DIM_SPORT)
+          {
+            ports = entry->match.tcpudp.sports;
+            inv   = entry->inv_sport;
+          }
+        else
+          {
+            ports = entry->match.tcpudp.dports;
+            inv   = entry->inv_dport;
+          }
+
+        lo[0] = ports[0] >> 8;
+        lo[1] = ports[0] & 0xff;
+        hi[0] = ports[1] >> 8;
+        hi[1] = ports[1] & 0xff;
+        break;
+
+      default:
+        return IPFILTER_RANGE_ANY;
+    }
+
+  return inv ? IPFILTER_RANGE_OUT : IPFILTER_RANGE_IN;
+}
+
+/****************************************************************************
+ * Name: ipfilter_class_bound
+ *
+ * Description:
+ *   Insert one interval start key into the sorted bound array, unless it is
+ *   already there.
+ *
+ ****************************************************************************/
+
+static void ipfilter_class_bound(FAR struct ipfilter_dim_s *dim,
+                                 FAR const uint8_t *key)
+{
+  int keylen = dim->keylen;
+  int lo = 0;
+  int hi = dim->nbounds;
+  int mid;
+  int cmp;
+
+  while (lo < hi)
+    {
+      mid = (lo + hi) / 2;
+      cmp = memcmp(dim->bounds + mid * keylen, key, keylen);
+      if (cmp == 0)
+        {
+          return;
+        }
+      else if (cmp < 0)
+        {
+          lo = mid + 1;
+        }
+      else
+        {
+          hi = mid;
+        }
+    }
+
+  memmove(dim->bounds + (lo + 1) * keylen, dim->bounds + lo * keylen,
+          (dim->nbounds - lo) * keylen);
+  memcpy(dim->bounds + lo * keylen, key, keylen);
+  dim->nbounds++;
+}
+
+/****************************************************************************
+ * Name: ipfilter_class_dim
+ *
+ * Description:
+ *   Build the intervals and rule bitmaps of one field.
+ *
+ ****************************************************************************/
+
+static int ipfilter_class_dim(FAR struct ipfilter_class_s *cls, int index)
+{
+  FAR struct ipfilter_dim_s *dim = &cls->dims[index];
+  uint8_t lo[IPFILTER_KEY_MAX];
+  uint8_t hi[IPFILTER_KEY_MAX];
+  uint8_t key[IPFILTER_KEY_MAX];
+  enum ipfilter_range_e range;
+  FAR uint32_t *set;
+  int keylen = dim->keylen;
+  bool in;
+  int i;
+  int j;
+
+  /* Each rule adds at most two bounds: its low key and the key following
+   * its high key.  The interval starting at zero is implicit.
+   */
+
+  dim->bounds = kmm_malloc(2 * cls->nrules * keylen);
+  if (dim->bounds == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < cls->nrules; i++)
+    {
+      range = ipfilter_class_range(cls, cls->rules[i], index, lo, hi);
+      if (range == IPFILTER_RANGE_ANY)
+        {
+          continue;
+        }
+
+      for (j = 0; j < keylen; j++)
+        {
+          if (lo[j] != 0)
+            {
+              ipfilter_class_bound(dim, lo);
+              break;
+            }
+        }
+
+      for (j = keylen - 1; j >= 0 && hi[j] == 0xff; j--)
+        {
+          hi[j] = 0;
+        }
+
+      if (j >= 0)
+        {
+          hi[j]++;
+          ipfilter_class_bound(dim, hi);
+        }
+    }
+
+  /* Nothing to classify if no rule restricts this field */
+
+  if (dim->nbounds == 0)
+    {
+      kmm_free(dim->bounds);
+      dim->bounds = NULL;
+      return OK;
+    }
+
+  dim->sets = kmm_zalloc((dim->nbounds + 1) * cls->nwords *
+                         sizeof(uint32_t));
+  if (dim->sets == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  /* No rule bound falls inside an interval, so the start key of each
+   * interval stands for all of its values.
+   */
+
+  for (i = 0; i <= dim->nbounds; i++)
+    {
+      if (i == 0)
+        {
+          memset(key, 0, keylen);
+        }
+      else
+        {
+          memcpy(key, dim->bounds + (i - 1) * keylen, keylen);
+        }
+
+      set = dim->sets + i * cls->nwords;
+      for (j = 0; j < cls->nrules; j++)
+        {
+          range = ipfilter_class_range(cls, cls->rules[j], index, lo, hi);
+          if (range != IPFILTER_RANGE_ANY)
+            {
+              in = memcmp(lo, key, keylen) <= 0 &&
+                   memcmp(key, hi, keylen) <= 0;
+              if (in != (range == IPFILTER_RANGE_IN))
+                {
+                  continue;
+                }
+            }
+
+          set[j / IPFILTER_SET_BITS] |= UINT32_C(1) <<
+                                        (j % IPFILTER_SET_BITS);
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ipfilter_class_set
+ *
+ * Description:
+ *   Find the rule bitmap of the interval that contains 'key'.
+ *
+ ****************************************************************************/
+
+static FAR const uint32_t *
+ipfilter_class_set(FAR const struct ipfilter_class_s *cls,
+                   FAR const struct ipfilter_dim_s *dim,
+                   FAR const uint8_t *key)
+{
+  int lo = 0;
+  int hi = dim->nbounds;
+  int mid;
+
+  /* Count the bounds that are not above the key */
+
+  while (lo < hi)
+    {
+      mid = (lo + hi) / 2;
+      if (memcmp(dim->bounds + mid * dim->keylen, key, dim->keylen) <= 0)
+        {
+          lo = mid + 1;
+        }
+      else
+        {
+          hi = mid;
+        }
+    }
+
+  return dim->sets + lo * cls->nwords;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipfilter_class_build
+ *
+ * Description:
+ *   Compile the filter entries of a chain into a classifier.
+ *
+ ****************************************************************************/
+
+int ipfilter_class_build(FAR sq_queue_t *queue, sa_family_t family,
+                         FAR struct ipfilter_class_s **clsp)
+{
+  FAR struct ipfilter_class_s *cls;
+  FAR sq_entry_t *entry;
+  size_t nrules = 0;
+  int i;
+
+  sq_for_every(queue, entry)
+    {
+      nrules++;
+    }
+
+  *clsp = NULL;
+  if (nrules < CONFIG_NET_IPFILTER_CLASSIFIER_THRESHOLD ||
+      nrules > UINT16_MAX)
+    {
+      return OK;
+    }
+
+  cls = kmm_zalloc(sizeof(*cls) + nrules * sizeof(FAR void *));
+  if (cls == NULL)
+    {
+      nwarn("WARNING: No memory for the filter classifier\n");
+      return -ENOMEM;
+    }
+
+  cls->rules  = (FAR struct ipfilter_entry_s **)(cls + 1);
+  cls->family = family;
+  cls->nrules = nrules;
+  cls->nwords = IPFILTER_SET_WORDS(nrules);
+
+  i = 0;
+  sq_for_every(queue, entry)
+    {
+      cls->rules[i++] = (FAR struct ipfilter_entry_s *)entry;
+    }
+
+  cls->dims[IPFILTER_DIM_SRCIP].keylen = family == PF_INET ?
+                                         sizeof(in_addr_t) :
+                                         sizeof(net_ipv6addr_t);
+  cls->dims[IPFILTER_DIM_DSTIP].keylen = cls->dims[0].keylen;
+  cls->dims[IPFILTER_DIM_PROTO].keylen = sizeof(uint8_t);
+  cls->dims[IPFILTER_DIM_SPORT].keylen = sizeof(uint16_t);
+  cls->dims[IPFILTER_DIM_DPORT].keylen = sizeof(uint16_t);
+
+  for (i = 0; i < IPFILTER_DIM_MAX; i++)
+    {
+      if (ipfilter_class_dim(cls, i) < 0)
+        {
+          nwarn("WARNING: No memory for the filter classifier\n");
+          ipfilter_class_free(cls);
+          return -ENOMEM;
+        }
+    }
+
+  *clsp = cls;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ipfilter_class_free
+ *
+ * Description:
+ *   Free a classifier built by ipfilter_class_build().  The filter entries
+ *   are not touched.
+ *
+ ****************************************************************************/
+
+void ipfilter_class_free(FAR struct ipfilter_class_s *cls)
+{
+  int i;
+
+  if (cls == NULL)
+    {
+      return;
+    }
+
+  for (i = 0; i < IPFILTER_DIM_MAX; i++)
+    {
+      kmm_free(cls->dims[i].bounds);
+      kmm_free(cls->dims[i].sets);
+    }
+
+  kmm_free(cls);
+}
+
+/****************************************************************************
+ * Name: ipfilter_class_match
+ *
+ * Description:
+ *   Find the first rule of a compiled chain that matches a packet.
+ *
+ ****************************************************************************/
+
+int ipfilter_class_match(FAR const struct ipfilter_class_s *cls,
+                         FAR const void *srcip, FAR const void *dstip,
+                         uint8_t proto, FAR const void *l4hdr,
+                         ipfilter_verify_t verify, FAR const void *arg)
+{
+  FAR const uint32_t *sets[IPFILTER_DIM_MAX];
+  FAR const uint8_t *keys[IPFILTER_DIM_MAX];
+  FAR const struct ipfilter_entry_s *entry;
+  uint32_t word;
+  int nsets = 0;
+  int i;
+  int j;
+
+  keys[IPFILTER_DIM_SRCIP] = srcip;
+  keys[IPFILTER_DIM_DSTIP] = dstip;
+  keys[IPFILTER_DIM_PROTO] = &proto;
+
+  /* Ports in TCP & UDP headers have same offset. */
+
+  if (proto == IP_PROTO_TCP || proto == IP_PROTO_UDP)
+    {
+      FAR const struct udp_hdr_s *udp = l4hdr;
+
+      keys[IPFILTER_DIM_SPORT] = (FAR const uint8_t *)&udp->srcport;
+      keys[IPFILTER_DIM_DPORT] = (FAR const uint8_t *)&udp->destport;
+    }
+  else
+    {
+      keys[IPFILTER_DIM_SPORT] = NULL;
+      keys[IPFILTER_DIM_DPORT] = NULL;
+    }
+
+  for (i = 0; i < IPFILTER_DIM_MAX; i++)
+    {
+      if (cls->dims[i].nbounds > 0 && keys[i] != NULL)
+        {
+          sets[nsets++] = ipfilter_class_set(cls, &cls->dims[i], keys[i]);
+        }
+    }
+
+  /* Visit the candidates in chain order */
+
+  for (i = 0; i < cls->nwords; i++)
+    {
+      word = UINT32_MAX;
+      for (j = 0; j < nsets; j++)
+        {
+          word &= sets[j][i];
+        }
+
+      while (word != 0)
+        {
+          j = i * IPFILTER_SET_BITS + ffs((int)word) - 1;
+          if (j >= cls->nrules)
+            {
+              break;
+            }
+
+          entry = cls->rules[j];
+          if (verify(entry, arg))
+            {
+              return entry->target;
+            }
+
+          word &= word - 1;
+        }
+    }
+
+  ninfo("No filter matched, maybe uninitialized.\n");
+  return IPFILTER_TARGET_ACCEPT;
+}
+
+#endif /* CONFIG_NET_IPFILTER_CLASSIFIER */
@@ -30,6 +30,7 @@
 
 #include <sys/ioctl.h>
 #include <stdint.h>
+#include <inttypes.h>
 #include <stdlib.h>
 #include <debug.h>
 #include <string.h>
@@ -94,7 +95,19 @@ do  \
 
 /* The maximum I/O buffer occupied by fragment reassembly cache */
 
-#define REASSEMBLY_MAXOCCUPYIOB        CONFIG_IOB_NBUFFERS / 5
+#if CONFIG_NET_IPFRAG_REASS_MAXIOBS > 0
+#  define REASSEMBLY_MAXOCCUPYIOB      CONFIG_NET_IPFRAG_REASS_MAXIOBS
+#else
+#  define REASSEMBLY_MAXOCCUPYIOB      (CONFIG_IOB_NBUFFERS / 5)
+#endif
+
+/* Size of the hash table indexing the datagrams under reassembly */
+
+#define REASSEMBLY_HASHSIZE            CONFIG_NET_IPFRAG_REASS_HASHSIZE
+
+#if (REASSEMBLY_HASHSIZE & (REASSEMBLY_HASHSIZE - 1)) != 0
+#  error CONFIG_NET_IPFRAG_REASS_HASHSIZE must be a power of two
+#endif
 
 /* Deciding whether to fragment outgoing packets which target is to ourself */
 
@@ -117,26 +130,30 @@ static struct work_s g_wkfragtimeout;
 
 /* Remember the number of I/O buffers currently in reassembly cache */
 
-static uint8_t       g_bufoccupy;
+static uint32_t      g_bufoccupy;
 
-/* Queue header definition, it links all fragments of all NICs by ascending
- * ipid.
- */
+/* Hash table of the fragments of all NICs, indexed by the reassembly key */
 
-static sq_queue_t    g_assemblyhead_ipid;
+static sq_queue_t    g_assemblyhash[REASSEMBLY_HASHSIZE];
 
 /* Queue header definition, which connects all fragments of all NICs in order
  * of addition time.
  */
 
-static sq_queue_t    g_assemblyhead_time;
+static dq_queue_t    g_assemblyhead_time;
+
+/* Queue header definition, which connects all fragments of all NICs from
+ * the least to the most recently updated.
+ */
+
+static dq_queue_t    g_assemblyhead_lru;
 
 /****************************************************************************
  * Public Data
  ****************************************************************************/
 
-/* Only one thread can access g_assemblyhead_ipid and g_assemblyhead_time
- * at a time.
+/* Only one thread can access g_assemblyhash, g_assemblyhead_time and
+ * g_assemblyhead_lru at a time.
  */
 
 mutex_t              g_ipfrag_lock = NXMUTEX_INITIALIZER;
@@ -149,7 +166,12 @@ static void ip_fragin_timerout_expiry(wdparm_t arg);
 static void ip_fragin_timerwork(FAR void *arg);
 static inline FAR struct ip_fraglink_s *
 ip_fragin_freelink(FAR struct ip_fraglink_s *fraglink);
-static void ip_fragin_check(FAR struct ip_fragsnode_s *fragsnode);
+static void ip_fragin_freenode(FAR struct ip_fragsnode_s *node);
+static void ip_fragin_getkey(FAR struct ip_fraglink_s *fraglink,
+                             FAR struct ip_fragkey_s *key);
+static unsigned int ip_fragin_hash(FAR const struct ip_fragkey_s *key);
+static int ip_fragin_insert(FAR struct ip_fragsnode_s *node,
+                            FAR struct ip_fraglink_s *curfraglink);
 static void ip_fragin_cachemonitor(FAR struct ip_fragsnode_s *curnode);
 static inline FAR struct iob_s *
 ip_fragout_allocfragbuf(FAR struct iob_queue_s *fragq);
@@ -193,8 +215,8 @@ static void ip_fragin_timerwork(FAR void *arg)
 {
   clock_t curtick = clock_systime_ticks();
   sclock_t interval = 0;
-  FAR sq_entry_t *entry;
-  FAR sq_entry_t *entrynext;
+  FAR dq_entry_t *entry;
+  FAR dq_entry_t *entrynext;
   FAR struct ip_fragsnode_s *node;
 
   ninfo("Start reassembly work queue\n");
@@ -205,13 +227,12 @@ static void ip_fragin_timerwork(FAR void *arg)
    * interval
    */
 
-  entry = sq_peek(&g_assemblyhead_time);
+  entry = dq_peek(&g_assemblyhead_time);
   while (entry != NULL)
     {
-      entrynext = sq_next(entry);
+      entrynext = dq_next(entry);
 
-      node = (FAR struct ip_fragsnode_s *)
-             container_of(entry, FAR struct ip_fragsnode_s, flinkat);
+      node = container_of(entry, struct ip_fragsnode_s, flinkat);
 
       /* Check for timeout, be careful with the calculation formula,
        * the tick counter may overflow
@@ -270,22 +291,9 @@ static void ip_fragin_timerwork(FAR void *arg)
             }
 #endif
 
-          /* Remove fragments of this node */
-
-          if (node->frags != NULL)
-            {
-              FAR struct ip_fraglink_s *fraglink = node->frags;
+          /* Remove fragments of this node and free node memory */
 
-              while (fraglink)
-                {
-                  fraglink = ip_fragin_freelink(fraglink);
-                }
-            }
-
-          /* Remove node from single-list and free node memory */
-
-          ip_frag_remnode(node);
-          kmm_free(node);
+          ip_fragin_freenode(node);
         }
       else
         {
@@ -305,7 +313,7 @@ static void ip_fragin_timerwork(FAR void *arg)
 
   /* Be sure to start the timer, if there are nodes in the linked list */
 
-  if (sq_peek(&g_assemblyhead_time) != NULL)
+  if (!dq_empty(&g_assemblyhead_time))
     {
       clock_t delay = REASSEMBLY_TIMEOUT_MINIMALTICKS;
 
@@ -363,48 +371,275 @@ ip_fragin_freelink(FAR struct ip_fraglink_s *fraglink)
 }
 
 /****************************************************************************
- * Name: ip_fragin_check
+ * Name: ip_fragin_freenode
+ *
+ * Description:
+ *   Free all fragments of a node, remove the node from the reassembly
+ *   cache and free it.
+ *
+ * Input Parameters:
+ *   node - node of the upper-level linked list, it maintains
+ *          information about all fragments belonging to an IP datagram
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void ip_fragin_freenode(FAR struct ip_fragsnode_s *node)
+{
+  FAR struct ip_fraglink_s *fraglink = node->frags;
+
+  while (fraglink != NULL)
+    {
+      fraglink = ip_fragin_freelink(fraglink);
+    }
+
+  ip_frag_remnode(node);
+  kmm_free(node);
+}
+
+/****************************************************************************
+ * Name: ip_fragin_getkey
  *
  * Description:
- *   Check whether the zero fragment has been received or all fragments have
- *   been received.
+ *   Build the reassembly key of a fragment from its IP header.
  *
  * Input Parameters:
- *   fragsnode - node of the upper-level linked list, it maintains
- *               information bout all fragments belonging to an IP datagram
+ *   fraglink - node of the lower-level linked list, it maintains
+ *              information of one fragment
+ *   key      - Location to return the key
  *
  * Returned Value:
  *   None
  *
  ****************************************************************************/
 
-static void ip_fragin_check(FAR struct ip_fragsnode_s *fragsnode)
+static void ip_fragin_getkey(FAR struct ip_fraglink_s *fraglink,
+                             FAR struct ip_fragkey_s *key)
 {
-  uint16_t formerlen = 0;
-  FAR struct ip_fraglink_s *entry;
+  FAR uint8_t *hdr = fraglink->frag->io_data + fraglink->frag->io_offset;
+
+  memset(key, 0, sizeof(*key));
+  key->ipid   = fraglink->ipid;
+  key->isipv4 = fraglink->isipv4;
+
+#ifdef CONFIG_NET_IPv4
+  if (fraglink->isipv4)
+    {
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)hdr;
+
+      memcpy(key->srcaddr, ipv4->srcipaddr, sizeof(ipv4->srcipaddr));
+      memcpy(key->destaddr, ipv4->destipaddr, sizeof(ipv4->destipaddr));
+      key->proto = ipv4->proto;
+    }
+#endif
 
-  if (fragsnode->verifyflag & IP_FRAGVERIFY_RECVDTAILFRAG)
+#ifdef CONFIG_NET_IPv6
+  if (!fraglink->isipv4)
     {
-      entry = fragsnode->frags;
-      while (entry != NULL)
+      FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)hdr;
+
+      /* The fragment header follows any unfragmentable extension headers,
+       * so RFC 8200 keys on addresses and identification only.
+       */
+
+      memcpy(key->srcaddr, ipv6->srcipaddr, sizeof(net_ipv6addr_t));
+      memcpy(key->destaddr, ipv6->destipaddr, sizeof(net_ipv6addr_t));
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: ip_fragin_hash
+ *
+ * Description:
+ *   Return the hash table index of a reassembly key.
+ *
+ * Input Parameters:
+ *   key - The reassembly key
+ *
+ * Returned Value:
+ *   Index into g_assemblyhash
+ *
+ ****************************************************************************/
+
+static unsigned int ip_fragin_hash(FAR const struct ip_fragkey_s *key)
+{
+  uint32_t hash = key->ipid ^ key->proto;
+  int i;
+
+  for (i = 0; i < IPFRAG_ADDRSIZE; i++)
+    {
+      hash = hash * 31 + (key->srcaddr[i] ^ key->destaddr[i]);
+    }
+
+  hash ^= hash >> 16;
+  return hash & (REASSEMBLY_HASHSIZE - 1);
+}
+
+/****************************************************************************
+ * Name: ip_fragin_insert
+ *
+ * Description:
+ *   Insert one fragment into the offset ordered fragment list of a node and
+ *   update the received byte count.  A fragment with the same offset and
+ *   length as a queued one replaces it, any other overlap is rejected.
+ *
+ * Input Parameters:
+ *   node        - node of the upper-level linked list, it maintains
+ *                 information about all fragments belonging to an IP
+ *                 datagram
+ *   curfraglink - node of the lower-level linked list, it maintains
+ *                 information of one fragment
+ *
+ * Returned Value:
+ *   OK on success; -EINVAL if the fragment overlaps with the queued ones or
+ *   disagrees with the known datagram length.
+ *
+ ****************************************************************************/
+
+static int ip_fragin_insert(FAR struct ip_fragsnode_s *node,
+                            FAR struct ip_fraglink_s *curfraglink)
+{
+  FAR struct ip_fraglink_s *fraglink;
+  FAR struct ip_fraglink_s *lastlink = NULL;
+  uint32_t fragend = curfraglink->fragoff + curfraglink->fraglen;
+
+  /* Nothing may lie beyond the tail fragment, and there is only one */
+
+  if ((node->verifyflag & IP_FRAGVERIFY_RECVDTAILFRAG) != 0)
+    {
+      if (fragend > node->datalen ||
+          (!curfraglink->morefrags && fragend != node->datalen))
         {
-          if (entry->morefrags)
-            {
-              formerlen += entry->fraglen;
-            }
-          else
-            {
-              /* Only the last entry has a 0 morefrags flag */
+          return -EINVAL;
+        }
+    }
+  else if (!curfraglink->morefrags && node->lastfrag != NULL &&
+           node->lastfrag->fragoff + node->lastfrag->fraglen > fragend)
+    {
+      return -EINVAL;
+    }
 
-              if (entry->fragoff == formerlen)
-                {
-                  fragsnode->verifyflag |= IP_FRAGVERIFY_RECVDALLFRAGS;
-                }
-            }
+  /* Fragments mostly arrive in order, append after the last one directly.
+   * Otherwise walk the list, which is ordered by fragment offset value.
+   */
 
-          entry = entry->flink;
+  if (node->lastfrag != NULL &&
+      curfraglink->fragoff > node->lastfrag->fragoff)
+    {
+      lastlink = node->lastfrag;
+      fraglink = NULL;
+    }
+  else
+    {
+      fraglink = node->frags;
+      while (fraglink != NULL && fraglink->fragoff < curfraglink->fragoff)
+        {
+          lastlink = fraglink;
+          fraglink = fraglink->flink;
+        }
+    }
+
+  if (fraglink != NULL && fraglink->fragoff == curfraglink->fragoff)
+    {
+      if (fraglink->fraglen != curfraglink->fraglen ||
+          fraglink->morefrags != curfraglink->morefrags)
+        {
+          return -EINVAL;
+        }
+
+      /* Fragments with same offset value contain the same data, use the
+       * more recently arrived copy. Refer to RFC791, Section3.2, Page29.
+       * Replace and removed the old packet from the fragment list
+       */
+
+      curfraglink->flink = fraglink->flink;
+      if (lastlink == NULL)
+        {
+          node->frags = curfraglink;
+        }
+      else
+        {
+          lastlink->flink = curfraglink;
+        }
+
+      if (node->lastfrag == fraglink)
+        {
+          node->lastfrag = curfraglink;
         }
+
+      node->bufcnt -= IOBUF_CNT(fraglink->frag);
+      g_bufoccupy  -= IOBUF_CNT(fraglink->frag);
+
+      fraglink->flink = NULL;
+      ip_fragin_freelink(fraglink);
     }
+  else
+    {
+      /* Reject fragments overlapping with their neighbours, so that the
+       * received byte count stays exact.
+       */
+
+      if ((lastlink != NULL &&
+           lastlink->fragoff + lastlink->fraglen > curfraglink->fragoff) ||
+          (fraglink != NULL && fragend > fraglink->fragoff))
+        {
+          return -EINVAL;
+        }
+
+      /* Insert this fragment between lastlink and fraglink */
+
+      curfraglink->flink = fraglink;
+      if (lastlink == NULL)
+        {
+          node->frags = curfraglink;
+        }
+      else
+        {
+          lastlink->flink = curfraglink;
+        }
+
+      if (fraglink == NULL)
+        {
+          node->lastfrag = curfraglink;
+        }
+
+      node->rcvdlen += curfraglink->fraglen;
+    }
+
+  /* Remember I/O buffer count */
+
+  node->bufcnt += IOBUF_CNT(curfraglink->frag);
+  g_bufoccupy  += IOBUF_CNT(curfraglink->frag);
+
+  if (curfraglink->fragoff == 0)
+    {
+      /* Have received the zero fragment */
+
+      node->verifyflag |= IP_FRAGVERIFY_RECVDZEROFRAG;
+    }
+
+  if (!curfraglink->morefrags)
+    {
+      /* Have received the tail fragment */
+
+      node->verifyflag |= IP_FRAGVERIFY_RECVDTAILFRAG;
+      node->datalen     = fragend;
+    }
+
+  /* Fragments never overlap, so all of them are present once the byte
+   * count reaches the datagram length.
+   */
+
+  if ((node->verifyflag & IP_FRAGVERIFY_RECVDTAILFRAG) != 0 &&
+      node->rcvdlen == node->datalen)
+    {
+      node->verifyflag |= IP_FRAGVERIFY_RECVDALLFRAGS;
+    }
+
+  return OK;
 }
 
 /****************************************************************************
@@ -425,52 +660,31 @@ static void ip_fragin_check(FAR struct ip_fragsnode_s *fragsnode)
 
 static void ip_fragin_cachemonitor(FAR struct ip_fragsnode_s *curnode)
 {
-  uint32_t        cleancnt = 0;
-  uint32_t        bufcnt;
-  FAR sq_entry_t *entry;
-  FAR sq_entry_t *entrynext;
+  FAR dq_entry_t *entry;
+  FAR dq_entry_t *entrynext;
   FAR struct ip_fragsnode_s *node;
 
-  /* Start cache cleaning if g_bufoccupy exceeds the cache threshold */
+  /* Drop the least recently updated datagrams until g_bufoccupy is back
+   * under the cache threshold
+   */
 
-  if (g_bufoccupy > REASSEMBLY_MAXOCCUPYIOB)
+  entry = dq_peek(&g_assemblyhead_lru);
+  while (entry != NULL && g_bufoccupy > REASSEMBLY_MAXOCCUPYIOB)
     {
-      cleancnt = g_bufoccupy - REASSEMBLY_MAXOCCUPYIOB;
-      entry = sq_peek(&g_assemblyhead_time);
-
-      while (entry != NULL && cleancnt > 0)
-        {
-          entrynext = sq_next(entry);
+      entrynext = dq_next(entry);
 
-          node = (FAR struct ip_fragsnode_s *)
-                 container_of(entry, FAR struct ip_fragsnode_s, flinkat);
+      node = container_of(entry, struct ip_fragsnode_s, flinklru);
 
-          /* Skip specified node */
-
-          if (node != curnode)
-            {
-              /* Remove fragments of this node */
-
-              if (node->frags != NULL)
-                {
-                  FAR struct ip_fraglink_s *fraglink = node->frags;
+      /* Skip specified node */
 
-                  while (fraglink != NULL)
-                    {
-                      fraglink = ip_fragin_freelink(fraglink);
-                    }
-                }
-
-              /* Remove node from single-list and free node memory */
-
-              bufcnt = ip_frag_remnode(node);
-              kmm_free(node);
-
-              cleancnt = cleancnt > bufcnt ? cleancnt - bufcnt : 0;
-            }
-
-          entry = entrynext;
+      if (node != curnode)
+        {
+          ninfo("Reassembly cache full, drop ipid %" PRIu32 "\n",
+                node->key.ipid);
+          ip_fragin_freenode(node);
         }
+
+      entry = entrynext;
     }
 }
 
@@ -527,11 +741,13 @@ ip_fragout_allocfragbuf(FAR struct iob_queue_s *fragq)
 
 uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node)
 {
+  ASSERT(g_bufoccupy >= node->bufcnt);
   g_bufoccupy -= node->bufcnt;
-  ASSERT(g_bufoccupy < CONFIG_IOB_NBUFFERS);
 
-  sq_rem((FAR sq_entry_t *)node, &g_assemblyhead_ipid);
-  sq_rem((FAR sq_entry_t *)&node->flinkat, &g_assemblyhead_time);
+  sq_rem((FAR sq_entry_t *)node,
+         &g_assemblyhash[ip_fragin_hash(&node->key)]);
+  dq_rem(&node->flinkat, &g_assemblyhead_time);
+  dq_rem(&node->flinklru, &g_assemblyhead_lru);
 
   return node->bufcnt;
 }
@@ -559,189 +775,96 @@ bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
                        FAR struct ip_fraglink_s *curfraglink)
 {
   FAR struct ip_fragsnode_s *node;
+  FAR sq_queue_t            *bucket;
   FAR sq_entry_t            *entry;
-  FAR sq_entry_t            *entrylast = NULL;
+  struct ip_fragkey_s        key;
   bool                       empty;
 
-  /* The linked list is ordered by IP ID value, walk through it and try to
-   * find a node that has the same IP ID value, otherwise need to create a
-   * new node and insert it into the linked list.
-   */
+  empty = dq_empty(&g_assemblyhead_time);
+  curfraglink->fragsnode = NULL;
 
-  entry = sq_peek(&g_assemblyhead_ipid);
-  empty = (entry == NULL) ? true : false;
+  /* Look up the datagram this fragment belongs to in the hash table */
 
-  while (entry != NULL)
-    {
-      node = (struct ip_fragsnode_s *)entry;
+  ip_fragin_getkey(curfraglink, &key);
+  bucket = &g_assemblyhash[ip_fragin_hash(&key)];
 
-      if (dev == node->dev && curfraglink->ipid <= node->ipid)
+  for (entry = sq_peek(bucket); entry != NULL; entry = sq_next(entry))
+    {
+      node = (FAR struct ip_fragsnode_s *)entry;
+      if (node->dev == dev && memcmp(&node->key, &key, sizeof(key)) == 0)
         {
           break;
         }
-
-      entrylast = entry;
-      entry = sq_next(entry);
     }
 
-  node = (FAR struct ip_fragsnode_s *)entry;
-
-  if (node != NULL && curfraglink->ipid == node->ipid)
-    {
-      FAR struct ip_fraglink_s *fraglink;
-      FAR struct ip_fraglink_s *lastlink = NULL;
+  /* Buffer is take away, clear original pointers in NIC */
 
-      /* Found a previously created ip_fragsnode_s, insert this new
-       * ip_fraglink_s to the subchain of this node.
-       */
+  netdev_iob_clear(dev);
 
-      fraglink = node->frags;
+  if (entry != NULL)
+    {
+      node = (FAR struct ip_fragsnode_s *)entry;
 
-      /* An ip_fragsnode_s must have an ip_fraglink_s because we allocate a
-       * new ip_fraglink_s when caching a new ip_fraglink_s with a new IP ID
+      /* Found a previously created ip_fragsnode_s, it becomes the most
+       * recently updated one.
        */
 
-      while (fraglink != NULL)
-        {
-          /* The fragment list is ordered by fragment offset value */
-
-          if (curfraglink->fragoff <= fraglink->fragoff)
-            {
-              break;
-            }
-
-          lastlink = fraglink;
-          fraglink = fraglink->flink;
-        }
-
-      if (fraglink == NULL)
-        {
-          /* This fragment offset is greater than the previous fragments,
-           * added to the last position
-           */
-
-          lastlink->flink      = curfraglink;
-
-          /* Remember I/O buffer count */
-
-          node->bufcnt += IOBUF_CNT(curfraglink->frag);
-          g_bufoccupy  += IOBUF_CNT(curfraglink->frag);
-        }
-      else if (curfraglink->fragoff == fraglink->fragoff)
-        {
-          /* Fragments with same offset value contain the same data, use the
-           * more recently arrived copy. Refer to RFC791, Section3.2, Page29.
-           * Replace and removed the old packet from the fragment list
-           */
-
-          curfraglink->flink = fraglink->flink;
-          if (lastlink == NULL)
-            {
-              node->frags = curfraglink;
-            }
-          else
-            {
-              lastlink->flink = curfraglink;
-            }
-
-          iob_free_chain(fraglink->frag);
-          kmm_free(fraglink);
-        }
-      else
-        {
-          /* Insert into the fragment list */
-
-          if (lastlink == NULL)
-            {
-              /* Insert before the first node */
-
-              curfraglink->flink = node->frags;
-              node->frags = curfraglink;
-            }
-          else
-            {
-              /* Insert this node after lastlink */
-
-              curfraglink->flink = lastlink->flink;
-              lastlink->flink = curfraglink;
-            }
-
-          /* Remember I/O buffer count */
-
-          node->bufcnt += IOBUF_CNT(curfraglink->frag);
-          g_bufoccupy  += IOBUF_CNT(curfraglink->frag);
-        }
+      dq_rem(&node->flinklru, &g_assemblyhead_lru);
+      dq_addlast(&node->flinklru, &g_assemblyhead_lru);
     }
   else
     {
-      /* It's a new IP ID fragment, malloc a new node and insert it into the
-       * linked list
+      /* It's a new datagram, malloc a new node and insert it into the hash
+       * table
        */
 
-      node = kmm_malloc(sizeof(struct ip_fragsnode_s));
+      node = kmm_zalloc(sizeof(struct ip_fragsnode_s));
       if (node == NULL)
         {
           nerr("ERROR: Failed to allocate buffer.\n");
-          return -ENOMEM;
+          iob_free_chain(curfraglink->frag);
+          curfraglink->frag = NULL;
+          return empty;
         }
 
-      node->flink      = NULL;
-      node->flinkat    = NULL;
-      node->dev        = dev;
-      node->ipid       = curfraglink->ipid;
-      node->frags      = curfraglink;
-      node->tick       = clock_systime_ticks();
-      node->bufcnt     = IOBUF_CNT(curfraglink->frag);
-      g_bufoccupy     += IOBUF_CNT(curfraglink->frag);
-      node->verifyflag = 0;
-      node->outgoframe = NULL;
-
-      /* Insert this new node into linked list identified by
-       * g_assemblyhead_ipid with correct position
-       */
+      memcpy(&node->key, &key, sizeof(key));
+      node->dev  = dev;
+      node->tick = clock_systime_ticks();
 
-      if (sq_peek(&g_assemblyhead_ipid) == NULL || entrylast == NULL)
-        {
-          sq_addfirst((FAR sq_entry_t *)node, &g_assemblyhead_ipid);
-        }
-      else
-        {
-          sq_addafter(entrylast, (FAR sq_entry_t *)node,
-                      &g_assemblyhead_ipid);
-        }
+      sq_addfirst((FAR sq_entry_t *)node, bucket);
 
       /* Add this new node to the tail of linked list identified by
-       * g_assemblyhead_time
+       * g_assemblyhead_time and g_assemblyhead_lru
        */
 
-      sq_addlast((FAR sq_entry_t *)&node->flinkat, &g_assemblyhead_time);
+      dq_addlast(&node->flinkat, &g_assemblyhead_time);
+      dq_addlast(&node->flinklru, &g_assemblyhead_lru);
     }
 
-  if (curfraglink->fragoff == 0)
+  if (ip_fragin_insert(node, curfraglink) < 0)
     {
-      /* Have received the zero fragment */
+      nwarn("WARNING: Drop overlapping fragment, ipid %" PRIu32 "\n",
+            key.ipid);
 
-      node->verifyflag |= IP_FRAGVERIFY_RECVDZEROFRAG;
-    }
-  else if (!curfraglink->morefrags)
-    {
-      /* Have received the tail fragment */
+      iob_free_chain(curfraglink->frag);
+      curfraglink->frag = NULL;
 
-      node->verifyflag |= IP_FRAGVERIFY_RECVDTAILFRAG;
+      /* An IPv6 datagram with overlapping fragments is discarded as a
+       * whole (RFC 8200, Section 4.5).
+       */
+
+      if (!key.isipv4 || node->frags == NULL)
+        {
+          ip_fragin_freenode(node);
+        }
+
+      return empty;
     }
 
   /* For indexing convenience */
 
   curfraglink->fragsnode = node;
 
-  /* Check receiving status */
-
-  ip_fragin_check(node);
-
-  /* Buffer is take away, clear original pointers in NIC */
-
-  netdev_iob_clear(dev);
-
   /* Perform cache cleaning when reassembly cache size exceeds the configured
    * threshold
    */
@@ -1110,36 +1233,26 @@ int32_t ip_frag_uninit(void)
 
 void ip_frag_stop(FAR struct net_driver_s *dev)
 {
-  FAR sq_entry_t *entry = NULL;
-  FAR sq_entry_t *entrynext;
+  FAR dq_entry_t *entry = NULL;
+  FAR dq_entry_t *entrynext;
 
   ninfo("Stop frag processing for NIC:%p\n", dev);
 
   nxmutex_lock(&g_ipfrag_lock);
 
-  entry = sq_peek(&g_assemblyhead_ipid);
+  entry = dq_peek(&g_assemblyhead_time);
 
   /* Drop those unassembled incoming fragments belonging to this NIC */
 
   while (entry != NULL)
     {
-      FAR struct ip_fragsnode_s *node = (FAR struct ip_fragsnode_s *)entry;
-      entrynext = sq_next(entry);
+      FAR struct ip_fragsnode_s *node =
+        container_of(entry, struct ip_fragsnode_s, flinkat);
+      entrynext = dq_next(entry);
 
       if (dev == node->dev)
         {
-          if (node->frags != NULL)
-            {
-              FAR struct ip_fraglink_s *fraglink = node->frags;
-
-              while (fraglink != NULL)
-                {
-                  fraglink = ip_fragin_freelink(fraglink);
-                }
-            }
-
-          ip_frag_remnode(node);
-          kmm_free(entry);
+          ip_fragin_freenode(node);
         }
 
       entry = entrynext;
@@ -1166,44 +1279,20 @@ void ip_frag_stop(FAR struct net_driver_s *dev)
 
 void ip_frag_remallfrags(void)
 {
-  FAR sq_entry_t *entry = NULL;
-  FAR sq_entry_t *entrynext;
+  FAR dq_entry_t *entry;
   FAR struct net_driver_s *dev;
 
   nxmutex_lock(&g_ipfrag_lock);
 
-  entry = sq_peek(&g_assemblyhead_ipid);
-
   /* Drop all unassembled incoming fragments */
 
-  while (entry != NULL)
+  while ((entry = dq_peek(&g_assemblyhead_time)) != NULL)
     {
-      FAR struct ip_fragsnode_s *node = (FAR struct ip_fragsnode_s *)entry;
-      entrynext = sq_next(entry);
-
-      if (node->frags != NULL)
-        {
-          FAR struct ip_fraglink_s *fraglink = node->frags;
-
-          while (fraglink != NULL)
-            {
-              fraglink = ip_fragin_freelink(fraglink);
-            }
-        }
-
-      /* Because nodes managed by the two queues are the same,
-       * and g_assemblyhead_ipid will be cleared after this loop ends,
-       * so only reset g_assemblyhead_time is needed after this loop ends
-       */
-
-      sq_rem(entry, &g_assemblyhead_ipid);
-      kmm_free(entry);
-
-      entry = entrynext;
+      ip_fragin_freenode(container_of(entry, struct ip_fragsnode_s,
+                                      flinkat));
     }
 
-  sq_init(&g_assemblyhead_time);
-  g_bufoccupy = 0;
+  DEBUGASSERT(g_bufoccupy == 0);
 
   nxmutex_unlock(&g_ipfrag_lock);
 
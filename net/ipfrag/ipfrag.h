@@ -92,9 +92,30 @@ struct ip_fraglink_s
   uint32_t                   ipid;
 };
 
+/* Reassembly key.  Fragments belong to the same datagram when source,
+ * destination, protocol (IPv4 only) and identification all match.  The
+ * structure is cleared before it is filled so that it can be compared with
+ * memcmp().
+ */
+
+#ifdef CONFIG_NET_IPv6
+#  define IPFRAG_ADDRSIZE 8  /* Address size in 16-bit words */
+#else
+#  define IPFRAG_ADDRSIZE 2
+#endif
+
+struct ip_fragkey_s
+{
+  uint16_t                   srcaddr[IPFRAG_ADDRSIZE];
+  uint16_t                   destaddr[IPFRAG_ADDRSIZE];
+  uint32_t                   ipid;
+  uint8_t                    proto;     /* IPv4 protocol, zero for IPv6 */
+  uint8_t                    isipv4;    /* IPv4 or IPv6 */
+};
+
 struct ip_fragsnode_s
 {
-  /* This link is used to maintain a single-linked list of ip_fragsnode_s.
+  /* This link is used to maintain the hash chain of ip_fragsnode_s.
    * Must be the first field in the structure due to flink type casting.
    */
 
@@ -104,17 +125,23 @@ struct ip_fragsnode_s
    * time
    */
 
-  FAR sq_entry_t            *flinkat;
+  dq_entry_t                 flinkat;
+
+  /* Links all ip_fragsnode_s from the least to the most recently updated,
+   * used to pick the victim when the reassembly cache is full
+   */
+
+  dq_entry_t                 flinklru;
 
   /* Interface understood by the network */
 
   FAR struct net_driver_s   *dev;
 
-  /* IP Identification (IP ID) field defined in ipv4 header or in ipv6
-   * fragment header.
+  /* Addresses, protocol and IP Identification (IP ID) field defined in
+   * ipv4 header or in ipv6 fragment header.
    */
 
-  uint32_t                   ipid;
+  struct ip_fragkey_s        key;
 
   /* Count ticks, used by ressembly timer */
 
@@ -128,9 +155,21 @@ struct ip_fragsnode_s
 
   uint32_t                   bufcnt;
 
-  /* Linked all fragments with the same IP ID. */
+  /* Number of payload bytes received so far and the total payload length,
+   * which is only known once the tail fragment arrives.  Fragments never
+   * overlap, so all fragments are present when the two are equal.
+   */
+
+  uint32_t                   rcvdlen;
+  uint32_t                   datalen;
+
+  /* Linked all fragments with the same IP ID, ordered by fragment offset.
+   * Fragments usually arrive in order, so the last one is remembered to
+   * append without walking the list.
+   */
 
   FAR struct ip_fraglink_s  *frags;
+  FAR struct ip_fraglink_s  *lastfrag;
 
   /* Points to the reassembled outgoing IP frame */
 
@@ -149,8 +188,8 @@ extern "C"
 #  define EXTERN extern
 #endif
 
-/* Only one thread can access g_assemblyhead_ipid and g_assemblyhead_time
- * at a time
+/* Only one thread can access the reassembly hash table and queues at a
+ * time
  */
 
 extern mutex_t g_ipfrag_lock;
@@ -182,8 +221,10 @@ uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node);
  * Description:
  *   Enqueue one fragment.
  *   All fragments belonging to one IP frame are organized in a linked list
- *   form, that is a ip_fragsnode_s node. All ip_fragsnode_s nodes are also
- *   organized in an upper-level linked list.
+ *   form, that is a ip_fragsnode_s node. All ip_fragsnode_s nodes are
+ *   indexed by a hash table keyed by addresses, protocol and IP ID.
+ *   Fragments overlapping with the ones already queued are dropped, for
+ *   IPv6 together with the whole datagram (RFC 8200).
  *
  * Input Parameters:
  *   dev         - NIC Device instance
@@ -191,7 +232,10 @@ uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node);
  *                 information of one fragment
  *
  * Returned Value:
- *   Whether queue is empty before enqueue the new node
+ *   Whether queue is empty before enqueue the new node.  On return,
+ *   curfraglink->fragsnode is NULL if the fragment was dropped, in which
+ *   case its I/O buffer has been released and the caller still has to free
+ *   curfraglink.
  *
  ****************************************************************************/
 
@@ -494,6 +494,15 @@ int32_t ipv6_fragin(FAR struct net_driver_s *dev)
   restartwdog = ip_fragin_enqueue(dev, fraginfo);
 
   node = fraginfo->fragsnode;
+  if (node == NULL)
+    {
+      /* The fragment was dropped */
+
+      nxmutex_unlock(&g_ipfrag_lock);
+      kmm_free(fraginfo);
+      return OK;
+    }
+
   if (node->verifyflag & IP_FRAGVERIFY_RECVDALLFRAGS)
     {
       /* Well, all fragments of an IP frame have been received, remove
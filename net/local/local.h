@@ -36,6 +36,7 @@
 #include <stdint.h>
 #include <poll.h>
 
+#include <nuttx/circbuf.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/queue.h>
 #include <nuttx/net/net.h>
@@ -59,6 +60,16 @@ typedef uint16_t lc_size_t;  /* 16-bit index */
 typedef uint8_t lc_size_t;   /*  8-bit index */
 #endif
 
+/* Connected SOCK_STREAM peers of the direct transport exchange data
+ * through their receive rings and never open the FIFOs.
+ */
+
+#ifdef CONFIG_NET_LOCAL_STREAM_DIRECT
+#  define LOCAL_ISDIRECT(c) ((c)->lc_proto == SOCK_STREAM)
+#else
+#  define LOCAL_ISDIRECT(c) (false)
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -149,6 +160,17 @@ struct local_conn_s
 
   sem_t lc_waitsem;            /* Use to wait for a connection to be accepted */
 
+#ifdef CONFIG_NET_LOCAL_STREAM_DIRECT
+  /* Receive ring of a connected peer.  The other peer writes into it
+   * directly.
+   */
+
+  struct circbuf_s lc_rcvbuf;  /* Receive ring buffer */
+  sem_t lc_rcvsem;             /* Wait for data in lc_rcvbuf */
+  sem_t lc_sndsem;             /* Wait for space in the peer lc_rcvbuf */
+  uint8_t lc_shutdown;         /* SHUT_RD and/or SHUT_WR */
+#endif
+
   /* The following is a list if poll structures of threads waiting for
    * socket events.
    */
@@ -503,6 +525,7 @@ int local_send_packet(FAR struct file *filep, FAR const struct iovec *buf,
  *   psock    A pointer to a NuttX-specific, internal socket structure
  *   msg      Buffer to receive the message
  *   flags    Receive flags (ignored for now)
+ *   timeout  Receive timeout in milliseconds, UINT_MAX for none
  *
  * Returned Value:
  *   On success, returns the number of characters received. If no data is
@@ -513,7 +536,7 @@ int local_send_packet(FAR struct file *filep, FAR const struct iovec *buf,
  ****************************************************************************/
 
 ssize_t local_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
-                      int flags);
+                      int flags, unsigned int timeout);
 
 /****************************************************************************
  * Name: local_fifo_read
@@ -748,6 +771,141 @@ int local_set_pollthreshold(FAR struct local_conn_s *conn,
 
 int local_set_nonblocking(FAR struct local_conn_s *conn);
 
+/****************************************************************************
+ * Name: local_direct_connect
+ *
+ * Description:
+ *   Allocate the receive rings of two SOCK_STREAM peers and attach them
+ *   to each other.
+ *
+ * Input Parameters:
+ *   conn - One side of the connection
+ *   peer - The other side of the connection
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_STREAM_DIRECT
+int local_direct_connect(FAR struct local_conn_s *conn,
+                         FAR struct local_conn_s *peer);
+
+/****************************************************************************
+ * Name: local_direct_disconnect
+ *
+ * Description:
+ *   Detach a connection from its peer and wake up the peer so that it sees
+ *   the end of the connection.  Data already queued in the receive ring of
+ *   the peer remains readable.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+void local_direct_disconnect(FAR struct local_conn_s *conn);
+
+/****************************************************************************
+ * Name: local_direct_send
+ *
+ * Description:
+ *   Copy data into the receive ring of the peer, waiting for space unless
+ *   the socket is non-blocking.
+ *
+ * Input Parameters:
+ *   conn   - The sending connection
+ *   buf    - The data to send
+ *   iovcnt - The number of entries in buf
+ *   flags  - Send flags
+ *
+ * Returned Value:
+ *   The number of bytes sent or a negated errno value.
+ *
+ ****************************************************************************/
+
+ssize_t local_direct_send(FAR struct local_conn_s *conn,
+                          FAR const struct iovec *buf, size_t iovcnt,
+                          int flags);
+
+/****************************************************************************
+ * Name: local_direct_recv
+ *
+ * Description:
+ *   Read data from the receive ring of a connection, waiting for data
+ *   unless the socket is non-blocking.
+ *
+ * Input Parameters:
+ *   conn    - The receiving connection
+ *   buf     - Buffer to receive data
+ *   len     - Length of buffer
+ *   flags   - Receive flags
+ *   timeout - Receive timeout in milliseconds, UINT_MAX for none
+ *
+ * Returned Value:
+ *   The number of bytes received, zero at end-of-file or a negated errno
+ *   value.
+ *
+ ****************************************************************************/
+
+ssize_t local_direct_recv(FAR struct local_conn_s *conn, FAR void *buf,
+                          size_t len, int flags, unsigned int timeout);
+
+/****************************************************************************
+ * Name: local_direct_shutdown
+ *
+ * Description:
+ *   Shut down the receiving and/or the sending side of a connection.
+ *
+ ****************************************************************************/
+
+void local_direct_shutdown(FAR struct local_conn_s *conn, int how);
+
+/****************************************************************************
+ * Name: local_direct_pollstate
+ *
+ * Description:
+ *   Return the poll events that are currently true for a connection.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+pollevent_t local_direct_pollstate(FAR struct local_conn_s *conn);
+
+/****************************************************************************
+ * Name: local_direct_ioctl
+ *
+ * Description:
+ *   Handle FIONREAD, FIONWRITE and FIONSPACE for a connection.
+ *
+ ****************************************************************************/
+
+int local_direct_ioctl(FAR struct local_conn_s *conn, int cmd,
+                       unsigned long arg);
+
+/****************************************************************************
+ * Name: local_direct_setsize
+ *
+ * Description:
+ *   Change the size of the receive ring of a connection.  The ring is
+ *   allocated with lc_rcvsize when the connection is established, so only
+ *   rings of connected peers are resized here.  Fails with -EBUSY if the
+ *   ring holds more data than the new size.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+int local_direct_setsize(FAR struct local_conn_s *conn, size_t size);
+#endif /* CONFIG_NET_LOCAL_STREAM_DIRECT */
+
 #undef EXTERN
 #ifdef __cplusplus
 }
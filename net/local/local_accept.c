@@ -156,7 +156,11 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
               ret = local_getaddr(conn->lc_peer, addr, addrlen);
             }
 
-          if (ret == OK && nonblock)
+          /* The direct transport follows the socket flags, only the
+           * FIFOs need to be switched to non-blocking mode.
+           */
+
+          if (ret == OK && nonblock && !LOCAL_ISDIRECT(conn))
             {
               ret = local_set_nonblocking(conn);
             }
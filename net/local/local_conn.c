@@ -162,6 +162,14 @@ FAR struct local_conn_s *local_alloc(void)
       nxsem_init(&conn->lc_waitsem, 0, 0);
 #endif
 
+#ifdef CONFIG_NET_LOCAL_STREAM_DIRECT
+      /* The receive ring is allocated when the connection is established */
+
+      circbuf_init(&conn->lc_rcvbuf, NULL, 0);
+      nxsem_init(&conn->lc_rcvsem, 0, 0);
+      nxsem_init(&conn->lc_sndsem, 0, 0);
+#endif
+
       /* This semaphore is used for sending safely in multithread.
        * Make sure data will not be garbled when multi-thread sends.
        */
@@ -223,6 +231,17 @@ int local_alloc_accept(FAR struct local_conn_s *server,
   strlcpy(conn->lc_path, server->lc_path, sizeof(conn->lc_path));
   conn->lc_instance_id = client->lc_instance_id;
 
+#ifdef CONFIG_NET_LOCAL_STREAM_DIRECT
+  /* Attach the receive rings, the peers exchange data directly */
+
+  conn->lc_rcvsize = server->lc_rcvsize;
+  ret = local_direct_connect(conn, client);
+  if (ret < 0)
+    {
+      nerr("ERROR: Failed to connect %s: %d\n", client->lc_path, ret);
+      goto err;
+    }
+#else
   /* Create the FIFOs needed for the connection */
 
   ret = local_create_fifos(conn, server->lc_rcvsize, client->lc_rcvsize);
@@ -265,11 +284,15 @@ int local_alloc_accept(FAR struct local_conn_s *server,
   /* Do we have a connection?  Are the FIFOs opened? */
 
   DEBUGASSERT(conn->lc_infile.f_inode != NULL);
+#endif /* CONFIG_NET_LOCAL_STREAM_DIRECT */
+
   *accept = conn;
   return OK;
 
+#ifndef CONFIG_NET_LOCAL_STREAM_DIRECT
 errout_with_fifos:
   local_release_fifos(conn);
+#endif
 
 err:
   local_free(conn);
@@ -300,6 +323,12 @@ void local_free(FAR struct local_conn_s *conn)
 
   dq_rem(&conn->lc_conn.node, &g_local_connections);
 
+#ifdef CONFIG_NET_LOCAL_STREAM_DIRECT
+  /* Detach from the peer and let it see the end of the connection */
+
+  local_direct_disconnect(conn);
+#endif
+
   if (conn->lc_peer)
     {
       conn->lc_peer->lc_peer = NULL;
@@ -338,11 +367,21 @@ void local_free(FAR struct local_conn_s *conn)
 
   /* Destroy all FIFOs associted with the connection */
 
-  local_release_fifos(conn);
+  if (!LOCAL_ISDIRECT(conn))
+    {
+      local_release_fifos(conn);
+    }
+
 #ifdef CONFIG_NET_LOCAL_STREAM
   nxsem_destroy(&conn->lc_waitsem);
 #endif
 
+#ifdef CONFIG_NET_LOCAL_STREAM_DIRECT
+  nxsem_destroy(&conn->lc_rcvsem);
+  nxsem_destroy(&conn->lc_sndsem);
+  circbuf_uninit(&conn->lc_rcvbuf);
+#endif
+
   /* Destory sem associated with the connection */
 
   nxmutex_destroy(&conn->lc_sendlock);
@@ -0,0 +1,502 @@
+/****************************************************************************
+ * net/local/local_direct.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+#include <poll.h>
+
+#include <nuttx/circbuf.h>
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/mutex.h>
+#include <nuttx/net/net.h>
+#include <nuttx/semaphore.h>
+
+#include "socket/socket.h"
+#include "local/local.h"
+
+#ifdef CONFIG_NET_LOCAL_STREAM_DIRECT
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_direct_notify
+ *
+ * Description:
+ *   Wake up all threads waiting on 'sem'.  One count is left pending for a
+ *   thread that has already released the network lock but has not started
+ *   waiting yet.  Waiters always re-check their condition, so a stale count
+ *   only costs one extra loop.
+ *
+ ****************************************************************************/
+
+static void local_direct_notify(FAR sem_t *sem)
+{
+  int sval;
+
+  while (nxsem_get_value(sem, &sval) >= 0 && sval < 1)
+    {
+      nxsem_post(sem);
+    }
+}
+
+/****************************************************************************
+ * Name: local_direct_eof
+ *
+ * Description:
+ *   Return true if no more data will be added to the receive ring of
+ *   'conn':  The receiving side was shut down, or the peer has gone or shut
+ *   down its sending side.
+ *
+ ****************************************************************************/
+
+static bool local_direct_eof(FAR struct local_conn_s *conn)
+{
+  FAR struct local_conn_s *peer = conn->lc_peer;
+
+  return (conn->lc_shutdown & SHUT_RD) != 0 || peer == NULL ||
+         (peer->lc_shutdown & SHUT_WR) != 0;
+}
+
+/****************************************************************************
+ * Name: local_direct_wakeup
+ *
+ * Description:
+ *   Wake up every sender, receiver and poller of 'conn' after a change of
+ *   the connection state.
+ *
+ ****************************************************************************/
+
+static void local_direct_wakeup(FAR struct local_conn_s *conn)
+{
+  local_direct_notify(&conn->lc_rcvsem);
+  local_direct_notify(&conn->lc_sndsem);
+  local_event_pollnotify(conn, local_direct_pollstate(conn));
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_direct_connect
+ *
+ * Description:
+ *   Allocate the receive rings of two SOCK_STREAM peers and attach them
+ *   to each other.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+int local_direct_connect(FAR struct local_conn_s *conn,
+                         FAR struct local_conn_s *peer)
+{
+  int ret;
+
+  ret = circbuf_resize(&conn->lc_rcvbuf, conn->lc_rcvsize);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = circbuf_resize(&peer->lc_rcvbuf, peer->lc_rcvsize);
+  if (ret < 0)
+    {
+      circbuf_resize(&conn->lc_rcvbuf, 0);
+      return ret;
+    }
+
+  conn->lc_shutdown = 0;
+  peer->lc_shutdown = 0;
+  conn->lc_peer     = peer;
+  peer->lc_peer     = conn;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: local_direct_disconnect
+ *
+ * Description:
+ *   Detach a connection from its peer and wake up the peer so that it sees
+ *   the end of the connection.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+void local_direct_disconnect(FAR struct local_conn_s *conn)
+{
+  FAR struct local_conn_s *peer = conn->lc_peer;
+
+  if (peer != NULL)
+    {
+      peer->lc_peer = NULL;
+      conn->lc_peer = NULL;
+      local_direct_wakeup(peer);
+    }
+}
+
+/****************************************************************************
+ * Name: local_direct_send
+ *
+ * Description:
+ *   Copy data into the receive ring of the peer.  The whole buffer is sent
+ *   before returning unless the socket is non-blocking, the send times out
+ *   or the connection is broken; the number of bytes already sent is
+ *   returned in that case.
+ *
+ ****************************************************************************/
+
+ssize_t local_direct_send(FAR struct local_conn_s *conn,
+                          FAR const struct iovec *buf, size_t iovcnt,
+                          int flags)
+{
+  FAR struct local_conn_s *peer;
+  size_t offset = 0;
+  ssize_t nsent = 0;
+  bool nonblock;
+  int ret;
+
+  nonblock = _SS_ISNONBLOCK(conn->lc_conn.s_flags) ||
+             (flags & MSG_DONTWAIT) != 0;
+
+  /* Serialize the senders so that data of concurrent send() calls is not
+   * interleaved.
+   */
+
+  ret = nxmutex_lock(&conn->lc_sendlock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  net_lock();
+
+  while (iovcnt > 0)
+    {
+      ssize_t nwritten;
+
+      if (offset >= buf->iov_len)
+        {
+          buf++;
+          iovcnt--;
+          offset = 0;
+          continue;
+        }
+
+      peer = conn->lc_peer;
+      if ((conn->lc_shutdown & SHUT_WR) != 0 || peer == NULL ||
+          (peer->lc_shutdown & SHUT_RD) != 0)
+        {
+          ret = -EPIPE;
+          break;
+        }
+
+      nwritten = circbuf_write(&peer->lc_rcvbuf,
+                               (FAR const uint8_t *)buf->iov_base + offset,
+                               buf->iov_len - offset);
+      if (nwritten > 0)
+        {
+          offset += nwritten;
+          nsent  += nwritten;
+
+          local_direct_notify(&peer->lc_rcvsem);
+          local_event_pollnotify(peer, POLLIN);
+          continue;
+        }
+
+      /* The receive ring of the peer is full */
+
+      if (nonblock)
+        {
+          ret = -EAGAIN;
+          break;
+        }
+
+      ret = net_sem_timedwait(&conn->lc_sndsem,
+                              _SO_TIMEOUT(conn->lc_conn.s_sndtimeo));
+      if (ret < 0)
+        {
+          if (ret == -ETIMEDOUT)
+            {
+              ret = -EAGAIN;
+            }
+
+          break;
+        }
+    }
+
+  net_unlock();
+  nxmutex_unlock(&conn->lc_sendlock);
+
+  return nsent > 0 ? nsent : ret;
+}
+
+/****************************************************************************
+ * Name: local_direct_recv
+ *
+ * Description:
+ *   Read data from the receive ring of a connection.
+ *
+ ****************************************************************************/
+
+ssize_t local_direct_recv(FAR struct local_conn_s *conn, FAR void *buf,
+                          size_t len, int flags, unsigned int timeout)
+{
+  FAR struct local_conn_s *peer;
+  ssize_t ret;
+
+  net_lock();
+
+  while (circbuf_is_empty(&conn->lc_rcvbuf))
+    {
+      if (local_direct_eof(conn))
+        {
+          ret = 0;
+          goto out;
+        }
+
+      if (_SS_ISNONBLOCK(conn->lc_conn.s_flags) ||
+          (flags & MSG_DONTWAIT) != 0)
+        {
+          ret = -EAGAIN;
+          goto out;
+        }
+
+      ret = net_sem_timedwait(&conn->lc_rcvsem, timeout);
+      if (ret < 0)
+        {
+          if (ret == -ETIMEDOUT)
+            {
+              ret = -EAGAIN;
+            }
+
+          goto out;
+        }
+    }
+
+  if ((flags & MSG_PEEK) != 0)
+    {
+      ret = circbuf_peek(&conn->lc_rcvbuf, buf, len);
+      goto out;
+    }
+
+  ret = circbuf_read(&conn->lc_rcvbuf, buf, len);
+
+  /* Let the peer know that there is space in the ring again */
+
+  peer = conn->lc_peer;
+  if (ret > 0 && peer != NULL)
+    {
+      local_direct_notify(&peer->lc_sndsem);
+      local_event_pollnotify(peer, POLLOUT);
+    }
+
+out:
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: local_direct_shutdown
+ *
+ * Description:
+ *   Shut down the receiving and/or the sending side of a connection.
+ *   Pending received data is discarded when the receiving side is shut
+ *   down.  The peer will then see EPIPE on send() or end-of-file on recv().
+ *
+ ****************************************************************************/
+
+void local_direct_shutdown(FAR struct local_conn_s *conn, int how)
+{
+  net_lock();
+
+  conn->lc_shutdown |= how & SHUT_RDWR;
+  if ((how & SHUT_RD) != 0)
+    {
+      circbuf_reset(&conn->lc_rcvbuf);
+    }
+
+  local_direct_wakeup(conn);
+  if (conn->lc_peer != NULL)
+    {
+      local_direct_wakeup(conn->lc_peer);
+    }
+
+  net_unlock();
+}
+
+/****************************************************************************
+ * Name: local_direct_pollstate
+ *
+ * Description:
+ *   Return the poll events that are currently true for a connection.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+pollevent_t local_direct_pollstate(FAR struct local_conn_s *conn)
+{
+  FAR struct local_conn_s *peer = conn->lc_peer;
+  pollevent_t eventset = 0;
+
+  if (!circbuf_is_empty(&conn->lc_rcvbuf) || local_direct_eof(conn))
+    {
+      eventset |= POLLIN;
+    }
+
+  if (peer == NULL)
+    {
+      eventset |= POLLHUP;
+    }
+  else if ((peer->lc_shutdown & SHUT_RD) != 0)
+    {
+      eventset |= POLLERR;
+    }
+  else if ((conn->lc_shutdown & SHUT_WR) == 0 &&
+           !circbuf_is_full(&peer->lc_rcvbuf))
+    {
+      eventset |= POLLOUT;
+    }
+
+  return eventset;
+}
+
+/****************************************************************************
+ * Name: local_direct_ioctl
+ *
+ * Description:
+ *   Handle FIONREAD, FIONWRITE and FIONSPACE for a connection.
+ *
+ ****************************************************************************/
+
+int local_direct_ioctl(FAR struct local_conn_s *conn, int cmd,
+                       unsigned long arg)
+{
+  FAR struct local_conn_s *peer;
+  FAR int *value = (FAR int *)((uintptr_t)arg);
+  int ret = OK;
+
+  net_lock();
+
+  peer = conn->lc_peer;
+  if (conn->lc_state != LOCAL_STATE_CONNECTED)
+    {
+      ret = -ENOTCONN;
+    }
+  else if (cmd == FIONREAD)
+    {
+      /* Number of bytes available for reading */
+
+      *value = circbuf_used(&conn->lc_rcvbuf);
+    }
+  else if (peer == NULL)
+    {
+      ret = -ENOTCONN;
+    }
+  else if (cmd == FIONWRITE)
+    {
+      /* Number of bytes not yet read by the peer */
+
+      *value = circbuf_used(&peer->lc_rcvbuf);
+    }
+  else if (cmd == FIONSPACE)
+    {
+      /* Free space in the receive ring of the peer */
+
+      *value = circbuf_space(&peer->lc_rcvbuf);
+    }
+  else
+    {
+      ret = -ENOTTY;
+    }
+
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: local_direct_setsize
+ *
+ * Description:
+ *   Change the size of the receive ring of a connection.  The ring cannot
+ *   shrink below the data it holds.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+int local_direct_setsize(FAR struct local_conn_s *conn, size_t size)
+{
+  int ret;
+
+  if (size == 0)
+    {
+      return -EINVAL;
+    }
+
+  /* The ring of an unconnected socket is allocated with lc_rcvsize by
+   * local_direct_connect().
+   */
+
+  if (!circbuf_is_init(&conn->lc_rcvbuf))
+    {
+      return OK;
+    }
+
+  /* circbuf_resize() would drop the bytes that do not fit */
+
+  if (size < circbuf_used(&conn->lc_rcvbuf))
+    {
+      return -EBUSY;
+    }
+
+  ret = circbuf_resize(&conn->lc_rcvbuf, size);
+  if (ret >= 0 && conn->lc_peer != NULL)
+    {
+      local_direct_notify(&conn->lc_peer->lc_sndsem);
+      local_event_pollnotify(conn->lc_peer, POLLOUT);
+    }
+
+  return ret;
+}
+
+#endif /* CONFIG_NET_LOCAL_STREAM_DIRECT */
@@ -112,6 +112,7 @@ static int local_event_pollsetup(FAR struct local_conn_s *conn,
  * Name: local_inout_poll_cb
  ****************************************************************************/
 
+#ifndef CONFIG_NET_LOCAL_STREAM_DIRECT
 static void local_inout_poll_cb(FAR struct pollfd *fds)
 {
   FAR struct pollfd *originfds = fds->arg;
@@ -119,6 +120,7 @@ static void local_inout_poll_cb(FAR struct pollfd *fds)
   poll_notify(&originfds, 1, fds->revents);
 }
 #endif
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -170,6 +172,29 @@ int local_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
       return local_event_pollsetup(conn, fds, true);
     }
 
+#ifdef CONFIG_NET_LOCAL_STREAM_DIRECT
+  /* Connected peers are notified directly by the other peer */
+
+  if (conn->lc_state == LOCAL_STATE_CONNECTED)
+    {
+      pollevent_t eventset;
+
+      ret = local_event_pollsetup(conn, fds, true);
+      if (ret >= 0)
+        {
+          net_lock();
+          eventset = local_direct_pollstate(conn);
+          net_unlock();
+
+          poll_notify(&fds, 1, eventset);
+        }
+
+      return ret;
+    }
+
+  fds->priv = NULL;
+  goto pollerr;
+#else
   if (conn->lc_state == LOCAL_STATE_DISCONNECTED)
     {
       fds->priv = NULL;
@@ -276,7 +301,8 @@ int local_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
       default:
         break;
     }
-#endif
+#endif /* CONFIG_NET_LOCAL_STREAM_DIRECT */
+#endif /* CONFIG_NET_LOCAL_STREAM */
 
   return ret;
 
@@ -314,6 +340,11 @@ int local_pollteardown(FAR struct socket *psock, FAR struct pollfd *fds)
     }
 
 #ifdef CONFIG_NET_LOCAL_STREAM
+#ifdef CONFIG_NET_LOCAL_STREAM_DIRECT
+  /* Listening and connected sockets only use the event slots */
+
+  return local_event_pollsetup(conn, fds, false);
+#else
   if (conn->lc_state == LOCAL_STATE_LISTENING)
     {
       return local_event_pollsetup(conn, fds, false);
@@ -376,7 +407,8 @@ int local_pollteardown(FAR struct socket *psock, FAR struct pollfd *fds)
       default:
         break;
     }
-#endif
+#endif /* CONFIG_NET_LOCAL_STREAM_DIRECT */
+#endif /* CONFIG_NET_LOCAL_STREAM */
 
   return ret;
 }
@@ -57,6 +57,8 @@
  *
  ****************************************************************************/
 
+#if defined(CONFIG_NET_LOCAL_DGRAM) || \
+    !defined(CONFIG_NET_LOCAL_STREAM_DIRECT)
 static int psock_fifo_read(FAR struct socket *psock, FAR void *buf,
                            size_t offset, FAR size_t *readlen,
                            int flags, bool once)
@@ -123,6 +125,7 @@ static int psock_fifo_read(FAR struct socket *psock, FAR void *buf,
 
   return OK;
 }
+#endif
 
 /****************************************************************************
  * Name: local_recvctl
@@ -215,6 +218,7 @@ out:
  *   flags    Receive flags
  *   from     Address of source (may be NULL)
  *   fromlen  The length of the address structure
+ *   timeout  Receive timeout in milliseconds, UINT_MAX for none
  *
  * Returned Value:
  *   On success, returns the number of characters received.  If no data is
@@ -228,7 +232,7 @@ out:
 static inline ssize_t
 psock_stream_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
                       int flags, FAR struct sockaddr *from,
-                      FAR socklen_t *fromlen)
+                      FAR socklen_t *fromlen, unsigned int timeout)
 {
   FAR struct local_conn_s *conn = psock->s_conn;
   size_t readlen = len;
@@ -242,6 +246,17 @@ psock_stream_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
       return -ENOTCONN;
     }
 
+#ifdef CONFIG_NET_LOCAL_STREAM_DIRECT
+  /* Read straight from the receive ring */
+
+  ret = local_direct_recv(conn, buf, len, flags, timeout);
+  if (ret <= 0)
+    {
+      return ret;
+    }
+
+  readlen = ret;
+#else
   /* Check shutdown state */
 
   if (conn->lc_infile.f_inode == NULL)
@@ -275,6 +290,7 @@ psock_stream_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
     {
       return ret;
     }
+#endif
 
   /* Return the address family */
 
@@ -527,6 +543,7 @@ errout_with_halfduplex:
  *   psock    A pointer to a NuttX-specific, internal socket structure
  *   msg      Buffer to receive the message
  *   flags    Receive flags (ignored for now)
+ *   timeout  Receive timeout in milliseconds, UINT_MAX for none
  *
  * Returned Value:
  *   On success, returns the number of characters received. If no data is
@@ -537,7 +554,7 @@ errout_with_halfduplex:
  ****************************************************************************/
 
 ssize_t local_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
-                      int flags)
+                      int flags, unsigned int timeout)
 {
   FAR struct local_conn_s *conn = psock->s_conn;
   FAR socklen_t *fromlen = &msg->msg_namelen;
@@ -547,7 +564,7 @@ ssize_t local_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
 
   /* Check shutdown state */
 
-  if (conn->lc_infile.f_inode == NULL)
+  if (!LOCAL_ISDIRECT(conn) && conn->lc_infile.f_inode == NULL)
     {
       return 0;
     }
@@ -559,7 +576,8 @@ ssize_t local_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
 #ifdef CONFIG_NET_LOCAL_STREAM
   if (psock->s_type == SOCK_STREAM)
     {
-      len = psock_stream_recvfrom(psock, buf, len, flags, from, fromlen);
+      len = psock_stream_recvfrom(psock, buf, len, flags, from, fromlen,
+                                  timeout);
     }
   else
 #endif
@@ -197,6 +197,16 @@ static ssize_t local_send(FAR struct socket *psock,
               return -ENOTCONN;
             }
 
+#ifdef CONFIG_NET_LOCAL_STREAM_DIRECT
+          if (psock->s_type == SOCK_STREAM)
+            {
+              /* Copy the data straight into the receive ring of the peer */
+
+              ret = local_direct_send(conn, buf, len, flags);
+              break;
+            }
+#endif
+
           /* Check shutdown state */
 
           if (conn->lc_outfile.f_inode == NULL)
@@ -439,7 +449,7 @@ ssize_t local_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
 
   /* Check shutdown state */
 
-  if (conn->lc_outfile.f_inode == NULL)
+  if (!LOCAL_ISDIRECT(conn) && conn->lc_outfile.f_inode == NULL)
     {
       return -EPIPE;
     }
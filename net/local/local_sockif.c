@@ -675,6 +675,13 @@ static int local_setsockopt(FAR struct socket *psock, int level, int option,
                 {
                   rcvsize = MIN(*(FAR const int *)value,
                                 CONFIG_DEV_PIPE_MAXSIZE);
+#ifdef CONFIG_NET_LOCAL_STREAM_DIRECT
+                  if (psock->s_type == SOCK_STREAM)
+                    {
+                      ret = local_direct_setsize(conn->lc_peer, rcvsize);
+                    }
+                  else
+#endif
                   if (conn->lc_peer->lc_infile.f_inode != NULL)
                     {
                       ret = file_ioctl(&conn->lc_peer->lc_infile,
@@ -719,6 +726,13 @@ static int local_setsockopt(FAR struct socket *psock, int level, int option,
 #endif
 
               rcvsize = MIN(rcvsize, CONFIG_DEV_PIPE_MAXSIZE);
+#ifdef CONFIG_NET_LOCAL_STREAM_DIRECT
+              if (psock->s_type == SOCK_STREAM)
+                {
+                  ret = local_direct_setsize(conn, rcvsize);
+                }
+              else
+#endif
               if (conn->lc_infile.f_inode != NULL)
                 {
                   ret = file_ioctl(&conn->lc_infile, PIPEIOC_SETSIZE,
@@ -948,6 +962,14 @@ static int local_ioctl(FAR struct socket *psock, int cmd, unsigned long arg)
   FAR struct local_conn_s *conn = psock->s_conn;
   int ret = OK;
 
+#ifdef CONFIG_NET_LOCAL_STREAM_DIRECT
+  if (psock->s_type == SOCK_STREAM &&
+      (cmd == FIONREAD || cmd == FIONWRITE || cmd == FIONSPACE))
+    {
+      return local_direct_ioctl(conn, cmd, arg);
+    }
+#endif
+
   switch (cmd)
     {
       case FIONBIO:
@@ -1053,6 +1075,25 @@ static int local_socketpair(FAR struct socket *psocks[2])
                            = -1;
 #endif
 
+#ifdef CONFIG_NET_LOCAL_STREAM_DIRECT
+  if (psocks[0]->s_type == SOCK_STREAM)
+    {
+      /* Attach the receive rings, no FIFOs are needed */
+
+      net_lock();
+      ret = local_direct_connect(conns[0], conns[1]);
+      net_unlock();
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      conns[0]->lc_state = conns[1]->lc_state
+                         = LOCAL_STATE_CONNECTED;
+      return OK;
+    }
+#endif
+
   /* Create the FIFOs needed for the connection */
 
   ret = local_create_fifos(conns[0], conns[0]->lc_rcvsize,
@@ -1151,6 +1192,10 @@ static int local_shutdown(FAR struct socket *psock, int how)
       case SOCK_STREAM:
         {
           FAR struct local_conn_s *conn = psock->s_conn;
+
+#ifdef CONFIG_NET_LOCAL_STREAM_DIRECT
+          local_direct_shutdown(conn, how);
+#else
           if (how & SHUT_RD)
             {
               if (conn->lc_infile.f_inode != NULL)
@@ -1168,6 +1213,7 @@ static int local_shutdown(FAR struct socket *psock, int how)
                   conn->lc_outfile.f_inode = NULL;
                 }
             }
+#endif
         }
 
         return OK;
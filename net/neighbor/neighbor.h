@@ -38,6 +38,27 @@
 
 #ifdef CONFIG_NET_IPv6
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if (CONFIG_NET_IPv6_NCONF_HASHSIZE & \
+     (CONFIG_NET_IPv6_NCONF_HASHSIZE - 1)) != 0
+#  error CONFIG_NET_IPv6_NCONF_HASHSIZE must be a power of two
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Index of a Neighbor Table entry plus one, zero ends a hash chain */
+
+#if CONFIG_NET_IPv6_NCONF_ENTRIES < 255
+typedef uint8_t neighbor_index_t;
+#else
+typedef uint16_t neighbor_index_t;
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -48,12 +69,35 @@
 
 extern struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
 
+/* The Neighbor Table entries hashed by IPv6 address.  The chains are kept
+ * apart from the entries because those are copied out by netlink.
+ */
+
+extern neighbor_index_t g_neighbor_hash[CONFIG_NET_IPv6_NCONF_HASHSIZE];
+extern neighbor_index_t g_neighbor_next[CONFIG_NET_IPv6_NCONF_ENTRIES];
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
 
 struct net_driver_s; /* Forward reference */
 
+/****************************************************************************
+ * Name: neighbor_hash
+ *
+ * Description:
+ *   Return the hash chain of an IPv6 address.
+ *
+ * Input Parameters:
+ *   ipaddr - The IPv6 address;
+ *
+ * Returned Value:
+ *   The head of the chain in g_neighbor_hash[].
+ *
+ ****************************************************************************/
+
+FAR neighbor_index_t *neighbor_hash(const net_ipv6addr_t ipaddr);
+
 /****************************************************************************
  * Name: neighbor_findentry
  *
@@ -65,6 +65,8 @@
 void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
                   FAR uint8_t *addr)
 {
+  FAR neighbor_index_t *link;
+  neighbor_index_t ndx;
   uint8_t lltype;
   clock_t oldest_time;
   int     oldest_ndx;
@@ -74,39 +76,70 @@ void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
 
   DEBUGASSERT(dev != NULL && addr != NULL);
 
-  /* Find the matching entry, first unused entry, or the oldest used entry.
-   * The unused entry will have ne_time == 0 and should generate the oldest
-   * time.  REVISIT:  Could this fail on clock wraparound?  A more explicit
-   * check might be to compare ne_ipaddr with the IPv6 unspecified address.
-   */
+  /* Look for the matching entry in its hash chain */
 
-  oldest_time = g_neighbors[0].ne_time;
-  oldest_ndx  = 0;
-  lltype      = dev->d_lltype;
+  lltype = dev->d_lltype;
 
-  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+  for (ndx = *neighbor_hash(ipaddr); ndx != 0;
+       ndx = g_neighbor_next[ndx - 1])
     {
-      if (g_neighbors[i].ne_addr.na_lltype == lltype &&
-          net_ipv6addr_cmp(g_neighbors[i].ne_ipaddr, ipaddr))
+      if (g_neighbors[ndx - 1].ne_addr.na_lltype == lltype &&
+          net_ipv6addr_cmp(g_neighbors[ndx - 1].ne_ipaddr, ipaddr))
         {
-          oldest_ndx = i;
           found = true;
           break;
         }
+    }
 
-      if ((int)(g_neighbors[i].ne_time - oldest_time) < 0)
+  if (found)
+    {
+      oldest_ndx = ndx - 1;
+    }
+  else
+    {
+      /* Find the first unused entry, or the oldest used entry.  The unused
+       * entry will have ne_time == 0 and should generate the oldest time.
+       * REVISIT:  Could this fail on clock wraparound?  A more explicit
+       * check might be to compare ne_ipaddr with the IPv6 unspecified
+       * address.
+       */
+
+      oldest_time = g_neighbors[0].ne_time;
+      oldest_ndx  = 0;
+
+      for (i = 1; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
         {
-          oldest_ndx = i;
-          oldest_time = g_neighbors[i].ne_time;
+          if ((int)(g_neighbors[i].ne_time - oldest_time) < 0)
+            {
+              oldest_ndx = i;
+              oldest_time = g_neighbors[i].ne_time;
+            }
         }
-    }
 
-  /* When overwite old entry, need to notify RTM_DELNEIGH */
+      /* When overwite old entry, need to notify RTM_DELNEIGH */
 
-  if (!found && g_neighbors[oldest_ndx].ne_time != 0)
-    {
-      netlink_neigh_notify(&g_neighbors[oldest_ndx], RTM_DELNEIGH,
-                           AF_INET6);
+      if (g_neighbors[oldest_ndx].ne_time != 0)
+        {
+          netlink_neigh_notify(&g_neighbors[oldest_ndx], RTM_DELNEIGH,
+                               AF_INET6);
+        }
+
+      /* Move the entry to the hash chain of the new address */
+
+      if (g_neighbors[oldest_ndx].ne_dev != NULL)
+        {
+          link = neighbor_hash(g_neighbors[oldest_ndx].ne_ipaddr);
+          while (*link != oldest_ndx + 1)
+            {
+              link = &g_neighbor_next[*link - 1];
+            }
+
+          *link = g_neighbor_next[oldest_ndx];
+        }
+
+      link = neighbor_hash(ipaddr);
+      g_neighbor_next[oldest_ndx] = *link;
+      *link = oldest_ndx + 1;
     }
 
   /* Need to notify when entry is not found or changes in table */
@@ -38,6 +38,39 @@
 
 struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
 
+/* The Neighbor Table entries hashed by IPv6 address */
+
+neighbor_index_t g_neighbor_hash[CONFIG_NET_IPv6_NCONF_HASHSIZE];
+neighbor_index_t g_neighbor_next[CONFIG_NET_IPv6_NCONF_ENTRIES];
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
+
+/****************************************************************************
+ * Name: neighbor_hash
+ *
+ * Description:
+ *   Return the hash chain of an IPv6 address.
+ *
+ * Input Parameters:
+ *   ipaddr - The IPv6 address;
+ *
+ * Returned Value:
+ *   The head of the chain in g_neighbor_hash[].
+ *
+ ****************************************************************************/
+
+FAR neighbor_index_t *neighbor_hash(const net_ipv6addr_t ipaddr)
+{
+  uint16_t hash = 0;
+  int i;
+
+  for (i = 0; i < 8; i++)
+    {
+      hash ^= ipaddr[i];
+    }
+
+  hash ^= hash >> 8;
+  return &g_neighbor_hash[hash & (CONFIG_NET_IPv6_NCONF_HASHSIZE - 1)];
+}
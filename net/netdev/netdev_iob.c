@@ -108,9 +108,22 @@ void netdev_iob_prepare_dynamic(FAR struct net_driver_s *dev, uint16_t size)
       return;
     }
 
-  /* alloc new iob for jumbo frame */
+  /* Take a large pool buffer for the jumbo frame if it fits, or allocate
+   * one from the heap.
+   */
+
+  iob = iob_tryalloc_size(size, false);
+  if (iob != NULL && size > IOB_BUFSIZE(iob))
+    {
+      iob_free(iob);
+      iob = NULL;
+    }
+
+  if (iob == NULL)
+    {
+      iob = iob_alloc_dynamic(size);
+    }
 
-  iob = iob_alloc_dynamic(size);
   if (iob == NULL)
     {
       nerr("ERROR: Failed to allocate an I/O buffer.");
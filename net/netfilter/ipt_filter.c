@@ -361,16 +361,22 @@ skip_match:
  * Input Parameters:
  *   repl - The config got from user space to control filter table.
  *
+ * Returned Value:
+ *   OK on success, -ENOMEM if a chain was set but cannot be compiled into
+ *   a classifier.  Such a chain is matched linearly.
+ *
  ****************************************************************************/
 
 #ifdef CONFIG_NET_IPv4
-static void adjust_ipv4filter(FAR const struct ipt_replace *repl)
+static int adjust_ipv4filter(FAR const struct ipt_replace *repl)
 {
   FAR const struct ipt_entry *entry;
   FAR const uint8_t *head;
   enum ipfilter_chain_e chain;
   enum nf_inet_hooks hook;
   size_t size;
+  int ret = OK;
+  int err;
 
   for (hook = NF_INET_LOCAL_IN; hook <= NF_INET_LOCAL_OUT; hook++)
     {
@@ -400,18 +406,30 @@ static void adjust_ipv4filter(FAR const struct ipt_replace *repl)
               nwarn("WARNING: Failed to convert entry!\n");
             }
         }
+
+      /* The chain still works linearly if it cannot be compiled. */
+
+      err = ipfilter_cfg_build(PF_INET, chain);
+      if (err < 0)
+        {
+          ret = err;
+        }
     }
+
+  return ret;
 }
 #endif
 
 #ifdef CONFIG_NET_IPv6
-static void adjust_ipv6filter(FAR const struct ip6t_replace *repl)
+static int adjust_ipv6filter(FAR const struct ip6t_replace *repl)
 {
   FAR const struct ip6t_entry *entry;
   FAR const uint8_t *head;
   enum ipfilter_chain_e chain;
   enum nf_inet_hooks hook;
   size_t size;
+  int ret = OK;
+  int err;
 
   for (hook = NF_INET_LOCAL_IN; hook <= NF_INET_LOCAL_OUT; hook++)
     {
@@ -441,7 +459,17 @@ static void adjust_ipv6filter(FAR const struct ip6t_replace *repl)
               nwarn("WARNING: Failed to convert entry!\n");
             }
         }
+
+      /* The chain still works linearly if it cannot be compiled. */
+
+      err = ipfilter_cfg_build(PF_INET6, chain);
+      if (err < 0)
+        {
+          ret = err;
+        }
     }
+
+  return ret;
 }
 #endif
 
@@ -475,11 +503,15 @@ FAR struct ip6t_replace *ip6t_filter_init(void)
  * Name: ipt_filter_apply
  *
  * Description:
- *   Try to apply filter rules, will do nothing if failed.
+ *   Try to apply filter rules, will do nothing if the rules are invalid.
  *
  * Input Parameters:
  *   repl - The config got from user space to control filter table.
  *
+ * Returned Value:
+ *   OK on success, -EINVAL if the rules are invalid, -ENOMEM if the rules
+ *   are applied but a chain cannot be compiled into a classifier.
+ *
  ****************************************************************************/
 
 #ifdef CONFIG_NET_IPv4
@@ -535,9 +567,7 @@ int ipt_filter_apply(FAR const struct ipt_replace *repl)
 
   /* Set config table into ip filter. */
 
-  adjust_ipv4filter(repl);
-
-  return OK;
+  return adjust_ipv4filter(repl);
 }
 #endif
 
@@ -594,8 +624,6 @@ int ip6t_filter_apply(FAR const struct ip6t_replace *repl)
 
   /* Set config table into ip filter. */
 
-  adjust_ipv6filter(repl);
-
-  return OK;
+  return adjust_ipv6filter(repl);
 }
 #endif
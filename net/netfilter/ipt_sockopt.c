@@ -307,9 +307,11 @@ static int replace_entries(FAR const struct ipt_replace *repl, socklen_t len)
 
   ret = table->apply_func(repl);
 
-  /* If successfully applied, save data into kernel space. */
+  /* If successfully applied, save data into kernel space.  -ENOMEM means
+   * the rules are in effect but could not be compiled into a classifier.
+   */
 
-  if (ret == OK)
+  if (ret == OK || ret == -ENOMEM)
     {
       memcpy(new_repl, repl, sizeof(*repl) + repl->size);
       SWAP_PTR(table->repl, new_repl);
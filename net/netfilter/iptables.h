@@ -147,11 +147,15 @@ FAR struct ip6t_replace *ip6t_filter_init(void);
  * Name: ipt_filter_apply
  *
  * Description:
- *   Try to apply filter rules, will do nothing if failed.
+ *   Try to apply filter rules, will do nothing if the rules are invalid.
  *
  * Input Parameters:
  *   repl - The config got from user space to control filter table.
  *
+ * Returned Value:
+ *   OK on success, -EINVAL if the rules are invalid, -ENOMEM if the rules
+ *   are applied but a chain cannot be compiled into a classifier.
+ *
  ****************************************************************************/
 
 #ifdef CONFIG_NET_IPFILTER
@@ -69,7 +69,8 @@ static int  netlink_poll(FAR struct socket *psock, FAR struct pollfd *fds,
 static ssize_t netlink_sendmsg(FAR struct socket *psock,
                                FAR struct msghdr *msg, int flags);
 static ssize_t netlink_recvmsg(FAR struct socket *psock,
-                               FAR struct msghdr *msg, int flags);
+                               FAR struct msghdr *msg, int flags,
+                               unsigned int timeout);
 static int netlink_close(FAR struct socket *psock);
 
 /****************************************************************************
@@ -663,11 +664,13 @@ static ssize_t netlink_sendmsg(FAR struct socket *psock,
  *   psock    A pointer to a NuttX-specific, internal socket structure
  *   msg      Buffer to receive the message
  *   flags    Receive flags (ignored)
+ *   timeout  Receive timeout in milliseconds, UINT_MAX for none
  *
  ****************************************************************************/
 
 static ssize_t netlink_recvmsg(FAR struct socket *psock,
-                               FAR struct msghdr *msg, int flags)
+                               FAR struct msghdr *msg, int flags,
+                               unsigned int timeout)
 {
   FAR void *buf = msg->msg_iov->iov_base;
   size_t len = msg->msg_iov->iov_len;
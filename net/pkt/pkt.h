@@ -221,6 +221,7 @@ uint16_t pkt_callback(FAR struct net_driver_s *dev,
  *   psock    A pointer to a NuttX-specific, internal socket structure
  *   msg      Buffer to receive the message
  *   flags    Receive flags
+ *   timeout  Receive timeout in milliseconds, UINT_MAX for none
  *
  * Returned Value:
  *   On success, returns the number of characters received. If no data is
@@ -231,7 +232,7 @@ uint16_t pkt_callback(FAR struct net_driver_s *dev,
  ****************************************************************************/
 
 ssize_t pkt_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
-                    int flags);
+                    int flags, unsigned int timeout);
 
 /****************************************************************************
  * Name: pkt_find_device
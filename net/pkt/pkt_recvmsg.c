@@ -380,6 +380,7 @@ static inline ssize_t pkt_readahead(FAR struct pkt_conn_s *conn,
  *   psock    A pointer to a NuttX-specific, internal socket structure
  *   msg      Buffer to receive the message
  *   flags    Receive flags
+ *   timeout  Receive timeout in milliseconds, UINT_MAX for none
  *
  * Returned Value:
  *   On success, returns the number of characters received. If no data is
@@ -390,7 +391,7 @@ static inline ssize_t pkt_readahead(FAR struct pkt_conn_s *conn,
  ****************************************************************************/
 
 ssize_t pkt_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
-                    int flags)
+                    int flags, unsigned int timeout)
 {
   FAR void *buf = msg->msg_iov->iov_base;
   size_t len = msg->msg_iov->iov_len;
@@ -0,0 +1,158 @@
+/****************************************************************************
+ * net/procfs/net_arp.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* Output format:
+ *
+ *   Lookups:  Hits: xxxx Misses: xxxx
+ *   Requests: xxxx Timeouts: xxxx
+ *   Held:     Queued: xxxx Sent: xxxx Dropped: xxxx
+ *   Entries:  Expired: xxxx Evicted: xxxx
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdio.h>
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/net/netstats.h>
+
+#include "procfs/procfs.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_NET) && defined(CONFIG_NET_STATISTICS)
+
+#ifdef CONFIG_NET_ARP
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* Line generating functions */
+
+static int netprocfs_lookups(FAR struct netprocfs_file_s *netfile);
+static int netprocfs_requests(FAR struct netprocfs_file_s *netfile);
+static int netprocfs_held(FAR struct netprocfs_file_s *netfile);
+static int netprocfs_entries(FAR struct netprocfs_file_s *netfile);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Line generating functions */
+
+static const linegen_t g_arp_linegen[] =
+{
+  netprocfs_lookups,
+  netprocfs_requests,
+  netprocfs_held,
+  netprocfs_entries
+};
+
+#define NSTAT_LINES (sizeof(g_arp_linegen) / sizeof(linegen_t))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netprocfs_lookups
+ ****************************************************************************/
+
+static int netprocfs_lookups(FAR struct netprocfs_file_s *netfile)
+{
+  return snprintf(netfile->line, NET_LINELEN,
+                  "Lookups:  Hits: %04x Misses: %04x\n",
+                  g_netstats.arp.hits, g_netstats.arp.misses);
+}
+
+/****************************************************************************
+ * Name: netprocfs_requests
+ ****************************************************************************/
+
+static int netprocfs_requests(FAR struct netprocfs_file_s *netfile)
+{
+  return snprintf(netfile->line, NET_LINELEN,
+                  "Requests: %04x Timeouts: %04x\n",
+                  g_netstats.arp.requests, g_netstats.arp.timeouts);
+}
+
+/****************************************************************************
+ * Name: netprocfs_held
+ ****************************************************************************/
+
+static int netprocfs_held(FAR struct netprocfs_file_s *netfile)
+{
+  return snprintf(netfile->line, NET_LINELEN,
+                  "Held:     Queued: %04x Sent: %04x Dropped: %04x\n",
+                  g_netstats.arp.queued, g_netstats.arp.flushed,
+                  g_netstats.arp.qdrops);
+}
+
+/****************************************************************************
+ * Name: netprocfs_entries
+ ****************************************************************************/
+
+static int netprocfs_entries(FAR struct netprocfs_file_s *netfile)
+{
+  return snprintf(netfile->line, NET_LINELEN,
+                  "Entries:  Expired: %04x Evicted: %04x\n",
+                  g_netstats.arp.expired, g_netstats.arp.evicted);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netprocfs_read_arpstats
+ *
+ * Description:
+ *   Read and format ARP statistics.
+ *
+ * Input Parameters:
+ *   priv - A reference to the network procfs file structure
+ *   buffer - The user-provided buffer into which network status will be
+ *            returned.
+ *   bulen  - The size in bytes of the user provided buffer.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+ssize_t netprocfs_read_arpstats(FAR struct netprocfs_file_s *priv,
+                                FAR char *buffer, size_t buflen)
+{
+  return netprocfs_read_linegen(priv, buffer, buflen,
+                                g_arp_linegen, NSTAT_LINES);
+}
+
+#endif /* CONFIG_NET_ARP */
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * !CONFIG_FS_PROCFS_EXCLUDE_NET */
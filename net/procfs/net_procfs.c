@@ -114,6 +114,14 @@ static const struct netprocfs_entry_s g_net_entries[] =
       netprocfs_read_netstats
     }
   },
+#  ifdef CONFIG_NET_ARP
+  {
+    DTYPE_FILE, "arp",
+    {
+      netprocfs_read_arpstats
+    }
+  },
+#  endif
 #  ifdef CONFIG_NET_MLD
   {
     DTYPE_FILE, "mld",
@@ -51,6 +51,14 @@
 #  define TCP_LINELEN 120
 #endif
 
+/* Room for the loss recovery statistics */
+
+#ifdef CONFIG_NET_STATISTICS
+#  define TCP_STATSLEN 60
+#else
+#  define TCP_STATSLEN 0
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -84,7 +92,7 @@ static ssize_t netprocfs_tcpstats(FAR struct netprocfs_file_s *priv,
           continue;
         }
 
-      if (buflen - len < TCP_LINELEN)
+      if (buflen - len < TCP_LINELEN + TCP_STATSLEN)
         {
           break;
         }
@@ -102,7 +110,12 @@ static ssize_t netprocfs_tcpstats(FAR struct netprocfs_file_s *priv,
 #if CONFIG_NET_SEND_BUFSIZE > 0
                       " %6" PRIu32
 #endif
-                      " %6u",
+                      " %6u"
+#ifdef CONFIG_NET_STATISTICS
+                      " %4" PRIu32 " %4" PRIu32
+                      " %4" PRIu32 " %4" PRIu32
+#endif
+                      ,
                       priv->offset++,
                       conn->tcpstateflags,
                       conn->sconn.s_flags,
@@ -113,7 +126,14 @@ static ssize_t netprocfs_tcpstats(FAR struct netprocfs_file_s *priv,
 #if CONFIG_NET_SEND_BUFSIZE > 0
                       tcp_wrbuffer_inqueue_size(conn),
 #endif
-                      (conn->readahead) ? conn->readahead->io_pktlen : 0);
+                      (conn->readahead) ? conn->readahead->io_pktlen : 0
+#ifdef CONFIG_NET_STATISTICS
+                      , conn->rstats.ofo_queued,
+                      conn->rstats.ofo_dropped,
+                      conn->rstats.rto_rexmit,
+                      conn->rstats.sack_rexmit
+#endif
+                      );
 
       len += snprintf(buffer + len, buflen - len,
                       " %*s:%-6" PRIu16 " %*s:%-6" PRIu16 "\n",
@@ -170,6 +190,9 @@ ssize_t netprocfs_read_tcpstats(FAR struct netprocfs_file_s *priv,
                                           "txsz   "
 #endif
                                           "rxsz "
+#ifdef CONFIG_NET_STATISTICS
+                                          "ofoq ofod rtox sack "
+#endif
                                           "%-*s "
                                           "%-*s\n"
                                           ,
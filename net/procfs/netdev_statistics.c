@@ -77,11 +77,16 @@ static int netprocfs_rxstatistics_header(
 static int netprocfs_rxstatistics(FAR struct netprocfs_file_s *netfile);
 static int netprocfs_rxpackets_header(FAR struct netprocfs_file_s *netfile);
 static int netprocfs_rxpackets(FAR struct netprocfs_file_s *netfile);
+static int netprocfs_rxpolls(FAR struct netprocfs_file_s *netfile);
 static int netprocfs_txstatistics_header(
     FAR struct netprocfs_file_s *netfile);
 static int netprocfs_txstatistics(FAR struct netprocfs_file_s *netfile);
 static int netprocfs_errors(FAR struct netprocfs_file_s *netfile);
 #endif /* CONFIG_NETDEV_STATISTICS */
+#if defined(CONFIG_NETDEV_STATISTICS) && defined(CONFIG_NETDEV_MULTIQUEUE)
+static int netprocfs_rxqueues(FAR struct netprocfs_file_s *netfile);
+static int netprocfs_txqueues(FAR struct netprocfs_file_s *netfile);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -114,8 +119,13 @@ static const linegen_t g_netstat_linegen[] =
   netprocfs_rxstatistics,
   netprocfs_rxpackets_header,
   netprocfs_rxpackets,
+  netprocfs_rxpolls,
   netprocfs_txstatistics_header,
   netprocfs_txstatistics,
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  netprocfs_rxqueues,
+  netprocfs_txqueues,
+#endif
   netprocfs_errors
 #endif /* CONFIG_NETDEV_STATISTICS */
 };
@@ -518,6 +528,35 @@ static int netprocfs_rxpackets(FAR struct netprocfs_file_s *netfile)
 }
 #endif /* CONFIG_NETDEV_STATISTICS */
 
+/****************************************************************************
+ * Name: netprocfs_rxpolls
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_STATISTICS
+static int netprocfs_rxpolls(FAR struct netprocfs_file_s *netfile)
+{
+  FAR struct netdev_statistics_s *stats;
+  FAR struct net_driver_s *dev;
+  unsigned long ratio = 0;
+
+  DEBUGASSERT(netfile != NULL && netfile->dev != NULL);
+  dev = netfile->dev;
+  stats = &dev->d_statistics;
+
+  /* Packets per interrupt grows when interrupts are mitigated */
+
+  if (stats->rx_interrupts > 0)
+    {
+      ratio = stats->rx_packets / stats->rx_interrupts;
+    }
+
+  return snprintf(netfile->line, NET_LINELEN,
+                  "\tRX Interrupts: %08" PRIx32 " Polls: %08" PRIx32
+                  " Pkts/Int: %lu\n",
+                  stats->rx_interrupts, stats->rx_polls, ratio);
+}
+#endif /* CONFIG_NETDEV_STATISTICS */
+
 /****************************************************************************
  * Name: netprocfs_txstatistics_header
  ****************************************************************************/
@@ -558,6 +597,57 @@ static int netprocfs_txstatistics(FAR struct netprocfs_file_s *netfile)
 }
 #endif /* CONFIG_NETDEV_STATISTICS */
 
+/****************************************************************************
+ * Name: netprocfs_queues
+ ****************************************************************************/
+
+#if defined(CONFIG_NETDEV_STATISTICS) && defined(CONFIG_NETDEV_MULTIQUEUE)
+static int netprocfs_queues(FAR struct netprocfs_file_s *netfile,
+                            FAR const char *title,
+                            FAR const uint32_t *packets)
+{
+  int len;
+  int i;
+
+  /* Show as many queues as fit on the line, 9 characters each */
+
+  len = snprintf(netfile->line, NET_LINELEN, "\t%s:", title);
+  for (i = 0; i < CONFIG_NETDEV_MAX_QUEUES && len + 10 < NET_LINELEN; i++)
+    {
+      len += snprintf(&netfile->line[len], NET_LINELEN - len,
+                      " %08" PRIx32, packets[i]);
+    }
+
+  netfile->line[len++] = '\n';
+  netfile->line[len]   = '\0';
+  return len;
+}
+
+/****************************************************************************
+ * Name: netprocfs_rxqueues
+ ****************************************************************************/
+
+static int netprocfs_rxqueues(FAR struct netprocfs_file_s *netfile)
+{
+  DEBUGASSERT(netfile != NULL && netfile->dev != NULL);
+
+  return netprocfs_queues(netfile, "RXQ",
+                          netfile->dev->d_statistics.rxq_packets);
+}
+
+/****************************************************************************
+ * Name: netprocfs_txqueues
+ ****************************************************************************/
+
+static int netprocfs_txqueues(FAR struct netprocfs_file_s *netfile)
+{
+  DEBUGASSERT(netfile != NULL && netfile->dev != NULL);
+
+  return netprocfs_queues(netfile, "TXQ",
+                          netfile->dev->d_statistics.txq_packets);
+}
+#endif /* CONFIG_NETDEV_STATISTICS && CONFIG_NETDEV_MULTIQUEUE */
+
 /****************************************************************************
  * Name: netprocfs_errors
  ****************************************************************************/
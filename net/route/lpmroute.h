@@ -0,0 +1,212 @@
+/****************************************************************************
+ * net/route/lpmroute.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __NET_ROUTE_LPMROUTE_H
+#define __NET_ROUTE_LPMROUTE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "route/route.h"
+
+#ifdef CONFIG_ROUTE_LPM_TRIE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The trie indexes the in-memory routing tables only */
+
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE
+#  define NET_ROUTE_IPv4_LPM 1
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_RAMROUTE
+#  define NET_ROUTE_IPv6_LPM 1
+#endif
+
+/* Number of 32-bit words in the largest key */
+
+#ifdef NET_ROUTE_IPv6_LPM
+#  define NET_LPM_NWORDS 4
+#else
+#  define NET_LPM_NWORDS 1
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* One node of the path-compressed binary trie.  A node embedded in a
+ * routing table entry carries a route; the other nodes only branch.  All
+ * routes with the same prefix hang off the first of them through 'dup'.
+ */
+
+struct net_lpm_node_s
+{
+  FAR struct net_lpm_node_s *child[2]; /* Sub-tries selected by the next bit */
+  FAR struct net_lpm_node_s *parent;   /* Parent node, NULL for the root */
+  FAR struct net_lpm_node_s *dup;      /* Next route with the same prefix */
+  uint32_t key[NET_LPM_NWORDS];        /* Prefix in host byte order */
+  uint8_t  plen;                       /* Prefix length in bits */
+  bool     route;                      /* Embedded in a routing table entry */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_init_lpmroute
+ *
+ * Description:
+ *   Initialize the longest prefix match tries
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called early in initialization so that no special protection is needed.
+ *
+ ****************************************************************************/
+
+void net_init_lpmroute(void);
+
+/****************************************************************************
+ * Name: net_lpmmask_ipv4 and net_lpmmask_ipv6
+ *
+ * Description:
+ *   Check that a netmask can be indexed by the trie.  The trie indexes a
+ *   route by its prefix length, so the one bits of the netmask must be
+ *   contiguous.
+ *
+ * Input Parameters:
+ *   netmask - The netmask of a new route.
+ *
+ * Returned Value:
+ *   True if the netmask is contiguous.
+ *
+ ****************************************************************************/
+
+#ifdef NET_ROUTE_IPv4_LPM
+bool net_lpmmask_ipv4(in_addr_t netmask);
+#endif
+
+#ifdef NET_ROUTE_IPv6_LPM
+bool net_lpmmask_ipv6(const net_ipv6addr_t netmask);
+#endif
+
+/****************************************************************************
+ * Name: net_addlpm_ipv4 and net_addlpm_ipv6
+ *
+ * Description:
+ *   Add one in-memory routing table entry to the trie.  The branch nodes
+ *   are preallocated, so this cannot fail.  Routes with the same prefix
+ *   are visited in the order they were added.  The netmask must have been
+ *   checked with net_lpmmask_ipv4/6().
+ *
+ * Input Parameters:
+ *   route - The routing table entry, already linked into the table.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The caller holds the network lock.
+ *
+ ****************************************************************************/
+
+#ifdef NET_ROUTE_IPv4_LPM
+void net_addlpm_ipv4(FAR struct net_route_ipv4_s *route);
+#endif
+
+#ifdef NET_ROUTE_IPv6_LPM
+void net_addlpm_ipv6(FAR struct net_route_ipv6_s *route);
+#endif
+
+/****************************************************************************
+ * Name: net_dellpm_ipv4 and net_dellpm_ipv6
+ *
+ * Description:
+ *   Remove one in-memory routing table entry from the trie
+ *
+ * Input Parameters:
+ *   route - The routing table entry that was added with net_addlpm_*().
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The caller holds the network lock.
+ *
+ ****************************************************************************/
+
+#ifdef NET_ROUTE_IPv4_LPM
+void net_dellpm_ipv4(FAR struct net_route_ipv4_s *route);
+#endif
+
+#ifdef NET_ROUTE_IPv6_LPM
+void net_dellpm_ipv6(FAR struct net_route_ipv6_s *route);
+#endif
+
+/****************************************************************************
+ * Name: net_foreachlpm_ipv4 and net_foreachlpm_ipv6
+ *
+ * Description:
+ *   Visit the routes whose network contains 'target', from the longest to
+ *   the shortest prefix.  This replaces net_foreachroute_ipv4/6() for
+ *   route lookups and only touches the nodes on the path to 'target'.
+ *   The handler must not modify the routing table.
+ *
+ * Input Parameters:
+ *   target  - The address to look up.
+ *   handler - Will be called for each matching route.
+ *   arg     - An arbitrary value that will be passed to the handler.
+ *
+ * Returned Value:
+ *   Zero (OK) returned if all matching routes were visited.  Handlers may
+ *   terminate the search early with any non-zero value, which is then
+ *   returned.
+ *
+ ****************************************************************************/
+
+#ifdef NET_ROUTE_IPv4_LPM
+int net_foreachlpm_ipv4(in_addr_t target, route_handler_ipv4_t handler,
+                        FAR void *arg);
+#endif
+
+#ifdef NET_ROUTE_IPv6_LPM
+int net_foreachlpm_ipv6(const net_ipv6addr_t target,
+                        route_handler_ipv6_t handler, FAR void *arg);
+#endif
+
+#endif /* CONFIG_ROUTE_LPM_TRIE */
+#endif /* __NET_ROUTE_LPMROUTE_H */
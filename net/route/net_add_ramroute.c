@@ -64,6 +64,16 @@ int net_addroute_ipv4(in_addr_t target, in_addr_t netmask, in_addr_t router)
 {
   FAR struct net_route_ipv4_s *route;
 
+#ifdef CONFIG_ROUTE_LPM_TRIE
+  /* The trie cannot index a netmask with holes */
+
+  if (!net_lpmmask_ipv4(netmask))
+    {
+      nerr("ERROR:  Non-contiguous netmask\n");
+      return -EINVAL;
+    }
+#endif
+
   /* Allocate a route entry */
 
   route = net_allocroute_ipv4();
@@ -88,6 +98,9 @@ int net_addroute_ipv4(in_addr_t target, in_addr_t netmask, in_addr_t router)
 
   ramroute_ipv4_addlast((FAR struct net_route_ipv4_entry_s *)route,
                         &g_ipv4_routes);
+#ifdef CONFIG_ROUTE_LPM_TRIE
+  net_addlpm_ipv4(route);
+#endif
   net_unlock();
 
   netlink_route_notify(route, RTM_NEWROUTE, AF_INET);
@@ -101,6 +114,16 @@ int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask,
 {
   FAR struct net_route_ipv6_s *route;
 
+#ifdef CONFIG_ROUTE_LPM_TRIE
+  /* The trie cannot index a netmask with holes */
+
+  if (!net_lpmmask_ipv6(netmask))
+    {
+      nerr("ERROR:  Non-contiguous netmask\n");
+      return -EINVAL;
+    }
+#endif
+
   /* Allocate a route entry */
 
   route = net_allocroute_ipv6();
@@ -125,6 +148,9 @@ int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask,
 
   ramroute_ipv6_addlast((FAR struct net_route_ipv6_entry_s *)route,
                         &g_ipv6_routes);
+#ifdef CONFIG_ROUTE_LPM_TRIE
+  net_addlpm_ipv6(route);
+#endif
   net_unlock();
 
   netlink_route_notify(route, RTM_NEWROUTE, AF_INET6);
@@ -130,6 +130,12 @@ void net_init_ramroute(void)
       ramroute_ipv6_addlast(&g_prealloc_ipv6routes[i], &g_free_ipv6routes);
     }
 #endif
+
+#ifdef CONFIG_ROUTE_LPM_TRIE
+  /* And the prefix trie that indexes the routing tables */
+
+  net_init_lpmroute();
+#endif
 }
 
 /****************************************************************************
@@ -0,0 +1,662 @@
+/****************************************************************************
+ * net/route/net_lpmroute.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+#include <assert.h>
+
+#include <nuttx/nuttx.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/ip.h>
+
+#include "route/lpmroute.h"
+#include "route/ramroute.h"
+#include "route/route.h"
+#include "utils/utils.h"
+
+#ifdef CONFIG_ROUTE_LPM_TRIE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Bit 'n' (counting from the most significant bit) of a key */
+
+#define LPM_BIT(k,n) (((k)[(n) >> 5] >> (31 - ((n) & 31))) & 1)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One trie per address family.  Every branch node has exactly two
+ * children, so a trie holding N distinct prefixes never needs more than
+ * N - 1 branch nodes.  The branch nodes are therefore preallocated along
+ * with the routing table entries.
+ */
+
+struct net_lpm_trie_s
+{
+  FAR struct net_lpm_node_s *root;     /* Root of the trie */
+  FAR struct net_lpm_node_s *free;     /* Free branch nodes (via parent) */
+  uint8_t nwords;                      /* Number of words in a key */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef NET_ROUTE_IPv4_LPM
+static struct net_lpm_trie_s g_ipv4_lpm;
+static struct net_lpm_node_s
+  g_ipv4_lpm_branches[CONFIG_ROUTE_MAX_IPv4_RAMROUTES];
+#endif
+
+#ifdef NET_ROUTE_IPv6_LPM
+static struct net_lpm_trie_s g_ipv6_lpm;
+static struct net_lpm_node_s
+  g_ipv6_lpm_branches[CONFIG_ROUTE_MAX_IPv6_RAMROUTES];
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lpm_init
+ ****************************************************************************/
+
+static void lpm_init(FAR struct net_lpm_trie_s *trie,
+                     FAR struct net_lpm_node_s *branches, int nbranches,
+                     uint8_t nwords)
+{
+  int i;
+
+  trie->root   = NULL;
+  trie->free   = NULL;
+  trie->nwords = nwords;
+
+  for (i = 0; i < nbranches; i++)
+    {
+      branches[i].parent = trie->free;
+      trie->free         = &branches[i];
+    }
+}
+
+/****************************************************************************
+ * Name: lpm_common
+ *
+ * Description:
+ *   Return the length of the common prefix of two keys, limited to 'max'
+ *   bits.
+ *
+ ****************************************************************************/
+
+static uint8_t lpm_common(FAR const uint32_t *k1, FAR const uint32_t *k2,
+                          uint8_t max)
+{
+  uint32_t diff;
+  uint8_t len = 0;
+  int i;
+
+  for (i = 0; len < max; i++, len += 32)
+    {
+      diff = k1[i] ^ k2[i];
+      if (diff != 0)
+        {
+          len += 32 - fls((int)diff);
+          break;
+        }
+    }
+
+  return len < max ? len : max;
+}
+
+/****************************************************************************
+ * Name: lpm_replace
+ *
+ * Description:
+ *   Put 'newnode' in the place of 'oldnode' below the parent of 'oldnode'.
+ *
+ ****************************************************************************/
+
+static void lpm_replace(FAR struct net_lpm_trie_s *trie,
+                        FAR struct net_lpm_node_s *oldnode,
+                        FAR struct net_lpm_node_s *newnode)
+{
+  FAR struct net_lpm_node_s *parent = oldnode->parent;
+
+  if (newnode != NULL)
+    {
+      newnode->parent = parent;
+    }
+
+  if (parent == NULL)
+    {
+      trie->root = newnode;
+    }
+  else
+    {
+      parent->child[parent->child[1] == oldnode] = newnode;
+    }
+}
+
+/****************************************************************************
+ * Name: lpm_move
+ *
+ * Description:
+ *   Let 'newnode' take over the position and the children of 'oldnode'.
+ *
+ ****************************************************************************/
+
+static void lpm_move(FAR struct net_lpm_trie_s *trie,
+                     FAR struct net_lpm_node_s *oldnode,
+                     FAR struct net_lpm_node_s *newnode)
+{
+  int i;
+
+  lpm_replace(trie, oldnode, newnode);
+  for (i = 0; i < 2; i++)
+    {
+      newnode->child[i] = oldnode->child[i];
+      if (newnode->child[i] != NULL)
+        {
+          newnode->child[i]->parent = newnode;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: lpm_insert
+ ****************************************************************************/
+
+static void lpm_insert(FAR struct net_lpm_trie_s *trie,
+                       FAR struct net_lpm_node_s *node)
+{
+  FAR struct net_lpm_node_s *parent = NULL;
+  FAR struct net_lpm_node_s *cur = trie->root;
+  FAR struct net_lpm_node_s *branch;
+  FAR struct net_lpm_node_s **prev;
+  uint8_t common = 0;
+
+  node->child[0] = NULL;
+  node->child[1] = NULL;
+  node->parent   = NULL;
+  node->dup      = NULL;
+  node->route    = true;
+
+  /* Walk down while the prefix of the current node covers the new one */
+
+  while (cur != NULL)
+    {
+      common = lpm_common(cur->key, node->key, MIN(cur->plen, node->plen));
+      if (common < cur->plen)
+        {
+          break;
+        }
+
+      if (cur->plen == node->plen)
+        {
+          if (cur->route)
+            {
+              /* Another route with the same prefix.  Keep the routes in
+               * the order they were added, like the routing table.
+               */
+
+              for (prev = &cur->dup; *prev != NULL; prev = &(*prev)->dup)
+                {
+                }
+
+              *prev = node;
+            }
+          else
+            {
+              /* The route takes over the branch node */
+
+              lpm_move(trie, cur, node);
+              cur->parent = trie->free;
+              trie->free  = cur;
+            }
+
+          return;
+        }
+
+      parent = cur;
+      cur    = cur->child[LPM_BIT(node->key, cur->plen)];
+    }
+
+  if (cur == NULL)
+    {
+      /* Nothing below the parent in this direction */
+
+      node->parent = parent;
+      if (parent == NULL)
+        {
+          trie->root = node;
+        }
+      else
+        {
+          parent->child[LPM_BIT(node->key, parent->plen)] = node;
+        }
+    }
+  else if (common == node->plen)
+    {
+      /* The new prefix covers the current node */
+
+      lpm_replace(trie, cur, node);
+      node->child[LPM_BIT(cur->key, node->plen)] = cur;
+      cur->parent = node;
+    }
+  else
+    {
+      /* The prefixes diverge at bit 'common':  Branch there */
+
+      branch = trie->free;
+      DEBUGASSERT(branch != NULL);
+      trie->free = branch->parent;
+
+      memcpy(branch->key, node->key, sizeof(branch->key));
+      branch->plen  = common;
+      branch->dup   = NULL;
+      branch->route = false;
+
+      lpm_replace(trie, cur, branch);
+      branch->child[LPM_BIT(node->key, common)] = node;
+      branch->child[LPM_BIT(cur->key, common)]  = cur;
+      node->parent = branch;
+      cur->parent  = branch;
+    }
+}
+
+/****************************************************************************
+ * Name: lpm_remove
+ ****************************************************************************/
+
+static void lpm_remove(FAR struct net_lpm_trie_s *trie,
+                       FAR struct net_lpm_node_s *node)
+{
+  FAR struct net_lpm_node_s *cur = trie->root;
+  FAR struct net_lpm_node_s *parent;
+  FAR struct net_lpm_node_s *branch;
+  FAR struct net_lpm_node_s *child;
+  FAR struct net_lpm_node_s **prev;
+
+  /* Find the node that holds this prefix */
+
+  while (cur != NULL && cur->plen < node->plen)
+    {
+      cur = cur->child[LPM_BIT(node->key, cur->plen)];
+    }
+
+  if (cur == NULL || cur->plen != node->plen || !cur->route ||
+      lpm_common(cur->key, node->key, node->plen) != node->plen)
+    {
+      return;
+    }
+
+  if (cur != node)
+    {
+      /* Just unlink it from the list of routes with the same prefix */
+
+      for (prev = &cur->dup; *prev != NULL; prev = &(*prev)->dup)
+        {
+          if (*prev == node)
+            {
+              *prev = node->dup;
+              break;
+            }
+        }
+
+      return;
+    }
+
+  if (node->dup != NULL)
+    {
+      /* The next route with the same prefix takes the place of this one,
+       * the others stay behind it in order.
+       */
+
+      lpm_move(trie, node, node->dup);
+      return;
+    }
+
+  if (node->child[0] != NULL && node->child[1] != NULL)
+    {
+      /* Still needed to branch:  Replace it with a branch node */
+
+      branch = trie->free;
+      DEBUGASSERT(branch != NULL);
+      trie->free = branch->parent;
+
+      memcpy(branch->key, node->key, sizeof(branch->key));
+      branch->plen  = node->plen;
+      branch->dup   = NULL;
+      branch->route = false;
+      lpm_move(trie, node, branch);
+      return;
+    }
+
+  /* Zero or one child:  Splice the node out */
+
+  child  = node->child[node->child[0] == NULL];
+  parent = node->parent;
+  lpm_replace(trie, node, child);
+
+  /* A branch node left with a single child is not needed anymore */
+
+  if (child == NULL && parent != NULL && !parent->route)
+    {
+      lpm_replace(trie, parent, parent->child[parent->child[0] == NULL]);
+      parent->parent = trie->free;
+      trie->free     = parent;
+    }
+}
+
+/****************************************************************************
+ * Name: lpm_lookup
+ *
+ * Description:
+ *   Return the deepest node whose prefix covers 'key'.  All of its
+ *   ancestors cover 'key' as well.
+ *
+ ****************************************************************************/
+
+static FAR struct net_lpm_node_s *
+lpm_lookup(FAR struct net_lpm_trie_s *trie, FAR const uint32_t *key)
+{
+  FAR struct net_lpm_node_s *best = NULL;
+  FAR struct net_lpm_node_s *cur = trie->root;
+
+  while (cur != NULL && lpm_common(cur->key, key, cur->plen) == cur->plen)
+    {
+      best = cur;
+      if (cur->plen == trie->nwords * 32)
+        {
+          break;
+        }
+
+      cur = cur->child[LPM_BIT(key, cur->plen)];
+    }
+
+  return best;
+}
+
+/****************************************************************************
+ * Name: lpm_contiguous
+ *
+ * Description:
+ *   Return true if a netmask in key form is a run of one bits followed by
+ *   zero bits only.
+ *
+ ****************************************************************************/
+
+static bool lpm_contiguous(FAR const uint32_t *mask, int nwords)
+{
+  uint32_t inv;
+  int i;
+
+  for (i = 0; i < nwords && mask[i] == UINT32_MAX; i++)
+    {
+    }
+
+  if (i < nwords)
+    {
+      inv = ~mask[i];
+      if ((inv & (inv + 1)) != 0)
+        {
+          return false;
+        }
+
+      while (++i < nwords)
+        {
+          if (mask[i] != 0)
+            {
+              return false;
+            }
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: lpm_ipv4_key and lpm_ipv6_key
+ ****************************************************************************/
+
+#ifdef NET_ROUTE_IPv4_LPM
+static void lpm_ipv4_key(FAR uint32_t *key, in_addr_t addr)
+{
+  key[0] = NTOHL(addr);
+}
+#endif
+
+#ifdef NET_ROUTE_IPv6_LPM
+static void lpm_ipv6_key(FAR uint32_t *key, const net_ipv6addr_t addr)
+{
+  int i;
+
+  for (i = 0; i < 4; i++)
+    {
+      key[i] = ((uint32_t)NTOHS(addr[2 * i]) << 16) |
+               NTOHS(addr[2 * i + 1]);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_init_lpmroute
+ *
+ * Description:
+ *   Initialize the longest prefix match tries
+ *
+ ****************************************************************************/
+
+void net_init_lpmroute(void)
+{
+#ifdef NET_ROUTE_IPv4_LPM
+  lpm_init(&g_ipv4_lpm, g_ipv4_lpm_branches,
+           CONFIG_ROUTE_MAX_IPv4_RAMROUTES, 1);
+#endif
+
+#ifdef NET_ROUTE_IPv6_LPM
+  lpm_init(&g_ipv6_lpm, g_ipv6_lpm_branches,
+           CONFIG_ROUTE_MAX_IPv6_RAMROUTES, 4);
+#endif
+}
+
+/****************************************************************************
+ * Name: net_lpmmask_ipv4 and net_lpmmask_ipv6
+ *
+ * Description:
+ *   Check that a netmask can be indexed by the trie
+ *
+ ****************************************************************************/
+
+#ifdef NET_ROUTE_IPv4_LPM
+bool net_lpmmask_ipv4(in_addr_t netmask)
+{
+  uint32_t key[1];
+
+  lpm_ipv4_key(key, netmask);
+  return lpm_contiguous(key, 1);
+}
+#endif
+
+#ifdef NET_ROUTE_IPv6_LPM
+bool net_lpmmask_ipv6(const net_ipv6addr_t netmask)
+{
+  uint32_t key[4];
+
+  lpm_ipv6_key(key, netmask);
+  return lpm_contiguous(key, 4);
+}
+#endif
+
+/****************************************************************************
+ * Name: net_addlpm_ipv4 and net_addlpm_ipv6
+ *
+ * Description:
+ *   Add one in-memory routing table entry to the trie
+ *
+ ****************************************************************************/
+
+#ifdef NET_ROUTE_IPv4_LPM
+void net_addlpm_ipv4(FAR struct net_route_ipv4_s *route)
+{
+  FAR struct net_lpm_node_s *node =
+    &((FAR struct net_route_ipv4_entry_s *)route)->lpm;
+
+  memset(node->key, 0, sizeof(node->key));
+  lpm_ipv4_key(node->key, route->target & route->netmask);
+  node->plen = net_ipv4_mask2pref(route->netmask);
+  lpm_insert(&g_ipv4_lpm, node);
+}
+#endif
+
+#ifdef NET_ROUTE_IPv6_LPM
+void net_addlpm_ipv6(FAR struct net_route_ipv6_s *route)
+{
+  FAR struct net_lpm_node_s *node =
+    &((FAR struct net_route_ipv6_entry_s *)route)->lpm;
+  net_ipv6addr_t masked;
+  int i;
+
+  for (i = 0; i < 8; i++)
+    {
+      masked[i] = route->target[i] & route->netmask[i];
+    }
+
+  lpm_ipv6_key(node->key, masked);
+  node->plen = net_ipv6_mask2pref(route->netmask);
+  lpm_insert(&g_ipv6_lpm, node);
+}
+#endif
+
+/****************************************************************************
+ * Name: net_dellpm_ipv4 and net_dellpm_ipv6
+ *
+ * Description:
+ *   Remove one in-memory routing table entry from the trie
+ *
+ ****************************************************************************/
+
+#ifdef NET_ROUTE_IPv4_LPM
+void net_dellpm_ipv4(FAR struct net_route_ipv4_s *route)
+{
+  lpm_remove(&g_ipv4_lpm,
+             &((FAR struct net_route_ipv4_entry_s *)route)->lpm);
+}
+#endif
+
+#ifdef NET_ROUTE_IPv6_LPM
+void net_dellpm_ipv6(FAR struct net_route_ipv6_s *route)
+{
+  lpm_remove(&g_ipv6_lpm,
+             &((FAR struct net_route_ipv6_entry_s *)route)->lpm);
+}
+#endif
+
+/****************************************************************************
+ * Name: net_foreachlpm_ipv4 and net_foreachlpm_ipv6
+ *
+ * Description:
+ *   Visit the routes whose network contains 'target', from the longest to
+ *   the shortest prefix.
+ *
+ ****************************************************************************/
+
+#ifdef NET_ROUTE_IPv4_LPM
+int net_foreachlpm_ipv4(in_addr_t target, route_handler_ipv4_t handler,
+                        FAR void *arg)
+{
+  FAR struct net_route_ipv4_entry_s *entry;
+  FAR struct net_lpm_node_s *route;
+  FAR struct net_lpm_node_s *node;
+  uint32_t key[NET_LPM_NWORDS];
+  int ret = 0;
+
+  memset(key, 0, sizeof(key));
+  lpm_ipv4_key(key, target);
+
+  /* Prevent concurrent access to the routing table */
+
+  net_lock();
+
+  for (node = lpm_lookup(&g_ipv4_lpm, key); ret == 0 && node != NULL;
+       node = node->parent)
+    {
+      for (route = node->route ? node : NULL; ret == 0 && route != NULL;
+           route = route->dup)
+        {
+          entry = container_of(route, struct net_route_ipv4_entry_s, lpm);
+          ret   = handler(&entry->entry, arg);
+        }
+    }
+
+  net_unlock();
+  return ret;
+}
+#endif
+
+#ifdef NET_ROUTE_IPv6_LPM
+int net_foreachlpm_ipv6(const net_ipv6addr_t target,
+                        route_handler_ipv6_t handler, FAR void *arg)
+{
+  FAR struct net_route_ipv6_entry_s *entry;
+  FAR struct net_lpm_node_s *route;
+  FAR struct net_lpm_node_s *node;
+  uint32_t key[NET_LPM_NWORDS];
+  int ret = 0;
+
+  lpm_ipv6_key(key, target);
+
+  /* Prevent concurrent access to the routing table */
+
+  net_lock();
+
+  for (node = lpm_lookup(&g_ipv6_lpm, key); ret == 0 && node != NULL;
+       node = node->parent)
+    {
+      for (route = node->route ? node : NULL; ret == 0 && route != NULL;
+           route = route->dup)
+        {
+          entry = container_of(route, struct net_route_ipv6_entry_s, lpm);
+          ret   = handler(&entry->entry, arg);
+        }
+    }
+
+  net_unlock();
+  return ret;
+}
+#endif
+
+#endif /* CONFIG_ROUTE_LPM_TRIE */
@@ -29,6 +29,7 @@
 
 #include <nuttx/config.h>
 
+#include "route/lpmroute.h"
 #include "route/route.h"
 
 #if defined(CONFIG_ROUTE_IPv4_RAMROUTE) || defined(CONFIG_ROUTE_IPv6_RAMROUTE)
@@ -68,6 +69,9 @@ struct net_route_ipv4_entry_s
 {
   struct net_route_ipv4_s entry;
   FAR struct net_route_ipv4_entry_s *flink;
+#ifdef CONFIG_ROUTE_LPM_TRIE
+  struct net_lpm_node_s lpm;            /* Node in the prefix trie */
+#endif
 };
 
 /* This structure describes the head of a routing table list */
@@ -86,6 +90,9 @@ struct net_route_ipv6_entry_s
 {
   struct net_route_ipv6_s entry;
   FAR struct net_route_ipv6_entry_s *flink;
+#ifdef CONFIG_ROUTE_LPM_TRIE
+  struct net_lpm_node_s lpm;            /* Node in the prefix trie */
+#endif
 };
 
 /* This structure describes the head of a routing table list */
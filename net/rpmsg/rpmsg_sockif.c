@@ -172,7 +172,8 @@ static int        rpmsg_socket_poll(FAR struct socket *psock,
 static ssize_t    rpmsg_socket_sendmsg(FAR struct socket *psock,
                                        FAR struct msghdr *msg, int flags);
 static ssize_t    rpmsg_socket_recvmsg(FAR struct socket *psock,
-                                       FAR struct msghdr *msg, int flags);
+                                       FAR struct msghdr *msg, int flags,
+                                       unsigned int timeout);
 static int        rpmsg_socket_close(FAR struct socket *psock);
 static int        rpmsg_socket_ioctl(FAR struct socket *psock,
                                      int cmd, unsigned long arg);
@@ -1231,7 +1232,8 @@ static ssize_t rpmsg_socket_sendmsg(FAR struct socket *psock,
 }
 
 static ssize_t rpmsg_socket_recvmsg(FAR struct socket *psock,
-                                    FAR struct msghdr *msg, int flags)
+                                    FAR struct msghdr *msg, int flags,
+                                    unsigned int timeout)
 {
   FAR struct rpmsg_socket_conn_s *conn = psock->s_conn;
   FAR struct sockaddr *from = msg->msg_name;
@@ -1309,8 +1311,7 @@ static ssize_t rpmsg_socket_recvmsg(FAR struct socket *psock,
   nxsem_reset(&conn->recvsem, 0);
   nxmutex_unlock(&conn->recvlock);
 
-  ret = net_sem_timedwait(&conn->recvsem,
-                          _SO_TIMEOUT(conn->sconn.s_rcvtimeo));
+  ret = net_sem_timedwait(&conn->recvsem, timeout);
   if (!conn->ept.rdev || conn->unbind)
     {
       ret = 0;
@@ -0,0 +1,238 @@
+/****************************************************************************
+ * net/socket/recvmmsg.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <limits.h>
+
+#include <nuttx/cancelpt.h>
+#include <nuttx/clock.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+
+#ifdef CONFIG_NET
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_recvmmsg
+ *
+ * Description:
+ *   psock_recvmmsg() receives multiple messages from a socket with a
+ *   single call.  This is an internal OS interface.  It is functionally
+ *   equivalent to recvmmsg() except that:
+ *
+ *   - It is not a cancellation point,
+ *   - It does not modify the errno variable, and
+ *   - It accepts the internal socket structure as an input rather than an
+ *     task-specific socket descriptor.
+ *
+ *   For Internet sockets the network lock is taken once for the whole
+ *   batch rather than once per message.
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   msgvec    Array of messages to receive
+ *   vlen      Number of entries in msgvec
+ *   flags     Receive flags.  MSG_WAITFORONE turns on MSG_DONTWAIT after
+ *             the first message has been received.
+ *   timeout   Optional upper bound of the time spent waiting for the whole
+ *             batch.  Once it expires, only messages that are already
+ *             queued are returned.
+ *
+ * Returned Value:
+ *   On success, returns the number of messages received in msgvec; the
+ *   msg_len field of each received entry holds the number of bytes
+ *   received.  If no message could be received, a negated errno value is
+ *   returned (see comments with recvmsg() for a list of appropriate errno
+ *   values).
+ *
+ ****************************************************************************/
+
+int psock_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags,
+                   FAR const struct timespec *timeout)
+{
+#ifdef CONFIG_NET_SOCKOPTS
+  FAR struct socket_conn_s *conn;
+#endif
+  unsigned int rcvtimeo = UINT_MAX;
+  clock_t deadline = 0;
+  unsigned int i;
+  ssize_t ret = OK;
+  bool locked;
+
+  if (msgvec == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if (psock == NULL || psock->s_conn == NULL)
+    {
+      return -EBADF;
+    }
+
+  if (timeout != NULL)
+    {
+      if (timeout->tv_sec < 0 || timeout->tv_nsec < 0 ||
+          timeout->tv_nsec >= NSEC_PER_SEC)
+        {
+          return -EINVAL;
+        }
+
+      deadline = clock_systime_ticks() + clock_time2ticks(timeout);
+    }
+
+#ifdef CONFIG_NET_SOCKOPTS
+  conn     = psock->s_conn;
+  rcvtimeo = _SO_TIMEOUT(conn->s_rcvtimeo);
+#endif
+
+  locked = _SS_BATCHLOCK(psock);
+  if (locked)
+    {
+      net_lock();
+    }
+
+  for (i = 0; i < vlen; i++)
+    {
+      unsigned int wait = rcvtimeo;
+
+      if (timeout != NULL && (flags & MSG_DONTWAIT) == 0)
+        {
+          sclock_t remain = (sclock_t)(deadline - clock_systime_ticks());
+
+          if (remain <= 0)
+            {
+              /* The batch timed out, just drain what is already queued */
+
+              flags |= MSG_DONTWAIT;
+            }
+          else
+            {
+              /* Bound the wait by the time left in the batch */
+
+              unsigned int msec = TICK2MSEC(remain);
+
+              if (msec == 0)
+                {
+                  msec = 1;
+                }
+
+              if (msec < wait)
+                {
+                  wait = msec;
+                }
+            }
+        }
+
+      ret = psock_recvmsg_timeout(psock, &msgvec[i].msg_hdr,
+                                  flags & ~MSG_WAITFORONE, wait);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      msgvec[i].msg_len = ret;
+
+      if ((flags & MSG_WAITFORONE) != 0)
+        {
+          flags |= MSG_DONTWAIT;
+        }
+    }
+
+  if (locked)
+    {
+      net_unlock();
+    }
+
+  /* Report the error only if no message at all was received */
+
+  return i > 0 ? i : ret;
+}
+
+/****************************************************************************
+ * Function: recvmmsg
+ *
+ * Description:
+ *   The recvmmsg() call is an extension of recvmsg() that allows the
+ *   caller to receive multiple messages from a socket using a single
+ *   system call.
+ *
+ * Parameters:
+ *   sockfd   Socket descriptor of socket
+ *   msgvec   Array of messages to receive
+ *   vlen     Number of entries in msgvec
+ *   flags    Receive flags, see psock_recvmmsg()
+ *   timeout  Optional timeout for the whole batch
+ *
+ * Returned Value:
+ *   On success, returns the number of messages received in msgvec.  On
+ *   error, -1 is returned, and errno is set appropriately (see recvmsg()).
+ *   An error is only returned if no message could be received.
+ *
+ ****************************************************************************/
+
+int recvmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags, FAR struct timespec *timeout)
+{
+  FAR struct socket *psock;
+  FAR struct file *filep;
+  int ret;
+
+  /* recvmmsg() is a cancellation point */
+
+  enter_cancellation_point();
+
+  /* Get the underlying socket structure */
+
+  ret = sockfd_socket(sockfd, &filep, &psock);
+
+  /* Let psock_recvmmsg() do all of the work */
+
+  if (ret == OK)
+    {
+      ret = psock_recvmmsg(psock, msgvec, vlen, flags, timeout);
+      fs_putfilep(filep);
+    }
+
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
+
+#endif /* CONFIG_NET */
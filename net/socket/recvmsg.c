@@ -28,6 +28,7 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <limits.h>
 
 #include <nuttx/cancelpt.h>
 #include <nuttx/fs/fs.h>
@@ -42,35 +43,26 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: psock_recvmsg
+ * Name: psock_recvmsg_timeout
  *
  * Description:
- *   psock_recvmsg() receives messages from a socket, and may be used to
- *   receive data on a socket whether or not it is connection-oriented.
- *   This is an internal OS interface.  It is functionally equivalent to
- *   recvmsg() except that:
- *
- *   - It is not a cancellation point,
- *   - It does not modify the errno variable, and
- *   - It accepts the internal socket structure as an input rather than an
- *     task-specific socket descriptor.
+ *   Same as psock_recvmsg(), but the wait for data is bounded by the
+ *   timeout given instead of the SO_RCVTIMEO option of the socket.
  *
  * Input Parameters:
  *   psock     A pointer to a NuttX-specific, internal socket structure
  *   msg       Buffer to receive data
  *   flags     Receive flags
+ *   timeout   Longest wait in milliseconds, UINT_MAX to wait forever
  *
  * Returned Value:
- *   On success, returns the number of characters received.  If no data is
- *   available to be received and the peer has performed an orderly shutdown,
- *   psock_recvmsg() will return 0.  Otherwise, on any failure, a negated
- *   errno value is returned (see comments with recvmsg() for a list of
- *   appropriate errno values).
+ *   See psock_recvmsg().
  *
  ****************************************************************************/
 
-ssize_t psock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
-                       int flags)
+ssize_t psock_recvmsg_timeout(FAR struct socket *psock,
+                              FAR struct msghdr *msg, int flags,
+                              unsigned int timeout)
 {
   unsigned long msg_controllen;
   FAR void *msg_control;
@@ -112,7 +104,7 @@ ssize_t psock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
   msg_control         = msg->msg_control;
   msg_controllen      = msg->msg_controllen;
 
-  ret = psock->s_sockif->si_recvmsg(psock, msg, flags);
+  ret = psock->s_sockif->si_recvmsg(psock, msg, flags, timeout);
 
   /* Recover the pointer and calculate the cmsg's true data length */
 
@@ -122,6 +114,55 @@ ssize_t psock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
   return ret;
 }
 
+/****************************************************************************
+ * Name: psock_recvmsg
+ *
+ * Description:
+ *   psock_recvmsg() receives messages from a socket, and may be used to
+ *   receive data on a socket whether or not it is connection-oriented.
+ *   This is an internal OS interface.  It is functionally equivalent to
+ *   recvmsg() except that:
+ *
+ *   - It is not a cancellation point,
+ *   - It does not modify the errno variable, and
+ *   - It accepts the internal socket structure as an input rather than an
+ *     task-specific socket descriptor.
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   msg       Buffer to receive data
+ *   flags     Receive flags
+ *
+ * Returned Value:
+ *   On success, returns the number of characters received.  If no data is
+ *   available to be received and the peer has performed an orderly shutdown,
+ *   psock_recvmsg() will return 0.  Otherwise, on any failure, a negated
+ *   errno value is returned (see comments with recvmsg() for a list of
+ *   appropriate errno values).
+ *
+ ****************************************************************************/
+
+ssize_t psock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
+                       int flags)
+{
+#ifdef CONFIG_NET_SOCKOPTS
+  FAR struct socket_conn_s *conn;
+#endif
+  unsigned int timeout = UINT_MAX;
+
+  if (psock == NULL || psock->s_conn == NULL)
+    {
+      return -EBADF;
+    }
+
+#ifdef CONFIG_NET_SOCKOPTS
+  conn    = psock->s_conn;
+  timeout = _SO_TIMEOUT(conn->s_rcvtimeo);
+#endif
+
+  return psock_recvmsg_timeout(psock, msg, flags, timeout);
+}
+
 /****************************************************************************
  * Function: recvmsg
  *
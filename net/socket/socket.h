@@ -94,6 +94,14 @@
 #  define _SO_TIMEOUT(t) (UINT_MAX)
 #endif /* CONFIG_NET_SOCKOPTS */
 
+/* Internet sockets only block through net_sem_timedwait() and friends,
+ * which break the network lock while waiting.  The network lock may then
+ * be held across a whole sendmmsg()/recvmmsg() batch.
+ */
+
+#define _SS_BATCHLOCK(s) \
+  ((s)->s_domain == PF_INET || (s)->s_domain == PF_INET6)
+
 /* Macro to set socket errors */
 
 #ifdef CONFIG_NET_SOCKOPTS
@@ -182,6 +190,28 @@ net_sockif(sa_family_t family, int type, int protocol);
 int net_timeo(clock_t start_time, socktimeo_t timeo);
 #endif
 
+/****************************************************************************
+ * Name: psock_recvmsg_timeout
+ *
+ * Description:
+ *   Same as psock_recvmsg(), but the wait for data is bounded by the
+ *   timeout given instead of the SO_RCVTIMEO option of the socket.
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   msg       Buffer to receive data
+ *   flags     Receive flags
+ *   timeout   Longest wait in milliseconds, UINT_MAX to wait forever
+ *
+ * Returned Value:
+ *   See psock_recvmsg().
+ *
+ ****************************************************************************/
+
+ssize_t psock_recvmsg_timeout(FAR struct socket *psock,
+                              FAR struct msghdr *msg, int flags,
+                              unsigned int timeout);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
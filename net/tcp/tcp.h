@@ -118,6 +118,25 @@
 
 #define TCP_SACK_RANGES_MAX   4
 
+/* The number of disjoint ranges in the out-of-order pool.  Only the first
+ * TCP_SACK_RANGES_MAX of them fit into the SACK option of an ACK.
+ */
+
+#ifdef CONFIG_NET_TCP_OUT_OF_ORDER
+#  define TCP_OFOSEG_MAX      CONFIG_NET_TCP_OUT_OF_ORDER_SEGS
+#endif
+
+/* Check if the retransmission timer of a connection is running.  With the
+ * timer wheel, the shared timer may only be waiting for a delayed ACK, so
+ * conn->timer must be set as well.
+ */
+
+#ifdef CONFIG_NET_TCP_TIMER_WHEEL
+#  define tcp_rto_pending(conn) ((conn)->tpending && (conn)->timer != 0)
+#else
+#  define tcp_rto_pending(conn) (!work_available(&(conn)->work))
+#endif
+
 /* After receiving 3 duplicate ACKs, TCP performs a retransmission
  * (RFC 5681 (3.2))
  */
@@ -168,6 +187,18 @@ struct tcp_ofoseg_s
   FAR struct iob_s *data; /* Out-of-order buffering */
 };
 
+#ifdef CONFIG_NET_STATISTICS
+/* Per-connection loss recovery statistics */
+
+struct tcp_rstats_s
+{
+  uint32_t ofo_queued;    /* Segments queued out of order */
+  uint32_t ofo_dropped;   /* Out-of-order segments dropped or evicted */
+  uint32_t rto_rexmit;    /* Retransmissions after a timeout */
+  uint32_t sack_rexmit;   /* Retransmissions of segments lost per SACK */
+};
+#endif
+
 /* SACK ranges to include in ACK packets. */
 
 struct tcp_sack_s
@@ -226,7 +257,13 @@ struct tcp_conn_s
                            * variable */
   uint8_t  rto;           /* Retransmission time-out */
   uint8_t  tcpstateflags; /* TCP state and flags */
+#ifdef CONFIG_NET_TCP_TIMER_WHEEL
+  dq_entry_t tnode;       /* Link in the timer wheel slot */
+  uint32_t texpiry;       /* Wheel tick of the next expiry */
+  bool     tpending;      /* Linked into the timer wheel */
+#else
   struct   work_s work;   /* TCP timer handle */
+#endif
   bool     timeout;       /* Trigger from timer expiry */
   uint8_t  timer;         /* The retransmission timer (units: half-seconds) */
   uint8_t  nrtx;          /* The number of retransmissions for the last
@@ -304,9 +341,17 @@ struct tcp_conn_s
 
   uint8_t nofosegs;
 
-  /* This defines a out of order segment block. */
+  /* Left edge of the most recently received out-of-order segment */
+
+  uint32_t ofoseq;
+
+  /* The out-of-order ranges, sorted by sequence number */
+
+  struct tcp_ofoseg_s ofosegs[TCP_OFOSEG_MAX];
+#endif
 
-  struct tcp_ofoseg_s ofosegs[TCP_SACK_RANGES_MAX];
+#ifdef CONFIG_NET_STATISTICS
+  struct tcp_rstats_s rstats;    /* Loss recovery statistics */
 #endif
 
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
@@ -326,6 +371,11 @@ struct tcp_conn_s
   uint32_t   isn;         /* Initial sequence number */
   uint32_t   sndseq_max;  /* The sequence number of next not-retransmitted
                            * segment (next greater sndseq) */
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+  clock_t    rack_xmit;   /* Send time of the most recently delivered
+                           * segment (RACK) */
+  uint32_t   sack_high;   /* Highest sequence number SACKed by the peer */
+#endif
 #endif
 
 #ifdef CONFIG_NET_TCPBACKLOG
@@ -413,6 +463,10 @@ struct tcp_wrbuffer_s
                             * segment sent */
 #if defined(CONFIG_NET_TCP_FAST_RETRANSMIT) && !defined(CONFIG_NET_TCP_CC_NEWRENO)
   uint8_t    wb_nack;      /* The number of ack count */
+#endif
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+  bool       wb_sacked;    /* The peer has selectively ACKed this segment */
+  clock_t    wb_xmit;      /* Time the segment was last (re)transmitted */
 #endif
   struct iob_s *wb_iob;    /* Head of the I/O buffer chain */
 };
@@ -1046,6 +1100,103 @@ void tcp_update_keeptimer(FAR struct tcp_conn_s *conn, int timeout);
 
 void tcp_stop_timer(FAR struct tcp_conn_s *conn);
 
+/****************************************************************************
+ * Name: tcp_wheel_update
+ *
+ * Description:
+ *   (Re-)arm the timer wheel entry of the provided TCP connection.  The
+ *   expiry is rounded up to a wheel tick so that the connection never
+ *   expires early and all connections due in the same half second are
+ *   handled together.  A zero timeout expires on the next tick.
+ *
+ * Input Parameters:
+ *   conn    - The TCP "connection" to poll for TX data
+ *   timeout - Time for the next timeout (units: half-seconds)
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *   conn is not NULL and timeout is not negative.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_TIMER_WHEEL
+void tcp_wheel_update(FAR struct tcp_conn_s *conn, int timeout);
+#endif
+
+/****************************************************************************
+ * Name: tcp_wheel_cancel
+ *
+ * Description:
+ *   Remove the provided TCP connection from the timer wheel
+ *
+ * Input Parameters:
+ *   conn - The TCP "connection" to poll for TX data
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *   conn is not NULL.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_TIMER_WHEEL
+void tcp_wheel_cancel(FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: tcp_timewait_add
+ *
+ * Description:
+ *   Remember a connection that is freed in the TIME_WAIT state for the
+ *   rest of its TIME_WAIT period.  Only the addresses, the ports and the
+ *   expiry are kept.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection being freed
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_TCP_TIMER_WHEEL) && CONFIG_NET_TCP_TIMEWAIT_ENTRIES > 0
+void tcp_timewait_add(FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: tcp_timewait_input
+ *
+ * Description:
+ *   Handle a segment that matches no connection but belongs to a
+ *   connection remembered in the TIME_WAIT table.  Such segments (usually
+ *   a retransmitted FIN) are acknowledged; resets are silently dropped.
+ *
+ * Input Parameters:
+ *   dev - The device driver structure holding the received segment
+ *   tcp - The TCP header of the received segment
+ *
+ * Returned Value:
+ *   true if the segment was handled here; false if it should be answered
+ *   with a reset as usual.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_TCP_TIMER_WHEEL) && CONFIG_NET_TCP_TIMEWAIT_ENTRIES > 0
+bool tcp_timewait_input(FAR struct net_driver_s *dev,
+                        FAR struct tcp_hdr_s *tcp);
+#endif
+
 /****************************************************************************
  * Name: tcp_findlistener
  *
@@ -1192,6 +1343,31 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
 
 void tcp_reset(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn);
 
+/****************************************************************************
+ * Name: tcp_reply
+ *
+ * Description:
+ *   Turn the received segment in the device buffer into a no-data reply
+ *   with the given flags.  The sequence number is taken from the ACK of
+ *   the received segment and the received segment is acknowledged.
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure to use in the send operation
+ *   conn   - The TCP connection structure holding connection information,
+ *            may be NULL
+ *   flags  - The TCP flags of the reply
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+void tcp_reply(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
+               uint8_t flags);
+
 /****************************************************************************
  * Name: tcp_rx_mss
  *
@@ -1567,6 +1743,7 @@ int psock_tcp_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
  *   psock    Pointer to the socket structure for the SOCK_DRAM socket
  *   msg      Receive info and buffer for receive data
  *   flags    Receive flags
+ *   timeout  Receive timeout in milliseconds, UINT_MAX for none
  *
  * Returned Value:
  *   On success, returns the number of characters received.  On  error,
@@ -1577,7 +1754,7 @@ int psock_tcp_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
  ****************************************************************************/
 
 ssize_t psock_tcp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
-                           int flags);
+                           int flags, unsigned int timeout);
 
 /****************************************************************************
  * Name: psock_tcp_send
@@ -144,6 +144,11 @@ void tcp_appsend(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
            */
 
           conn->rx_unackseg = 1;
+#ifdef CONFIG_NET_TCP_TIMER_WHEEL
+          /* Make sure that the ACK is not delayed for too long */
+
+          tcp_update_timer(conn);
+#endif
           return;
         }
     }
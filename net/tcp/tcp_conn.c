@@ -900,6 +900,15 @@ void tcp_free(FAR struct tcp_conn_s *conn)
 
   tcp_stop_timer(conn);
 
+#if defined(CONFIG_NET_TCP_TIMER_WHEEL) && CONFIG_NET_TCP_TIMEWAIT_ENTRIES > 0
+  /* Keep answering for the connection until TIME_WAIT is over */
+
+  if (conn->tcpstateflags == TCP_TIME_WAIT)
+    {
+      tcp_timewait_add(conn);
+    }
+#endif
+
   /* Make sure monitor is stopped. */
 
   tcp_stop_monitor(conn, TCP_CLOSE);
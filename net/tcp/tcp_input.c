@@ -55,6 +55,7 @@
 #include <assert.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/netstats.h>
@@ -268,81 +269,150 @@ static bool tcp_snd_wnd_update(FAR struct tcp_conn_s *conn,
 #ifdef CONFIG_NET_TCP_OUT_OF_ORDER
 
 /****************************************************************************
- * Name: tcp_rebuild_ofosegs
+ * Name: tcp_ofoseg_find
  *
  * Description:
- *   Re-build out-of-order pool from incoming segment
+ *   Find the first out-of-order range that ends at or after 'seq'.  The
+ *   ranges are kept sorted by sequence number, disjoint and not adjacent.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection of interest
+ *   seq  - The sequence number to look up
+ *
+ * Returned Value:
+ *   Index of the range, conn->nofosegs if all ranges end before 'seq'
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static int tcp_ofoseg_find(FAR struct tcp_conn_s *conn, uint32_t seq)
+{
+  int low = 0;
+  int high = conn->nofosegs;
+
+  while (low < high)
+    {
+      int mid = (low + high) >> 1;
+
+      if (TCP_SEQ_LT(conn->ofosegs[mid].right, seq))
+        {
+          low = mid + 1;
+        }
+      else
+        {
+          high = mid;
+        }
+    }
+
+  return low;
+}
+
+/****************************************************************************
+ * Name: tcp_ofoseg_evict
+ *
+ * Description:
+ *   Drop the out-of-order range with the highest sequence numbers, the one
+ *   that is needed last.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection of interest
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void tcp_ofoseg_evict(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_ofoseg_s *seg = &conn->ofosegs[--conn->nofosegs];
+
+  ninfo("TCP OFOSEG evict [%" PRIu32 " : %" PRIu32 "]\n",
+        seg->left, seg->right);
+
+  iob_free_chain(seg->data);
+  seg->data = NULL;
+
+#ifdef CONFIG_NET_STATISTICS
+  conn->rstats.ofo_dropped++;
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_insert_ofoseg
+ *
+ * Description:
+ *   Insert an incoming segment into the out-of-order pool, merging it with
+ *   every range that it overlaps or touches.  If the pool is full, the
+ *   range with the highest sequence numbers gives way to data that is
+ *   needed earlier.
  *
  * Input Parameters:
  *   conn   - The TCP connection of interest
- *   ofoseg - Pointer to incoming out-of-order segment
- *   start  - Index of start postion of segment pool
+ *   ofoseg - The incoming segment; its data is always consumed
  *
  * Returned Value:
- *   True if incoming data has been consumed
+ *   None
  *
  * Assumptions:
  *   The network is locked.
  *
  ****************************************************************************/
 
-static bool tcp_rebuild_ofosegs(FAR struct tcp_conn_s *conn,
-                                FAR struct tcp_ofoseg_s *ofoseg,
-                                int start)
+static void tcp_insert_ofoseg(FAR struct tcp_conn_s *conn,
+                              FAR struct tcp_ofoseg_s *ofoseg)
 {
-  struct tcp_ofoseg_s *seg;
-  int i;
+  FAR struct tcp_ofoseg_s *seg;
+  int first;
+  int last;
 
-  for (i = start; i < conn->nofosegs && ofoseg->data != NULL; i++)
+  first = tcp_ofoseg_find(conn, ofoseg->left);
+
+  for (last = first; last < conn->nofosegs; last++)
     {
-      seg = &conn->ofosegs[i];
+      seg = &conn->ofosegs[last];
 
-      /* ofoseg    |~~~
-       * segpool |---|
+      /* ofoseg  |---|
+       * segpool       |---|
        */
 
-      if (TCP_SEQ_GTE(ofoseg->left, seg->left))
+      if (TCP_SEQ_GT(seg->left, ofoseg->right))
         {
-          /* ofoseg        |---|
-           * segpool |---|
-           */
-
-          if (TCP_SEQ_GT(ofoseg->left, seg->right))
-            {
-              continue;
-            }
-
-          /* ofoseg      |---|
-           * segpool |---|
-           */
+          break;
+        }
 
-          else if (ofoseg->left == seg->right)
-            {
-              net_iob_concat(&seg->data, &ofoseg->data);
-              seg->right = ofoseg->right;
-            }
+      /* ofoseg    |~~~
+       * segpool |---|
+       */
 
+      if (TCP_SEQ_LTE(seg->left, ofoseg->left))
+        {
           /* ofoseg   |--|
            * segpool |---|
            */
 
-          else if (TCP_SEQ_LTE(ofoseg->right, seg->right))
+          if (TCP_SEQ_GTE(seg->right, ofoseg->right))
             {
               iob_free_chain(ofoseg->data);
-              ofoseg->data = NULL;
+              *ofoseg = *seg;
             }
 
           /* ofoseg    |---|
            * segpool |---|
            */
 
-          else if (TCP_SEQ_GT(ofoseg->right, seg->right))
+          else
             {
               ofoseg->data =
                 iob_trimhead(ofoseg->data,
                              TCP_SEQ_SUB(seg->right, ofoseg->left));
               net_iob_concat(&seg->data, &ofoseg->data);
-              seg->right = ofoseg->right;
+              ofoseg->data = seg->data;
+              ofoseg->left = seg->left;
             }
         }
 
@@ -352,56 +422,63 @@ static bool tcp_rebuild_ofosegs(FAR struct tcp_conn_s *conn,
 
       else
         {
-          /* ofoseg  |---|
-           * segpool     |---|
-           */
-
-          if (ofoseg->right == seg->left)
-            {
-              net_iob_concat(&ofoseg->data, &seg->data);
-              seg->data = ofoseg->data;
-              seg->left = ofoseg->left;
-              ofoseg->data = NULL;
-            }
-
-          /* ofoseg  |---|
-           * segpool       |---|
-           */
-
-          else if (TCP_SEQ_LT(ofoseg->right, seg->left))
-            {
-              continue;
-            }
-
           /* ofoseg  |---|~|
            * segpool  |--|
            */
 
-          else if (TCP_SEQ_GTE(ofoseg->right, seg->right))
+          if (TCP_SEQ_LTE(seg->right, ofoseg->right))
             {
               iob_free_chain(seg->data);
-              *seg = *ofoseg;
-              ofoseg->data = NULL;
             }
 
           /* ofoseg  |---|
            * segpool   |---|
            */
 
-          else if (TCP_SEQ_GT(ofoseg->right, seg->left))
+          else
             {
-              ofoseg->data =
-                iob_trimtail(ofoseg->data,
-                             ofoseg->right - seg->left);
+              seg->data =
+                iob_trimhead(seg->data,
+                             TCP_SEQ_SUB(ofoseg->right, seg->left));
               net_iob_concat(&ofoseg->data, &seg->data);
-              seg->data = ofoseg->data;
-              seg->left = ofoseg->left;
-              ofoseg->data = NULL;
+              ofoseg->right = seg->right;
             }
         }
+
+      seg->data = NULL;
+    }
+
+  if (last > first)
+    {
+      /* The ranges first..last-1 collapse into one */
+
+      conn->ofosegs[first] = *ofoseg;
+      memmove(&conn->ofosegs[first + 1], &conn->ofosegs[last],
+              (conn->nofosegs - last) * sizeof(struct tcp_ofoseg_s));
+      conn->nofosegs -= last - first - 1;
+      return;
+    }
+
+  /* A new hole.  Make room if the pool is full. */
+
+  if (conn->nofosegs == TCP_OFOSEG_MAX)
+    {
+      if (first == conn->nofosegs)
+        {
+          iob_free_chain(ofoseg->data);
+#ifdef CONFIG_NET_STATISTICS
+          conn->rstats.ofo_dropped++;
+#endif
+          return;
+        }
+
+      tcp_ofoseg_evict(conn);
     }
 
-  return (ofoseg->data == NULL);
+  memmove(&conn->ofosegs[first + 1], &conn->ofosegs[first],
+          (conn->nofosegs - first) * sizeof(struct tcp_ofoseg_s));
+  conn->ofosegs[first] = *ofoseg;
+  conn->nofosegs++;
 }
 
 /****************************************************************************
@@ -428,28 +505,33 @@ static void tcp_input_ofosegs(FAR struct net_driver_s *dev,
                               unsigned int iplen)
 {
   struct tcp_ofoseg_s ofoseg;
-  bool rebuild;
-  int i = 0;
+  int bufsize;
+  int i;
   int len;
 
   ofoseg.left =
     tcp_getsequence(((FAR struct tcp_hdr_s *)IPBUF(iplen))->seqno);
 
-  /* Calculate the pending size of out-of-order cache, if the input edge can
-   * not fill the adjacent segments, drop it
+  /* Get left/right edge from incoming data */
+
+  len = (dev->d_appdata - dev->d_iob->io_data) - dev->d_iob->io_offset;
+  ofoseg.right = TCP_SEQ_ADD(ofoseg.left, dev->d_iob->io_pktlen - len);
+
+  /* If the out-of-order cache is full, only data that is needed before
+   * the last cached range is worth taking.
    */
 
-  if (tcp_ofoseg_bufsize(conn) > CONFIG_NET_TCP_OUT_OF_ORDER_BUFSIZE &&
-      ofoseg.left >= conn->ofosegs[0].left)
+  bufsize = tcp_ofoseg_bufsize(conn);
+  if (bufsize + (int)TCP_SEQ_SUB(ofoseg.right, ofoseg.left) >
+      CONFIG_NET_TCP_OUT_OF_ORDER_BUFSIZE && conn->nofosegs > 0 &&
+      TCP_SEQ_GTE(ofoseg.left, conn->ofosegs[conn->nofosegs - 1].left))
     {
+#ifdef CONFIG_NET_STATISTICS
+      conn->rstats.ofo_dropped++;
+#endif
       return;
     }
 
-  /* Get left/right edge from incoming data */
-
-  len = (dev->d_appdata - dev->d_iob->io_data) - dev->d_iob->io_offset;
-  ofoseg.right = TCP_SEQ_ADD(ofoseg.left, dev->d_iob->io_pktlen - len);
-
   ninfo("TCP OFOSEG out-of-order "
         "[%" PRIu32 " : %" PRIu32 " : %" PRIu32 "]\n",
         ofoseg.left, ofoseg.right, TCP_SEQ_SUB(ofoseg.right, ofoseg.left));
@@ -466,44 +548,25 @@ static void tcp_input_ofosegs(FAR struct net_driver_s *dev,
 
   ofoseg.data = dev->d_iob;
 
-  /* Build out-of-order pool */
-
-  rebuild = tcp_rebuild_ofosegs(conn, &ofoseg, 0);
+  /* Remember the most recent segment, it is reported first in the SACK
+   * option (RFC 2018).
+   */
 
-  /* Incoming segment out of order from existing pool, add to new segment */
+  conn->ofoseq = ofoseg.left;
+#ifdef CONFIG_NET_STATISTICS
+  conn->rstats.ofo_queued++;
+#endif
 
-  if (!rebuild && conn->nofosegs != TCP_SACK_RANGES_MAX)
-    {
-      conn->ofosegs[conn->nofosegs] = ofoseg;
-      conn->nofosegs++;
-      rebuild = true;
-    }
+  tcp_insert_ofoseg(conn, &ofoseg);
 
-  /* Try Re-order ofosegs */
+  /* Keep the pool within its memory budget, giving up the data that is
+   * needed last.
+   */
 
-  if (rebuild &&
-      tcp_reorder_ofosegs(conn->nofosegs, (FAR void *)conn->ofosegs))
+  while (conn->nofosegs > 0 &&
+         tcp_ofoseg_bufsize(conn) > CONFIG_NET_TCP_OUT_OF_ORDER_BUFSIZE)
     {
-      /* Re-build out-of-order pool after re-order */
-
-      while (i < conn->nofosegs - 1)
-        {
-          if (tcp_rebuild_ofosegs(conn, &conn->ofosegs[i], i + 1))
-            {
-              for (; i < conn->nofosegs - 1; i++)
-                {
-                  conn->ofosegs[i] = conn->ofosegs[i + 1];
-                }
-
-              conn->nofosegs--;
-
-              i = 0;
-            }
-          else
-            {
-              i++;
-            }
-        }
+      tcp_ofoseg_evict(conn);
     }
 
   for (i = 0; i < conn->nofosegs; i++)
@@ -517,10 +580,7 @@ static void tcp_input_ofosegs(FAR struct net_driver_s *dev,
    * response.
    */
 
-  if (rebuild)
-    {
-      netdev_iob_clear(dev);
-    }
+  netdev_iob_clear(dev);
 
 prepare:
   netdev_iob_prepare(dev, false, 0);
@@ -869,6 +929,15 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
         }
     }
 
+#if defined(CONFIG_NET_TCP_TIMER_WHEEL) && CONFIG_NET_TCP_TIMEWAIT_ENTRIES > 0
+  /* A late segment of a connection that was freed in TIME_WAIT? */
+
+  if (tcp_timewait_input(dev, tcp))
+    {
+      return;
+    }
+#endif
+
   nwarn("WARNING: SYN with no listener (or old packet) .. reset\n");
 
   /* This is (1) an old duplicate packet or (2) a SYN packet but with
@@ -1303,6 +1372,10 @@ found:
             tcp_setsequence(conn->sndseq, conn->isn);
             conn->sent          = 0;
             conn->sndseq_max    = 0;
+#  ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+            conn->sack_high     = conn->isn;
+            conn->rack_xmit     = clock_systime_ticks();
+#  endif
 #endif
             conn->tx_unacked    = 0;
             tcp_snd_wnd_init(conn, tcp);
@@ -1369,6 +1442,10 @@ found:
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
             conn->isn           = tcp_getsequence(tcp->ackno);
             tcp_setsequence(conn->sndseq, conn->isn);
+#  ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+            conn->sack_high     = conn->isn;
+            conn->rack_xmit     = clock_systime_ticks();
+#  endif
 #endif
             dev->d_len          = 0;
             dev->d_sndlen       = 0;
@@ -645,6 +645,7 @@ static void tcp_notify_recvcpu(FAR struct tcp_conn_s *conn)
  *   psock    Pointer to the socket structure for the SOCK_DRAM socket
  *   msg      Receive info and buffer for receive data
  *   flags    Receive flags
+ *   timeout  Receive timeout in milliseconds, UINT_MAX for none
  *
  * Returned Value:
  *   On success, returns the number of characters received.  On  error,
@@ -655,7 +656,7 @@ static void tcp_notify_recvcpu(FAR struct tcp_conn_s *conn)
  ****************************************************************************/
 
 ssize_t psock_tcp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
-                           int flags)
+                           int flags, unsigned int timeout)
 {
   FAR struct sockaddr   *from    = msg->msg_name;
   FAR socklen_t         *fromlen = &msg->msg_namelen;
@@ -785,8 +786,7 @@ ssize_t psock_tcp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
            * received.
            */
 
-          ret = net_sem_timedwait(&state.ir_sem,
-                               _SO_TIMEOUT(conn->sconn.s_rcvtimeo));
+          ret = net_sem_timedwait(&state.ir_sem, timeout);
           tls_cleanup_pop(tls_get_info(), 0);
           if (ret == -ETIMEDOUT)
             {
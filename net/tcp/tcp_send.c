@@ -149,7 +149,7 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
     }
   else
     {
-      if (work_available(&conn->work) && conn->tx_unacked != 0)
+      if (!tcp_rto_pending(conn) && conn->tx_unacked != 0)
         {
           conn->timeout = false;
           tcp_update_retrantimer(conn, conn->rto);
@@ -300,9 +300,35 @@ void tcp_send(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 #ifdef CONFIG_NET_TCP_SELECTIVE_ACK
   if ((conn->flags & TCP_SACK) && (flags == TCP_ACK) && conn->nofosegs > 0)
     {
-      int optlen = conn->nofosegs * sizeof(struct tcp_sack_s);
+      FAR struct tcp_ofoseg_s *sacks[TCP_SACK_RANGES_MAX];
+      int nsacks = 0;
+      int optlen;
       int i;
 
+      /* Per RFC 2018, the first block reports the range holding the most
+       * recently received segment, the others follow in sequence order.
+       */
+
+      for (i = 0; i < conn->nofosegs; i++)
+        {
+          if (TCP_SEQ_GTE(conn->ofoseq, conn->ofosegs[i].left) &&
+              TCP_SEQ_LT(conn->ofoseq, conn->ofosegs[i].right))
+            {
+              sacks[nsacks++] = &conn->ofosegs[i];
+              break;
+            }
+        }
+
+      for (i = 0; i < conn->nofosegs && nsacks < TCP_SACK_RANGES_MAX; i++)
+        {
+          if (nsacks == 0 || sacks[0] != &conn->ofosegs[i])
+            {
+              sacks[nsacks++] = &conn->ofosegs[i];
+            }
+        }
+
+      optlen = nsacks * sizeof(struct tcp_sack_s);
+
       tcp->optdata[0] = TCP_OPT_NOOP;
       tcp->optdata[1] = TCP_OPT_NOOP;
       tcp->optdata[2] = TCP_OPT_SACK;
@@ -310,16 +336,16 @@ void tcp_send(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 
       optlen += 4;
 
-      for (i = 0; i < conn->nofosegs; i++)
+      for (i = 0; i < nsacks; i++)
         {
           ninfo("TCP SACK [%d]"
                 "[%" PRIu32 " : %" PRIu32 " : %" PRIu32 "]\n", i,
-                conn->ofosegs[i].left, conn->ofosegs[i].right,
-                TCP_SEQ_SUB(conn->ofosegs[i].right, conn->ofosegs[i].left));
+                sacks[i]->left, sacks[i]->right,
+                TCP_SEQ_SUB(sacks[i]->right, sacks[i]->left));
           tcp_setsequence(&tcp->optdata[4 + i * 2 * sizeof(uint32_t)],
-                          conn->ofosegs[i].left);
+                          sacks[i]->left);
           tcp_setsequence(&tcp->optdata[4 + (i * 2 + 1) * sizeof(uint32_t)],
-                          conn->ofosegs[i].right);
+                          sacks[i]->right);
         }
 
       dev->d_len += optlen;
@@ -363,13 +389,17 @@ void tcp_send(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 }
 
 /****************************************************************************
- * Name: tcp_reset
+ * Name: tcp_reply
  *
  * Description:
- *   Send a TCP reset (no-data) message
+ *   Turn the received segment in the device buffer into a no-data reply
+ *   with the given flags.
  *
  * Input Parameters:
  *   dev    - The device driver structure to use in the send operation
+ *   conn   - The TCP connection structure holding connection information,
+ *            may be NULL
+ *   flags  - The TCP flags of the reply
  *
  * Returned Value:
  *   None
@@ -379,7 +409,8 @@ void tcp_send(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
  *
  ****************************************************************************/
 
-void tcp_reset(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
+void tcp_reply(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
+               uint8_t flags)
 {
   FAR struct tcp_hdr_s *tcp;
   uint32_t ackno;
@@ -392,10 +423,6 @@ void tcp_reset(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
       return;
     }
 
-#ifdef CONFIG_NET_STATISTICS
-  g_netstats.tcp.rst++;
-#endif
-
   /* TCP setup */
 
   tcp = tcp_header(dev);
@@ -437,7 +464,7 @@ void tcp_reset(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
 
   acklen        -= (tcp->tcpoffset >> 4) << 2;
 
-  tcp->flags     = TCP_RST | TCP_ACK;
+  tcp->flags     = flags;
   tcp->tcpoffset = 5 << 4;
 
   /* Flip the seqno and ackno fields in the TCP header. */
@@ -529,6 +556,37 @@ void tcp_reset(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
 #endif /* CONFIG_NET_IPv4 */
 }
 
+/****************************************************************************
+ * Name: tcp_reset
+ *
+ * Description:
+ *   Send a TCP reset (no-data) message
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure to use in the send operation
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+void tcp_reset(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
+{
+  if (dev->d_iob == NULL)
+    {
+      return;
+    }
+
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.tcp.rst++;
+#endif
+
+  tcp_reply(dev, conn, TCP_RST | TCP_ACK);
+}
+
 /****************************************************************************
  * Name: tcp_rx_mss
  *
@@ -49,6 +49,7 @@
 #include <debug.h>
 
 #include <arch/irq.h>
+#include <nuttx/clock.h>
 #include <nuttx/tls.h>
 #include <nuttx/net/net.h>
 #include <nuttx/mm/iob.h>
@@ -235,6 +236,9 @@ static void retransmit_segment(FAR struct tcp_conn_s *conn,
         }
 
       TCP_WBSENT(wrb) = 0;
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+      wrb->wb_sacked = false;
+#endif
 
       /* Insert the write buffer into the write_q (in sequence
        * number order).  The retransmission will occur below
@@ -410,6 +414,143 @@ static int parse_sack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp,
 
   return nsack;
 }
+
+/****************************************************************************
+ * Name: psock_sack_update
+ *
+ * Description:
+ *   Update the scoreboard of the un-ACKed write buffers from the SACK
+ *   blocks of an incoming ACK.  Write buffers fully covered by a block are
+ *   marked as SACKed, and the send time of the most recently delivered
+ *   segment is recorded for the time-based loss detection (RACK, RFC 8985).
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   segs   - The SACK blocks, sorted by sequence number
+ *   nsacks - Number of SACK blocks
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void psock_sack_update(FAR struct tcp_conn_s *conn,
+                              FAR struct tcp_ofoseg_s *segs, int nsacks)
+{
+  FAR struct tcp_wrbuffer_s *wrb;
+  FAR sq_entry_t *entry;
+  uint32_t lastseq;
+  int i;
+
+  for (entry = sq_peek(&conn->unacked_q); entry; entry = sq_next(entry))
+    {
+      wrb = (FAR struct tcp_wrbuffer_s *)entry;
+      if (wrb->wb_sacked)
+        {
+          continue;
+        }
+
+      lastseq = TCP_SEQ_ADD(TCP_WBSEQNO(wrb), TCP_WBPKTLEN(wrb));
+      for (i = 0; i < nsacks; i++)
+        {
+          if (TCP_SEQ_GTE(TCP_WBSEQNO(wrb), segs[i].left) &&
+              TCP_SEQ_LTE(lastseq, segs[i].right))
+            {
+              wrb->wb_sacked = true;
+
+              /* Only segments sent once tell when the data left us */
+
+              if (TCP_WBNRTX(wrb) == 0 &&
+                  (sclock_t)(wrb->wb_xmit - conn->rack_xmit) > 0)
+                {
+                  conn->rack_xmit = wrb->wb_xmit;
+                }
+
+              if (TCP_SEQ_GT(lastseq, conn->sack_high))
+                {
+                  conn->sack_high = lastseq;
+                }
+
+              break;
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: psock_sack_rexmit
+ *
+ * Description:
+ *   Retransmit the un-ACKed write buffers that the scoreboard marks as
+ *   lost.  A hole below the highest SACKed sequence number is lost once
+ *   the duplicate ACK threshold has been reached, or when a segment sent
+ *   more than a reordering window later than it has already been
+ *   delivered.  The reordering window is a quarter of the smoothed RTT.
+ *
+ * Input Parameters:
+ *   conn      - The TCP connection of interest
+ *   dupthresh - The duplicate ACK threshold has been reached
+ *
+ * Returned Value:
+ *   Number of write buffers queued for retransmission
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static int psock_sack_rexmit(FAR struct tcp_conn_s *conn, bool dupthresh)
+{
+  FAR struct tcp_wrbuffer_s *wrb;
+  FAR sq_entry_t *entry;
+  FAR sq_entry_t *next;
+  sclock_t reo_wnd;
+  int nrexmit = 0;
+
+  reo_wnd = HSEC2TICK(conn->sa) / 32;
+  if (reo_wnd < 1)
+    {
+      reo_wnd = 1;
+    }
+
+  for (entry = sq_peek(&conn->unacked_q); entry; entry = next)
+    {
+      wrb  = (FAR struct tcp_wrbuffer_s *)entry;
+      next = sq_next(entry);
+
+      /* The unacked_q is in sequence number order */
+
+      if (!TCP_SEQ_LT(TCP_WBSEQNO(wrb), conn->sack_high))
+        {
+          break;
+        }
+
+      if (wrb->wb_sacked ||
+          (!dupthresh &&
+           (sclock_t)(conn->rack_xmit - wrb->wb_xmit) <= reo_wnd))
+        {
+          continue;
+        }
+
+      ninfo("TCP REXMIT "
+            "[%" PRIu32 " : %" PRIu32 " : %d]\n",
+            TCP_WBSEQNO(wrb),
+            TCP_SEQ_ADD(TCP_WBSEQNO(wrb), TCP_WBPKTLEN(wrb)),
+            TCP_WBPKTLEN(wrb));
+
+      sq_rem(entry, &conn->unacked_q);
+      retransmit_segment(conn, wrb);
+#ifdef CONFIG_NET_STATISTICS
+      conn->rstats.sack_rexmit++;
+#endif
+      nrexmit++;
+    }
+
+  return nrexmit;
+}
 #endif /* CONFIG_NET_TCP_SELECTIVE_ACK */
 
 /****************************************************************************
@@ -438,6 +579,7 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
   FAR struct tcp_conn_s *conn = pvpriv;
 #ifdef CONFIG_NET_TCP_SELECTIVE_ACK
   struct tcp_ofoseg_s ofosegs[TCP_SACK_RANGES_MAX];
+  bool dupthresh = false;
   uint8_t nsacks = 0;
 #endif
 #ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
@@ -508,6 +650,29 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
       ackno = tcp_getsequence(tcp->ackno);
       ninfo("ACK: ackno=%" PRIu32 " flags=%04x\n", ackno, flags);
 
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+      /* Nothing below the cumulative ACK can be a hole */
+
+      if (TCP_SEQ_LT(conn->sack_high, ackno))
+        {
+          conn->sack_high = ackno;
+        }
+
+      /* Update the scoreboard from the SACK blocks of every ACK, not only
+       * when the duplicate ACK threshold is reached.
+       */
+
+      if ((conn->flags & TCP_SACK) &&
+          (tcp->tcpoffset & 0xf0) > 0x50)
+        {
+          nsacks = parse_sack(conn, tcp, ofosegs);
+          if (nsacks > 0)
+            {
+              psock_sack_update(conn, ofosegs, nsacks);
+            }
+        }
+#endif
+
       /* Look at every write buffer in the unacked_q.  The unacked_q
        * holds write buffers that have been entirely sent, but which
        * have not yet been ACKed.
@@ -543,6 +708,14 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
                 {
                   ninfo("ACK: wrb=%p Freeing write buffer\n", wrb);
 
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+                  if (TCP_WBNRTX(wrb) == 0 &&
+                      (sclock_t)(wrb->wb_xmit - conn->rack_xmit) > 0)
+                    {
+                      conn->rack_xmit = wrb->wb_xmit;
+                    }
+#endif
+
                   /* Yes... Remove the write buffer from ACK waiting queue */
 
                   sq_rem(entry, &conn->unacked_q);
@@ -615,13 +788,13 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
                     }
 
 #ifdef CONFIG_NET_TCP_SELECTIVE_ACK
-                  if ((conn->flags & TCP_SACK) &&
-                      (tcp->tcpoffset & 0xf0) > 0x50)
+                  if (nsacks > 0)
                     {
-                      /* Parse s-ack from tcp options */
-
-                      nsacks = parse_sack(conn, tcp, ofosegs);
+                      /* Every hole below the highest SACKed segment is
+                       * considered lost now.
+                       */
 
+                      dupthresh = true;
                       flags |= TCP_REXMIT;
                     }
 #ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
@@ -791,6 +964,10 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
             }
 #endif
 
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+          wrb->wb_xmit = clock_systime_ticks();
+#endif
+
           /* Reset the retransmission timer. */
 
           tcp_update_retrantimer(conn, conn->rto);
@@ -804,19 +981,15 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 
 #ifdef CONFIG_NET_TCP_SELECTIVE_ACK
 
-  /* Check if we are being asked to retransmit s-ack data */
+  /* Check if the SACK scoreboard reports lost segments */
 
   if (nsacks > 0)
     {
-      FAR struct tcp_wrbuffer_s *wrb;
-      FAR sq_entry_t *entry;
-      FAR sq_entry_t *next;
-      uint32_t right;
       int i;
 
       /* Dump s-ack edge */
 
-      for (i = 0, right = 0; i < nsacks; i++)
+      for (i = 0; i < nsacks; i++)
         {
           ninfo("TCP SACK [%d]"
                 "[%" PRIu32 " : %" PRIu32 " : %" PRIu32 "]\n",
@@ -824,31 +997,9 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
                 TCP_SEQ_SUB(ofosegs[i].right, ofosegs[i].left));
         }
 
-      for (entry = sq_peek(&conn->unacked_q); entry; entry = next)
+      if (psock_sack_rexmit(conn, dupthresh) > 0)
         {
-          wrb  = (FAR struct tcp_wrbuffer_s *)entry;
-          next = sq_next(entry);
-
-          for (i = 0, right = 0; i < nsacks; i++)
-            {
-              /* Wrb seqno out of s-ack edge ? do retransmit ! */
-
-              if (TCP_SEQ_LT(TCP_WBSEQNO(wrb), ofosegs[i].left) &&
-                  TCP_SEQ_GTE(TCP_WBSEQNO(wrb), right))
-                {
-                  ninfo("TCP REXMIT "
-                        "[%" PRIu32 " : %" PRIu32 " : %d]\n",
-                        TCP_WBSEQNO(wrb),
-                        TCP_SEQ_ADD(TCP_WBSEQNO(wrb), TCP_WBPKTLEN(wrb)),
-                        TCP_WBPKTLEN(wrb));
-                  sq_rem(entry, &conn->unacked_q);
-                  retransmit_segment(conn, (FAR void *)entry);
-                  break;
-                }
-
-              right = ofosegs[i].right;
-            }
-        }
+          flags |= TCP_REXMIT;
 
 #ifdef CONFIG_NET_TCP_CC_NEWRENO
           /* After Fast retransmitted, set ssthresh to the maximum of
@@ -862,6 +1013,7 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
               tcp_cc_update(conn, NULL);
             }
 #endif
+        }
     }
   else
 #endif
@@ -956,6 +1108,18 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
             }
         }
 
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+      /* The retransmission timeout discards the SACK information
+       * (RFC 2018, section 8).
+       */
+
+      wrb = (FAR struct tcp_wrbuffer_s *)sq_peek(&conn->unacked_q);
+      if (wrb != NULL)
+        {
+          conn->sack_high = TCP_WBSEQNO(wrb);
+        }
+
+#endif
       /* Move all segments that have been sent but not ACKed to the write
        * queue again note, the un-ACKed segments are put at the head of the
        * write_q so they can be resent as soon as possible.
@@ -1156,6 +1320,10 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 
               ninfo("SEND: wrb=%p Move to unacked_q\n", wrb);
 
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+              wrb->wb_xmit = clock_systime_ticks();
+#endif
+
               tmp = (FAR struct tcp_wrbuffer_s *)sq_remfirst(&conn->write_q);
               DEBUGASSERT(tmp == wrb);
               UNUSED(tmp);
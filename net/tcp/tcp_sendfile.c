@@ -73,6 +73,7 @@ struct sendfile_s
   FAR struct tcp_conn_s *snd_conn;         /* Connection associated with the socket */
   FAR struct devif_callback_s *snd_cb;     /* Reference to callback instance */
   FAR struct file   *snd_file;             /* File structure of the input file */
+  FAR const uint8_t *snd_map;              /* Direct mapping of the input file */
   sem_t              snd_sem;              /* Used to wake up the waiting thread */
   off_t              snd_foffset;          /* Input file offset */
   size_t             snd_flen;             /* File length */
@@ -96,6 +97,37 @@ struct sendfile_s
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: sendfile_fill
+ *
+ * Description:
+ *   Set up the outgoing packet with 'len' bytes of file data starting at
+ *   'offset' bytes from the start of the transfer.  If the input file is
+ *   memory backed, the data is copied into the device buffer directly from
+ *   the file content, otherwise it is read from the file.
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+static int sendfile_fill(FAR struct net_driver_s *dev,
+                         FAR struct sendfile_s *pstate,
+                         uint32_t offset, uint32_t len)
+{
+  FAR struct tcp_conn_s *conn = pstate->snd_conn;
+
+  if (pstate->snd_map != NULL)
+    {
+      return devif_send(dev, pstate->snd_map + offset, len,
+                        tcpip_hdrsize(conn));
+    }
+
+  return devif_file_send(dev, pstate->snd_file, len,
+                         pstate->snd_foffset + offset,
+                         tcpip_hdrsize(conn));
+}
+
 /****************************************************************************
  * Name: sendfile_eventhandler
  *
@@ -269,9 +301,7 @@ static uint16_t sendfile_eventhandler(FAR struct net_driver_s *dev,
        * happen until the polling cycle completes).
        */
 
-      ret = devif_file_send(dev, pstate->snd_file, sndlen,
-                            pstate->snd_foffset + pstate->snd_acked,
-                            tcpip_hdrsize(conn));
+      ret = sendfile_fill(dev, pstate, pstate->snd_acked, sndlen);
       if (ret < 0)
         {
           nerr("ERROR: Failed to read from input file: %d\n", (int)ret);
@@ -340,9 +370,7 @@ static uint16_t sendfile_eventhandler(FAR struct net_driver_s *dev,
            * happen until the polling cycle completes).
            */
 
-          ret = devif_file_send(dev, pstate->snd_file, sndlen,
-                                pstate->snd_foffset + pstate->snd_sent,
-                                tcpip_hdrsize(conn));
+          ret = sendfile_fill(dev, pstate, pstate->snd_sent, sndlen);
           if (ret < 0)
             {
               nerr("ERROR: Failed to read from input file: %d\n", (int)ret);
@@ -417,7 +445,9 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
                       FAR off_t *offset, size_t count)
 {
   FAR struct tcp_conn_s *conn;
+  struct mm_map_entry_s entry;
   struct sendfile_s state;
+  struct stat buf;
   off_t startpos;
   int ret = OK;
 
@@ -470,6 +500,31 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
       return startpos;
     }
 
+  /* If the input file is memory backed (e.g. ROMFS on XIP media or TMPFS),
+   * keep the file content mapped until all data has been acknowledged so
+   * that packets (and retransmissions) are filled directly from the file
+   * memory instead of through file_read().
+   */
+
+  entry.vaddr = NULL;
+  if (file_fstat(infile, &buf) >= 0 && S_ISREG(buf.st_mode))
+    {
+      off_t foffset = offset ? *offset : startpos;
+
+      if (foffset < buf.st_size)
+        {
+          if (count > buf.st_size - foffset)
+            {
+              count = buf.st_size - foffset;
+            }
+
+          if (file_mmap_direct(infile, foffset, count, &entry) < 0)
+            {
+              entry.vaddr = NULL;
+            }
+        }
+    }
+
   /* Initialize the state structure.  This is done with the network
    * locked because we don't want anything to happen until we are
    * ready.
@@ -486,6 +541,7 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
   state.snd_foffset = offset ? *offset : startpos; /* Input file offset */
   state.snd_flen    = count;                       /* Number of bytes to send */
   state.snd_file    = infile;                      /* File to read from */
+  state.snd_map     = entry.vaddr;                 /* Direct file mapping */
 
   /* Allocate resources to receive a callback */
 
@@ -545,6 +601,21 @@ errout_locked:
 #endif
   net_unlock();
 
+  if (entry.vaddr != NULL)
+    {
+      /* The file was never read, advance the file position by hand */
+
+      if (state.snd_sent > 0)
+        {
+          file_seek(infile, state.snd_foffset + state.snd_sent, SEEK_SET);
+        }
+
+      if (entry.munmap != NULL)
+        {
+          file_munmap(entry.vaddr, entry.length);
+        }
+    }
+
   /* Return the current file position */
 
   if (offset)
@@ -119,9 +119,70 @@ static int tcp_get_timeout(FAR struct tcp_conn_s *conn)
     }
 #endif
 
+#if defined(CONFIG_NET_TCP_TIMER_WHEEL) && defined(CONFIG_NET_TCP_DELAYED_ACK)
+  /* A pending delayed ACK shares the timer with the other timeouts */
+
+  if (conn->rx_unackseg > 0 && (timeout == 0 || timeout > ACK_DELAY))
+    {
+      timeout = ACK_DELAY;
+    }
+#endif
+
   return timeout;
 }
 
+/****************************************************************************
+ * Name: tcp_delayed_ack
+ *
+ * Description:
+ *   Account the time elapsed for a delayed acknowledgment and send the ACK
+ *   if it was delayed long enough.
+ *
+ * Input Parameters:
+ *   dev  - The device driver structure to use in the send operation
+ *   conn - The TCP "connection" to poll for TX data
+ *   hsec - Time elapsed (units: half-seconds)
+ *
+ * Returned Value:
+ *   true if the ACK was sent.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+static bool tcp_delayed_ack(FAR struct net_driver_s *dev,
+                            FAR struct tcp_conn_s *conn, int hsec)
+{
+  /* Is there a segment with a delayed acknowledgment? */
+
+  if (conn->rx_unackseg > 0)
+    {
+      /* Increment the ACK delay. */
+
+      conn->rx_acktimer += hsec;
+
+      /* Per RFC 1122:  "...an ACK should not be excessively delayed; in
+       * particular, the delay must be less than 0.5 seconds..."
+       */
+
+      if (conn->rx_acktimer >= ACK_DELAY)
+        {
+          /* Reset the delayed ACK state and send the ACK packet. */
+
+          conn->rx_unackseg = 0;
+          conn->rx_acktimer = 0;
+          tcp_synack(dev, conn, TCP_ACK);
+          return true;
+        }
+    }
+
+  return false;
+}
+#endif
+
+#ifndef CONFIG_NET_TCP_TIMER_WHEEL
 /****************************************************************************
  * Name: tcp_timer_expiry
  *
@@ -159,6 +220,7 @@ static void tcp_timer_expiry(FAR void *arg)
 
   net_unlock();
 }
+#endif
 
 /****************************************************************************
  * Name: tcp_xmit_probe
@@ -251,16 +313,20 @@ void tcp_update_timer(FAR struct tcp_conn_s *conn)
         }
 #endif
 
+#ifdef CONFIG_NET_TCP_TIMER_WHEEL
+      tcp_wheel_update(conn, timeout);
+#else
       if (work_available(&conn->work) ||
           TICK2HSEC(work_timeleft(&conn->work)) != timeout)
         {
           work_queue(LPWORK, &conn->work, tcp_timer_expiry,
                      conn, HSEC2TICK(timeout));
         }
+#endif
     }
   else
     {
-      work_cancel(LPWORK, &conn->work);
+      tcp_stop_timer(conn);
     }
 }
 
@@ -338,7 +404,11 @@ void tcp_update_keeptimer(FAR struct tcp_conn_s *conn, int timeout)
 
 void tcp_stop_timer(FAR struct tcp_conn_s *conn)
 {
+#ifdef CONFIG_NET_TCP_TIMER_WHEEL
+  tcp_wheel_cancel(conn);
+#else
   work_cancel(LPWORK, &conn->work);
+#endif
 }
 
 /****************************************************************************
@@ -510,6 +580,15 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
               /* Will not yet decrement to zero */
 
               conn->timer -= hsec;
+
+#if defined(CONFIG_NET_TCP_TIMER_WHEEL) && defined(CONFIG_NET_TCP_DELAYED_ACK)
+              /* The shared timer may have expired for a delayed ACK */
+
+              if (tcp_delayed_ack(dev, conn, hsec))
+                {
+                  goto done;
+                }
+#endif
             }
           else
             {
@@ -612,6 +691,7 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
 
 #ifdef CONFIG_NET_STATISTICS
               g_netstats.tcp.rexmit++;
+              conn->rstats.rto_rexmit++;
 #endif
               switch (conn->tcpstateflags & TCP_STATE_MASK)
                 {
@@ -790,32 +870,11 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
             }
 
 #ifdef CONFIG_NET_TCP_DELAYED_ACK
-          /* Handle delayed acknowledgments.  Is there a segment with a
-           * delayed acknowledgment?
-           */
+          /* Handle delayed acknowledgments */
 
-          if (conn->rx_unackseg > 0)
+          if (tcp_delayed_ack(dev, conn, hsec))
             {
-              /* Increment the ACK delay. */
-
-              conn->rx_acktimer += hsec;
-
-              /* Per RFC 1122:  "...an ACK should not be excessively
-               * delayed; in particular, the delay must be less than
-               * 0.5 seconds..."
-               */
-
-              if (conn->rx_acktimer >= ACK_DELAY)
-                {
-                  /* Reset the delayed ACK state and send the ACK
-                   * packet.
-                   */
-
-                  conn->rx_unackseg = 0;
-                  conn->rx_acktimer = 0;
-                  tcp_synack(dev, conn, TCP_ACK);
-                  goto done;
-                }
+              goto done;
             }
 #endif
 
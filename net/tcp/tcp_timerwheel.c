@@ -0,0 +1,584 @@
+/****************************************************************************
+ * net/tcp/tcp_timerwheel.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/queue.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/netstats.h>
+#include <nuttx/net/tcp.h>
+
+#include "netdev/netdev.h"
+#include "inet/inet.h"
+#include "tcp/tcp.h"
+
+#if defined(NET_TCP_HAVE_STACK) && defined(CONFIG_NET_TCP_TIMER_WHEEL)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if (CONFIG_NET_TCP_TIMER_WHEEL_SLOTS & \
+     (CONFIG_NET_TCP_TIMER_WHEEL_SLOTS - 1)) != 0
+#  error CONFIG_NET_TCP_TIMER_WHEEL_SLOTS must be a power of two
+#endif
+
+#define TCP_WHEEL_MASK        (CONFIG_NET_TCP_TIMER_WHEEL_SLOTS - 1)
+
+/* The wheel advances once per half second, the unit of all TCP timers */
+
+#define TCP_WHEEL_TICK        TICK_PER_HSEC
+
+/* Modular comparison of wheel ticks */
+
+#define TCP_WHEEL_DUE(t, now) ((int32_t)((t) - (now)) <= 0)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct tcp_wheel_s
+{
+  struct work_s work;                               /* Wheel tick */
+  dq_queue_t    slot[CONFIG_NET_TCP_TIMER_WHEEL_SLOTS];
+  uint32_t      now;                                /* Last tick handled */
+  unsigned int  count;                              /* Connections linked */
+};
+
+#if CONFIG_NET_TCP_TIMEWAIT_ENTRIES > 0
+/* A connection that was freed in the TIME_WAIT state.  Entries are
+ * allocated round robin from a ring, so the oldest entry is always the
+ * next one to be reused.
+ */
+
+struct tcp_timewait_s
+{
+  FAR struct tcp_timewait_s *flink; /* Next entry in the hash chain */
+  union ip_binding_u u;             /* IP address binding */
+  uint32_t expiry;                  /* Wheel tick when TIME_WAIT ends */
+  uint16_t lport;                   /* Local port, in network byte order */
+  uint16_t rport;                   /* Remote port, in network byte order */
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+  uint8_t  domain;                  /* IP domain: PF_INET or PF_INET6 */
+#endif
+  bool     inuse;                   /* Linked into a hash chain */
+};
+#endif
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void tcp_wheel_work(FAR void *arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct tcp_wheel_s g_tcp_wheel;
+
+#if CONFIG_NET_TCP_TIMEWAIT_ENTRIES > 0
+static struct tcp_timewait_s g_tcp_timewait[CONFIG_NET_TCP_TIMEWAIT_ENTRIES];
+static FAR struct tcp_timewait_s *
+  g_tcp_twhash[CONFIG_NET_TCP_TIMEWAIT_ENTRIES];
+static unsigned int g_tcp_twnext;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_wheel_now
+ *
+ * Description:
+ *   Return the current wheel tick (units: half-seconds)
+ *
+ ****************************************************************************/
+
+static inline uint32_t tcp_wheel_now(void)
+{
+  return (uint32_t)(clock_systime_ticks() / TCP_WHEEL_TICK);
+}
+
+/****************************************************************************
+ * Name: tcp_wheel_schedule
+ *
+ * Description:
+ *   Schedule the wheel work for the next tick boundary
+ *
+ ****************************************************************************/
+
+static void tcp_wheel_schedule(void)
+{
+  clock_t ticks = clock_systime_ticks();
+
+  work_queue(LPWORK, &g_tcp_wheel.work, tcp_wheel_work, NULL,
+             TCP_WHEEL_TICK - ticks % TCP_WHEEL_TICK);
+}
+
+/****************************************************************************
+ * Name: tcp_wheel_work
+ *
+ * Description:
+ *   Advance the wheel up to the current tick and flag every connection
+ *   that is due.  The whole batch is handled under one acquisition of the
+ *   network lock; the expired connections are then serviced by tcp_timer()
+ *   on the next poll of their device.
+ *
+ * Input Parameters:
+ *   arg - Not used
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void tcp_wheel_work(FAR void *arg)
+{
+  FAR struct net_driver_s *dev = NULL;
+  FAR struct tcp_conn_s *conn;
+  FAR dq_entry_t *entry;
+  FAR dq_entry_t *next;
+  FAR dq_queue_t *slot;
+  uint32_t now;
+
+  net_lock();
+
+  now = tcp_wheel_now();
+
+  /* If we fell behind by more than one revolution, a single pass over all
+   * of the slots is enough.
+   */
+
+  if (now - g_tcp_wheel.now > CONFIG_NET_TCP_TIMER_WHEEL_SLOTS)
+    {
+      g_tcp_wheel.now = now - CONFIG_NET_TCP_TIMER_WHEEL_SLOTS;
+    }
+
+  while (g_tcp_wheel.count > 0 && g_tcp_wheel.now != now)
+    {
+      g_tcp_wheel.now++;
+      slot = &g_tcp_wheel.slot[g_tcp_wheel.now & TCP_WHEEL_MASK];
+
+      for (entry = dq_peek(slot); entry != NULL; entry = next)
+        {
+          next = dq_next(entry);
+          conn = container_of(entry, struct tcp_conn_s, tnode);
+
+          /* Connections due in a later revolution stay where they are */
+
+          if (!TCP_WHEEL_DUE(conn->texpiry, now))
+            {
+              continue;
+            }
+
+          dq_rem(entry, slot);
+          conn->tpending = false;
+          g_tcp_wheel.count--;
+
+          conn->timeout = true;
+
+          /* Connections on the same device usually come in runs, one
+           * notification per run is enough.
+           */
+
+          if (conn->dev != dev)
+            {
+              dev = conn->dev;
+              netdev_txnotify_dev(dev);
+            }
+        }
+    }
+
+  g_tcp_wheel.now = now;
+  if (g_tcp_wheel.count > 0)
+    {
+      tcp_wheel_schedule();
+    }
+
+  net_unlock();
+}
+
+#if CONFIG_NET_TCP_TIMEWAIT_ENTRIES > 0
+/****************************************************************************
+ * Name: tcp_timewait_hash
+ *
+ * Description:
+ *   Return the hash chain for the given remote address and ports
+ *
+ ****************************************************************************/
+
+static FAR struct tcp_timewait_s **
+tcp_timewait_hash(FAR const void *raddr, size_t len, uint16_t lport,
+                  uint16_t rport)
+{
+  FAR const uint16_t *addr = raddr;
+  uint32_t hash = ((uint32_t)lport << 16) ^ rport;
+  size_t i;
+
+  for (i = 0; i < len / sizeof(uint16_t); i++)
+    {
+      hash = (hash * 31) ^ addr[i];
+    }
+
+  return &g_tcp_twhash[hash % CONFIG_NET_TCP_TIMEWAIT_ENTRIES];
+}
+
+/****************************************************************************
+ * Name: tcp_timewait_chain
+ *
+ * Description:
+ *   Return the hash chain of a TIME_WAIT entry
+ *
+ ****************************************************************************/
+
+static FAR struct tcp_timewait_s **
+tcp_timewait_chain(FAR struct tcp_timewait_s *tw)
+{
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (tw->domain == PF_INET6)
+#endif
+    {
+      return tcp_timewait_hash(tw->u.ipv6.raddr, sizeof(net_ipv6addr_t),
+                               tw->lport, tw->rport);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      return tcp_timewait_hash(&tw->u.ipv4.raddr, sizeof(in_addr_t),
+                               tw->lport, tw->rport);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_timewait_unlink
+ *
+ * Description:
+ *   Remove a TIME_WAIT entry from its hash chain
+ *
+ ****************************************************************************/
+
+static void tcp_timewait_unlink(FAR struct tcp_timewait_s *tw)
+{
+  FAR struct tcp_timewait_s **prev = tcp_timewait_chain(tw);
+
+  while (*prev != tw)
+    {
+      DEBUGASSERT(*prev != NULL);
+      prev = &(*prev)->flink;
+    }
+
+  *prev     = tw->flink;
+  tw->inuse = false;
+}
+#endif /* CONFIG_NET_TCP_TIMEWAIT_ENTRIES > 0 */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_wheel_update
+ *
+ * Description:
+ *   (Re-)arm the timer wheel entry of the provided TCP connection.
+ *
+ * Input Parameters:
+ *   conn    - The TCP "connection" to poll for TX data
+ *   timeout - Time for the next timeout (units: half-seconds)
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_wheel_update(FAR struct tcp_conn_s *conn, int timeout)
+{
+  clock_t ticks = clock_systime_ticks();
+  uint32_t expiry;
+
+  /* The first tick boundary at least 'timeout' half-seconds from now */
+
+  expiry = (uint32_t)((ticks + HSEC2TICK(timeout)) / TCP_WHEEL_TICK) + 1;
+
+  if (conn->tpending)
+    {
+      if (conn->texpiry == expiry)
+        {
+          return;
+        }
+
+      dq_rem(&conn->tnode,
+             &g_tcp_wheel.slot[conn->texpiry & TCP_WHEEL_MASK]);
+    }
+  else
+    {
+      /* The wheel is idle when it holds no connections, so just restart
+       * it from the current tick.
+       */
+
+      if (g_tcp_wheel.count++ == 0)
+        {
+          g_tcp_wheel.now = (uint32_t)(ticks / TCP_WHEEL_TICK);
+        }
+
+      conn->tpending = true;
+    }
+
+  conn->texpiry = expiry;
+  dq_addlast(&conn->tnode, &g_tcp_wheel.slot[expiry & TCP_WHEEL_MASK]);
+
+  if (work_available(&g_tcp_wheel.work))
+    {
+      tcp_wheel_schedule();
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_wheel_cancel
+ *
+ * Description:
+ *   Remove the provided TCP connection from the timer wheel
+ *
+ * Input Parameters:
+ *   conn - The TCP "connection" to poll for TX data
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_wheel_cancel(FAR struct tcp_conn_s *conn)
+{
+  if (conn->tpending)
+    {
+      dq_rem(&conn->tnode,
+             &g_tcp_wheel.slot[conn->texpiry & TCP_WHEEL_MASK]);
+      conn->tpending = false;
+      g_tcp_wheel.count--;
+    }
+}
+
+#if CONFIG_NET_TCP_TIMEWAIT_ENTRIES > 0
+/****************************************************************************
+ * Name: tcp_timewait_add
+ *
+ * Description:
+ *   Remember a connection that is freed in the TIME_WAIT state for the
+ *   rest of its TIME_WAIT period.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection being freed
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_timewait_add(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_timewait_s **chain;
+  FAR struct tcp_timewait_s *tw;
+
+  DEBUGASSERT(conn->tcpstateflags == TCP_TIME_WAIT);
+
+  if (conn->timer == 0)
+    {
+      return;
+    }
+
+  /* Reuse the oldest entry */
+
+  tw = &g_tcp_timewait[g_tcp_twnext];
+  g_tcp_twnext = (g_tcp_twnext + 1) % CONFIG_NET_TCP_TIMEWAIT_ENTRIES;
+
+  if (tw->inuse)
+    {
+      tcp_timewait_unlink(tw);
+    }
+
+  tw->u      = conn->u;
+  tw->expiry = tcp_wheel_now() + conn->timer;
+  tw->lport  = conn->lport;
+  tw->rport  = conn->rport;
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+  tw->domain = conn->domain;
+#endif
+
+  chain     = tcp_timewait_chain(tw);
+  tw->flink = *chain;
+  tw->inuse = true;
+  *chain    = tw;
+}
+
+/****************************************************************************
+ * Name: tcp_timewait_input
+ *
+ * Description:
+ *   Handle a segment that matches no connection but belongs to a
+ *   connection remembered in the TIME_WAIT table.
+ *
+ * Input Parameters:
+ *   dev - The device driver structure holding the received segment
+ *   tcp - The TCP header of the received segment
+ *
+ * Returned Value:
+ *   true if the segment was handled here; false if it should be answered
+ *   with a reset as usual.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool tcp_timewait_input(FAR struct net_driver_s *dev,
+                        FAR struct tcp_hdr_s *tcp)
+{
+  FAR struct tcp_timewait_s **prev;
+  FAR struct tcp_timewait_s *tw;
+  uint32_t now;
+
+  /* A new SYN is never part of the old connection */
+
+  if ((tcp->flags & TCP_SYN) != 0)
+    {
+      return false;
+    }
+
+  now = tcp_wheel_now();
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
+#endif
+    {
+      FAR struct ipv6_hdr_s *ip = IPv6BUF;
+
+      prev = tcp_timewait_hash(ip->srcipaddr, sizeof(net_ipv6addr_t),
+                               tcp->destport, tcp->srcport);
+      for (; (tw = *prev) != NULL; prev = &tw->flink)
+        {
+          if (
+#ifdef CONFIG_NET_IPv4
+              tw->domain == PF_INET6 &&
+#endif
+              tw->lport == tcp->destport && tw->rport == tcp->srcport &&
+              (net_ipv6addr_cmp(tw->u.ipv6.laddr, g_ipv6_unspecaddr) ||
+               net_ipv6addr_cmp(ip->destipaddr, tw->u.ipv6.laddr)) &&
+              net_ipv6addr_cmp(ip->srcipaddr, tw->u.ipv6.raddr))
+            {
+              break;
+            }
+        }
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      FAR struct ipv4_hdr_s *ip = IPv4BUF;
+      in_addr_t srcipaddr = net_ip4addr_conv32(ip->srcipaddr);
+      in_addr_t destipaddr = net_ip4addr_conv32(ip->destipaddr);
+
+      prev = tcp_timewait_hash(&srcipaddr, sizeof(in_addr_t),
+                               tcp->destport, tcp->srcport);
+      for (; (tw = *prev) != NULL; prev = &tw->flink)
+        {
+          if (
+#ifdef CONFIG_NET_IPv6
+              tw->domain == PF_INET &&
+#endif
+              tw->lport == tcp->destport && tw->rport == tcp->srcport &&
+              (net_ipv4addr_cmp(tw->u.ipv4.laddr, INADDR_ANY) ||
+               net_ipv4addr_cmp(destipaddr, tw->u.ipv4.laddr)) &&
+              net_ipv4addr_cmp(srcipaddr, tw->u.ipv4.raddr))
+            {
+              break;
+            }
+        }
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+  if (tw == NULL)
+    {
+      return false;
+    }
+
+  if (TCP_WHEEL_DUE(tw->expiry, now))
+    {
+      /* TIME_WAIT is over, forget the connection */
+
+      *prev     = tw->flink;
+      tw->inuse = false;
+      return false;
+    }
+
+  /* Per RFC 1337, resets are ignored in TIME_WAIT.  Anything else (a
+   * retransmitted FIN, most likely) is acknowledged again.
+   */
+
+  if ((tcp->flags & TCP_RST) != 0)
+    {
+      dev->d_len = 0;
+    }
+  else
+    {
+      ninfo("TIME_WAIT segment, sending ACK\n");
+      tcp_reply(dev, NULL, TCP_ACK);
+    }
+
+  return true;
+}
+#endif /* CONFIG_NET_TCP_TIMEWAIT_ENTRIES > 0 */
+
+#endif /* NET_TCP_HAVE_STACK && CONFIG_NET_TCP_TIMER_WHEEL */
@@ -756,6 +756,7 @@ void udp_callback_cleanup(FAR void *arg);
  *   psock    Pointer to the socket structure for the SOCK_DRAM socket
  *   msg      Receive info and buffer for receive data
  *   flags    Receive flags
+ *   timeout  Receive timeout in milliseconds, UINT_MAX for none
  *
  * Returned Value:
  *   On success, returns the number of characters received.  On  error,
@@ -766,7 +767,7 @@ void udp_callback_cleanup(FAR void *arg);
  ****************************************************************************/
 
 ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
-                           int flags);
+                           int flags, unsigned int timeout);
 
 /****************************************************************************
  * Name: psock_udp_sendto
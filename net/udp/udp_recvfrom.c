@@ -665,8 +665,10 @@ static void udp_notify_recvcpu(FAR struct udp_conn_s *conn)
  *   Perform the recvfrom operation for a UDP SOCK_DGRAM
  *
  * Input Parameters:
- *   psock  Pointer to the socket structure for the SOCK_DRAM socket
- *   msg    Receive info and buffer for receive data
+ *   psock    Pointer to the socket structure for the SOCK_DRAM socket
+ *   msg      Receive info and buffer for receive data
+ *   flags    Receive flags
+ *   timeout  Receive timeout in milliseconds, UINT_MAX for none
  *
  * Returned Value:
  *   On success, returns the number of characters received.  On  error,
@@ -677,7 +679,7 @@ static void udp_notify_recvcpu(FAR struct udp_conn_s *conn)
  ****************************************************************************/
 
 ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
-                           int flags)
+                           int flags, unsigned int timeout)
 {
   FAR struct udp_conn_s *conn = psock->s_conn;
   FAR struct net_driver_s *dev;
@@ -765,8 +767,7 @@ ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
            * received.
            */
 
-          ret = net_sem_timedwait(&state.ir_sem,
-                              _SO_TIMEOUT(conn->sconn.s_rcvtimeo));
+          ret = net_sem_timedwait(&state.ir_sem, timeout);
           tls_cleanup_pop(tls_get_info(), 0);
           if (ret == -ETIMEDOUT)
             {
@@ -514,6 +514,7 @@ ssize_t usrsock_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
  *   psock    A pointer to a NuttX-specific, internal socket structure
  *   msg      Buffer to receive the message
  *   flags    Receive flags (ignored)
+ *   timeout  Receive timeout in milliseconds, UINT_MAX for none
  *
  * Returned Value:
  *   On success, returns the number of characters received.  If no data is
@@ -524,7 +525,7 @@ ssize_t usrsock_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
  ****************************************************************************/
 
 ssize_t usrsock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
-                        int flags);
+                        int flags, unsigned int timeout);
 
 /****************************************************************************
  * Name: usrsock_getsockopt
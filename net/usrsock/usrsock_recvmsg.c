@@ -196,6 +196,7 @@ static int do_recvfrom_request(FAR struct usrsock_conn_s *conn,
  *   psock    A pointer to a NuttX-specific, internal socket structure
  *   msg      Buffer to receive the message
  *   flags    Receive flags (ignored)
+ *   timeout  Receive timeout in milliseconds, UINT_MAX for none
  *
  * Returned Value:
  *   On success, returns the number of characters received.  If no data is
@@ -206,7 +207,7 @@ static int do_recvfrom_request(FAR struct usrsock_conn_s *conn,
  ****************************************************************************/
 
 ssize_t usrsock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
-                        int flags)
+                        int flags, unsigned int timeout)
 {
   FAR void *buf = msg->msg_iov->iov_base;
   size_t len = msg->msg_iov->iov_len;
@@ -325,8 +326,7 @@ ssize_t usrsock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
 
           /* Wait for receive-avail (or abort, or timeout, or signal). */
 
-          ret = net_sem_timedwait(&state.reqstate.recvsem,
-                              _SO_TIMEOUT(conn->sconn.s_rcvtimeo));
+          ret = net_sem_timedwait(&state.reqstate.recvsem, timeout);
           usrsock_teardown_data_request_callback(&state);
           if (ret < 0)
             {
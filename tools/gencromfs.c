@@ -95,6 +95,9 @@
 #define CROMFS_MAGIC       0x4d4f5243
 #define CROMFS_BLOCKSIZE   512
 
+#define CROMFS_NODE_BLKINDEX (1 << 0) /* Must match fs/cromfs/cromfs.h */
+#define CROMFS_LZ4_HDR     2          /* Must match fs/cromfs/cromfs.h */
+
 #define LZF_BUFSIZE        512
 #define LZF_HLOG           13
 #define LZF_HSIZE          (1 << LZF_HLOG)
@@ -112,6 +115,15 @@
 #define LZF_MAX_OFF        (1 << LZF_HLOG)
 #define LZF_MAX_REF        ((1 << 8) + (1 << 3))
 
+#define LZ4_HLOG           10
+#define LZ4_HSIZE          (1 << LZ4_HLOG)
+#define LZ4_NDX(v)         (((v) * 2654435761u) >> (32 - LZ4_HLOG))
+
+#define LZ4_MINMATCH       4
+#define LZ4_MFLIMIT        12         /* No match starts in the last 12 bytes */
+#define LZ4_LASTLITERALS   5          /* The last 5 bytes are literals */
+#define LZ4_RUNMASK        15
+
 #define HEX_PER_LINE       8
 
 /****************************************************************************
@@ -142,7 +154,7 @@ struct cromfs_volume_s
 struct cromfs_node_s
 {
   uint16_t cn_mode;       /* File type, attributes, and access mode bits */
-  uint16_t cn_pad;        /* Not used */
+  uint16_t cn_flags;      /* CROMFS_NODE_* flags */
   uint32_t cn_name;       /* Offset from the beginning of the volume header to the
                            * node name string.  NUL-terminated. */
   uint32_t cn_size;       /* Size of the uncompressed data (in bytes) */
@@ -208,6 +220,10 @@ union lzf_result_u
 
 static uint8_t *g_lzf_hashtab[LZF_HSIZE];
 
+/* LZ4 hash table */
+
+static const uint8_t *g_lz4_hashtab[LZ4_HSIZE];
+
 /* Type of the callback from traverse_directory() */
 
 typedef int (*traversal_callback_t)(const char *dirpath, const char *name,
@@ -224,6 +240,9 @@ static char *g_outname;        /* Output file path */
 static FILE *g_outstream;      /* Main output stream */
 static FILE *g_tmpstream;      /* Temporary file output stream */
 
+static bool g_blkindex;        /* Generate block indexes (-i) */
+static bool g_lz4;             /* Compress with LZ4 (-z lz4) */
+
 static const char g_delim[] =
   "**************************************"
   "**************************************";
@@ -275,6 +294,9 @@ static void dump_hexbuffer(FILE *stream, const void *buffer,
 static void dump_nextline(FILE *stream);
 static size_t lzf_compress(const uint8_t *inbuffer, unsigned int inlen,
                            union lzf_result_u *result);
+static uint8_t *lz4_putlen(uint8_t *outptr, size_t len);
+static size_t lz4_compress(const uint8_t *inbuffer, unsigned int inlen,
+                           union lzf_result_u *result);
 static uint16_t get_mode(mode_t mode);
 #ifdef HOST_TGTSWAP
 static inline uint16_t tgt_uint16(uint16_t a);
@@ -303,7 +325,12 @@ static int  traverse_directory(const char *dirpath,
 
 static void show_usage(void)
 {
-  fprintf(stderr, "USAGE: %s <dir-path> <out-file>\n", g_progname);
+  fprintf(stderr, "USAGE: %s [-i] [-z lzf|lz4] <dir-path> <out-file>\n",
+          g_progname);
+  fprintf(stderr, "\nWhere:\n");
+  fprintf(stderr, "  -i:  Add a block index to each file for fast seeks\n");
+  fprintf(stderr, "  -z:  Block compression, lzf (default) or lz4.  LZ4\n");
+  fprintf(stderr, "       needs CONFIG_FS_CROMFS_LZ4 on the target\n");
   exit(1);
 }
 
@@ -810,6 +837,164 @@ genhdr:
   return retlen;
 }
 
+static uint8_t *lz4_putlen(uint8_t *outptr, size_t len)
+{
+  /* Run lengths of 15 or more continue in extra bytes */
+
+  while (len >= 255)
+    {
+      *outptr++ = 255;
+      len -= 255;
+    }
+
+  *outptr++ = len;
+  return outptr;
+}
+
+static size_t lz4_compress(const uint8_t *inbuffer, unsigned int inlen,
+                           union lzf_result_u *result)
+{
+  const uint8_t *inptr  = inbuffer;
+  const uint8_t *anchor = inbuffer;
+  const uint8_t *inend  = inbuffer + inlen;
+        uint8_t *outptr = result->compressed.lzf_buffer;
+        uint8_t *outend = outptr + inlen;
+  const uint8_t *ref;
+  uint8_t *token;
+  size_t litlen;
+  size_t len;
+  ssize_t cs;
+  ssize_t retlen;
+  uint32_t seq;
+
+  memset(g_lz4_hashtab, 0, sizeof(g_lz4_hashtab));
+
+  /* Greedy parse.  Blocks are smaller than 64KiB so every match is in
+   * range.
+   */
+
+  while (inlen > LZ4_MFLIMIT && inptr < inend - LZ4_MFLIMIT)
+    {
+      const uint8_t **hslot;
+
+      memcpy(&seq, inptr, sizeof(seq));
+      hslot  = &g_lz4_hashtab[LZ4_NDX(seq)];
+      ref    = *hslot;
+      *hslot = inptr;
+
+      if (ref == NULL || memcmp(ref, inptr, LZ4_MINMATCH) != 0)
+        {
+          inptr++;
+          continue;
+        }
+
+      len = LZ4_MINMATCH;
+      while (inptr + len < inend - LZ4_LASTLITERALS &&
+             ref[len] == inptr[len])
+        {
+          len++;
+        }
+
+      /* Token, literal run, offset and match length must fit */
+
+      litlen = inptr - anchor;
+      if (outptr + 1 + litlen / 255 + 1 + litlen + 2 +
+          (len - LZ4_MINMATCH) / 255 + 1 > outend)
+        {
+          cs = 0;
+          goto genhdr;
+        }
+
+      token = outptr++;
+      if (litlen >= LZ4_RUNMASK)
+        {
+          *token = LZ4_RUNMASK << 4;
+          outptr = lz4_putlen(outptr, litlen - LZ4_RUNMASK);
+        }
+      else
+        {
+          *token = litlen << 4;
+        }
+
+      memcpy(outptr, anchor, litlen);
+      outptr   += litlen;
+
+      *outptr++ = (inptr - ref) & 0xff;
+      *outptr++ = (inptr - ref) >> 8;
+
+      len      -= LZ4_MINMATCH;
+      if (len >= LZ4_RUNMASK)
+        {
+          *token |= LZ4_RUNMASK;
+          outptr  = lz4_putlen(outptr, len - LZ4_RUNMASK);
+        }
+      else
+        {
+          *token |= len;
+        }
+
+      inptr    += len + LZ4_MINMATCH;
+      anchor    = inptr;
+    }
+
+  /* The last sequence holds only literals */
+
+  litlen = inend - anchor;
+  if (outptr + 1 + litlen / 255 + 1 + litlen > outend)
+    {
+      cs = 0;
+      goto genhdr;
+    }
+
+  token = outptr++;
+  if (litlen >= LZ4_RUNMASK)
+    {
+      *token = LZ4_RUNMASK << 4;
+      outptr = lz4_putlen(outptr, litlen - LZ4_RUNMASK);
+    }
+  else
+    {
+      *token = litlen << 4;
+    }
+
+  memcpy(outptr, anchor, litlen);
+  outptr += litlen;
+
+  cs = outptr - (uint8_t *)result->compressed.lzf_buffer;
+
+genhdr:
+  if (cs > 0)
+    {
+      /* Write compressed header */
+
+      result->compressed.lzf_magic[0]   = 'Z';
+      result->compressed.lzf_magic[1]   = 'V';
+      result->compressed.lzf_type       = CROMFS_LZ4_HDR;
+      result->compressed.lzf_clen[0]    = cs >> 8;
+      result->compressed.lzf_clen[1]    = cs & 0xff;
+      result->compressed.lzf_ulen[0]    = inlen >> 8;
+      result->compressed.lzf_ulen[1]    = inlen & 0xff;
+      retlen                            = cs + LZF_TYPE1_HDR_SIZE;
+    }
+  else
+    {
+      /* Incompressible.  Write uncompressed header */
+
+      result->uncompressed.lzf_magic[0] = 'Z';
+      result->uncompressed.lzf_magic[1] = 'V';
+      result->uncompressed.lzf_type     = LZF_TYPE0_HDR;
+      result->uncompressed.lzf_len[0]   = inlen >> 8;
+      result->uncompressed.lzf_len[1]   = inlen & 0xff;
+
+      /* Copy uncompressed data into the result buffer */
+
+      memcpy(result->uncompressed.lzf_buffer, inbuffer, inlen);
+      retlen                            = inlen + LZF_TYPE0_HDR_SIZE;
+    }
+
+  return retlen;
+}
+
 static uint16_t get_mode(mode_t mode)
 {
   uint16_t ret = 0;
@@ -879,7 +1064,7 @@ static void gen_dirlink(const char *name, uint32_t tgtoffs, bool dirempty)
           (unsigned long)g_offset, name);
 
   node.cn_mode    = TGT_UINT16(DIRLINK_MODEFLAGS);
-  node.cn_pad     = 0;
+  node.cn_flags   = 0;
 
   g_offset       += sizeof(struct cromfs_node_s);
   node.cn_name    = TGT_UINT32(g_offset);
@@ -962,7 +1147,7 @@ static void gen_directory(const char *path, const char *name, mode_t mode,
           (unsigned long)save_offset, path);
 
   node.cn_mode    = TGT_UINT16(NUTTX_IFDIR | get_mode(mode));
-  node.cn_pad     = 0;
+  node.cn_flags   = 0;
 
   save_offset    += sizeof(struct cromfs_node_s);
   node.cn_name    = TGT_UINT32(save_offset);
@@ -995,31 +1180,54 @@ static void gen_file(const char *path, const char *name, mode_t mode,
   FILE *outstream;
   FILE *instream;
   uint8_t iobuffer[LZF_BUFSIZE];
+  uint32_t *blkindex = NULL;
+  struct stat buf;
   size_t nread;
   size_t ntotal;
   size_t blklen;
   size_t blktotal;
+  size_t idxlen;
+  unsigned int nblocks;
   unsigned int blkno;
   int namlen;
 
   namlen      = strlen(name) + 1;
 
-  /* Open a new temporary file */
-
-  outstream   = open_tmpfile();
-  g_tmpstream = outstream;
-  g_offset    = nodeoffs + sizeof(struct cromfs_node_s) + namlen;
-
   /* Open the source data file */
 
   instream    = fopen(path, "r");
-  if (!instream)
+  if (!instream || fstat(fileno(instream), &buf) < 0)
     {
       fprintf(stderr, "fopen for source file %s failed: %s\n",
               path, strerror(errno));
       exit(1);
     }
 
+  /* The block index, if any, lies between the file name and the first
+   * block.  All blocks but the last one hold LZF_BUFSIZE bytes.
+   */
+
+  nblocks     = (buf.st_size + LZF_BUFSIZE - 1) / LZF_BUFSIZE;
+  idxlen      = 0;
+
+  if (g_blkindex && nblocks > 0)
+    {
+      idxlen   = nblocks * sizeof(uint32_t);
+      blkindex = malloc(idxlen);
+      if (blkindex == NULL)
+        {
+          fprintf(stderr, "Failed to allocate the block index of %s\n",
+                  path);
+          exit(1);
+        }
+    }
+
+  /* Open a new temporary file */
+
+  outstream   = open_tmpfile();
+  g_tmpstream = outstream;
+  g_offset    = nodeoffs + sizeof(struct cromfs_node_s) + namlen + idxlen;
+
   /* Then read data from the file, compress it, and write it to the new
    * temporary file
    */
@@ -1039,7 +1247,15 @@ static void gen_file(const char *path, const char *name, mode_t mode,
 
           /* Compress the chunk */
 
-          blklen = lzf_compress(iobuffer, nread, &result);
+          if (g_lz4)
+            {
+              blklen = lz4_compress(iobuffer, nread, &result);
+            }
+          else
+            {
+              blklen = lzf_compress(iobuffer, nread, &result);
+            }
+
           if (result.cmn.lzf_type == LZF_TYPE0_HDR)
             {
               clen = nread;
@@ -1058,6 +1274,11 @@ static void gen_file(const char *path, const char *name, mode_t mode,
           dump_hexbuffer(g_tmpstream, &result, blklen);
           dump_nextline(g_tmpstream);
 
+          if (blkindex != NULL && blkno < nblocks)
+            {
+              blkindex[blkno] = TGT_UINT32(g_offset);
+            }
+
           ntotal   += nread;
           blktotal += blklen;
           g_offset += blklen;
@@ -1068,6 +1289,14 @@ static void gen_file(const char *path, const char *name, mode_t mode,
     }
   while (nread > 0);
 
+  fclose(instream);
+
+  if (blkno != nblocks)
+    {
+      fprintf(stderr, "%s changed while it was being read\n", path);
+      exit(1);
+    }
+
   /* Restore the old tmpfile context */
 
   g_tmpstream        = save_tmpstream;
@@ -1080,14 +1309,15 @@ static void gen_file(const char *path, const char *name, mode_t mode,
           (unsigned long)blktotal);
 
   node.cn_mode       = TGT_UINT16(NUTTX_IFREG | get_mode(mode));
-  node.cn_pad        = 0;
+  node.cn_flags      = TGT_UINT16(blkindex != NULL ?
+                                  CROMFS_NODE_BLKINDEX : 0);
 
   nodeoffs          += sizeof(struct cromfs_node_s);
   node.cn_name       = TGT_UINT32(nodeoffs);
 
   node.cn_size       = TGT_UINT32(ntotal);
 
-  nodeoffs          += namlen;
+  nodeoffs          += namlen + idxlen;
   node.u.cn_blocks   = TGT_UINT32(nodeoffs);
 
   nodeoffs          += blktotal;
@@ -1097,6 +1327,15 @@ static void gen_file(const char *path, const char *name, mode_t mode,
   dump_hexbuffer(g_tmpstream, name, namlen);
   dump_nextline(g_tmpstream);
 
+  if (blkindex != NULL)
+    {
+      fprintf(g_tmpstream, "\n  /* Offset %6lu:  Block index %s */\n\n",
+              (unsigned long)(nodeoffs - idxlen), path);
+      dump_hexbuffer(g_tmpstream, blkindex, idxlen);
+      dump_nextline(g_tmpstream);
+      free(blkindex);
+    }
+
   g_nnodes++;
 
   /* Now append the sub-tree nodes in the new tmpfile to the previous
@@ -1254,20 +1493,47 @@ int main(int argc, char **argv, char **envp)
   struct cromfs_volume_s vol;
   char *ptr;
   int result;
+  int option;
 
   /* Verify arguments */
 
   ptr = strrchr(argv[0], '/');
   g_progname = ptr == NULL ? argv[0] : ptr + 1;
 
-  if (argc != 3)
+  while ((option = getopt(argc, argv, "iz:h")) != -1)
+    {
+      switch (option)
+        {
+          case 'i':
+            g_blkindex = true;
+            break;
+
+          case 'z':
+            if (strcmp(optarg, "lz4") == 0)
+              {
+                g_lz4 = true;
+              }
+            else if (strcmp(optarg, "lzf") != 0)
+              {
+                fprintf(stderr, "Unknown compression: %s\n", optarg);
+                show_usage();
+              }
+            break;
+
+          case 'h':
+          default:
+            show_usage();
+        }
+    }
+
+  if (argc - optind != 2)
     {
       fprintf(stderr, "Unexpected number of arguments\n");
       show_usage();
     }
 
-  g_dirname  = argv[1];
-  g_outname  = argv[2];
+  g_dirname  = argv[optind];
+  g_outname  = argv[optind + 1];
 
   verify_directory();
   verify_outfile();
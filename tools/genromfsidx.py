@@ -0,0 +1,203 @@
+#!/usr/bin/env python3
+############################################################################
+# tools/genromfsidx.py
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed to the Apache Software Foundation (ASF) under one or more
+# contributor license agreements.  See the NOTICE file distributed with
+# this work for additional information regarding copyright ownership.  The
+# ASF licenses this file to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance with the
+# License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+# License for the specific language governing permissions and limitations
+# under the License.
+#
+############################################################################
+
+"""Generate a ROMFS image, like genromfs, with sorted directory indexes.
+
+The index of a directory is stored as the data of its "." entry.  NuttX
+binary searches it instead of walking the directory.  Other ROMFS readers
+ignore it, so the image stays compatible.  See fs/romfs/fs_romfs.h.
+"""
+
+import argparse
+import os
+import stat
+import struct
+import sys
+
+ALIGNMENT = 16
+NAME_MAX = 255
+
+HARDLINK = 0
+DIRECTORY = 1
+FILE = 2
+SOFTLINK = 3
+EXEC = 8
+
+IDX_MAGIC = b"RIDX"
+
+
+def alignup(value):
+    return (value + ALIGNMENT - 1) & ~(ALIGNMENT - 1)
+
+
+def padname(name):
+    name += b"\0"
+    return name + b"\0" * (alignup(len(name)) - len(name))
+
+
+def checksum(data):
+    words = struct.unpack(">%dI" % (len(data) // 4), data)
+    return -sum(words) & 0xFFFFFFFF
+
+
+class Entry:
+    def __init__(self, name, mode, data=b""):
+        self.name = name
+        self.mode = mode
+        self.data = data
+        self.info = 0
+        self.offset = 0
+        self.entries = []
+        self.first = 0
+
+    def hdrsize(self):
+        return 16 + len(padname(self.name))
+
+
+def scan(path, name, index):
+    st = os.lstat(path)
+    if stat.S_ISDIR(st.st_mode):
+        entry = Entry(name, DIRECTORY)
+        entry.dot = Entry(b".", HARDLINK)
+        entry.dotdot = Entry(b"..", HARDLINK)
+        for child in sorted(os.listdir(path)):
+            sub = scan(os.path.join(path, child), os.fsencode(child), index)
+            if sub is not None:
+                entry.entries.append(sub)
+
+        if index and entry.entries:
+            children = sorted(entry.entries, key=lambda e: e.name)
+            entry.dot.data = IDX_MAGIC + struct.pack(">I", len(children))
+            entry.dot.data += b"\0" * 4 * len(children)
+            entry.sorted = children
+        else:
+            entry.sorted = []
+
+    elif stat.S_ISREG(st.st_mode):
+        with open(path, "rb") as f:
+            entry = Entry(name, FILE, f.read())
+        if st.st_mode & stat.S_IXUSR:
+            entry.mode |= EXEC
+
+    elif stat.S_ISLNK(st.st_mode):
+        entry = Entry(name, SOFTLINK, os.fsencode(os.readlink(path)))
+
+    else:
+        print("Skipping %s" % path, file=sys.stderr)
+        return None
+
+    if len(name) > NAME_MAX:
+        print("Skipping %s: name too long" % path, file=sys.stderr)
+        return None
+
+    return entry
+
+
+def layout(entry, offset):
+    """Place the entries of a directory, then its subdirectories."""
+
+    entry.first = offset
+    for child in [entry.dot, entry.dotdot] + entry.entries:
+        child.offset = offset
+        offset += alignup(child.hdrsize() + len(child.data))
+
+    for child in entry.entries:
+        if child.mode == DIRECTORY:
+            offset = layout(child, offset)
+
+    return offset
+
+
+def link(entry, parent):
+    """Fill in the info fields and the indexes."""
+
+    entry.info = entry.first
+    entry.dot.info = entry.offset
+    entry.dotdot.info = parent.offset
+
+    for i, child in enumerate(entry.sorted):
+        start = 8 + 4 * i
+        data = entry.dot.data
+        entry.dot.data = data[:start] + struct.pack(">I", child.offset)
+        entry.dot.data += data[start + 4 :]
+
+    for child in entry.entries:
+        if child.mode == DIRECTORY:
+            link(child, entry)
+
+
+def emit(image, entry):
+    entries = [entry.dot, entry.dotdot] + entry.entries
+    for i, child in enumerate(entries):
+        nextoff = entries[i + 1].offset if i + 1 < len(entries) else 0
+        hdr = struct.pack(
+            ">IIII", nextoff | child.mode, child.info, len(child.data), 0
+        )
+        hdr += padname(child.name)
+        hdr = hdr[:12] + struct.pack(">I", checksum(hdr)) + hdr[16:]
+        image[child.offset : child.offset + len(hdr)] = hdr
+        start = child.offset + len(hdr)
+        image[start : start + len(child.data)] = child.data
+
+    for child in entry.entries:
+        if child.mode == DIRECTORY:
+            emit(image, child)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("-d", "--directory", required=True, help="source")
+    parser.add_argument("-f", "--file", required=True, help="output image")
+    parser.add_argument("-V", "--volume", default="rom", help="volume name")
+    parser.add_argument(
+        "--no-index", action="store_true", help="omit the directory indexes"
+    )
+    args = parser.parse_args()
+
+    root = scan(args.directory, b"", not args.no_index)
+    volhdr = 16 + len(padname(args.volume.encode()))
+
+    # The root directory has no header of its own, its "." entry is a
+    # directory that points at itself.
+
+    end = layout(root, volhdr)
+    root.offset = root.first
+    root.dot.mode = DIRECTORY
+    link(root, root)
+    root.dot.info = root.first
+
+    size = (end + 1023) & ~1023
+    image = bytearray(size)
+    image[0:volhdr] = struct.pack(">8sII", b"-rom1fs-", size, 0) + padname(
+        args.volume.encode()
+    )
+    emit(image, root)
+
+    image[12:16] = struct.pack(">I", checksum(bytes(image[: min(512, size)])))
+
+    with open(args.file, "wb") as f:
+        f.write(image)
+
+
+if __name__ == "__main__":
+    main()